@@ -0,0 +1,182 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_BENCH_H
+#define IGL_BENCH_H
+// Minimal self-contained benchmark harness used by igl_bench
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+  struct Options
+  {
+    // Untimed runs before measuring
+    int warmup = 1;
+    // Maximum number of timed runs
+    int repetitions = 10;
+    // Stop repeating once this many seconds have been spent (after at least
+    // min_repetitions timed runs)
+    double max_seconds = 5.0;
+    int min_repetitions = 3;
+    // Only run benchmarks whose name contains this substring
+    std::string filter;
+  };
+
+  struct Result
+  {
+    std::string name;
+    // Number of input faces of the mesh
+    size_t faces;
+    // Number of processed elements per run (faces, queries, ...)
+    size_t elements;
+    int repetitions;
+    // Seconds per run
+    double min;
+    double median;
+    double p95;
+    // elements / median
+    double throughput;
+  };
+
+  inline double seconds()
+  {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Returns q-quantile (q in [0,1]) of sorted times using nearest rank
+  inline double quantile(const std::vector<double> & sorted, const double q)
+  {
+    const size_t n = sorted.size();
+    size_t k = (size_t)std::ceil(q*n);
+    k = std::min(std::max<size_t>(k,1),n);
+    return sorted[k-1];
+  }
+
+  class Runner
+  {
+    public:
+      Runner(const Options & options): m_options(options) {}
+      // Time `run` (and call untimed `setup` before each run)
+      //
+      // Inputs:
+      //   name  name of the benchmark
+      //   faces  number of faces of the input mesh
+      //   elements  number of elements processed by one call to run
+      //   setup  function called before each run (not timed)
+      //   run  function to be timed
+      void add(
+        const std::string & name,
+        const size_t faces,
+        const size_t elements,
+        const std::function<void()> & setup,
+        const std::function<void()> & run)
+      {
+        if(!enabled(name))
+        {
+          return;
+        }
+        for(int w = 0;w<m_options.warmup;w++)
+        {
+          setup();
+          run();
+        }
+        std::vector<double> times;
+        double total = 0;
+        while((int)times.size() < m_options.repetitions)
+        {
+          setup();
+          const double t0 = seconds();
+          run();
+          const double t = seconds()-t0;
+          times.push_back(t);
+          total += t;
+          if((int)times.size() >= m_options.min_repetitions &&
+            total > m_options.max_seconds)
+          {
+            break;
+          }
+        }
+        std::sort(times.begin(),times.end());
+        Result r;
+        r.name = name;
+        r.faces = faces;
+        r.elements = elements;
+        r.repetitions = (int)times.size();
+        r.min = times.front();
+        r.median = quantile(times,0.5);
+        r.p95 = quantile(times,0.95);
+        r.throughput = r.median>0 ? elements/r.median : 0;
+        printf("%-36s %10zu %5d %12.3f %12.3f %12.3f %14.4g\n",
+          r.name.c_str(),r.faces,r.repetitions,
+          r.min*1e3,r.median*1e3,r.p95*1e3,r.throughput);
+        fflush(stdout);
+        m_results.push_back(r);
+      }
+      void add(
+        const std::string & name,
+        const size_t faces,
+        const size_t elements,
+        const std::function<void()> & run)
+      {
+        return add(name,faces,elements,[](){},run);
+      }
+      // Whether a benchmark with this name would be run
+      bool enabled(const std::string & name) const
+      {
+        return m_options.filter.empty() ||
+          name.find(m_options.filter) != std::string::npos;
+      }
+      void print_header() const
+      {
+        printf("%-36s %10s %5s %12s %12s %12s %14s\n",
+          "benchmark","faces","reps","min (ms)","median (ms)","p95 (ms)",
+          "elements/s");
+      }
+      // Write all results as a JSON array
+      //
+      // Inputs:
+      //   filename  path to output .json file
+      // Returns true on success
+      bool write_json(const std::string & filename) const
+      {
+        FILE * f = fopen(filename.c_str(),"w");
+        if(f == NULL)
+        {
+          fprintf(stderr,"IOError: %s could not be opened...\n",
+            filename.c_str());
+          return false;
+        }
+        fprintf(f,"[\n");
+        for(size_t i = 0;i<m_results.size();i++)
+        {
+          const Result & r = m_results[i];
+          fprintf(f,
+            "  {\"name\": \"%s\", \"faces\": %zu, \"elements\": %zu, "
+            "\"repetitions\": %d, \"min\": %.9g, \"median\": %.9g, "
+            "\"p95\": %.9g, \"throughput\": %.9g}%s\n",
+            r.name.c_str(),r.faces,r.elements,r.repetitions,
+            r.min,r.median,r.p95,r.throughput,
+            i+1<m_results.size()?",":"");
+        }
+        fprintf(f,"]\n");
+        fclose(f);
+        return true;
+      }
+    private:
+      Options m_options;
+      std::vector<Result> m_results;
+  };
+}
+
+#endif
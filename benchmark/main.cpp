@@ -0,0 +1,560 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+//
+// igl_bench: timings of core libigl kernels on procedurally generated meshes
+// of increasing size.
+//
+// Usage:
+//   igl_bench [options]
+//
+// Options:
+//   --min-faces N    smallest mesh size (default 10000)
+//   --max-faces N    largest mesh size (default 1000000, up to ~10M)
+//   --queries N      number of query points/rays (default 100000)
+//   --reps N         maximum number of timed repetitions (default 10)
+//   --warmup N       untimed runs before timing (default 1)
+//   --max-seconds S  stop repeating after S seconds (default 5)
+//   --filter STR     only run benchmarks whose name contains STR
+//   --json FILE      also write results to FILE as JSON
+//   --tmp DIR        directory for temporary files (default .)
+//
+// Meshes are unit spheres obtained by repeatedly upsampling an octahedron
+// (8*4^k faces), so sizes grow by 4x from one level to the next.
+//
+// Tree construction and winding number based signed distance are
+// additionally timed with 1, 2, 4, ... threads (up to all available threads)
+// to show how they scale with cores.
+#include "bench.h"
+
+#include <igl/AABB.h>
+#include <igl/FlatAABB.h>
+#include <igl/Hit.h>
+#include <igl/KDTree.h>
+#include <igl/MappedMesh.h>
+#include <igl/PI.h>
+#include <igl/PackedTriangles.h>
+#include <igl/SignedDistanceField.h>
+#include <igl/cotmatrix.h>
+#include <igl/decimate.h>
+#include <igl/decode_mesh.h>
+#include <igl/encode_mesh.h>
+#include <igl/fast_find_intersections.h>
+#include <igl/fast_readOBJ.h>
+#include <igl/fast_readPLY.h>
+#include <igl/fast_readSTL.h>
+#include <igl/fast_winding_number.h>
+#include <igl/fast_writeDMAT.h>
+#include <igl/fast_writeOBJ.h>
+#include <igl/fast_writeOFF.h>
+#include <igl/fast_writePLY.h>
+#include <igl/fast_writeSTL.h>
+#include <igl/grad.h>
+#include <igl/hausdorff.h>
+#include <igl/massmatrix.h>
+#include <igl/num_threads.h>
+#include <igl/per_vertex_normals.h>
+#include <igl/ray_mesh_intersect.h>
+#include <igl/readIGLB.h>
+#include <igl/readOBJ.h>
+#include <igl/readPLY.h>
+#include <igl/readSTL.h>
+#include <igl/remove_duplicate_vertices.h>
+#include <igl/set_num_threads.h>
+#include <igl/signed_distance.h>
+#include <igl/snap_points.h>
+#include <igl/stream_mesh.h>
+#include <igl/triangle_triangle_adjacency.h>
+#include <igl/unique_edge_map.h>
+#include <igl/upsample.h>
+#include <igl/winding_number.h>
+#include <igl/writeDMAT.h>
+#include <igl/writeIGLB.h>
+#include <igl/writeOBJ.h>
+#include <igl/writeOFF.h>
+#include <igl/writePLY.h>
+#include <igl/writeSTL.h>
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Unit sphere with 8*4^k faces
+static void sphere(const int k, Eigen::MatrixXd & V, Eigen::MatrixXi & F)
+{
+  V.resize(6,3);
+  V<<
+     1, 0, 0,
+    -1, 0, 0,
+     0, 1, 0,
+     0,-1, 0,
+     0, 0, 1,
+     0, 0,-1;
+  F.resize(8,3);
+  F<<
+    0,2,4,
+    2,1,4,
+    1,3,4,
+    3,0,4,
+    2,0,5,
+    1,2,5,
+    3,1,5,
+    0,3,5;
+  if(k>0)
+  {
+    igl::upsample(V,F,k);
+  }
+  V.rowwise().normalize();
+}
+
+int main(int argc, char * argv[])
+{
+  using namespace Eigen;
+  using namespace std;
+  bench::Options options;
+  size_t min_faces = 10000;
+  size_t max_faces = 1000000;
+  int num_queries = 100000;
+  string json;
+  string tmp = ".";
+  for(int a = 1;a<argc;a++)
+  {
+    const string arg(argv[a]);
+    const bool has_value = a+1<argc;
+    if(arg == "--min-faces" && has_value)
+    {
+      min_faces = strtoull(argv[++a],NULL,10);
+    }else if(arg == "--max-faces" && has_value)
+    {
+      max_faces = strtoull(argv[++a],NULL,10);
+    }else if(arg == "--queries" && has_value)
+    {
+      num_queries = atoi(argv[++a]);
+    }else if(arg == "--reps" && has_value)
+    {
+      options.repetitions = std::max(1,atoi(argv[++a]));
+      options.min_repetitions =
+        std::min(options.min_repetitions,options.repetitions);
+    }else if(arg == "--warmup" && has_value)
+    {
+      options.warmup = atoi(argv[++a]);
+    }else if(arg == "--max-seconds" && has_value)
+    {
+      options.max_seconds = atof(argv[++a]);
+    }else if(arg == "--filter" && has_value)
+    {
+      options.filter = argv[++a];
+    }else if(arg == "--json" && has_value)
+    {
+      json = argv[++a];
+    }else if(arg == "--tmp" && has_value)
+    {
+      tmp = argv[++a];
+    }else
+    {
+      fprintf(stderr,"Unknown or incomplete option: %s\n",arg.c_str());
+      fprintf(stderr,"See the top of benchmark/main.cpp for usage\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Thread counts for scaling benchmarks: powers of two and the maximum
+  const size_t max_threads = igl::num_threads();
+  vector<size_t> thread_counts;
+  for(size_t t = 1;t<max_threads;t *= 2)
+  {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  bench::Runner runner(options);
+  runner.print_header();
+  for(int k = 0;(size_t)(8<<(2*k)) <= max_faces;k++)
+  {
+    const size_t m = 8<<(2*k);
+    if(m < min_faces)
+    {
+      continue;
+    }
+    MatrixXd V;
+    MatrixXi F;
+    sphere(k,V,F);
+
+    // Query points in and around the sphere, rays towards the origin
+    srand(0);
+    const MatrixXd P = MatrixXd::Random(num_queries,3)*1.5;
+    const MatrixXd D = -P;
+
+    // Intrinsic operators
+    {
+      SparseMatrix<double> L,M,G;
+      runner.add("cotmatrix",m,m,[&](){ igl::cotmatrix(V,F,L); });
+      runner.add("massmatrix",m,m,
+        [&](){ igl::massmatrix(V,F,igl::MASSMATRIX_TYPE_VORONOI,M); });
+      runner.add("grad",m,m,[&](){ igl::grad(V,F,G); });
+    }
+    {
+      MatrixXd N;
+      runner.add("per_vertex_normals",m,m,
+        [&](){ igl::per_vertex_normals(V,F,N); });
+    }
+
+    // Combinatorics
+    {
+      MatrixXi E,uE;
+      VectorXi EMAP;
+      vector<vector<int> > uE2E;
+      runner.add("unique_edge_map",m,m,
+        [&](){ igl::unique_edge_map(F,E,uE,EMAP,uE2E); });
+      MatrixXi TT,TTi;
+      runner.add("triangle_triangle_adjacency",m,m,
+        [&](){ igl::triangle_triangle_adjacency(F,TT,TTi); });
+    }
+
+    // Spatial queries
+    {
+      igl::AABB<MatrixXd,3> tree;
+      runner.add("AABB::init",m,m,[&](){ tree.init(V,F); });
+      const char * split_names[] = {"median","sah"};
+      for(int s = 0;s<igl::NUM_AABB_SPLIT_TYPES;s++)
+      {
+        const igl::AABBSplitType split = (igl::AABBSplitType)s;
+        for(const size_t t : thread_counts)
+        {
+          igl::set_num_threads(t);
+          runner.add(
+            string("AABB::init[")+split_names[s]+","+to_string(t)+" threads]",
+            m,m,[&](){ tree.init(V,F,split); });
+        }
+        igl::set_num_threads(max_threads);
+      }
+      tree.init(V,F);
+      {
+        // Deformed copy of the mesh
+        const MatrixXd U = (V.array()*(1.0+0.1*V.col(0).array().sin()).
+          replicate(1,3)).matrix();
+        runner.add("AABB::refit",m,m,[&](){ tree.refit(U,F); });
+        tree.refit(V,F);
+      }
+      VectorXd sqrD;
+      VectorXi I;
+      MatrixXd C;
+      runner.add("AABB::squared_distance",m,num_queries,
+        [&](){ tree.squared_distance(V,F,P,sqrD,I,C); });
+      size_t num_hits = 0;
+      runner.add("AABB::intersect_ray",m,num_queries,
+        [&]()
+        {
+          num_hits = 0;
+          for(int q = 0;q<num_queries;q++)
+          {
+            igl::Hit hit;
+            const RowVector3d o = P.row(q);
+            const RowVector3d d = D.row(q);
+            num_hits += tree.intersect_ray(V,F,o,d,hit);
+          }
+        });
+      VectorXi HI;
+      VectorXd HT;
+      MatrixXd HUV;
+      runner.add("AABB::intersect_rays",m,num_queries,
+        [&](){ tree.intersect_rays(V,F,P,D,VectorXd(),VectorXd(),HI,HT,HUV); });
+      VectorXi H;
+      runner.add("AABB::intersect_rays_any",m,num_queries,
+        [&](){ tree.intersect_rays_any(V,F,P,D,VectorXd(),VectorXd(),H); });
+    }
+    {
+      igl::FlatAABB<MatrixXd,3,float> tree;
+      runner.add("FlatAABB::init",m,m,[&](){ tree.init(V,F); });
+      tree.init(V,F);
+      VectorXd sqrD;
+      VectorXi I;
+      MatrixXd C;
+      runner.add("FlatAABB::squared_distance",m,num_queries,
+        [&](){ tree.squared_distance(V,F,P,sqrD,I,C); });
+      size_t num_hits = 0;
+      runner.add("FlatAABB::intersect_ray",m,num_queries,
+        [&]()
+        {
+          num_hits = 0;
+          for(int q = 0;q<num_queries;q++)
+          {
+            igl::Hit hit;
+            const RowVector3d o = P.row(q);
+            const RowVector3d d = D.row(q);
+            num_hits += tree.intersect_ray(V,F,o,d,hit);
+          }
+        });
+    }
+    {
+      // Brute force over all faces, so only a few rays
+      const int num_rays = std::min(num_queries,100);
+      const MatrixXf Vf = V.cast<float>();
+      size_t num_hits = 0;
+      runner.add("ray_mesh_intersect",m,num_rays,
+        [&]()
+        {
+          num_hits = 0;
+          for(int q = 0;q<num_rays;q++)
+          {
+            igl::Hit hit;
+            const RowVector3d o = P.row(q);
+            const RowVector3d d = D.row(q);
+            num_hits += igl::ray_mesh_intersect(o,d,V,F,hit);
+          }
+        });
+      runner.add("ray_mesh_intersect[float]",m,num_rays,
+        [&]()
+        {
+          num_hits = 0;
+          for(int q = 0;q<num_rays;q++)
+          {
+            igl::Hit hit;
+            const RowVector3f o = P.row(q).cast<float>();
+            const RowVector3f d = D.row(q).cast<float>();
+            num_hits += igl::ray_mesh_intersect(o,d,Vf,F,hit);
+          }
+        });
+      // Packed once for all rays
+      igl::PackedTriangles<double> T;
+      T.init(V,F);
+      runner.add("ray_mesh_intersect[packed]",m,num_rays,
+        [&]()
+        {
+          num_hits = 0;
+          for(int q = 0;q<num_rays;q++)
+          {
+            igl::Hit hit;
+            const RowVector3d o = P.row(q);
+            const RowVector3d d = D.row(q);
+            num_hits += igl::ray_mesh_intersect(o,d,T,hit);
+          }
+        });
+    }
+    {
+      igl::KDTree<double,3> tree;
+      runner.add("KDTree::init",m,m,[&](){ tree.init(V); });
+      tree.init(V);
+      MatrixXi I;
+      MatrixXd sqrD;
+      runner.add("KDTree::knn[k=8]",m,num_queries,
+        [&](){ tree.knn(P,8,I,sqrD); });
+      VectorXi C,J;
+      VectorXd sqrR;
+      // Roughly 10 neighbors per query near the surface
+      const double radius = 4.0*sqrt(4.0*igl::PI/m);
+      runner.add("KDTree::radius_search",m,num_queries,
+        [&](){ tree.radius_search(P,radius,C,J,sqrR); });
+      VectorXi SI;
+      VectorXd minD;
+      runner.add("snap_points",m,num_queries,
+        [&](){ igl::snap_points(P,V,SI,minD); });
+    }
+    {
+      VectorXd W;
+      runner.add("winding_number",m,num_queries,
+        [&](){ igl::winding_number(V,F,P,W); });
+      runner.add("fast_winding_number",m,num_queries,
+        [&](){ igl::fast_winding_number(V,F,P,W); });
+      VectorXd S;
+      VectorXi I;
+      MatrixXd C,N;
+      runner.add("signed_distance",m,num_queries,
+        [&]()
+        {
+          igl::signed_distance(
+            P,V,F,igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL,S,I,C,N);
+        });
+      // Exact only within a few edge lengths of the surface
+      const double band = 4.0*sqrt(4.0*igl::PI/m);
+      runner.add("signed_distance[band]",m,num_queries,
+        [&]()
+        {
+          igl::signed_distance(
+            P,V,F,igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL,0.,band,S,I,C,N);
+        });
+      igl::SignedDistanceField sdf;
+      runner.add("SignedDistanceField::init",m,m,
+        [&]()
+        {
+          sdf.init(V,F,igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL,16,4);
+        });
+      sdf.init(V,F,igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL,16,4);
+      MatrixXd G;
+      runner.add("SignedDistanceField::signed_distance",m,num_queries,
+        [&]()
+        {
+          sdf.signed_distance(
+            P,igl::SIGNED_DISTANCE_FIELD_INTERPOLATION_TRILINEAR,S,G);
+        });
+      for(const size_t t : thread_counts)
+      {
+        igl::set_num_threads(t);
+        runner.add(
+          "signed_distance[winding_number,"+to_string(t)+" threads]",
+          m,num_queries,
+          [&]()
+          {
+            igl::signed_distance(
+              P,V,F,igl::SIGNED_DISTANCE_TYPE_WINDING_NUMBER,S,I,C,N);
+          });
+      }
+      igl::set_num_threads(max_threads);
+    }
+
+    {
+      // Bumpy copy of the mesh
+      const MatrixXd U = (V.array()*(1.0+0.01*(10.0*V.col(0).array()).sin()).
+        replicate(1,3)).matrix();
+      double d,lower,upper;
+      runner.add("hausdorff",m,m,[&](){ igl::hausdorff(V,F,U,F,d); });
+      runner.add("hausdorff[bounds]",m,m,
+        [&]()
+        {
+          igl::hausdorff(
+            V,F,U,F,1e-4,numeric_limits<double>::infinity(),lower,upper);
+        });
+    }
+
+    {
+      // Copy of the mesh crossing it along a band
+      MatrixXd U = V;
+      U.col(0).array() += 0.5;
+      MatrixXi IF;
+      VectorXi C;
+      runner.add("fast_find_self_intersections",m,m,
+        [&](){ igl::fast_find_self_intersections(V,F,false,IF,C); });
+      runner.add("fast_find_intersections",m,m,
+        [&](){ igl::fast_find_intersections(V,F,U,F,false,IF,C); });
+    }
+
+    // Remeshing
+    {
+      MatrixXd U;
+      MatrixXi G;
+      VectorXi J;
+      runner.add("decimate",m,m,
+        [&](){ igl::decimate(V,F,m/2,U,G,J); });
+    }
+
+    // IO
+    if(runner.enabled("readOBJ") || runner.enabled("fast_readOBJ") ||
+      runner.enabled("stream_mesh"))
+    {
+      const string obj = tmp+"/igl_bench.obj";
+      igl::writeOBJ(obj,V,F);
+      MatrixXd RV;
+      MatrixXi RF;
+      runner.add("readOBJ",m,m,[&](){ igl::readOBJ(obj,RV,RF); });
+      runner.add("fast_readOBJ",m,m,[&](){ igl::fast_readOBJ(obj,RV,RF); });
+      // Bounding box in blocks of 64k vertices
+      runner.add("stream_mesh",m,m,[&]()
+      {
+        RowVector3d min_c = RowVector3d::Constant( 1e300);
+        RowVector3d max_c = RowVector3d::Constant(-1e300);
+        igl::stream_mesh(obj,1<<16,
+          [&](const MatrixXd & B, const int)
+          {
+            min_c = min_c.cwiseMin(B.colwise().minCoeff());
+            max_c = max_c.cwiseMax(B.colwise().maxCoeff());
+            return true;
+          },
+          [](const MatrixXi &, const int){ return true; });
+      });
+      remove(obj.c_str());
+    }
+    if(runner.enabled("IGLB") || runner.enabled("MappedMesh"))
+    {
+      const string iglb = tmp+"/igl_bench.iglb";
+      igl::writeIGLB(iglb,V,F);
+      MatrixXd RV;
+      MatrixXi RF;
+      runner.add("readIGLB",m,m,[&](){ igl::readIGLB(iglb,RV,RF); });
+      // Open and touch every vertex through the map
+      double sum = 0;
+      runner.add("MappedMesh",m,m,[&]()
+      {
+        igl::MappedMesh mesh;
+        mesh.open(iglb);
+        sum += mesh.map<double>("V").sum();
+      });
+      remove(iglb.c_str());
+    }
+    if(runner.enabled("readSTL") || runner.enabled("fast_readSTL"))
+    {
+      const string stl = tmp+"/igl_bench.stl";
+      igl::writeSTL(stl,V,F,false);
+      MatrixXd RV,RN;
+      MatrixXi RF;
+      runner.add("readSTL",m,m,[&](){ igl::readSTL(stl,RV,RF,RN); });
+      runner.add("fast_readSTL",m,m,
+        [&](){ igl::fast_readSTL(stl,RV,RF,RN); });
+      MatrixXd SV;
+      MatrixXi SF,SVI,SVJ;
+      runner.add("readSTL[weld]",m,m,[&]()
+      {
+        igl::readSTL(stl,SV,SF,RN);
+        igl::remove_duplicate_vertices(SV,SF,0,RV,SVI,SVJ,RF);
+      });
+      runner.add("fast_readSTL[weld]",m,m,
+        [&](){ igl::fast_readSTL(stl,0,RV,RF,RN); });
+      remove(stl.c_str());
+    }
+    if(runner.enabled("readPLY") || runner.enabled("fast_readPLY") ||
+      runner.enabled("writePLY") || runner.enabled("fast_writePLY"))
+    {
+      const string ply = tmp+"/igl_bench.ply";
+      igl::writePLY(ply,V,F,false);
+      MatrixXd RV;
+      MatrixXi RF;
+      runner.add("readPLY",m,m,[&](){ igl::readPLY(ply,RV,RF); });
+      runner.add("fast_readPLY",m,m,[&](){ igl::fast_readPLY(ply,RV,RF); });
+      runner.add("writePLY",m,m,[&](){ igl::writePLY(ply,V,F,false); });
+      runner.add("fast_writePLY",m,m,[&](){ igl::fast_writePLY(ply,V,F); });
+      remove(ply.c_str());
+    }
+    if(runner.enabled("encode_mesh") || runner.enabled("decode_mesh"))
+    {
+      std::vector<unsigned char> data;
+      runner.add("encode_mesh",m,m,[&](){ igl::encode_mesh(V,F,16,data); });
+      igl::encode_mesh(V,F,16,data);
+      MatrixXd RV;
+      MatrixXi RF;
+      runner.add("decode_mesh",m,m,[&](){ igl::decode_mesh(data,RV,RF); });
+    }
+    // ASCII writers
+    {
+      const string out = tmp+"/igl_bench_out";
+      const string obj = out+".obj", off = out+".off", stl = out+".stl";
+      const string ply = out+".ply", dmat = out+".dmat";
+      runner.add("writeOBJ",m,m,[&](){ igl::writeOBJ(obj,V,F); });
+      runner.add("fast_writeOBJ",m,m,[&](){ igl::fast_writeOBJ(obj,V,F); });
+      runner.add("writeOFF",m,m,[&](){ igl::writeOFF(off,V,F); });
+      runner.add("fast_writeOFF",m,m,[&](){ igl::fast_writeOFF(off,V,F); });
+      runner.add("writeSTL[ascii]",m,m,[&](){ igl::writeSTL(stl,V,F,true); });
+      runner.add("fast_writeSTL",m,m,[&](){ igl::fast_writeSTL(stl,V,F); });
+      runner.add("writePLY[ascii]",m,m,[&](){ igl::writePLY(ply,V,F,true); });
+      runner.add("fast_writePLY[ascii]",m,m,
+        [&](){ igl::fast_writePLY(ply,V,F,true); });
+      runner.add("writeDMAT",m,m,[&](){ igl::writeDMAT(dmat,V); });
+      runner.add("fast_writeDMAT",m,m,[&](){ igl::fast_writeDMAT(dmat,V); });
+      for(const string & f : {obj,off,stl,ply,dmat})
+      {
+        remove(f.c_str());
+      }
+    }
+  }
+  if(!json.empty() && !runner.write_json(json))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
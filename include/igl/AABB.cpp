@@ -6,17 +6,26 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "AABB.h"
+#include "PackedTriangles.h"
+#include "Profiler.h"
 #include "EPS.h"
 #include "barycenter.h"
 #include "barycentric_coordinates.h"
 #include "colon.h"
 #include "doublearea.h"
+#include "morton_order.h"
 #include "point_simplex_squared_distance.h"
 #include "project_to_line_segment.h"
 #include "sort.h"
 #include "volume.h"
+#include "parallel_for.h"
+#include "parallel_sort.h"
 #include "ray_box_intersect.h"
 #include "ray_mesh_intersect.h"
+#include "ray_triangle_intersect.h"
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
 #include <iomanip>
 #include <limits>
@@ -24,6 +33,582 @@
 #include <queue>
 #include <stack>
 
+namespace igl
+{
+  namespace aabb
+  {
+    // Subtrees (and boxes) over at least this many elements are built in
+    // parallel
+    const int PARALLEL_BUILD_MIN_SIZE = 4096;
+    // Number of bins per axis used to evaluate the surface area heuristic
+    const int SAH_NUM_BINS = 16;
+    // Bounding box of elements I[0],...,I[n-1] and of their barycenters
+    //
+    // Inputs:
+    //   V  #V by dim list of mesh vertex positions
+    //   Ele  #Ele by dim+1 list of mesh indices into #V
+    //   BC  #Ele by dim list of barycenters, or empty to skip centroid_box
+    //   I  list of n indices into Ele
+    //   n  number of elements
+    // Outputs:
+    //   box  bounding box of elements
+    //   centroid_box  bounding box of barycenters
+    template <typename DerivedV, typename DerivedBC, int DIM>
+    inline void bounding_boxes(
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele,
+      const Eigen::PlainObjectBase<DerivedBC> & BC,
+      const int * I,
+      const int n,
+      Eigen::AlignedBox<typename DerivedV::Scalar,DIM> & box,
+      Eigen::AlignedBox<typename DerivedV::Scalar,DIM> & centroid_box)
+    {
+      typedef Eigen::AlignedBox<typename DerivedV::Scalar,DIM> Box;
+      // Per-thread boxes: 2*t for elements, 2*t+1 for barycenters
+      std::vector<Box,Eigen::aligned_allocator<Box> > S;
+      box.setEmpty();
+      centroid_box.setEmpty();
+      parallel_for(
+        n,
+        [&S](const size_t nt){ S.assign(2*nt,Box()); },
+        [&V,&Ele,&BC,I,&S](const int i, const size_t t)
+        {
+          const int e = I[i];
+          for(int c = 0;c<Ele.cols();c++)
+          {
+            S[2*t].extend(V.row(Ele(e,c)).transpose());
+          }
+          if(BC.size() > 0)
+          {
+            S[2*t+1].extend(BC.row(e).transpose());
+          }
+        },
+        [&S,&box,&centroid_box](const size_t t)
+        {
+          box.extend(S[2*t]);
+          centroid_box.extend(S[2*t+1]);
+        },
+        PARALLEL_BUILD_MIN_SIZE);
+    }
+    // Half of the surface area of a box (half perimeter in 2D)
+    template <typename Scalar, int DIM>
+    inline Scalar half_area(const Eigen::AlignedBox<Scalar,DIM> & box)
+    {
+      if(box.isEmpty())
+      {
+        return 0;
+      }
+      const Eigen::Matrix<Scalar,DIM,1> e = box.sizes();
+      Scalar a = 0;
+      for(int d = 0;d<DIM;d++)
+      {
+        Scalar p = 1;
+        for(int c = 0;c<DIM;c++)
+        {
+          if(c != d)
+          {
+            p *= e(c);
+          }
+        }
+        a += p;
+      }
+      return a;
+    }
+    // Partition elements I[0],...,I[n-1] (n>1) into two non-empty groups
+    // minimizing the binned surface area heuristic. Falls back to a median
+    // split if all barycenters fall into a single bin.
+    //
+    // Inputs:
+    //   V  #V by dim list of mesh vertex positions
+    //   Ele  #Ele by dim+1 list of mesh indices into #V
+    //   BC  #Ele by dim list of barycenters
+    //   centroid_box  bounding box of barycenters of I
+    //   I  list of n indices into Ele
+    //   n  number of elements
+    // Outputs:
+    //   I  reordered so that I[0],...,I[mid-1] go to the left child
+    // Returns mid
+    template <typename DerivedV, typename DerivedBC, int DIM>
+    inline int sah_partition(
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele,
+      const Eigen::PlainObjectBase<DerivedBC> & BC,
+      const Eigen::AlignedBox<typename DerivedV::Scalar,DIM> & centroid_box,
+      int * I,
+      const int n)
+    {
+      typedef typename DerivedV::Scalar Scalar;
+      typedef Eigen::AlignedBox<Scalar,DIM> Box;
+      const int B = SAH_NUM_BINS;
+      const Eigen::Matrix<Scalar,DIM,1> cmin = centroid_box.min();
+      const Eigen::Matrix<Scalar,DIM,1> extent = centroid_box.sizes();
+      const auto bin = [&BC,&cmin,&extent,B](const int e, const int d)->int
+      {
+        const int k = (int)(B*((BC(e,d)-cmin(d))/extent(d)));
+        return std::max(0,std::min(k,B-1));
+      };
+      // Per-thread bins: [t*DIM*B + d*B + k]
+      std::vector<Box,Eigen::aligned_allocator<Box> > SB;
+      std::vector<int> SC;
+      std::vector<Box,Eigen::aligned_allocator<Box> > bins(DIM*B);
+      std::vector<int> counts(DIM*B,0);
+      parallel_for(
+        n,
+        [&SB,&SC,B](const size_t nt)
+        {
+          SB.assign(nt*DIM*B,Box());
+          SC.assign(nt*DIM*B,0);
+        },
+        [&V,&Ele,&extent,I,&bin,&SB,&SC,B](const int i, const size_t t)
+        {
+          const int e = I[i];
+          Box ebox;
+          for(int c = 0;c<Ele.cols();c++)
+          {
+            ebox.extend(V.row(Ele(e,c)).transpose());
+          }
+          for(int d = 0;d<DIM;d++)
+          {
+            if(extent(d) > 0)
+            {
+              const int b = t*DIM*B + d*B + bin(e,d);
+              SB[b].extend(ebox);
+              SC[b]++;
+            }
+          }
+        },
+        [&SB,&SC,&bins,&counts,B](const size_t t)
+        {
+          for(int b = 0;b<DIM*B;b++)
+          {
+            bins[b].extend(SB[t*DIM*B+b]);
+            counts[b] += SC[t*DIM*B+b];
+          }
+        },
+        PARALLEL_BUILD_MIN_SIZE);
+      // Sweep candidate planes between bins k and k+1 on every axis
+      Scalar best_cost = std::numeric_limits<Scalar>::infinity();
+      int best_d = -1;
+      int best_k = -1;
+      for(int d = 0;d<DIM;d++)
+      {
+        if(!(extent(d) > 0))
+        {
+          continue;
+        }
+        Scalar right_area[SAH_NUM_BINS];
+        int right_count[SAH_NUM_BINS];
+        {
+          Box R;
+          int nr = 0;
+          for(int k = B-1;k>0;k--)
+          {
+            R.extend(bins[d*B+k]);
+            nr += counts[d*B+k];
+            right_area[k-1] = half_area(R);
+            right_count[k-1] = nr;
+          }
+        }
+        Box L;
+        int nl = 0;
+        for(int k = 0;k<B-1;k++)
+        {
+          L.extend(bins[d*B+k]);
+          nl += counts[d*B+k];
+          if(nl == 0 || right_count[k] == 0)
+          {
+            continue;
+          }
+          const Scalar cost = half_area(L)*nl + right_area[k]*right_count[k];
+          if(cost < best_cost)
+          {
+            best_cost = cost;
+            best_d = d;
+            best_k = k;
+          }
+        }
+      }
+      if(best_d < 0)
+      {
+        // Barycenters (nearly) coincide: split in half along longest axis
+        int max_d = 0;
+        extent.maxCoeff(&max_d);
+        const int mid = (n+1)/2;
+        std::nth_element(I,I+mid,I+n,[&BC,max_d](const int a, const int b)
+          {
+            return BC(a,max_d) < BC(b,max_d);
+          });
+        return mid;
+      }
+      return std::partition(I,I+n,[&bin,best_d,best_k](const int e)
+        {
+          return bin(e,best_d) <= best_k;
+        }) - I;
+    }
+    // Bounding box of a single element
+    template <typename DerivedV, int DIM>
+    inline Eigen::AlignedBox<typename DerivedV::Scalar,DIM> element_box(
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele,
+      const int e)
+    {
+      Eigen::AlignedBox<typename DerivedV::Scalar,DIM> box;
+      for(int c = 0;c<Ele.cols();c++)
+      {
+        box.extend(V.row(Ele(e,c)).transpose());
+      }
+      return box;
+    }
+    // Serially recompute boxes of a subtree bottom-up
+    template <typename DerivedV, int DIM>
+    inline void refit_subtree(
+      AABB<DerivedV,DIM> & tree,
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele)
+    {
+      if(tree.is_leaf())
+      {
+        tree.m_box = element_box<DerivedV,DIM>(V,Ele,tree.m_primitive);
+        return;
+      }
+      tree.m_box.setEmpty();
+      for(AABB<DerivedV,DIM> * child : {tree.m_left,tree.m_right})
+      {
+        if(child)
+        {
+          refit_subtree(*child,V,Ele);
+          tree.m_box.extend(child->m_box);
+        }
+      }
+    }
+    // Remove leaf holding e from subtree rooted at internal node tree
+    //
+    // Inputs:
+    //   tree  internal node
+    //   e  element to remove
+    //   box  only search children whose box contains this box, or NULL to
+    //     search everywhere
+    // Returns true iff e was found
+    template <typename DerivedV, int DIM>
+    inline bool remove_element(
+      AABB<DerivedV,DIM> & tree,
+      const int e,
+      const Eigen::AlignedBox<typename DerivedV::Scalar,DIM> * box)
+    {
+      for(int c = 0;c<2;c++)
+      {
+        AABB<DerivedV,DIM> * child = c==0 ? tree.m_left : tree.m_right;
+        if(child == NULL || (box && !child->m_box.contains(*box)))
+        {
+          continue;
+        }
+        if(child->is_leaf())
+        {
+          if(child->m_primitive != e)
+          {
+            continue;
+          }
+          // Replace tree by sibling
+          AABB<DerivedV,DIM> * sibling = c==0 ? tree.m_right : tree.m_left;
+          tree.m_left = NULL;
+          tree.m_right = NULL;
+          delete child;
+          if(sibling)
+          {
+            std::swap(tree.m_left,sibling->m_left);
+            std::swap(tree.m_right,sibling->m_right);
+            tree.m_box = sibling->m_box;
+            tree.m_primitive = sibling->m_primitive;
+            delete sibling;
+          }else
+          {
+            tree.m_box.setEmpty();
+          }
+          return true;
+        }
+        if(remove_element(*child,e,box))
+        {
+          tree.m_box.setEmpty();
+          if(tree.m_left) tree.m_box.extend(tree.m_left->m_box);
+          if(tree.m_right) tree.m_box.extend(tree.m_right->m_box);
+          return true;
+        }
+      }
+      return false;
+    }
+    // Number of rays traversing the tree together in intersect_rays*
+    const int RAY_PACKET_SIZE = 8;
+    // Rays of a packet in structure-of-arrays layout. Unused lanes have an
+    // empty interval tmin > tmax and hence never hit anything.
+    template <typename Scalar>
+    struct RayPacket
+    {
+      int id[RAY_PACKET_SIZE];
+      Scalar o[3][RAY_PACKET_SIZE];
+      Scalar d[3][RAY_PACKET_SIZE];
+      Scalar inv_d[3][RAY_PACKET_SIZE];
+      Scalar tmin[RAY_PACKET_SIZE];
+      // Shrinks as hits are found
+      Scalar tmax[RAY_PACKET_SIZE];
+      // Rays prepared for igl::ray_triangle_intersect
+      PackedRays<Scalar> rays;
+      static_assert(
+        RAY_PACKET_SIZE == PackedRays<Scalar>::LANES,
+        "A packet should fill the lanes of PackedRays");
+    };
+    // Slab test of all lanes of a packet against a box
+    //
+    // Outputs:
+    //   mask  whether each lane's interval [tmin,tmax] overlaps the box
+    // Returns whether any lane does
+    template <typename Scalar, int DIM>
+    inline bool packet_box_intersect(
+      const RayPacket<Scalar> & R,
+      const Eigen::AlignedBox<Scalar,DIM> & box,
+      bool * mask)
+    {
+      Scalar bmin[3],bmax[3];
+      for(int k = 0;k<3;k++)
+      {
+        bmin[k] = box.min()(k);
+        bmax[k] = box.max()(k);
+      }
+      bool any = false;
+      for(int l = 0;l<RAY_PACKET_SIZE;l++)
+      {
+        Scalar t0 = R.tmin[l];
+        Scalar t1 = R.tmax[l];
+        for(int k = 0;k<3;k++)
+        {
+          // NaNs (origin on slab with zero direction) leave t0,t1 unchanged
+          const Scalar ta = (bmin[k]-R.o[k][l])*R.inv_d[k][l];
+          const Scalar tb = (bmax[k]-R.o[k][l])*R.inv_d[k][l];
+          t0 = std::max(t0,std::min(ta,tb));
+          t1 = std::min(t1,std::max(ta,tb));
+        }
+        mask[l] = t0 <= t1;
+        any = any || mask[l];
+      }
+      return any;
+    }
+    // Intersect all lanes of a packet with a triangle at once using
+    // igl::PackedRays
+    //
+    // Inputs:
+    //   R  packet of rays
+    //   V  #V by 3 list of vertex positions
+    //   Ele  #Ele by 3 list of triangle indices
+    //   f  index into Ele of triangle
+    // Outputs:
+    //   hit  whether each lane hits the triangle with t in (tmin,tmax)
+    //   t,u,v  ray parameter and barycentric coordinates of hits
+    // Returns whether any lane hits
+    template <typename Scalar, typename DerivedV>
+    inline bool packet_triangle_intersect(
+      const RayPacket<Scalar> & R,
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele,
+      const int f,
+      bool * hit,
+      Scalar * t,
+      Scalar * u,
+      Scalar * v)
+    {
+      Scalar P[3][3];
+      for(int c = 0;c<3;c++)
+      {
+        for(int k = 0;k<3;k++)
+        {
+          P[c][k] = V(Ele(f,c),k);
+        }
+      }
+      const int lanes_hit =
+        R.rays.intersect_triangle(P[0],P[1],P[2],R.tmin,R.tmax,t,u,v);
+      for(int l = 0;l<RAY_PACKET_SIZE;l++)
+      {
+        hit[l] = (lanes_hit>>l) & 1;
+      }
+      return lanes_hit != 0;
+    }
+    // Intersect a ray with triangle f of Ele for t in (0,max_t), set hit on
+    // success
+    template <typename DerivedV, typename Derivedorigin, typename Deriveddir>
+    inline bool ray_triangle(
+      const Eigen::PlainObjectBase<DerivedV> & V,
+      const Eigen::MatrixXi & Ele,
+      const Eigen::MatrixBase<Derivedorigin> & origin,
+      const Eigen::MatrixBase<Deriveddir> & dir,
+      const int f,
+      const typename DerivedV::Scalar max_t,
+      igl::Hit & hit)
+    {
+      typedef typename DerivedV::Scalar Scalar;
+      Scalar P[3][3];
+      for(int c = 0;c<3;c++)
+      {
+        for(int k = 0;k<3;k++)
+        {
+          P[c][k] = V(Ele(f,c),k);
+        }
+      }
+      Scalar t,u,v;
+      if(ray_triangle_intersect(
+        WatertightRay<Scalar>(origin,dir),P[0],P[1],P[2],Scalar(0),max_t,t,u,v))
+      {
+        hit = {f,-1,(float)u,(float)v,(float)t};
+        return true;
+      }
+      return false;
+    }
+    // Depth-first traversal of tree by a packet of rays
+    //
+    // Inputs:
+    //   tree  (non-empty) tree
+    //   R  packet of rays
+    //   leaf  function called as leaf(e,mask) for each leaf element e whose
+    //     box is hit by the lanes in mask, may shrink R.tmax
+    template <typename DerivedV, int DIM, typename LeafFunc>
+    inline void packet_traverse(
+      const AABB<DerivedV,DIM> & tree,
+      RayPacket<typename DerivedV::Scalar> & R,
+      const LeafFunc & leaf)
+    {
+      typedef typename DerivedV::Scalar Scalar;
+      // Sum of directions decides which child to visit first
+      Scalar sum_d[3] = {0,0,0};
+      for(int k = 0;k<3;k++)
+      {
+        for(int l = 0;l<RAY_PACKET_SIZE;l++)
+        {
+          sum_d[k] += R.d[k][l];
+        }
+      }
+      std::vector<const AABB<DerivedV,DIM> *> stack;
+      stack.reserve(64);
+      stack.push_back(&tree);
+      bool mask[RAY_PACKET_SIZE];
+      while(!stack.empty())
+      {
+        const AABB<DerivedV,DIM> * node = stack.back();
+        stack.pop_back();
+        if(!packet_box_intersect(R,node->m_box,mask))
+        {
+          continue;
+        }
+        if(node->is_leaf())
+        {
+          leaf(node->m_primitive,mask);
+          continue;
+        }
+        const auto c =
+          (node->m_right->m_box.center()-node->m_left->m_box.center()).eval();
+        Scalar dot = 0;
+        for(int k = 0;k<3;k++)
+        {
+          dot += c(k)*sum_d[k];
+        }
+        if(dot >= 0)
+        {
+          stack.push_back(node->m_right);
+          stack.push_back(node->m_left);
+        }else
+        {
+          stack.push_back(node->m_left);
+          stack.push_back(node->m_right);
+        }
+      }
+    }
+    // Sort rays into coherent packets and call func on each packet in
+    // parallel
+    //
+    // Inputs:
+    //   O  #R by 3 list of ray origins
+    //   D  #R by 3 list of ray directions
+    //   tmin  #R list of per-ray minimum parameters, or empty for 0
+    //   tmax  #R list of per-ray maximum parameters, or empty for infinity
+    //   func  function called as func(R) for each packet R
+    template <
+      typename Scalar,
+      typename DerivedO,
+      typename DerivedD,
+      typename Func>
+    inline void for_each_ray_packet(
+      const Eigen::PlainObjectBase<DerivedO> & O,
+      const Eigen::PlainObjectBase<DerivedD> & D,
+      const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+      const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+      const Func & func)
+    {
+      assert(O.cols() == 3 && D.cols() == 3 && "Rays should be 3D");
+      assert(O.rows() == D.rows() && "Origins and directions must match");
+      assert((tmin.size() == 0 || tmin.size() == O.rows()) && "#tmin != #R");
+      assert((tmax.size() == 0 || tmax.size() == O.rows()) && "#tmax != #R");
+      const int num_rays = O.rows();
+      // Sort by direction octant, then by Morton code of origin
+      std::vector<std::pair<uint64_t,int> > order(num_rays);
+      {
+        Eigen::Matrix<uint64_t,Eigen::Dynamic,1> K;
+        morton_codes(O,K);
+        parallel_for(num_rays,[&D,&K,&order](const int r)
+          {
+            uint64_t key = K(r);
+            for(int k = 0;k<3;k++)
+            {
+              key |= uint64_t(D(r,k) < 0) << (60+k);
+            }
+            order[r] = std::make_pair(key,r);
+          },
+          10000);
+        parallel_sort(order.begin(),order.end(),
+          [](const std::pair<uint64_t,int> & a,const std::pair<uint64_t,int> & b)
+          {
+            return a.first < b.first;
+          },
+          10000);
+      }
+      const int num_packets = (num_rays+RAY_PACKET_SIZE-1)/RAY_PACKET_SIZE;
+      parallel_for(
+        num_packets,
+        [&O,&D,&tmin,&tmax,&func,&order,num_rays](const int p)
+        {
+          RayPacket<Scalar> R;
+          for(int l = 0;l<RAY_PACKET_SIZE;l++)
+          {
+            const int i = p*RAY_PACKET_SIZE+l;
+            if(i >= num_rays)
+            {
+              // Unused lane
+              R.id[l] = -1;
+              for(int k = 0;k<3;k++)
+              {
+                R.o[k][l] = 0;
+                R.d[k][l] = 1;
+                R.inv_d[k][l] = 1;
+              }
+              R.tmin[l] = 1;
+              R.tmax[l] = 0;
+              continue;
+            }
+            const int r = order[i].second;
+            R.id[l] = r;
+            for(int k = 0;k<3;k++)
+            {
+              R.o[k][l] = O(r,k);
+              R.d[k][l] = D(r,k);
+              R.inv_d[k][l] = Scalar(1)/R.d[k][l];
+            }
+            R.tmin[l] = tmin.size() ? tmin(r) : Scalar(0);
+            R.tmax[l] =
+              tmax.size() ? tmax(r) : std::numeric_limits<Scalar>::infinity();
+            R.rays.set(l,WatertightRay<Scalar>(O.row(r),D.row(r)));
+          }
+          func(R);
+        },
+        16);
+    }
+  }
+}
+
 template <typename DerivedV, int DIM>
   template <typename Derivedbb_mins, typename Derivedbb_maxs>
 IGL_INLINE void igl::AABB<DerivedV,DIM>::init(
@@ -94,11 +679,52 @@ void igl::AABB<DerivedV,DIM>::init(
     const Eigen::PlainObjectBase<DerivedV> & V,
     const Eigen::MatrixXi & Ele)
 {
+  IGL_PROFILE_SCOPE("AABB::init");
   using namespace Eigen;
   // deinit will be immediately called...
   return init(V,Ele,MatrixXDIMS(),MatrixXDIMS(),VectorXi(),0);
 }
 
+template <typename DerivedV, int DIM>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::init(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele,
+    const AABBSplitType split_type)
+{
+  switch(split_type)
+  {
+    default:
+      assert(false && "Unknown split type");
+    case AABB_SPLIT_TYPE_MEDIAN:
+      return init(V,Ele);
+    case AABB_SPLIT_TYPE_SAH:
+    {
+      IGL_PROFILE_SCOPE("AABB::init");
+      deinit();
+      if(V.size() == 0 || Ele.size() == 0)
+      {
+        return;
+      }
+      MatrixXDIMS BC;
+      if(Ele.cols() == 1)
+      {
+        // points
+        BC = V;
+      }else
+      {
+        // Simplices
+        barycenter(V,Ele,BC);
+      }
+      std::vector<int> I(Ele.rows());
+      for(int e = 0;e<Ele.rows();e++)
+      {
+        I[e] = e;
+      }
+      return init_sah(V,Ele,BC,I.data(),Ele.rows());
+    }
+  }
+}
+
   template <typename DerivedV, int DIM>
 IGL_INLINE void igl::AABB<DerivedV,DIM>::init(
     const Eigen::PlainObjectBase<DerivedV> & V,
@@ -115,15 +741,10 @@ IGL_INLINE void igl::AABB<DerivedV,DIM>::init(
   }
   assert(DIM == V.cols() && "V.cols() should matched declared dimension");
   //const Scalar inf = numeric_limits<Scalar>::infinity();
-  m_box = AlignedBox<Scalar,DIM>();
   // Compute bounding box
-  for(int i = 0;i<I.rows();i++)
   {
-    for(int c = 0;c<Ele.cols();c++)
-    {
-      m_box.extend(V.row(Ele(I(i),c)).transpose());
-      m_box.extend(V.row(Ele(I(i),c)).transpose());
-    }
+    AlignedBox<Scalar,DIM> _;
+    aabb::bounding_boxes(V,Ele,MatrixXDIMS(),I.data(),I.rows(),m_box,_);
   }
   switch(I.size())
   {
@@ -182,28 +803,235 @@ IGL_INLINE void igl::AABB<DerivedV,DIM>::init(
           }
         }
         //m_depth = 0;
-        if(LI.rows()>0)
+        const auto build_left = [this,&V,&Ele,&SI,&LI]()
         {
-          m_left = new AABB();
-          m_left->init(V,Ele,SI,LI);
-          //m_depth = std::max(m_depth, m_left->m_depth+1);
-        }
-        if(RI.rows()>0)
+          if(LI.rows()>0)
+          {
+            m_left = new AABB();
+            m_left->init(V,Ele,SI,LI);
+            //m_depth = std::max(m_depth, m_left->m_depth+1);
+          }
+        };
+        const auto build_right = [this,&V,&Ele,&SI,&RI]()
+        {
+          if(RI.rows()>0)
+          {
+            m_right = new AABB();
+            m_right->init(V,Ele,SI,RI);
+            //m_depth = std::max(m_depth, m_right->m_depth+1);
+          }
+        };
+        // Subtrees are independent
+        if(I.rows() >= aabb::PARALLEL_BUILD_MIN_SIZE)
+        {
+          parallel_for(2,[&build_left,&build_right](const int c)
+            {
+              if(c == 0) build_left(); else build_right();
+            });
+        }else
         {
-          m_right = new AABB();
-          m_right->init(V,Ele,SI,RI);
-          //m_depth = std::max(m_depth, m_right->m_depth+1);
+          build_left();
+          build_right();
         }
       }
   }
 }
 
+  template <typename DerivedV, int DIM>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::init_sah(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele, 
+    const MatrixXDIMS & BC,
+    int * I,
+    const int n)
+{
+  using namespace Eigen;
+  deinit();
+  if(V.size() == 0 || Ele.size() == 0 || n == 0)
+  {
+    return;
+  }
+  assert(DIM == V.cols() && "V.cols() should matched declared dimension");
+  AlignedBox<Scalar,DIM> centroid_box;
+  aabb::bounding_boxes(V,Ele,BC,I,n,m_box,centroid_box);
+  if(n == 1)
+  {
+    m_primitive = I[0];
+    return;
+  }
+  const int mid = aabb::sah_partition(V,Ele,BC,centroid_box,I,n);
+  assert(mid > 0 && mid < n);
+  m_left = new AABB();
+  m_right = new AABB();
+  // Subtrees are independent and work on disjoint ranges of I
+  if(n >= aabb::PARALLEL_BUILD_MIN_SIZE)
+  {
+    parallel_for(2,[this,&V,&Ele,&BC,I,n,mid](const int c)
+      {
+        if(c == 0)
+        {
+          m_left->init_sah(V,Ele,BC,I,mid);
+        }else
+        {
+          m_right->init_sah(V,Ele,BC,I+mid,n-mid);
+        }
+      });
+  }else
+  {
+    m_left->init_sah(V,Ele,BC,I,mid);
+    m_right->init_sah(V,Ele,BC,I+mid,n-mid);
+  }
+}
+
 template <typename DerivedV, int DIM>
 IGL_INLINE bool igl::AABB<DerivedV,DIM>::is_leaf() const
 {
   return m_primitive != -1;
 }
 
+template <typename DerivedV, int DIM>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::refit(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele)
+{
+  IGL_PROFILE_SCOPE("AABB::refit");
+  // Cut the tree at a fixed depth: subtrees below the cut are refit in
+  // parallel, nodes above it serially afterwards
+  const int cut_depth = 8;
+  std::vector<AABB *> top;
+  std::vector<AABB *> subtrees;
+  std::vector<std::pair<AABB *,int> > stack(1,std::make_pair(this,0));
+  while(!stack.empty())
+  {
+    AABB * node = stack.back().first;
+    const int depth = stack.back().second;
+    stack.pop_back();
+    if(node->is_leaf() || depth == cut_depth)
+    {
+      subtrees.push_back(node);
+      continue;
+    }
+    top.push_back(node);
+    for(AABB * child : {node->m_left,node->m_right})
+    {
+      if(child)
+      {
+        stack.push_back(std::make_pair(child,depth+1));
+      }
+    }
+  }
+  parallel_for(subtrees.size(),[&subtrees,&V,&Ele](const int s)
+    {
+      aabb::refit_subtree(*subtrees[s],V,Ele);
+    });
+  // Children come after their parents in top
+  for(int t = top.size()-1;t>=0;t--)
+  {
+    AABB * node = top[t];
+    node->m_box.setEmpty();
+    if(node->m_left) node->m_box.extend(node->m_left->m_box);
+    if(node->m_right) node->m_box.extend(node->m_right->m_box);
+  }
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE typename igl::AABB<DerivedV,DIM>::Scalar
+igl::AABB<DerivedV,DIM>::sah_cost() const
+{
+  const Scalar root_area = aabb::half_area(m_box);
+  if(!(root_area > 0))
+  {
+    return 0;
+  }
+  Scalar area = 0;
+  std::vector<const AABB *> stack(1,this);
+  while(!stack.empty())
+  {
+    const AABB * node = stack.back();
+    stack.pop_back();
+    area += aabb::half_area(node->m_box);
+    for(const AABB * child : {node->m_left,node->m_right})
+    {
+      if(child)
+      {
+        stack.push_back(child);
+      }
+    }
+  }
+  return area/root_area;
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::insert(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele,
+    const int e)
+{
+  using namespace Eigen;
+  const AlignedBox<Scalar,DIM> box = aabb::element_box<DerivedV,DIM>(V,Ele,e);
+  if(!is_leaf() && m_left == NULL && m_right == NULL)
+  {
+    // empty tree
+    m_primitive = e;
+    m_box = box;
+    return;
+  }
+  AABB * node = this;
+  while(!node->is_leaf())
+  {
+    node->m_box.extend(box);
+    if(node->m_left == NULL || node->m_right == NULL)
+    {
+      // Fill missing child
+      AABB * & missing = node->m_left ? node->m_right : node->m_left;
+      missing = new AABB();
+      missing->m_primitive = e;
+      missing->m_box = box;
+      return;
+    }
+    const auto growth = [&box](const AABB * child)->Scalar
+    {
+      return
+        aabb::half_area(child->m_box.merged(box))-aabb::half_area(child->m_box);
+    };
+    node = growth(node->m_left) <= growth(node->m_right) ?
+      node->m_left : node->m_right;
+  }
+  // Split leaf into old element and new element
+  node->m_left = new AABB();
+  node->m_left->m_primitive = node->m_primitive;
+  node->m_left->m_box = node->m_box;
+  node->m_right = new AABB();
+  node->m_right->m_primitive = e;
+  node->m_right->m_box = box;
+  node->m_primitive = -1;
+  node->m_box.extend(box);
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE bool igl::AABB<DerivedV,DIM>::remove(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele,
+    const int e)
+{
+  if(is_leaf())
+  {
+    if(m_primitive != e)
+    {
+      return false;
+    }
+    deinit();
+    return true;
+  }
+  // If the tree is up to date, the element's leaf lies below boxes
+  // containing its box. Otherwise fall back to searching everywhere.
+  const Eigen::AlignedBox<Scalar,DIM> box =
+    aabb::element_box<DerivedV,DIM>(V,Ele,e);
+  return
+    aabb::remove_element(*this,e,&box) ||
+    aabb::remove_element<DerivedV,DIM>(*this,e,NULL);
+}
+
 template <typename DerivedV, int DIM>
 template <typename Derivedq>
 IGL_INLINE std::vector<int> igl::AABB<DerivedV,DIM>::find(
@@ -369,10 +1197,24 @@ igl::AABB<DerivedV,DIM>::squared_distance(
   Scalar min_sqr_d,
   int & i,
   RowVectorDIMS & c) const
+{
+  return squared_distance(V,Ele,p,Scalar(0),min_sqr_d,i,c);
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE typename igl::AABB<DerivedV,DIM>::Scalar 
+igl::AABB<DerivedV,DIM>::squared_distance(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele, 
+  const RowVectorDIMS & p,
+  const Scalar low_sqr_d,
+  const Scalar up_sqr_d,
+  int & i,
+  RowVectorDIMS & c) const
 {
   using namespace Eigen;
   using namespace std;
-  Scalar sqr_d = min_sqr_d;
+  Scalar sqr_d = up_sqr_d;
   //assert(DIM == 3 && "Code has only been tested for DIM == 3");
   assert((Ele.cols() == 3 || Ele.cols() == 2 || Ele.cols() == 1)
     && "Code has only been tested for simplex sizes 3,2,1");
@@ -385,22 +1227,32 @@ igl::AABB<DerivedV,DIM>::squared_distance(
   {
     bool looked_left = false;
     bool looked_right = false;
+    // Looking is pointless once something within the lower bound is found
     const auto & look_left = [&]()
     {
+      looked_left = true;
+      if(sqr_d < low_sqr_d)
+      {
+        return;
+      }
       int i_left;
       RowVectorDIMS c_left = c;
-      Scalar sqr_d_left = m_left->squared_distance(V,Ele,p,sqr_d,i_left,c_left);
+      Scalar sqr_d_left = 
+        m_left->squared_distance(V,Ele,p,low_sqr_d,sqr_d,i_left,c_left);
       this->set_min(p,sqr_d_left,i_left,c_left,sqr_d,i,c);
-      looked_left = true;
     };
     const auto & look_right = [&]()
     {
+      looked_right = true;
+      if(sqr_d < low_sqr_d)
+      {
+        return;
+      }
       int i_right;
       RowVectorDIMS c_right = c;
       Scalar sqr_d_right = 
-        m_right->squared_distance(V,Ele,p,sqr_d,i_right,c_right);
+        m_right->squared_distance(V,Ele,p,low_sqr_d,sqr_d,i_right,c_right);
       this->set_min(p,sqr_d_right,i_right,c_right,sqr_d,i,c);
-      looked_right = true;
     };
 
     // must look left or right if in box
@@ -769,14 +1621,15 @@ IGL_INLINE void igl::AABB<DerivedV,DIM>::set_min(
   int & i,
   RowVectorDIMS & c) const
 {
-#ifndef NDEBUG
-  //std::cout<<matlab_format(c_candidate,"c_candidate")<<std::endl;
-  const Scalar pc_norm = (p-c_candidate).squaredNorm();
-  const Scalar diff = fabs(sqr_d_candidate - pc_norm);
-  assert(diff<=1e-10 && "distance should match norm of difference");
-#endif
   if(sqr_d_candidate < sqr_d)
   {
+#ifndef NDEBUG
+    // (A candidate that is not smaller may be "nothing found" under a bound)
+    //std::cout<<matlab_format(c_candidate,"c_candidate")<<std::endl;
+    const Scalar pc_norm = (p-c_candidate).squaredNorm();
+    const Scalar diff = fabs(sqr_d_candidate - pc_norm);
+    assert(diff<=1e-10 && "distance should match norm of difference");
+#endif
     i = i_candidate;
     c = c_candidate;
     sqr_d = sqr_d_candidate;
@@ -807,15 +1660,13 @@ igl::AABB<DerivedV,DIM>::intersect_ray(
   {
     // Actually process elements
     assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
-    // Cheesecake way of hitting element
-    bool ret = ray_mesh_intersect(origin,dir,V,Ele.row(m_primitive),hits);
-    // Since we only gave ray_mesh_intersect a single face, it will have set
-    // any hits to id=0. Set these to this primitive's id
-    for(auto & hit : hits)
+    igl::Hit hit;
+    if(aabb::ray_triangle(V,Ele,origin,dir,m_primitive,t1,hit))
     {
-      hit.id = m_primitive;
+      hits.push_back(hit);
+      return true;
     }
-    return ret;
+    return false;
   }
   std::vector<igl::Hit> left_hits;
   std::vector<igl::Hit> right_hits;
@@ -917,10 +1768,7 @@ igl::AABB<DerivedV,DIM>::intersect_ray(
   {
     // Actually process elements
     assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
-    // Cheesecake way of hitting element
-    bool ret = ray_mesh_intersect(origin,dir,V,Ele.row(m_primitive),hit);
-    hit.id = m_primitive;
-    return ret;
+    return aabb::ray_triangle(V,Ele,origin,dir,m_primitive,min_t,hit);
   }
 
   // Doesn't seem like smartly choosing left before/after right makes a
@@ -951,6 +1799,214 @@ igl::AABB<DerivedV,DIM>::intersect_ray(
   return left_ret || right_ret;
 }
 
+template <typename DerivedV, int DIM>
+template <
+  typename DerivedO,
+  typename DerivedD,
+  typename DerivedI,
+  typename DerivedT,
+  typename DerivedUV>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::intersect_rays(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele, 
+  const Eigen::PlainObjectBase<DerivedO> & O,
+  const Eigen::PlainObjectBase<DerivedD> & D,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedT> & T,
+  Eigen::PlainObjectBase<DerivedUV> & UV) const
+{
+  IGL_PROFILE_SCOPE("AABB::intersect_rays");
+  assert(DIM == 3 && "Ray queries only make sense in 3D");
+  assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
+  using namespace aabb;
+  I.setConstant(O.rows(),1,-1);
+  T.setConstant(O.rows(),1,std::numeric_limits<typename DerivedT::Scalar>::infinity());
+  UV.setZero(O.rows(),2);
+  if(!is_leaf() && m_left == NULL)
+  {
+    // empty tree
+    return;
+  }
+  for_each_ray_packet(O,D,tmin,tmax,
+    [this,&V,&Ele,&I,&T,&UV](RayPacket<Scalar> & R)
+    {
+      int hit_id[RAY_PACKET_SIZE];
+      Scalar hit_u[RAY_PACKET_SIZE],hit_v[RAY_PACKET_SIZE];
+      std::fill(hit_id,hit_id+RAY_PACKET_SIZE,-1);
+      packet_traverse(*this,R,
+        [&R,&V,&Ele,&hit_id,&hit_u,&hit_v](const int e, const bool * mask)
+        {
+          bool hit[RAY_PACKET_SIZE];
+          Scalar t[RAY_PACKET_SIZE],u[RAY_PACKET_SIZE],v[RAY_PACKET_SIZE];
+          if(!packet_triangle_intersect(R,V,Ele,e,hit,t,u,v))
+          {
+            return;
+          }
+          for(int l = 0;l<RAY_PACKET_SIZE;l++)
+          {
+            if(mask[l] && hit[l])
+            {
+              R.tmax[l] = t[l];
+              hit_id[l] = e;
+              hit_u[l] = u[l];
+              hit_v[l] = v[l];
+            }
+          }
+        });
+      for(int l = 0;l<RAY_PACKET_SIZE;l++)
+      {
+        if(hit_id[l] >= 0)
+        {
+          const int r = R.id[l];
+          I(r) = hit_id[l];
+          T(r) = R.tmax[l];
+          UV(r,0) = hit_u[l];
+          UV(r,1) = hit_v[l];
+        }
+      }
+    });
+}
+
+template <typename DerivedV, int DIM>
+template <
+  typename DerivedO,
+  typename DerivedD,
+  typename DerivedH>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::intersect_rays_any(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele, 
+  const Eigen::PlainObjectBase<DerivedO> & O,
+  const Eigen::PlainObjectBase<DerivedD> & D,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+  Eigen::PlainObjectBase<DerivedH> & H) const
+{
+  IGL_PROFILE_SCOPE("AABB::intersect_rays_any");
+  assert(DIM == 3 && "Ray queries only make sense in 3D");
+  assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
+  using namespace aabb;
+  H.setZero(O.rows(),1);
+  if(!is_leaf() && m_left == NULL)
+  {
+    // empty tree
+    return;
+  }
+  for_each_ray_packet(O,D,tmin,tmax,
+    [this,&V,&Ele,&H](RayPacket<Scalar> & R)
+    {
+      packet_traverse(*this,R,
+        [&R,&V,&Ele,&H](const int e, const bool * mask)
+        {
+          bool hit[RAY_PACKET_SIZE];
+          Scalar t[RAY_PACKET_SIZE],u[RAY_PACKET_SIZE],v[RAY_PACKET_SIZE];
+          if(!packet_triangle_intersect(R,V,Ele,e,hit,t,u,v))
+          {
+            return;
+          }
+          for(int l = 0;l<RAY_PACKET_SIZE;l++)
+          {
+            if(mask[l] && hit[l])
+            {
+              H(R.id[l]) = 1;
+              // Retire lane: empty interval misses every box
+              R.tmax[l] = -std::numeric_limits<Scalar>::infinity();
+            }
+          }
+        });
+    });
+}
+
+template <typename DerivedV, int DIM>
+template <
+  typename DerivedO,
+  typename DerivedD,
+  typename DerivedC,
+  typename DerivedI,
+  typename DerivedT,
+  typename DerivedUV>
+IGL_INLINE void igl::AABB<DerivedV,DIM>::intersect_rays_all(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele, 
+  const Eigen::PlainObjectBase<DerivedO> & O,
+  const Eigen::PlainObjectBase<DerivedD> & D,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedT> & T,
+  Eigen::PlainObjectBase<DerivedUV> & UV) const
+{
+  IGL_PROFILE_SCOPE("AABB::intersect_rays_all");
+  assert(DIM == 3 && "Ray queries only make sense in 3D");
+  assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
+  using namespace aabb;
+  struct RayHit
+  {
+    Scalar t;
+    int id;
+    Scalar u,v;
+  };
+  // Hits of each ray, gathered into flat arrays afterwards
+  std::vector<std::vector<RayHit> > hits(O.rows());
+  if(is_leaf() || m_left != NULL)
+  {
+    for_each_ray_packet(O,D,tmin,tmax,
+      [this,&V,&Ele,&hits](RayPacket<Scalar> & R)
+      {
+        packet_traverse(*this,R,
+          [&R,&V,&Ele,&hits](const int e, const bool * mask)
+          {
+            bool hit[RAY_PACKET_SIZE];
+            Scalar t[RAY_PACKET_SIZE],u[RAY_PACKET_SIZE],v[RAY_PACKET_SIZE];
+            if(!packet_triangle_intersect(R,V,Ele,e,hit,t,u,v))
+            {
+              return;
+            }
+            for(int l = 0;l<RAY_PACKET_SIZE;l++)
+            {
+              if(mask[l] && hit[l])
+              {
+                hits[R.id[l]].push_back({t[l],e,u[l],v[l]});
+              }
+            }
+          });
+        for(int l = 0;l<RAY_PACKET_SIZE;l++)
+        {
+          if(R.id[l] >= 0)
+          {
+            std::vector<RayHit> & H = hits[R.id[l]];
+            std::sort(H.begin(),H.end(),
+              [](const RayHit & a, const RayHit & b){ return a.t < b.t; });
+          }
+        }
+      });
+  }
+  C.resize(O.rows()+1,1);
+  C(0) = 0;
+  for(int r = 0;r<O.rows();r++)
+  {
+    C(r+1) = C(r) + hits[r].size();
+  }
+  const int num_hits = C(O.rows());
+  I.resize(num_hits,1);
+  T.resize(num_hits,1);
+  UV.resize(num_hits,2);
+  parallel_for(O.rows(),[&hits,&C,&I,&T,&UV](const int r)
+    {
+      for(int h = 0;h<(int)hits[r].size();h++)
+      {
+        const int c = C(r)+h;
+        I(c) = hits[r][h].id;
+        T(c) = hits[r][h].t;
+        UV(c,0) = hits[r][h].u;
+        UV(c,1) = hits[r][h].v;
+      }
+    },
+    10000);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
 // generated by autoexplicit.sh
@@ -962,6 +2018,8 @@ template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::squared_di
 // generated by autoexplicit.sh
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::init(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&);
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::init(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&);
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::init(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, igl::AABBSplitType);
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::init(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, igl::AABBSplitType);
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::squared_distance<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::squared_distance<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
 template double igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::squared_distance(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::Matrix<double, 1, 3, 1, 1, 3> const&, int&, Eigen::Matrix<double, 1, 3, 1, 1, 3>&) const;
@@ -974,4 +2032,17 @@ template std::vector<int, std::allocator<int> > igl::AABB<Eigen::Matrix<double,
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::serialize<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&, int) const;
 template std::vector<int, std::allocator<int> > igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::find<Eigen::Matrix<double, 1, -1, 1, 1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, 1, -1, 1, 1, -1> > const&, bool) const;
 template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::serialize<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&, int) const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::intersect_rays<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::intersect_rays_any<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&) const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::intersect_rays_all<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::refit(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&);
+template double igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::sah_cost() const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::insert(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, int);
+template bool igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::remove(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, int);
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::refit(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&);
+template double igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::sah_cost() const;
+template void igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::insert(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, int);
+template bool igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>::remove(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, int);
+template bool igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::intersect_ray(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::Matrix<double, 1, 3, 1, 1, 3> const&, Eigen::Matrix<double, 1, 3, 1, 1, 3> const&, std::vector<igl::Hit, std::allocator<igl::Hit> >&) const;
+template bool igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>::intersect_ray(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::Matrix<double, 1, 3, 1, 1, 3> const&, Eigen::Matrix<double, 1, 3, 1, 1, 3> const&, igl::Hit&) const;
 #endif
@@ -15,6 +15,17 @@
 #include <vector>
 namespace igl
 {
+  enum AABBSplitType
+  {
+    // Split at the median of the barycenters along the longest axis of the
+    // box: balanced tree, fastest to build
+    AABB_SPLIT_TYPE_MEDIAN = 0,
+    // Split minimizing the binned surface area heuristic: slower to build but
+    // tighter trees for meshes with uneven element sizes or density (fewer
+    // boxes visited per ray or distance query)
+    AABB_SPLIT_TYPE_SAH = 1,
+    NUM_AABB_SPLIT_TYPES = 2
+  };
   // Implementation of semi-general purpose axis-aligned bounding box hierarchy.
   // The mesh (V,Ele) is stored and managed by the caller and each routine here
   // simply takes it as references (it better not change between calls).
@@ -117,6 +128,19 @@ public:
       IGL_INLINE void init(
           const Eigen::PlainObjectBase<DerivedV> & V,
           const Eigen::MatrixXi & Ele);
+      // Build an Axis-Aligned Bounding Box tree for a given mesh using a given
+      // split heuristic. Large subtrees are built in parallel (see
+      // igl::parallel_for); the resulting tree does not depend on the number
+      // of threads.
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions. 
+      //   Ele  #Ele by dim+1 list of mesh indices into #V. 
+      //   split_type  heuristic used to split elements between children
+      IGL_INLINE void init(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele,
+          const AABBSplitType split_type);
       // Build an Axis-Aligned Bounding Box tree for a given mesh.
       //
       // Inputs:
@@ -134,6 +158,67 @@ public:
           const Eigen::MatrixXi & Ele, 
           const Eigen::MatrixXi & SI,
           const Eigen::VectorXi & I);
+      // Build an Axis-Aligned Bounding Box tree for a given mesh by recursively
+      // splitting according to the binned surface area heuristic.
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions. 
+      //   Ele  #Ele by dim+1 list of mesh indices into #V. 
+      //   BC  #Ele by dim list of element barycenters
+      //   I  pointer to n indices into Ele of elements to include (reordered
+      //     on output)
+      //   n  number of elements to include
+      IGL_INLINE void init_sah(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele, 
+          const MatrixXDIMS & BC,
+          int * I,
+          const int n);
+      // Recompute all boxes bottom-up for new vertex positions, keeping the
+      // tree structure (Ele must be unchanged). Independent subtrees are
+      // refit in parallel. Much cheaper than init, but boxes of a strongly
+      // deformed mesh overlap more and more: compare sah_cost() with its
+      // value after init to decide when to rebuild.
+      //
+      // Inputs:
+      //   V  #V by dim list of new mesh vertex positions
+      //   Ele  #Ele by dim+1 list of mesh indices into #V (same as for init)
+      IGL_INLINE void refit(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele);
+      // Surface area heuristic cost of the tree: sum over all nodes of the
+      // surface area of their box (perimeter in 2D) divided by the surface
+      // area of the root's box. This is proportional to the expected number
+      // of boxes visited by a random ray. A refit or edited tree is worth
+      // rebuilding once its cost exceeds the cost right after init by a
+      // factor of roughly 1.5 to 2.
+      //
+      // Returns cost (0 for empty or flat trees)
+      IGL_INLINE Scalar sah_cost() const;
+      // Insert an element into the tree, descending into the child whose
+      // surface area increases least and splitting the leaf reached.
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions
+      //   Ele  #Ele by dim+1 list of mesh indices into #V
+      //   e  index into Ele of element to insert (not yet in the tree)
+      IGL_INLINE void insert(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele,
+          const int e);
+      // Remove an element from the tree, replacing its parent by its sibling.
+      // Other element indices are left untouched, so rows of Ele should not
+      // be renumbered without rebuilding.
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions
+      //   Ele  #Ele by dim+1 list of mesh indices into #V
+      //   e  index into Ele of element to remove
+      // Returns true iff e was found (and removed)
+      IGL_INLINE bool remove(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele,
+          const int e);
       // Return whether at leaf node
       IGL_INLINE bool is_leaf() const;
       // Find the indices of elements containing given point: this makes sense
@@ -215,6 +300,29 @@ public:
         const Scalar min_sqr_d,
         int & i,
         RowVectorDIMS & c) const;
+      // Compute squared distance to a query point, if within a given range
+      //
+      // Inputs:
+      //   V  #V by dim list of vertex positions
+      //   Ele  #Ele by dim list of simplex indices
+      //   p  dim-long query point 
+      //   low_sqr_d  lower bound: stop searching as soon as a primitive at
+      //     squared distance less than this is found (so the result is only
+      //     the smallest if it is at least low_sqr_d)
+      //   up_sqr_d  upper bound: only consider distances less than this
+      // Outputs:
+      //   i  facet index corresponding to smallest distances (unchanged if
+      //     nothing closer than up_sqr_d)
+      //   c  closest point (unchanged if nothing closer than up_sqr_d)
+      // Returns squared distance (up_sqr_d if nothing is closer)
+      IGL_INLINE Scalar squared_distance(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele, 
+        const RowVectorDIMS & p,
+        const Scalar low_sqr_d,
+        const Scalar up_sqr_d,
+        int & i,
+        RowVectorDIMS & c) const;
       // All hits
       IGL_INLINE bool intersect_ray(
         const Eigen::PlainObjectBase<DerivedV> & V,
@@ -237,6 +345,82 @@ public:
         const RowVectorDIMS & dir,
         const Scalar min_t,
         igl::Hit & hit) const;
+      // Intersect many rays with the triangles of the mesh at once (DIM==3).
+      // Rays are sorted by direction octant and origin so that coherent rays
+      // are grouped into packets of 8 which traverse the tree together: each
+      // box is tested against all lanes of a packet in turn, each triangle
+      // against all lanes at once (see igl::PackedRays).
+      // Packets are processed in parallel. Only hits with t in the open
+      // interval (tmin,tmax) are reported.
+      //
+      // Inputs:
+      //   V  #V by 3 list of vertex positions
+      //   Ele  #Ele by 3 list of triangle indices
+      //   O  #R by 3 list of ray origins
+      //   D  #R by 3 list of ray directions
+      //   tmin  #R list of per-ray minimum parameters, or empty for 0
+      //   tmax  #R list of per-ray maximum parameters, or empty for infinity
+      // Outputs:
+      //   I  #R list of indices into Ele of first hits (-1 if none)
+      //   T  #R list of parameters of first hits (infinity if none)
+      //   UV  #R by 2 list of barycentric coordinates of first hits
+      template <
+        typename DerivedO,
+        typename DerivedD,
+        typename DerivedI,
+        typename DerivedT,
+        typename DerivedUV>
+      IGL_INLINE void intersect_rays(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele, 
+        const Eigen::PlainObjectBase<DerivedO> & O,
+        const Eigen::PlainObjectBase<DerivedD> & D,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+        Eigen::PlainObjectBase<DerivedI> & I,
+        Eigen::PlainObjectBase<DerivedT> & T,
+        Eigen::PlainObjectBase<DerivedUV> & UV) const;
+      // Any hit (occlusion) variant: stops at the first hit found per ray
+      //
+      // Outputs:
+      //   H  #R list of whether each ray hits any triangle
+      template <
+        typename DerivedO,
+        typename DerivedD,
+        typename DerivedH>
+      IGL_INLINE void intersect_rays_any(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele, 
+        const Eigen::PlainObjectBase<DerivedO> & O,
+        const Eigen::PlainObjectBase<DerivedD> & D,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+        Eigen::PlainObjectBase<DerivedH> & H) const;
+      // All hits variant
+      //
+      // Outputs:
+      //   C  #R+1 list of offsets: hits of ray r are C(r),...,C(r+1)-1
+      //   I  #hits list of indices into Ele, sorted by T per ray
+      //   T  #hits list of ray parameters
+      //   UV  #hits by 2 list of barycentric coordinates
+      template <
+        typename DerivedO,
+        typename DerivedD,
+        typename DerivedC,
+        typename DerivedI,
+        typename DerivedT,
+        typename DerivedUV>
+      IGL_INLINE void intersect_rays_all(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele, 
+        const Eigen::PlainObjectBase<DerivedO> & O,
+        const Eigen::PlainObjectBase<DerivedD> & D,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmin,
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & tmax,
+        Eigen::PlainObjectBase<DerivedC> & C,
+        Eigen::PlainObjectBase<DerivedI> & I,
+        Eigen::PlainObjectBase<DerivedT> & T,
+        Eigen::PlainObjectBase<DerivedUV> & UV) const;
 
 
 public:
@@ -0,0 +1,431 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "FastWindingNumber.h"
+#include "PI.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace igl
+{
+  namespace fwn
+  {
+    // Index of (j,k) into symmetric storage 00,01,02,11,12,22
+    inline int sym(const int j, const int k)
+    {
+      static const int S[3][3] = {{0,1,2},{1,3,4},{2,4,5}};
+      return S[j][k];
+    }
+    // Add expansion of a child (or primitive) about its center c to the
+    // expansion E about E.center
+    inline void shift_add(
+      const double * c,
+      const double * t0,
+      const double (*t1)[3],
+      const double (*t2)[3],
+      FastWindingNumber::Expansion & E)
+    {
+      double d[3];
+      for(int j = 0;j<3;j++)
+      {
+        d[j] = c[j]-E.center[j];
+      }
+      for(int i = 0;i<3;i++)
+      {
+        E.t0[i] += t0[i];
+        for(int j = 0;j<3;j++)
+        {
+          E.t1[j][i] += d[j]*t0[i] + (t1 ? t1[j][i] : 0.);
+          for(int k = j;k<3;k++)
+          {
+            double t = 0.5*d[j]*d[k]*t0[i];
+            if(t1)
+            {
+              t += 0.5*(d[j]*t1[k][i] + d[k]*t1[j][i]);
+            }
+            E.t2[sym(j,k)][i] += t + t2[sym(j,k)][i];
+          }
+        }
+      }
+    }
+    // Evaluate expansion E at a query point, given r = E.center - q
+    inline double evaluate(
+      const FastWindingNumber::Expansion & E,
+      const double * r,
+      const int order)
+    {
+      const double r2 = r[0]*r[0]+r[1]*r[1]+r[2]*r[2];
+      const double ir = 1./std::sqrt(r2);
+      const double ir2 = ir*ir;
+      const double ir3 = ir2*ir;
+      double w = ir3*(r[0]*E.t0[0]+r[1]*E.t0[1]+r[2]*E.t0[2]);
+      if(order >= 1)
+      {
+        // ∑_ij ∂_j (r_i/|r|³) t1[j][i]
+        double tr = 0;
+        double rt1r = 0;
+        for(int i = 0;i<3;i++)
+        {
+          tr += E.t1[i][i];
+          for(int j = 0;j<3;j++)
+          {
+            rt1r += r[j]*E.t1[j][i]*r[i];
+          }
+        }
+        const double ir5 = ir3*ir2;
+        w += ir3*tr - 3.*ir5*rt1r;
+        if(order >= 2)
+        {
+          // ∑_ijk ∂_j ∂_k (r_i/|r|³) t2[jk][i]
+          double a = 0;
+          double b = 0;
+          double c = 0;
+          for(int i = 0;i<3;i++)
+          {
+            for(int j = 0;j<3;j++)
+            {
+              a += r[j]*E.t2[sym(i,j)][i];
+              b += r[i]*E.t2[sym(j,j)][i];
+              for(int k = 0;k<3;k++)
+              {
+                c += r[i]*r[j]*r[k]*E.t2[sym(j,k)][i];
+              }
+            }
+          }
+          const double ir7 = ir5*ir2;
+          w += -3.*ir5*(2.*a+b) + 15.*ir7*c;
+        }
+      }
+      return w/(4.*igl::PI);
+    }
+    // Exact winding number of triangle with corners T[0..2],T[3..5],T[6..8]
+    // at q, see igl::winding_number_3
+    inline double triangle(const double * T, const double * q)
+    {
+      double v[3][3];
+      double vl[3];
+      for(int t = 0;t<3;t++)
+      {
+        vl[t] = 0;
+        for(int d = 0;d<3;d++)
+        {
+          v[t][d] = T[3*t+d]-q[d];
+          vl[t] += v[t][d]*v[t][d];
+        }
+        vl[t] = std::sqrt(vl[t]);
+      }
+      const double detf =
+        v[0][0]*(v[1][1]*v[2][2]-v[1][2]*v[2][1])+
+        v[0][1]*(v[1][2]*v[2][0]-v[1][0]*v[2][2])+
+        v[0][2]*(v[1][0]*v[2][1]-v[1][1]*v[2][0]);
+      const double dp0 = v[1][0]*v[2][0]+v[1][1]*v[2][1]+v[1][2]*v[2][2];
+      const double dp1 = v[2][0]*v[0][0]+v[2][1]*v[0][1]+v[2][2]*v[0][2];
+      const double dp2 = v[0][0]*v[1][0]+v[0][1]*v[1][1]+v[0][2]*v[1][2];
+      return atan2(detf,
+        vl[0]*vl[1]*vl[2] + dp0*vl[0] + dp1*vl[1] + dp2*vl[2])/(2.*igl::PI);
+    }
+    // Winding number of point dipole at X[0..2] with area-weighted normal
+    // X[3..5] at q
+    inline double point(const double * X, const double * q)
+    {
+      const double d[3] = {X[0]-q[0],X[1]-q[1],X[2]-q[2]};
+      const double d2 = d[0]*d[0]+d[1]*d[1]+d[2]*d[2];
+      if(d2 == 0)
+      {
+        return 0;
+      }
+      return (d[0]*X[3]+d[1]*X[4]+d[2]*X[5])/(4.*igl::PI*d2*std::sqrt(d2));
+    }
+  }
+}
+
+IGL_INLINE void igl::FastWindingNumber::deinit()
+{
+  m_tree.deinit();
+  m_expansions.clear();
+  m_primitives.resize(0,0);
+}
+
+IGL_INLINE bool igl::FastWindingNumber::empty() const
+{
+  return m_tree.empty();
+}
+
+IGL_INLINE void igl::FastWindingNumber::init(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const int order,
+  const int leaf_size)
+{
+  assert(V.cols() == 3 && "V should be 3D");
+  assert((F.size() == 0 || F.cols() == 3) && "F should be triangles");
+  deinit();
+  m_order = order;
+  m_tree.init(V,F,leaf_size);
+  if(m_tree.empty())
+  {
+    return;
+  }
+  const int m = F.rows();
+  Eigen::MatrixXd PT(m,3),PN(m,3),PC(m,6);
+  Eigen::VectorXd PA(m),PR(m);
+  parallel_for(m,[&V,&F,&PT,&PN,&PC,&PA,&PR](const int f)
+  {
+    const Eigen::RowVector3d a = V.row(F(f,0));
+    const Eigen::RowVector3d b = V.row(F(f,1));
+    const Eigen::RowVector3d c = V.row(F(f,2));
+    const Eigen::RowVector3d g = (a+b+c)/3.;
+    PT.row(f) = g;
+    PN.row(f) = 0.5*(b-a).cross(c-a);
+    PA(f) = PN.row(f).norm();
+    // Second moment of uniform triangle about its centroid per unit area
+    const Eigen::RowVector3d corners[3] = {a-g,b-g,c-g};
+    PR(f) = 0;
+    PC.row(f).setZero();
+    for(int t = 0;t<3;t++)
+    {
+      const Eigen::RowVector3d & e = corners[t];
+      PR(f) = std::max(PR(f),e.norm());
+      for(int j = 0;j<3;j++)
+      {
+        for(int k = j;k<3;k++)
+        {
+          PC(f,fwn::sym(j,k)) += e(j)*e(k)/12.;
+        }
+      }
+    }
+  },1000);
+  m_primitives.resize(m,9);
+  const std::vector<int> & prims = m_tree.m_primitives;
+  parallel_for(m,[this,&V,&F,&prims](const int k)
+  {
+    const int f = prims[k];
+    for(int t = 0;t<3;t++)
+    {
+      m_primitives.block(k,3*t,1,3) = V.row(F(f,t));
+    }
+  },1000);
+  precompute(PT,PA,PN,PC,PR);
+}
+
+IGL_INLINE void igl::FastWindingNumber::init(
+  const Eigen::MatrixXd & P,
+  const Eigen::MatrixXd & N,
+  const Eigen::VectorXd & A,
+  const int order,
+  const int leaf_size)
+{
+  assert(P.cols() == 3 && "P should be 3D");
+  assert(N.rows() == P.rows() && N.cols() == 3 && "N should match P");
+  assert(A.size() == P.rows() && "A should match P");
+  deinit();
+  m_order = order;
+  const int m = P.rows();
+  Eigen::MatrixXi E(m,1);
+  for(int p = 0;p<m;p++)
+  {
+    E(p) = p;
+  }
+  m_tree.init(P,E,leaf_size);
+  if(m_tree.empty())
+  {
+    return;
+  }
+  const Eigen::MatrixXd PN = N.array().colwise()*A.array();
+  m_primitives.resize(m,6);
+  const std::vector<int> & prims = m_tree.m_primitives;
+  parallel_for(m,[this,&P,&PN,&prims](const int k)
+  {
+    const int p = prims[k];
+    m_primitives.block(k,0,1,3) = P.row(p);
+    m_primitives.block(k,3,1,3) = PN.row(p);
+  },1000);
+  precompute(P,A,PN,Eigen::MatrixXd::Zero(m,6),Eigen::VectorXd::Zero(m));
+}
+
+IGL_INLINE void igl::FastWindingNumber::precompute(
+  const Eigen::MatrixXd & PT,
+  const Eigen::VectorXd & PA,
+  const Eigen::MatrixXd & PN,
+  const Eigen::MatrixXd & PC,
+  const Eigen::VectorXd & PR)
+{
+  typedef FlatAABB<Eigen::MatrixXd,3>::Node Node;
+  const std::vector<Node> & nodes = m_tree.m_nodes;
+  const std::vector<int> & prims = m_tree.m_primitives;
+  const int num_nodes = nodes.size();
+  m_expansions.resize(num_nodes);
+  // Total area of each node's primitives
+  std::vector<double> area(num_nodes,0.);
+  // Center (area-weighted centroid, or box center if there is no area) and
+  // radius: the smaller of the distance to the farthest box corner and the
+  // bound from the children
+  const auto & set_center = [&nodes,this](
+    const int n, const double a, const double * ag)
+  {
+    const Node & node = nodes[n];
+    Expansion & E = m_expansions[n];
+    double corner = 0;
+    for(int d = 0;d<3;d++)
+    {
+      E.center[d] = a > 0 ? ag[d]/a : 0.5*(node.min[d]+node.max[d]);
+      const double e = std::max(E.center[d]-node.min[d],node.max[d]-E.center[d]);
+      corner += e*e;
+    }
+    E.radius = std::sqrt(corner);
+    std::fill(E.t0,E.t0+3,0.);
+    std::fill(&E.t1[0][0],&E.t1[0][0]+9,0.);
+    std::fill(&E.t2[0][0],&E.t2[0][0]+18,0.);
+  };
+  const auto & distance = [](const double * a, const double * b)->double
+  {
+    return std::sqrt(
+      (a[0]-b[0])*(a[0]-b[0])+(a[1]-b[1])*(a[1]-b[1])+(a[2]-b[2])*(a[2]-b[2]));
+  };
+  // Leaves directly from their primitives, in parallel
+  parallel_for(num_nodes,
+    [&nodes,&prims,&area,&set_center,&distance,&PT,&PA,&PN,&PC,&PR,this](
+      const int n)
+  {
+    const Node & node = nodes[n];
+    if(!node.is_leaf())
+    {
+      return;
+    }
+    double a = 0;
+    double ag[3] = {0,0,0};
+    for(int k = node.offset;k<node.offset+node.count;k++)
+    {
+      const int p = prims[k];
+      a += PA(p);
+      for(int d = 0;d<3;d++)
+      {
+        ag[d] += PA(p)*PT(p,d);
+      }
+    }
+    area[n] = a;
+    set_center(n,a,ag);
+    Expansion & E = m_expansions[n];
+    double radius = 0;
+    for(int k = node.offset;k<node.offset+node.count;k++)
+    {
+      const int p = prims[k];
+      const double c[3] = {PT(p,0),PT(p,1),PT(p,2)};
+      const double t0[3] = {PN(p,0),PN(p,1),PN(p,2)};
+      double t2[6][3];
+      for(int jk = 0;jk<6;jk++)
+      {
+        for(int i = 0;i<3;i++)
+        {
+          t2[jk][i] = 0.5*PC(p,jk)*t0[i];
+        }
+      }
+      fwn::shift_add(c,t0,NULL,t2,E);
+      radius = std::max(radius,distance(c,E.center)+PR(p));
+    }
+    E.radius = std::min(E.radius,radius);
+  },1000);
+  // Internal nodes from their children: children come after their parent
+  for(int n = num_nodes-1;n>=0;n--)
+  {
+    const Node & node = nodes[n];
+    if(node.is_leaf())
+    {
+      continue;
+    }
+    const int children[2] = {n+1,node.offset};
+    double a = 0;
+    double ag[3] = {0,0,0};
+    for(const int c : children)
+    {
+      a += area[c];
+      for(int d = 0;d<3;d++)
+      {
+        ag[d] += area[c]*m_expansions[c].center[d];
+      }
+    }
+    area[n] = a;
+    set_center(n,a,ag);
+    Expansion & E = m_expansions[n];
+    double radius = 0;
+    for(const int c : children)
+    {
+      const Expansion & C = m_expansions[c];
+      fwn::shift_add(C.center,C.t0,C.t1,C.t2,E);
+      radius = std::max(radius,distance(C.center,E.center)+C.radius);
+    }
+    E.radius = std::min(E.radius,radius);
+  }
+}
+
+IGL_INLINE double igl::FastWindingNumber::winding_number(
+  const Eigen::RowVector3d & q,
+  const double beta) const
+{
+  if(empty())
+  {
+    return 0;
+  }
+  const std::vector<FlatAABB<Eigen::MatrixXd,3>::Node> & nodes =
+    m_tree.m_nodes;
+  const bool points = m_primitives.cols() == 6;
+  const double beta2 = beta*beta;
+  // Depth-first traversal keeps at most depth+1 nodes on the stack
+  int stack_buffer[64];
+  std::vector<int> stack_heap;
+  int * stack = stack_buffer;
+  if(m_tree.m_depth+2 > 64)
+  {
+    stack_heap.resize(m_tree.m_depth+2);
+    stack = stack_heap.data();
+  }
+  int top = 0;
+  stack[top++] = 0;
+  double w = 0;
+  while(top > 0)
+  {
+    const int n = stack[--top];
+    const Expansion & E = m_expansions[n];
+    const double r[3] = {E.center[0]-q(0),E.center[1]-q(1),E.center[2]-q(2)};
+    const double r2 = r[0]*r[0]+r[1]*r[1]+r[2]*r[2];
+    if(r2 > beta2*E.radius*E.radius)
+    {
+      w += fwn::evaluate(E,r,m_order);
+      continue;
+    }
+    const FlatAABB<Eigen::MatrixXd,3>::Node & node = nodes[n];
+    if(node.is_leaf())
+    {
+      for(int k = node.offset;k<node.offset+node.count;k++)
+      {
+        const double * X = m_primitives.data()+k*m_primitives.cols();
+        w += points ?
+          fwn::point(X,q.data()) :
+          fwn::triangle(X,q.data());
+      }
+      continue;
+    }
+    stack[top++] = node.offset;
+    stack[top++] = n+1;
+  }
+  return w;
+}
+
+IGL_INLINE void igl::FastWindingNumber::winding_number(
+  const Eigen::MatrixXd & Q,
+  const double beta,
+  Eigen::VectorXd & W) const
+{
+  assert((Q.rows() == 0 || Q.cols() == 3) && "Q should be 3D");
+  W.resize(Q.rows());
+  parallel_for(Q.rows(),[this,&Q,beta,&W](const int q)
+  {
+    W(q) = winding_number(Eigen::RowVector3d(Q.row(q)),beta);
+  },100);
+}
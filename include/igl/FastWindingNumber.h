@@ -0,0 +1,143 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FASTWINDINGNUMBER_H
+#define IGL_FASTWINDINGNUMBER_H
+
+#include "FlatAABB.h"
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <vector>
+namespace igl
+{
+  // Approximate generalized winding numbers of triangle soups or oriented
+  // point clouds by treating far away clusters of primitives as a single
+  // dipole source ("Fast Winding Numbers for Soups and Clouds" [Barill et al.
+  // 2018]).
+  //
+  // Each node of a bounding volume hierarchy stores the Taylor expansion (up
+  // to second order) of the winding number contributions of its primitives
+  // about the node's area-weighted center. A query uses a node's expansion if
+  // it is farther than beta times the node's radius from its center and
+  // otherwise descends, summing exact contributions at the leaves. Larger
+  // beta is more accurate and slower.
+  //
+  // Unlike igl::AABB the structure keeps its own copy of the primitives
+  // (stored in tree order), so queries only need the query points.
+  //
+  // Example:
+  //   igl::FastWindingNumber fwn;
+  //   fwn.init(V,F);
+  //   Eigen::VectorXd W;
+  //   fwn.winding_number(Q,2.0,W);
+  class FastWindingNumber
+  {
+  public:
+    // Expansion of a node about its center
+    struct Expansion
+    {
+      // Center and radius of a ball containing all primitives of the node
+      double center[3];
+      double radius;
+      // Zeroth order term: ∑ a n
+      double t0[3];
+      // First order term: t1[j][i] = ∑ ∫ (x-center)_j n_i dA
+      double t1[3][3];
+      // Second order term: ½ ∑ ∫ (x-center)_j (x-center)_k n_i dA, which is
+      // symmetric in j and k, so only j<=k are stored:
+      //   t2[jk][i] with jk indexing 00,01,02,11,12,22
+      double t2[6][3];
+    };
+    // Hierarchy over primitives
+    FlatAABB<Eigen::MatrixXd,3> m_tree;
+    // #nodes list of expansions corresponding to m_tree.m_nodes
+    std::vector<Expansion> m_expansions;
+    // #primitives by 9 list of triangle corners, or #primitives by 6 list of
+    // point positions and area-weighted normals, in the order of
+    // m_tree.m_primitives
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
+      m_primitives;
+    // Highest order of expansion used in queries (0, 1 or 2)
+    int m_order;
+    FastWindingNumber(): m_tree(), m_expansions(), m_primitives(), m_order(2)
+    {}
+    IGL_INLINE void deinit();
+    // Return whether there are no primitives
+    IGL_INLINE bool empty() const;
+    // Precompute hierarchy for a triangle soup
+    //
+    // Inputs:
+    //   V  #V by 3 list of vertex positions
+    //   F  #F by 3 list of triangle indices into V
+    //   order  highest order of expansion to use {2}
+    //   leaf_size  maximum number of triangles per leaf {8}
+    IGL_INLINE void init(
+      const Eigen::MatrixXd & V,
+      const Eigen::MatrixXi & F,
+      const int order = 2,
+      const int leaf_size = 8);
+    // Precompute hierarchy for an oriented point cloud
+    //
+    // Inputs:
+    //   P  #P by 3 list of point positions
+    //   N  #P by 3 list of unit outward normals
+    //   A  #P list of areas associated with each point (e.g., π r² where r
+    //     is the distance to the k-th nearest neighbor, see igl::KDTree)
+    //   order  highest order of expansion to use {2}
+    //   leaf_size  maximum number of points per leaf {8}
+    IGL_INLINE void init(
+      const Eigen::MatrixXd & P,
+      const Eigen::MatrixXd & N,
+      const Eigen::VectorXd & A,
+      const int order = 2,
+      const int leaf_size = 8);
+    // Approximate winding number at a single point
+    //
+    // Inputs:
+    //   q  query point
+    //   beta  accuracy parameter: use expansion of nodes whose center is
+    //     farther than beta times their radius {2}
+    // Returns winding number (1 inside, 0 outside for closed, consistently
+    //   oriented input)
+    IGL_INLINE double winding_number(
+      const Eigen::RowVector3d & q,
+      const double beta = 2.0) const;
+    // Approximate winding numbers at many points (in parallel)
+    //
+    // Inputs:
+    //   Q  #Q by 3 list of query points
+    //   beta  accuracy parameter (see above)
+    // Outputs:
+    //   W  #Q list of winding numbers
+    IGL_INLINE void winding_number(
+      const Eigen::MatrixXd & Q,
+      const double beta,
+      Eigen::VectorXd & W) const;
+  private:
+    // Compute expansions of all nodes from the moments of the primitives
+    //
+    // Inputs:
+    //   PT  #primitives by 3 list of primitive centers (in input order)
+    //   PA  #primitives list of primitive areas
+    //   PN  #primitives by 3 list of area-weighted normals
+    //   PC  #primitives by 6 list of second moments per unit area about
+    //     centers (00, 01, 02, 11, 12, 22), zero for points
+    //   PR  #primitives list of radii about centers
+    IGL_INLINE void precompute(
+      const Eigen::MatrixXd & PT,
+      const Eigen::VectorXd & PA,
+      const Eigen::MatrixXd & PN,
+      const Eigen::MatrixXd & PC,
+      const Eigen::VectorXd & PR);
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "FastWindingNumber.cpp"
+#endif
+
+#endif
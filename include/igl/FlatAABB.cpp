@@ -0,0 +1,786 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "FlatAABB.h"
+#include "EPS.h"
+#include "barycenter.h"
+#include "doublearea.h"
+#include "parallel_for.h"
+#include "point_simplex_squared_distance.h"
+#include "volume.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace igl
+{
+  namespace flat_aabb
+  {
+    // Round x down (or up) to the nearest representable BoxScalar so that
+    // boxes stored in lower precision still contain their primitives
+    template <typename BoxScalar, typename Scalar>
+    inline BoxScalar round_down(const Scalar x)
+    {
+      BoxScalar b = static_cast<BoxScalar>(x);
+      if(static_cast<Scalar>(b) > x)
+      {
+        b = std::nextafter(b,-std::numeric_limits<BoxScalar>::infinity());
+      }
+      return b;
+    }
+    template <typename BoxScalar, typename Scalar>
+    inline BoxScalar round_up(const Scalar x)
+    {
+      BoxScalar b = static_cast<BoxScalar>(x);
+      if(static_cast<Scalar>(b) < x)
+      {
+        b = std::nextafter(b,std::numeric_limits<BoxScalar>::infinity());
+      }
+      return b;
+    }
+  }
+}
+
+// Traversal stack: enough for depth-first traversal of a tree of depth
+// m_depth, on the call stack unless the tree is unusually deep
+#define IGL_FLAT_AABB_STACK(stack) \
+  int stack##_buffer[64]; \
+  std::vector<int> stack##_heap; \
+  int * stack = stack##_buffer; \
+  if(m_depth+2 > 64) \
+  { \
+    stack##_heap.resize(m_depth+2); \
+    stack = stack##_heap.data(); \
+  }
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::deinit()
+{
+  m_nodes.clear();
+  m_primitives.clear();
+  m_depth = 0;
+  m_triangles.deinit();
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::empty() const
+{
+  return m_nodes.empty();
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::init(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele,
+    const int leaf_size)
+{
+  deinit();
+  if(V.size() == 0 || Ele.size() == 0)
+  {
+    return;
+  }
+  assert(DIM == V.cols() && "V.cols() should matched declared dimension");
+  assert(leaf_size >= 1);
+  MatrixXDIMS BC;
+  if(Ele.cols() == 1)
+  {
+    // points
+    BC = V;
+  }else
+  {
+    // Simplices
+    barycenter(V,Ele,BC);
+  }
+  m_primitives.resize(Ele.rows());
+  for(int e = 0;e<Ele.rows();e++)
+  {
+    m_primitives[e] = e;
+  }
+  // A binary tree with ceil(m/leaf_size) leaves has less than twice as many
+  // nodes
+  m_nodes.reserve(2*((Ele.rows()+leaf_size-1)/leaf_size));
+  build(V,Ele,BC,0,Ele.rows(),leaf_size,0);
+  if(DIM == 3 && Ele.cols() == 3)
+  {
+    m_triangles.init(V,Ele,m_primitives);
+  }
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE int igl::FlatAABB<DerivedV,DIM,BoxScalar>::build(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const MatrixXDIMS & BC,
+  const int begin,
+  const int end,
+  const int leaf_size,
+  const int depth)
+{
+  const int n = m_nodes.size();
+  m_nodes.push_back(Node());
+  m_depth = std::max(m_depth,depth);
+  Eigen::AlignedBox<Scalar,DIM> box;
+  Eigen::AlignedBox<Scalar,DIM> centroid_box;
+  for(int k = begin;k<end;k++)
+  {
+    const int e = m_primitives[k];
+    for(int c = 0;c<Ele.cols();c++)
+    {
+      box.extend(V.row(Ele(e,c)).transpose());
+    }
+    centroid_box.extend(BC.row(e).transpose());
+  }
+  set_box(n,box.min(),box.max());
+  if(end-begin <= leaf_size)
+  {
+    m_nodes[n].offset = begin;
+    m_nodes[n].count = end-begin;
+    return n;
+  }
+  // Median split along longest axis of barycenters
+  int max_d = 0;
+  centroid_box.diagonal().maxCoeff(&max_d);
+  const int mid = (begin+end)/2;
+  std::nth_element(
+    m_primitives.begin()+begin,
+    m_primitives.begin()+mid,
+    m_primitives.begin()+end,
+    [&BC,max_d](const int a, const int b)
+    {
+      return BC(a,max_d) < BC(b,max_d);
+    });
+  build(V,Ele,BC,begin,mid,leaf_size,depth+1);
+  const int right = build(V,Ele,BC,mid,end,leaf_size,depth+1);
+  // m_nodes may have been reallocated
+  m_nodes[n].offset = right;
+  m_nodes[n].count = 0;
+  return n;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+template <typename Derivedmin, typename Derivedmax>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::set_box(
+  const int n,
+  const Eigen::MatrixBase<Derivedmin> & bmin,
+  const Eigen::MatrixBase<Derivedmax> & bmax)
+{
+  Node & node = m_nodes[n];
+  for(int d = 0;d<DIM;d++)
+  {
+    node.min[d] = flat_aabb::round_down<BoxScalar>(bmin(d));
+    node.max[d] = flat_aabb::round_up<BoxScalar>(bmax(d));
+  }
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::init(
+  const AABB<DerivedV,DIM> & tree)
+{
+  deinit();
+  if(!tree.is_leaf() && (tree.m_left == NULL || tree.m_right == NULL))
+  {
+    // empty tree
+    return;
+  }
+  const std::function<int(const AABB<DerivedV,DIM> *,const int)> flatten =
+    [this,&flatten](const AABB<DerivedV,DIM> * t, const int depth)->int
+  {
+    const int n = m_nodes.size();
+    m_nodes.push_back(Node());
+    m_depth = std::max(m_depth,depth);
+    set_box(n,t->m_box.min(),t->m_box.max());
+    if(t->is_leaf())
+    {
+      m_nodes[n].offset = m_primitives.size();
+      m_nodes[n].count = 1;
+      m_primitives.push_back(t->m_primitive);
+      return n;
+    }
+    assert(t->m_left && t->m_right);
+    flatten(t->m_left,depth+1);
+    const int right = flatten(t->m_right,depth+1);
+    m_nodes[n].offset = right;
+    m_nodes[n].count = 0;
+    return n;
+  };
+  flatten(&tree,0);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+template <typename Derivedbb_mins, typename Derivedbb_maxs>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::init(
+  const Eigen::PlainObjectBase<Derivedbb_mins> & bb_mins,
+  const Eigen::PlainObjectBase<Derivedbb_maxs> & bb_maxs,
+  const Eigen::VectorXi & elements)
+{
+  assert(bb_mins.rows() == bb_maxs.rows() && "Serial tree arrays must match");
+  assert(bb_mins.rows() == elements.rows() && "Serial tree arrays must match");
+  deinit();
+  const int m = elements.rows();
+  if(m == 0 || (elements(0) == -1 && m < 3))
+  {
+    // empty tree
+    return;
+  }
+  const std::function<int(const int,const int)> unheap =
+    [this,&unheap,&bb_mins,&bb_maxs,&elements,m](
+      const int i, const int depth)->int
+  {
+    const int n = m_nodes.size();
+    m_nodes.push_back(Node());
+    m_depth = std::max(m_depth,depth);
+    set_box(n,bb_mins.row(i),bb_maxs.row(i));
+    if(elements(i) != -1)
+    {
+      m_nodes[n].offset = m_primitives.size();
+      m_nodes[n].count = 1;
+      m_primitives.push_back(elements(i));
+      return n;
+    }
+    assert(2*i+2 < m && "Serial tree is missing children");
+    unheap(2*i+1,depth+1);
+    const int right = unheap(2*i+2,depth+1);
+    m_nodes[n].offset = right;
+    m_nodes[n].count = 0;
+    return n;
+  };
+  unheap(0,0);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+template <typename Derivedbb_mins, typename Derivedbb_maxs>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::serialize(
+  Eigen::PlainObjectBase<Derivedbb_mins> & bb_mins,
+  Eigen::PlainObjectBase<Derivedbb_maxs> & bb_maxs,
+  Eigen::VectorXi & elements) const
+{
+  if(empty())
+  {
+    // Same as igl::AABB::serialize of an empty tree
+    bb_mins.setConstant(1,DIM,std::numeric_limits<Scalar>::max());
+    bb_maxs.setConstant(1,DIM,std::numeric_limits<Scalar>::lowest());
+    elements.setConstant(1,1,-1);
+    return;
+  }
+  // Size of heap needed for a balanced subtree over k primitives (split like
+  // igl::AABB::init)
+  const std::function<int(const int)> range_size =
+    [&range_size](const int k)->int
+  {
+    return k==1 ? 1 : 1+2*std::max(range_size((k+1)/2),range_size(k/2));
+  };
+  const std::function<int(const int)> node_size =
+    [this,&node_size,&range_size](const int n)->int
+  {
+    const Node & node = m_nodes[n];
+    if(node.is_leaf())
+    {
+      return range_size(node.count);
+    }
+    return 1+2*std::max(node_size(n+1),node_size(node.offset));
+  };
+  const int m = node_size(0);
+  bb_mins.resize(m,DIM);
+  bb_maxs.resize(m,DIM);
+  elements.setConstant(m,1,-1);
+  // Write primitives [begin,end) of leaf n as a subtree rooted at heap
+  // index i
+  const std::function<void(const int,const int,const int,const int)>
+    write_range = [this,&write_range,&bb_mins,&bb_maxs,&elements](
+      const int n, const int begin, const int end, const int i)
+  {
+    const Node & node = m_nodes[n];
+    for(int d = 0;d<DIM;d++)
+    {
+      bb_mins(i,d) = node.min[d];
+      bb_maxs(i,d) = node.max[d];
+    }
+    if(end-begin == 1)
+    {
+      elements(i) = m_primitives[begin];
+      return;
+    }
+    const int mid = begin+(end-begin+1)/2;
+    write_range(n,begin,mid,2*i+1);
+    write_range(n,mid,end,2*i+2);
+  };
+  const std::function<void(const int,const int)> write =
+    [this,&write,&write_range,&bb_mins,&bb_maxs](const int n, const int i)
+  {
+    const Node & node = m_nodes[n];
+    if(node.is_leaf())
+    {
+      write_range(n,node.offset,node.offset+node.count,i);
+      return;
+    }
+    for(int d = 0;d<DIM;d++)
+    {
+      bb_mins(i,d) = node.min[d];
+      bb_maxs(i,d) = node.max[d];
+    }
+    write(n+1,2*i+1);
+    write(node.offset,2*i+2);
+  };
+  write(0,0);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+template <typename Derivedq>
+IGL_INLINE std::vector<int> igl::FlatAABB<DerivedV,DIM,BoxScalar>::find(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & Ele,
+    const Eigen::PlainObjectBase<Derivedq> & q,
+    const bool first) const
+{
+  assert(q.size() == DIM &&
+      "Query dimension should match aabb dimension");
+  assert(Ele.cols() == V.cols()+1 &&
+      "FlatAABB::find only makes sense for (d+1)-simplices");
+  std::vector<int> found;
+  if(empty())
+  {
+    return found;
+  }
+  const Scalar epsilon = igl::EPS<Scalar>();
+  const RowVectorDIMS p = q;
+  IGL_FLAT_AABB_STACK(stack);
+  int top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const Node & node = m_nodes[stack[--top]];
+    if(box_squared_distance(node,p) > 0)
+    {
+      continue;
+    }
+    if(!node.is_leaf())
+    {
+      // Visit left before right
+      stack[top++] = node.offset;
+      stack[top++] = (&node-m_nodes.data())+1;
+      continue;
+    }
+    for(int k = node.offset;k<node.offset+node.count;k++)
+    {
+      const int e = m_primitives[k];
+      // Initialize to some value > -epsilon
+      Scalar a1=0,a2=0,a3=0,a4=0;
+      switch(DIM)
+      {
+        case 3:
+          {
+            // Barycentric coordinates
+            typedef Eigen::Matrix<Scalar,1,3> RowVector3S;
+            const RowVector3S V1 = V.row(Ele(e,0));
+            const RowVector3S V2 = V.row(Ele(e,1));
+            const RowVector3S V3 = V.row(Ele(e,2));
+            const RowVector3S V4 = V.row(Ele(e,3));
+            const RowVector3S q3 = p.template head<3>();
+            a1 = volume_single(V2,V4,V3,q3);
+            a2 = volume_single(V1,V3,V4,q3);
+            a3 = volume_single(V1,V4,V2,q3);
+            a4 = volume_single(V1,V2,V3,q3);
+            break;
+          }
+        case 2:
+          {
+            // Barycentric coordinates
+            typedef Eigen::Matrix<Scalar,2,1> Vector2S;
+            const Vector2S V1 = V.row(Ele(e,0));
+            const Vector2S V2 = V.row(Ele(e,1));
+            const Vector2S V3 = V.row(Ele(e,2));
+            const Vector2S q2 = p.template head<2>();
+            a1 = doublearea_single(V1,V2,q2);
+            a2 = doublearea_single(V2,V3,q2);
+            a3 = doublearea_single(V3,V1,q2);
+            break;
+          }
+        default:assert(false);
+      }
+      // Normalization is important for correcting sign
+      const Scalar sum = a1+a2+a3+a4;
+      a1 /= sum;
+      a2 /= sum;
+      a3 /= sum;
+      a4 /= sum;
+      if(
+          a1>=-epsilon &&
+          a2>=-epsilon &&
+          a3>=-epsilon &&
+          a4>=-epsilon)
+      {
+        found.push_back(e);
+        if(first)
+        {
+          return found;
+        }
+      }
+    }
+  }
+  return found;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE typename igl::FlatAABB<DerivedV,DIM,BoxScalar>::Scalar
+igl::FlatAABB<DerivedV,DIM,BoxScalar>::box_squared_distance(
+  const Node & node,
+  const RowVectorDIMS & p) const
+{
+  Scalar sqr_d = 0;
+  for(int d = 0;d<DIM;d++)
+  {
+    const Scalar lo = static_cast<Scalar>(node.min[d]) - p(d);
+    const Scalar hi = p(d) - static_cast<Scalar>(node.max[d]);
+    const Scalar e = std::max(std::max(lo,hi),Scalar(0));
+    sqr_d += e*e;
+  }
+  return sqr_d;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE typename igl::FlatAABB<DerivedV,DIM,BoxScalar>::Scalar
+igl::FlatAABB<DerivedV,DIM,BoxScalar>::squared_distance(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const RowVectorDIMS & p,
+  int & i,
+  RowVectorDIMS & c) const
+{
+  return squared_distance(V,Ele,p,std::numeric_limits<Scalar>::infinity(),i,c);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE typename igl::FlatAABB<DerivedV,DIM,BoxScalar>::Scalar
+igl::FlatAABB<DerivedV,DIM,BoxScalar>::squared_distance(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const RowVectorDIMS & p,
+  const Scalar min_sqr_d,
+  int & i,
+  RowVectorDIMS & c) const
+{
+  assert((Ele.cols() == 3 || Ele.cols() == 2 || Ele.cols() == 1)
+    && "Code has only been tested for simplex sizes 3,2,1");
+  Scalar sqr_d = min_sqr_d;
+  if(empty())
+  {
+    return sqr_d;
+  }
+  IGL_FLAT_AABB_STACK(stack);
+  int top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const int n = stack[--top];
+    const Node & node = m_nodes[n];
+    // The bound may have tightened since this node was pushed
+    if(box_squared_distance(node,p) >= sqr_d)
+    {
+      continue;
+    }
+    if(node.is_leaf())
+    {
+      for(int k = node.offset;k<node.offset+node.count;k++)
+      {
+        const int e = m_primitives[k];
+        Scalar sqr_d_e;
+        RowVectorDIMS c_e;
+        point_simplex_squared_distance<DIM>(p,V,Ele,e,sqr_d_e,c_e);
+        if(sqr_d_e < sqr_d)
+        {
+          sqr_d = sqr_d_e;
+          i = e;
+          c = c_e;
+        }
+      }
+      continue;
+    }
+    const int left = n+1;
+    const int right = node.offset;
+    const Scalar left_sqr_d = box_squared_distance(m_nodes[left],p);
+    const Scalar right_sqr_d = box_squared_distance(m_nodes[right],p);
+    // Push farther child first so that the nearer one is visited first
+    if(left_sqr_d < right_sqr_d)
+    {
+      if(right_sqr_d < sqr_d) stack[top++] = right;
+      if(left_sqr_d < sqr_d) stack[top++] = left;
+    }else
+    {
+      if(left_sqr_d < sqr_d) stack[top++] = left;
+      if(right_sqr_d < sqr_d) stack[top++] = right;
+    }
+  }
+  return sqr_d;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+template <
+  typename DerivedP,
+  typename DerivedsqrD,
+  typename DerivedI,
+  typename DerivedC>
+IGL_INLINE void igl::FlatAABB<DerivedV,DIM,BoxScalar>::squared_distance(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const Eigen::PlainObjectBase<DerivedP> & P,
+  Eigen::PlainObjectBase<DerivedsqrD> & sqrD,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedC> & C) const
+{
+  assert(P.cols() == V.cols() && "cols in P should match dim of cols in V");
+  sqrD.resize(P.rows(),1);
+  I.resize(P.rows(),1);
+  C.resizeLike(P);
+  parallel_for(
+    P.rows(),
+    [this,&V,&Ele,&P,&sqrD,&I,&C](const int p)
+    {
+      RowVectorDIMS Pp = P.row(p), c;
+      int Ip = -1;
+      sqrD(p) = squared_distance(V,Ele,Pp,Ip,c);
+      I(p) = Ip;
+      C.row(p).head(DIM) = c;
+    },
+    1000);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::ray_box(
+  const Node & node,
+  const RowVectorDIMS & o,
+  const RowVectorDIMS & d,
+  const RowVectorDIMS & inv_d,
+  const Scalar t0,
+  const Scalar t1) const
+{
+  Scalar tmin = t0;
+  Scalar tmax = t1;
+  for(int k = 0;k<DIM;k++)
+  {
+    const Scalar lo = static_cast<Scalar>(node.min[k]);
+    const Scalar hi = static_cast<Scalar>(node.max[k]);
+    if(d(k) == 0)
+    {
+      // Parallel to slab
+      if(o(k) < lo || o(k) > hi)
+      {
+        return false;
+      }
+      continue;
+    }
+    Scalar ta = (lo-o(k))*inv_d(k);
+    Scalar tb = (hi-o(k))*inv_d(k);
+    if(ta > tb)
+    {
+      std::swap(ta,tb);
+    }
+    tmin = std::max(tmin,ta);
+    tmax = std::min(tmax,tb);
+    if(tmin > tmax)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE igl::WatertightRay<typename DerivedV::Scalar>
+igl::FlatAABB<DerivedV,DIM,BoxScalar>::watertight_ray(
+  const RowVectorDIMS & o,
+  const RowVectorDIMS & d)
+{
+  Eigen::Matrix<Scalar,3,1> o3 = Eigen::Matrix<Scalar,3,1>::Zero();
+  Eigen::Matrix<Scalar,3,1> d3 = Eigen::Matrix<Scalar,3,1>::Zero();
+  for(int k = 0;k<DIM && k<3;k++)
+  {
+    o3(k) = o(k);
+    d3(k) = d(k);
+  }
+  return WatertightRay<Scalar>(o3,d3);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::ray_triangle(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const WatertightRay<Scalar> & ray,
+  const int f,
+  const Scalar max_t,
+  igl::Hit & hit) const
+{
+  Scalar v[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+  for(int c = 0;c<3;c++)
+  {
+    for(int k = 0;k<DIM && k<3;k++)
+    {
+      v[c][k] = V(Ele(f,c),k);
+    }
+  }
+  Scalar t,u,w;
+  if(ray_triangle_intersect(ray,v[0],v[1],v[2],Scalar(0),max_t,t,u,w))
+  {
+    hit = {f,-1,(float)u,(float)w,(float)t};
+    return true;
+  }
+  return false;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::intersect_ray(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const RowVectorDIMS & origin,
+  const RowVectorDIMS & dir,
+  std::vector<igl::Hit> & hits) const
+{
+  assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
+  hits.clear();
+  if(empty())
+  {
+    return false;
+  }
+  const RowVectorDIMS inv_d = dir.cwiseInverse();
+  const Scalar inf = std::numeric_limits<Scalar>::infinity();
+  const WatertightRay<Scalar> ray = watertight_ray(origin,dir);
+  const bool packed = m_triangles.size() == (int)m_primitives.size();
+  IGL_FLAT_AABB_STACK(stack);
+  int top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const int n = stack[--top];
+    const Node & node = m_nodes[n];
+    if(!ray_box(node,origin,dir,inv_d,0,inf))
+    {
+      continue;
+    }
+    if(!node.is_leaf())
+    {
+      stack[top++] = node.offset;
+      stack[top++] = n+1;
+      continue;
+    }
+    if(packed)
+    {
+      m_triangles.intersect_ray(
+        ray,node.offset,node.offset+node.count,Scalar(0),inf,hits);
+      continue;
+    }
+    for(int k = node.offset;k<node.offset+node.count;k++)
+    {
+      igl::Hit hit;
+      if(ray_triangle(V,Ele,ray,m_primitives[k],inf,hit))
+      {
+        hits.push_back(hit);
+      }
+    }
+  }
+  std::sort(
+    hits.begin(),
+    hits.end(),
+    [](const Hit & a, const Hit & b)->bool{ return a.t < b.t;});
+  return hits.size() > 0;
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::intersect_ray(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const RowVectorDIMS & origin,
+  const RowVectorDIMS & dir,
+  igl::Hit & hit) const
+{
+  return intersect_ray(
+    V,Ele,origin,dir,std::numeric_limits<Scalar>::infinity(),hit);
+}
+
+template <typename DerivedV, int DIM, typename BoxScalar>
+IGL_INLINE bool igl::FlatAABB<DerivedV,DIM,BoxScalar>::intersect_ray(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  const RowVectorDIMS & origin,
+  const RowVectorDIMS & dir,
+  const Scalar _min_t,
+  igl::Hit & hit) const
+{
+  assert((Ele.size() == 0 || Ele.cols() == 3) && "Elements should be triangles");
+  if(empty())
+  {
+    return false;
+  }
+  Scalar min_t = _min_t;
+  bool found = false;
+  const RowVectorDIMS inv_d = dir.cwiseInverse();
+  const WatertightRay<Scalar> ray = watertight_ray(origin,dir);
+  const bool packed = m_triangles.size() == (int)m_primitives.size();
+  IGL_FLAT_AABB_STACK(stack);
+  int top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const int n = stack[--top];
+    const Node & node = m_nodes[n];
+    if(!ray_box(node,origin,dir,inv_d,0,min_t))
+    {
+      continue;
+    }
+    if(!node.is_leaf())
+    {
+      // Visit the child on the side the ray comes from first
+      const int left = n+1;
+      const int right = node.offset;
+      int k = 0;
+      dir.cwiseAbs().maxCoeff(&k);
+      if(dir(k) > 0)
+      {
+        stack[top++] = right;
+        stack[top++] = left;
+      }else
+      {
+        stack[top++] = left;
+        stack[top++] = right;
+      }
+      continue;
+    }
+    if(packed)
+    {
+      found |= m_triangles.intersect_ray(
+        ray,node.offset,node.offset+node.count,Scalar(0),min_t,hit);
+      continue;
+    }
+    for(int k = node.offset;k<node.offset+node.count;k++)
+    {
+      igl::Hit leaf_hit;
+      if(ray_triangle(V,Ele,ray,m_primitives[k],min_t,leaf_hit))
+      {
+        min_t = leaf_hit.t;
+        hit = leaf_hit;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+#undef IGL_FLAT_AABB_STACK
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, double>;
+template class igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, float>;
+template class igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2, double>;
+template class igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2, float>;
+template void igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, double>::squared_distance<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, float>::squared_distance<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, double>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, 1, 0, -1, 1> const&);
+template void igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, double>::serialize<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&) const;
+template std::vector<int, std::allocator<int> > igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3, double>::find<Eigen::Matrix<double, 1, -1, 1, 1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, 1, -1, 1, 1, -1> > const&, bool) const;
+template std::vector<int, std::allocator<int> > igl::FlatAABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2, double>::find<Eigen::Matrix<double, 1, -1, 1, 1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::PlainObjectBase<Eigen::Matrix<double, 1, -1, 1, 1, -1> > const&, bool) const;
+#endif
@@ -0,0 +1,250 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FLATAABB_H
+#define IGL_FLATAABB_H
+
+#include "AABB.h"
+#include "Hit.h"
+#include "PackedTriangles.h"
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <vector>
+namespace igl
+{
+  // Axis-aligned bounding box hierarchy stored as a single array of nodes in
+  // depth-first order (the left child of a node is the next node, the right
+  // child is stored by index) with leaves referring to small ranges of a
+  // single primitive index array. Traversals are iterative and use a small
+  // stack, so queries touch memory mostly sequentially instead of chasing
+  // heap pointers like igl::AABB.
+  //
+  // With BoxScalar=float, boxes are rounded outward to float and a node takes
+  // 32 bytes (for DIM=3) instead of 56 with double boxes. Primitive tests are
+  // always carried out in the precision of V.
+  //
+  // Like igl::AABB, the mesh (V,Ele) is stored and managed by the caller and
+  // each routine here simply takes it as references.
+  //
+  // Example:
+  //   igl::FlatAABB<Eigen::MatrixXd,3,float> tree;
+  //   tree.init(V,F);
+  //   tree.squared_distance(V,F,P,sqrD,I,C);
+  template <
+    typename DerivedV,
+    int DIM,
+    typename BoxScalar = typename DerivedV::Scalar>
+    class FlatAABB
+    {
+public:
+      typedef typename DerivedV::Scalar Scalar;
+      typedef Eigen::Matrix<Scalar,1,DIM> RowVectorDIMS;
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,DIM> MatrixXDIMS;
+      struct Node
+      {
+        BoxScalar min[DIM];
+        BoxScalar max[DIM];
+        // leaf: index into m_primitives of first primitive
+        // otherwise: index into m_nodes of right child (left child is next)
+        int offset;
+        // leaf: number of primitives (>0), otherwise: 0
+        int count;
+        bool is_leaf() const { return count > 0; }
+      };
+      // #nodes list of nodes in depth-first order, root is m_nodes[0]
+      std::vector<Node> m_nodes;
+      // #Ele list of indices into Ele, leaves refer to ranges of this
+      std::vector<int> m_primitives;
+      // Depth of the deepest leaf (root has depth 0)
+      int m_depth;
+      // Copies of triangles in the order of m_primitives so that each leaf
+      // is tested against a ray with a few SIMD instructions (only set by
+      // init(V,Ele,leaf_size) for 3D triangle meshes)
+      PackedTriangles<Scalar> m_triangles;
+      FlatAABB(): m_nodes(), m_primitives(), m_depth(0), m_triangles() {}
+      IGL_INLINE void deinit();
+      // Return whether tree is empty
+      IGL_INLINE bool empty() const;
+      // Build a hierarchy for a given mesh by recursively splitting primitives
+      // at the median of their barycenters along the longest axis.
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions.
+      //   Ele  #Ele by dim+1 list of mesh indices into #V.
+      //   leaf_size  maximum number of primitives per leaf {4}
+      IGL_INLINE void init(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele,
+          const int leaf_size = 4);
+      // Flatten an existing pointer-based hierarchy (one primitive per leaf)
+      //
+      // Inputs:
+      //   tree  hierarchy built with igl::AABB::init
+      IGL_INLINE void init(const AABB<DerivedV,DIM> & tree);
+      // Build from a serialization in the format of igl::AABB::serialize
+      //
+      // Inputs:
+      //   bb_mins  max_tree by dim list of bounding box min corner positions
+      //   bb_maxs  max_tree by dim list of bounding box max corner positions
+      //   elements  max_tree list of element or (not leaf id) indices into Ele
+      template <typename Derivedbb_mins, typename Derivedbb_maxs>
+        IGL_INLINE void init(
+            const Eigen::PlainObjectBase<Derivedbb_mins> & bb_mins,
+            const Eigen::PlainObjectBase<Derivedbb_maxs> & bb_maxs,
+            const Eigen::VectorXi & elements);
+      // Serialize into the format of igl::AABB::serialize (implicit binary
+      // heap: children of i are 2*i+1 and 2*i+2). Leaves holding several
+      // primitives are expanded into balanced subtrees sharing the leaf's box.
+      //
+      // Outputs:
+      //   bb_mins  max_tree by dim list of bounding box min corner positions
+      //   bb_maxs  max_tree by dim list of bounding box max corner positions
+      //   elements  max_tree list of element or (not leaf id) indices into Ele
+      template <typename Derivedbb_mins, typename Derivedbb_maxs>
+        IGL_INLINE void serialize(
+            Eigen::PlainObjectBase<Derivedbb_mins> & bb_mins,
+            Eigen::PlainObjectBase<Derivedbb_maxs> & bb_maxs,
+            Eigen::VectorXi & elements) const;
+      // Find the indices of elements containing given point, see
+      // igl::AABB::find
+      template <typename Derivedq>
+      IGL_INLINE std::vector<int> find(
+          const Eigen::PlainObjectBase<DerivedV> & V,
+          const Eigen::MatrixXi & Ele,
+          const Eigen::PlainObjectBase<Derivedq> & q,
+          const bool first=false) const;
+      // Compute squared distance to a query point
+      //
+      // Inputs:
+      //   V  #V by dim list of vertex positions
+      //   Ele  #Ele by dim list of simplex indices
+      //   p  dim-long query point
+      //   min_sqr_d  only consider distances less than this {inf}
+      // Outputs:
+      //   i  facet index corresponding to smallest distances (unchanged if
+      //     nothing closer than min_sqr_d)
+      //   c  closest point
+      // Returns squared distance
+      IGL_INLINE Scalar squared_distance(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const RowVectorDIMS & p,
+        int & i,
+        RowVectorDIMS & c) const;
+      IGL_INLINE Scalar squared_distance(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const RowVectorDIMS & p,
+        const Scalar min_sqr_d,
+        int & i,
+        RowVectorDIMS & c) const;
+      // Compute the squared distance from all query points in P (in parallel)
+      //
+      // Inputs:
+      //   V  #V by dim list of vertex positions
+      //   Ele  #Ele by dim list of simplex indices
+      //   P  #P by dim list of query points
+      // Outputs:
+      //   sqrD  #P list of squared distances
+      //   I  #P list of indices into Ele of closest primitives
+      //   C  #P by dim list of closest points
+      template <
+        typename DerivedP,
+        typename DerivedsqrD,
+        typename DerivedI,
+        typename DerivedC>
+      IGL_INLINE void squared_distance(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const Eigen::PlainObjectBase<DerivedP> & P,
+        Eigen::PlainObjectBase<DerivedsqrD> & sqrD,
+        Eigen::PlainObjectBase<DerivedI> & I,
+        Eigen::PlainObjectBase<DerivedC> & C) const;
+      // Intersect a ray with the triangles of the mesh (DIM==3) using
+      // igl::ray_triangle_intersect
+      //
+      // Inputs:
+      //   V  #V by 3 list of vertex positions (the same as given to init)
+      //   Ele  #Ele by 3 list of triangle indices
+      //   origin  3-long ray origin
+      //   dir  3-long ray direction
+      //   min_t  only consider hits with t less than this {inf}
+      // Outputs:
+      //   hits  list of all hits sorted by t
+      //   hit  first hit
+      // Returns true iff there was a hit
+      IGL_INLINE bool intersect_ray(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const RowVectorDIMS & origin,
+        const RowVectorDIMS & dir,
+        std::vector<igl::Hit> & hits) const;
+      IGL_INLINE bool intersect_ray(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const RowVectorDIMS & origin,
+        const RowVectorDIMS & dir,
+        igl::Hit & hit) const;
+      IGL_INLINE bool intersect_ray(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const RowVectorDIMS & origin,
+        const RowVectorDIMS & dir,
+        const Scalar min_t,
+        igl::Hit & hit) const;
+private:
+      // Recursively build subtree over m_primitives[begin,end)
+      //
+      // Returns index of subtree root in m_nodes
+      IGL_INLINE int build(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const MatrixXDIMS & BC,
+        const int begin,
+        const int end,
+        const int leaf_size,
+        const int depth);
+      // Set box of node n to (conservatively rounded) [bmin,bmax]
+      template <typename Derivedmin, typename Derivedmax>
+      IGL_INLINE void set_box(
+        const int n,
+        const Eigen::MatrixBase<Derivedmin> & bmin,
+        const Eigen::MatrixBase<Derivedmax> & bmax);
+      // Squared distance from p to box of node n (0 if inside)
+      IGL_INLINE Scalar box_squared_distance(
+        const Node & node,
+        const RowVectorDIMS & p) const;
+      // Slab test of ray (o + t*d, with inverse direction inv_d) against box
+      // of node for t in [t0,t1]
+      IGL_INLINE bool ray_box(
+        const Node & node,
+        const RowVectorDIMS & o,
+        const RowVectorDIMS & d,
+        const RowVectorDIMS & inv_d,
+        const Scalar t0,
+        const Scalar t1) const;
+      // Prepare ray for ray_triangle (padded with zeros if DIM<3)
+      IGL_INLINE static WatertightRay<Scalar> watertight_ray(
+        const RowVectorDIMS & o,
+        const RowVectorDIMS & d);
+      // Intersect ray with triangle f of Ele for t in (0,max_t), set hit on
+      // success
+      IGL_INLINE bool ray_triangle(
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        const WatertightRay<Scalar> & ray,
+        const int f,
+        const Scalar max_t,
+        igl::Hit & hit) const;
+    };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "FlatAABB.cpp"
+#endif
+
+#endif
@@ -0,0 +1,374 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "KDTree.h"
+#include "Profiler.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+
+namespace igl
+{
+  namespace kdtree
+  {
+    // Subtrees over at least this many points are built in parallel
+    const int PARALLEL_BUILD_MIN_SIZE = 4096;
+    // Maximum depth of traversal stacks (trees over up to 2^31 points are
+    // at most 31 levels deep)
+    const int MAX_DEPTH = 64;
+    // Number of leaves of a subtree over n points: subtrees at the same depth
+    // have (at most two) sizes differing by one
+    inline int num_leaves(const int n, const int leaf_size)
+    {
+      if(n <= leaf_size)
+      {
+        return 1;
+      }
+      int leaves = 0;
+      std::map<int,int> level;
+      level[n] = 1;
+      while(!level.empty())
+      {
+        std::map<int,int> next;
+        for(const auto & sc : level)
+        {
+          const int s = sc.first;
+          if(s <= leaf_size)
+          {
+            leaves += sc.second;
+          }else
+          {
+            next[s/2] += sc.second;
+            next[s-s/2] += sc.second;
+          }
+        }
+        level.swap(next);
+      }
+      return leaves;
+    }
+  }
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::deinit()
+{
+  m_nodes.clear();
+  m_points.resize(0,m_points.cols());
+  m_indices.clear();
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE bool igl::KDTree<Scalar,DIM>::empty() const
+{
+  return m_nodes.empty();
+}
+
+template <typename Scalar, int DIM>
+template <typename DerivedP>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::init(
+  const Eigen::MatrixBase<DerivedP> & P,
+  const int leaf_size)
+{
+  IGL_PROFILE_SCOPE("KDTree::init");
+  assert((DIM == Eigen::Dynamic || P.cols() == DIM) &&
+    "P.cols() should match declared dimension");
+  assert(leaf_size >= 1);
+  deinit();
+  const int n = P.rows();
+  m_points.resize(n,P.cols());
+  if(n == 0)
+  {
+    return;
+  }
+  m_indices.resize(n);
+  for(int i = 0;i<n;i++)
+  {
+    m_indices[i] = i;
+  }
+  m_nodes.resize(2*kdtree::num_leaves(n,leaf_size)-1);
+  build(P,0,0,n,leaf_size);
+  // Store points in tree order
+  parallel_for(n,[this,&P](const int i)
+    {
+      m_points.row(i) = P.row(m_indices[i]).template cast<Scalar>();
+    },
+    10000);
+}
+
+template <typename Scalar, int DIM>
+template <typename DerivedP>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::build(
+  const Eigen::MatrixBase<DerivedP> & P,
+  const int node,
+  const int begin,
+  const int end,
+  const int leaf_size)
+{
+  Node & nd = m_nodes[node];
+  nd.begin = begin;
+  nd.end = end;
+  if(end-begin <= leaf_size)
+  {
+    nd.split = 0;
+    nd.dim = -1;
+    nd.right = -1;
+    return;
+  }
+  // Split widest axis of bounding box at median
+  const int dim = P.cols();
+  int max_d = 0;
+  {
+    Eigen::Matrix<Scalar,1,DIM> bmin = P.row(m_indices[begin]).template cast<Scalar>();
+    Eigen::Matrix<Scalar,1,DIM> bmax = bmin;
+    for(int i = begin+1;i<end;i++)
+    {
+      for(int d = 0;d<dim;d++)
+      {
+        const Scalar x = P(m_indices[i],d);
+        bmin(d) = std::min(bmin(d),x);
+        bmax(d) = std::max(bmax(d),x);
+      }
+    }
+    (bmax-bmin).maxCoeff(&max_d);
+  }
+  const int mid = begin+(end-begin)/2;
+  std::nth_element(
+    m_indices.begin()+begin,
+    m_indices.begin()+mid,
+    m_indices.begin()+end,
+    [&P,max_d](const int a, const int b)
+    {
+      const Scalar pa = P(a,max_d);
+      const Scalar pb = P(b,max_d);
+      return pa < pb || (pa == pb && a < b);
+    });
+  nd.split = P(m_indices[mid],max_d);
+  nd.dim = max_d;
+  nd.right = node+1 + 2*kdtree::num_leaves(mid-begin,leaf_size)-1;
+  const int right = nd.right;
+  // Subtrees are independent and fill disjoint ranges of nodes and indices
+  if(end-begin >= kdtree::PARALLEL_BUILD_MIN_SIZE)
+  {
+    parallel_for(2,[this,&P,node,right,begin,mid,end,leaf_size](const int c)
+      {
+        if(c == 0)
+        {
+          build(P,node+1,begin,mid,leaf_size);
+        }else
+        {
+          build(P,right,mid,end,leaf_size);
+        }
+      });
+  }else
+  {
+    build(P,node+1,begin,mid,leaf_size);
+    build(P,right,mid,end,leaf_size);
+  }
+}
+
+template <typename Scalar, int DIM>
+template <typename Derivedq>
+IGL_INLINE Scalar igl::KDTree<Scalar,DIM>::point_squared_distance(
+  const int i,
+  const Eigen::MatrixBase<Derivedq> & q) const
+{
+  const int dim = DIM == Eigen::Dynamic ? (int)m_points.cols() : DIM;
+  Scalar d = 0;
+  for(int c = 0;c<dim;c++)
+  {
+    const Scalar e = m_points(i,c)-q(c);
+    d += e*e;
+  }
+  return d;
+}
+
+template <typename Scalar, int DIM>
+template <typename Derivedq>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::knn(
+  const Eigen::MatrixBase<Derivedq> & q,
+  const int k,
+  std::vector<std::pair<Scalar,int> > & heap) const
+{
+  heap.clear();
+  if(empty() || k <= 0)
+  {
+    return;
+  }
+  const Scalar inf = std::numeric_limits<Scalar>::infinity();
+  // Stack of nodes with lower bound of their squared distance to q
+  std::pair<int,Scalar> stack[kdtree::MAX_DEPTH];
+  int top = 0;
+  stack[top++] = std::make_pair(0,Scalar(0));
+  while(top > 0)
+  {
+    int n = stack[--top].first;
+    const Scalar bound = stack[top].second;
+    const Scalar worst = (int)heap.size() < k ? inf : heap.front().first;
+    // Subtrees at exactly the worst distance may still hold equidistant
+    // points with smaller indices
+    if(bound > worst)
+    {
+      continue;
+    }
+    // Descend to leaf, pushing far children
+    while(m_nodes[n].dim >= 0)
+    {
+      const Node & nd = m_nodes[n];
+      const Scalar diff = q(nd.dim)-nd.split;
+      const int near = diff < 0 ? n+1 : nd.right;
+      const int far = diff < 0 ? nd.right : n+1;
+      assert(top < kdtree::MAX_DEPTH);
+      stack[top++] = std::make_pair(far,std::max(bound,diff*diff));
+      n = near;
+    }
+    const Node & leaf = m_nodes[n];
+    for(int i = leaf.begin;i<leaf.end;i++)
+    {
+      const std::pair<Scalar,int> c(point_squared_distance(i,q),m_indices[i]);
+      if((int)heap.size() < k)
+      {
+        heap.push_back(c);
+        std::push_heap(heap.begin(),heap.end());
+      }else if(c < heap.front())
+      {
+        std::pop_heap(heap.begin(),heap.end());
+        heap.back() = c;
+        std::push_heap(heap.begin(),heap.end());
+      }
+    }
+  }
+}
+
+template <typename Scalar, int DIM>
+template <typename DerivedQ, typename DerivedI, typename DerivedD>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::knn(
+  const Eigen::MatrixBase<DerivedQ> & Q,
+  const int k,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedD> & D) const
+{
+  IGL_PROFILE_SCOPE("KDTree::knn");
+  assert(empty() || Q.cols() == m_points.cols());
+  I.setConstant(Q.rows(),k,-1);
+  D.setConstant(
+    Q.rows(),k,std::numeric_limits<typename DerivedD::Scalar>::infinity());
+  parallel_for(Q.rows(),[this,&Q,k,&I,&D](const int q)
+    {
+      std::vector<std::pair<Scalar,int> > heap;
+      heap.reserve(k);
+      knn(Q.row(q),k,heap);
+      std::sort_heap(heap.begin(),heap.end());
+      for(int j = 0;j<(int)heap.size();j++)
+      {
+        D(q,j) = heap[j].first;
+        I(q,j) = heap[j].second;
+      }
+    },
+    1000);
+}
+
+template <typename Scalar, int DIM>
+template <
+  typename DerivedQ,
+  typename DerivedC,
+  typename DerivedI,
+  typename DerivedD>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::radius_search(
+  const Eigen::MatrixBase<DerivedQ> & Q,
+  const Scalar radius,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedD> & D) const
+{
+  IGL_PROFILE_SCOPE("KDTree::radius_search");
+  assert(empty() || Q.cols() == m_points.cols());
+  const Scalar sqr_radius = radius*radius;
+  // Neighbors of each query, gathered into flat arrays afterwards
+  std::vector<std::vector<std::pair<Scalar,int> > > N(Q.rows());
+  if(!empty())
+  {
+    parallel_for(Q.rows(),[this,&Q,sqr_radius,&N](const int q)
+      {
+        std::vector<std::pair<Scalar,int> > & Nq = N[q];
+        std::pair<int,Scalar> stack[kdtree::MAX_DEPTH];
+        int top = 0;
+        stack[top++] = std::make_pair(0,Scalar(0));
+        while(top > 0)
+        {
+          int n = stack[--top].first;
+          if(stack[top].second > sqr_radius)
+          {
+            continue;
+          }
+          while(m_nodes[n].dim >= 0)
+          {
+            const Node & nd = m_nodes[n];
+            const Scalar diff = Q(q,nd.dim)-nd.split;
+            const int near = diff < 0 ? n+1 : nd.right;
+            const int far = diff < 0 ? nd.right : n+1;
+            if(diff*diff <= sqr_radius)
+            {
+              assert(top < kdtree::MAX_DEPTH);
+              stack[top++] = std::make_pair(far,diff*diff);
+            }
+            n = near;
+          }
+          const Node & leaf = m_nodes[n];
+          for(int i = leaf.begin;i<leaf.end;i++)
+          {
+            const Scalar d = point_squared_distance(i,Q.row(q));
+            if(d <= sqr_radius)
+            {
+              Nq.push_back(std::make_pair(d,m_indices[i]));
+            }
+          }
+        }
+        std::sort(Nq.begin(),Nq.end());
+      },
+      1000);
+  }
+  C.resize(Q.rows()+1,1);
+  C(0) = 0;
+  for(int q = 0;q<Q.rows();q++)
+  {
+    C(q+1) = C(q)+N[q].size();
+  }
+  I.resize(C(Q.rows()),1);
+  D.resize(C(Q.rows()),1);
+  parallel_for(Q.rows(),[&N,&C,&I,&D](const int q)
+    {
+      for(int j = 0;j<(int)N[q].size();j++)
+      {
+        D(C(q)+j) = N[q][j].first;
+        I(C(q)+j) = N[q][j].second;
+      }
+    },
+    10000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::KDTree<double, 3>;
+template class igl::KDTree<double, 2>;
+template class igl::KDTree<double, -1>;
+template class igl::KDTree<float, 3>;
+template void igl::KDTree<double, 3>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<double, 2>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<double, -1>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<float, 3>::init<Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<double, 3>::knn<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 2>::knn<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, -1>::knn<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 3>::knn<Eigen::Matrix<double, 1, 3, 1, 1, 3>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 2>::knn<Eigen::Matrix<double, 1, 3, 1, 1, 3>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, -1>::knn<Eigen::Matrix<double, 1, 3, 1, 1, 3>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<float, 3>::knn<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 3>::radius_search<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, double, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&) const;
+template void igl::KDTree<float, 3>::radius_search<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<float, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, float, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, 1, 0, -1, 1> >&) const;
+#endif
@@ -0,0 +1,145 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_KDTREE_H
+#define IGL_KDTREE_H
+
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <vector>
+namespace igl
+{
+  // Balanced kd-tree over a point set for nearest neighbor and radius
+  // queries. Points are split at the median along the widest axis of their
+  // bounding box until at most leaf_size points remain. Unlike igl::AABB, the
+  // tree keeps its own copy of the points, reordered so that each leaf's
+  // points are contiguous in memory.
+  //
+  // Construction and batched queries run in parallel (see
+  // igl::parallel_for). Results do not depend on the number of threads: ties
+  // between equidistant points are broken by smaller index.
+  //
+  // Templates:
+  //   Scalar  float or double
+  //   DIM  dimension of points, or Eigen::Dynamic to pick it up from the
+  //     points at run time
+  //
+  // Example:
+  //   igl::KDTree<double,3> tree;
+  //   tree.init(V);
+  //   Eigen::MatrixXi I;
+  //   Eigen::MatrixXd D;
+  //   tree.knn(Q,8,I,D);
+  template <typename Scalar, int DIM>
+    class KDTree
+    {
+public:
+      typedef Eigen::Matrix<
+        Scalar,Eigen::Dynamic,DIM,DIM==1?Eigen::ColMajor:Eigen::RowMajor>
+        MatrixXDIMS;
+      struct Node
+      {
+        // Splitting coordinate: points in left subtree have coordinate <=
+        // split, points in right subtree >= split
+        Scalar split;
+        // Splitting axis, -1 for leaves
+        int dim;
+        // Index of right child (left child is next node), -1 for leaves
+        int right;
+        // Range of rows of m_points in this subtree
+        int begin;
+        int end;
+      };
+      // #nodes list of nodes in depth-first order, root is m_nodes[0]
+      std::vector<Node> m_nodes;
+      // #P by dim list of points in tree order
+      MatrixXDIMS m_points;
+      // #P list of indices of m_points into input points
+      std::vector<int> m_indices;
+      KDTree(): m_nodes(), m_points(), m_indices() {}
+      IGL_INLINE void deinit();
+      // Return whether tree is empty
+      IGL_INLINE bool empty() const;
+      // Build tree over a point set
+      //
+      // Inputs:
+      //   P  #P by dim list of point positions
+      //   leaf_size  maximum number of points per leaf {16}
+      template <typename DerivedP>
+      IGL_INLINE void init(
+        const Eigen::MatrixBase<DerivedP> & P,
+        const int leaf_size = 16);
+      // Find the k nearest points to each query point
+      //
+      // Inputs:
+      //   Q  #Q by dim list of query points
+      //   k  number of neighbors
+      // Outputs:
+      //   I  #Q by k list of indices into P of neighbors, sorted by distance
+      //     (-1 if P has less than k points)
+      //   D  #Q by k list of corresponding squared distances (infinity if P
+      //     has less than k points)
+      template <typename DerivedQ, typename DerivedI, typename DerivedD>
+      IGL_INLINE void knn(
+        const Eigen::MatrixBase<DerivedQ> & Q,
+        const int k,
+        Eigen::PlainObjectBase<DerivedI> & I,
+        Eigen::PlainObjectBase<DerivedD> & D) const;
+      // Find all points within a given distance of each query point
+      //
+      // Inputs:
+      //   Q  #Q by dim list of query points
+      //   radius  search radius (inclusive)
+      // Outputs:
+      //   C  #Q+1 list of offsets: neighbors of query q are C(q),...,C(q+1)-1
+      //   I  #neighbors list of indices into P, sorted by distance per query
+      //   D  #neighbors list of corresponding squared distances
+      template <
+        typename DerivedQ,
+        typename DerivedC,
+        typename DerivedI,
+        typename DerivedD>
+      IGL_INLINE void radius_search(
+        const Eigen::MatrixBase<DerivedQ> & Q,
+        const Scalar radius,
+        Eigen::PlainObjectBase<DerivedC> & C,
+        Eigen::PlainObjectBase<DerivedI> & I,
+        Eigen::PlainObjectBase<DerivedD> & D) const;
+private:
+      // Recursively build subtree over m_indices[begin,end) rooted at node
+      //
+      // Inputs:
+      //   P  #P by dim list of point positions (in input order)
+      template <typename DerivedP>
+      IGL_INLINE void build(
+        const Eigen::MatrixBase<DerivedP> & P,
+        const int node,
+        const int begin,
+        const int end,
+        const int leaf_size);
+      // Squared distance between row i of m_points and query point q
+      template <typename Derivedq>
+      IGL_INLINE Scalar point_squared_distance(
+        const int i,
+        const Eigen::MatrixBase<Derivedq> & q) const;
+      // Gather (squared distance, index) of the k nearest points to q
+      //
+      // Outputs:
+      //   heap  max-heap of at most k nearest points
+      template <typename Derivedq>
+      IGL_INLINE void knn(
+        const Eigen::MatrixBase<Derivedq> & q,
+        const int k,
+        std::vector<std::pair<Scalar,int> > & heap) const;
+    };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "KDTree.cpp"
+#endif
+
+#endif
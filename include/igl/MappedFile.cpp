@@ -0,0 +1,166 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "MappedFile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+IGL_INLINE igl::MappedFile::MappedFile():
+  m_data(NULL),
+  m_size(0),
+  m_open(false),
+  m_mapped(false),
+  m_buffer(),
+#ifdef _WIN32
+  m_file(INVALID_HANDLE_VALUE),
+  m_mapping(NULL)
+#else
+  m_fd(-1)
+#endif
+{
+}
+
+IGL_INLINE igl::MappedFile::~MappedFile()
+{
+  close();
+}
+
+IGL_INLINE bool igl::MappedFile::open(const std::string & filename)
+{
+  close();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(
+    filename.c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+  if(file != INVALID_HANDLE_VALUE)
+  {
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file,&size))
+    {
+      m_file = file;
+      m_size = (size_t)size.QuadPart;
+      m_open = true;
+      if(m_size == 0)
+      {
+        return true;
+      }
+      HANDLE mapping = CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+      if(mapping != NULL)
+      {
+        void * view = MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+        if(view != NULL)
+        {
+          m_mapping = mapping;
+          m_data = static_cast<const char *>(view);
+          m_mapped = true;
+          return true;
+        }
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+    m_file = INVALID_HANDLE_VALUE;
+    m_size = 0;
+    m_open = false;
+  }
+#else
+  const int fd = ::open(filename.c_str(),O_RDONLY);
+  if(fd >= 0)
+  {
+    struct stat st;
+    if(fstat(fd,&st) == 0 && S_ISREG(st.st_mode))
+    {
+      m_fd = fd;
+      m_size = (size_t)st.st_size;
+      m_open = true;
+      if(m_size == 0)
+      {
+        return true;
+      }
+      void * map = mmap(NULL,m_size,PROT_READ,MAP_PRIVATE,fd,0);
+      if(map != MAP_FAILED)
+      {
+        m_data = static_cast<const char *>(map);
+        m_mapped = true;
+        return true;
+      }
+      m_fd = -1;
+      m_size = 0;
+      m_open = false;
+    }
+    ::close(fd);
+  }
+#endif
+  // Fall back to reading the file
+  FILE * fp = fopen(filename.c_str(),"rb");
+  if(NULL == fp)
+  {
+    fprintf(stderr,"IOError: %s could not be opened...\n",filename.c_str());
+    return false;
+  }
+  char chunk[1<<16];
+  size_t count;
+  while((count = fread(chunk,1,sizeof(chunk),fp)) > 0)
+  {
+    m_buffer.insert(m_buffer.end(),chunk,chunk+count);
+  }
+  const bool failed = ferror(fp) != 0;
+  fclose(fp);
+  if(failed)
+  {
+    fprintf(stderr,"IOError: %s could not be read...\n",filename.c_str());
+    m_buffer.clear();
+    return false;
+  }
+  m_data = m_buffer.empty() ? NULL : m_buffer.data();
+  m_size = m_buffer.size();
+  m_open = true;
+  return true;
+}
+
+IGL_INLINE void igl::MappedFile::close()
+{
+#ifdef _WIN32
+  if(m_mapped)
+  {
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = NULL;
+  }
+  if(m_file != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+  }
+#else
+  if(m_mapped)
+  {
+    munmap(const_cast<char *>(m_data),m_size);
+  }
+  if(m_fd >= 0)
+  {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+#endif
+  m_buffer.clear();
+  m_data = NULL;
+  m_size = 0;
+  m_open = false;
+  m_mapped = false;
+}
@@ -0,0 +1,73 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MAPPEDFILE_H
+#define IGL_MAPPEDFILE_H
+#include "igl_inline.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace igl
+{
+  // Read-only view of the whole contents of a file. The file is memory-mapped
+  // (mmap on POSIX, a file mapping on Windows) so that pages are only read
+  // from disk when touched and no copy is made. If the file cannot be mapped
+  // (e.g., a pipe) it is read into memory instead.
+  //
+  // Example:
+  //   igl::MappedFile file;
+  //   if(!file.open("mesh.obj"))
+  //   {
+  //     return false;
+  //   }
+  //   parse(file.data(),file.data()+file.size());
+  class MappedFile
+  {
+    public:
+      MappedFile();
+      ~MappedFile();
+      // Open and map a file, closing any previously open file
+      //
+      // Inputs:
+      //   filename  path to file
+      // Returns true on success, false (with message to stderr) on errors
+      IGL_INLINE bool open(const std::string & filename);
+      // Unmap and close file
+      IGL_INLINE void close();
+      // Returns pointer to first byte of file (NULL if not open or empty)
+      const char * data() const { return m_data; }
+      // Returns size of file in bytes
+      size_t size() const { return m_size; }
+      // Returns whether the file is open
+      bool is_open() const { return m_open; }
+      // Returns whether the file is memory-mapped (rather than read)
+      bool is_mapped() const { return m_mapped; }
+    private:
+      // Not copyable
+      MappedFile(const MappedFile &);
+      MappedFile & operator=(const MappedFile &);
+      const char * m_data;
+      size_t m_size;
+      bool m_open;
+      bool m_mapped;
+      // Contents if the file could not be mapped
+      std::vector<char> m_buffer;
+#ifdef _WIN32
+      void * m_file;
+      void * m_mapping;
+#else
+      int m_fd;
+#endif
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "MappedFile.cpp"
+#endif
+
+#endif
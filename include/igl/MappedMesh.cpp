@@ -0,0 +1,349 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "MappedMesh.h"
+#include <cstdio>
+#include <cstring>
+
+namespace igl
+{
+  namespace mapped_mesh
+  {
+    const char MAGIC[8] = {'I','G','L','B','\r','\n','\x1a','\n'};
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const size_t HEADER_SIZE = 64;
+    const size_t RECORD_SIZE = 128;
+    const size_t ALIGNMENT = 64;
+    template <typename Scalar> struct scalar_type;
+    template <> struct scalar_type<double>
+    { static const MappedMesh::ScalarType value =
+        MappedMesh::SCALAR_TYPE_DOUBLE; };
+    template <> struct scalar_type<float>
+    { static const MappedMesh::ScalarType value =
+        MappedMesh::SCALAR_TYPE_FLOAT; };
+    template <> struct scalar_type<int>
+    { static const MappedMesh::ScalarType value =
+        MappedMesh::SCALAR_TYPE_INT32; };
+    template <> struct scalar_type<int64_t>
+    { static const MappedMesh::ScalarType value =
+        MappedMesh::SCALAR_TYPE_INT64; };
+    template <> struct scalar_type<unsigned char>
+    { static const MappedMesh::ScalarType value =
+        MappedMesh::SCALAR_TYPE_UINT8; };
+    inline size_t scalar_size(const MappedMesh::ScalarType type)
+    {
+      const size_t sizes[] = {8,4,4,8,1};
+      return sizes[type];
+    }
+    inline uint64_t align(const uint64_t offset)
+    {
+      return (offset+ALIGNMENT-1)/ALIGNMENT*ALIGNMENT;
+    }
+    template <typename T>
+    inline void put(char * & p, const T x)
+    {
+      memcpy(p,&x,sizeof(T));
+      p += sizeof(T);
+    }
+    template <typename T>
+    inline T get(const char * & p)
+    {
+      T x;
+      memcpy(&x,p,sizeof(T));
+      p += sizeof(T);
+      return x;
+    }
+  }
+}
+
+template <typename DerivedA>
+IGL_INLINE void igl::MappedMesh::Writer::add(
+  const std::string & name,
+  const Eigen::PlainObjectBase<DerivedA> & A)
+{
+  typedef typename DerivedA::Scalar Scalar;
+  // Column-major copy
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> C = A;
+  Entry e;
+  e.name = name;
+  e.type = mapped_mesh::scalar_type<Scalar>::value;
+  e.rows = C.rows();
+  e.cols = C.cols();
+  e.bytes.resize(sizeof(Scalar)*C.size());
+  if(C.size() > 0)
+  {
+    memcpy(e.bytes.data(),C.data(),e.bytes.size());
+  }
+  for(auto & f : m_entries)
+  {
+    if(f.name == name)
+    {
+      f = std::move(e);
+      return;
+    }
+  }
+  m_entries.push_back(std::move(e));
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE void igl::MappedMesh::Writer::add_aabb(
+  const std::string & prefix,
+  const igl::AABB<DerivedV,DIM> & tree)
+{
+  Eigen::MatrixXd bb_mins,bb_maxs;
+  Eigen::VectorXi elements;
+  tree.serialize(bb_mins,bb_maxs,elements);
+  add(prefix+"_mins",bb_mins);
+  add(prefix+"_maxs",bb_maxs);
+  add(prefix+"_elements",elements);
+}
+
+IGL_INLINE bool igl::MappedMesh::Writer::write(
+  const std::string & filename) const
+{
+  using namespace igl::mapped_mesh;
+  for(const auto & e : m_entries)
+  {
+    if(e.name.empty() || e.name.size() >= MAX_NAME_LENGTH)
+    {
+      fprintf(stderr,"IOError: MappedMesh::Writer bad section name \"%s\"\n",
+        e.name.c_str());
+      return false;
+    }
+  }
+  // Lay out sections
+  std::vector<uint64_t> offsets(m_entries.size());
+  uint64_t end = HEADER_SIZE;
+  for(size_t s = 0;s<m_entries.size();s++)
+  {
+    offsets[s] = align(end);
+    end = offsets[s]+m_entries[s].bytes.size();
+  }
+  const uint64_t directory = align(end);
+  FILE * fp = fopen(filename.c_str(),"wb");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"IOError: %s could not be opened for writing...\n",
+      filename.c_str());
+    return false;
+  }
+  std::vector<char> buffer(HEADER_SIZE,0);
+  char * p = buffer.data();
+  memcpy(p,MAGIC,sizeof(MAGIC));
+  p += sizeof(MAGIC);
+  put<uint32_t>(p,VERSION);
+  put<uint32_t>(p,BYTE_ORDER_MARK);
+  put<uint64_t>(p,m_entries.size());
+  put<uint64_t>(p,directory);
+  bool ok = fwrite(buffer.data(),1,buffer.size(),fp) == buffer.size();
+  uint64_t pos = HEADER_SIZE;
+  const char zeros[ALIGNMENT] = {0};
+  for(size_t s = 0;ok && s<m_entries.size();s++)
+  {
+    const std::vector<char> & bytes = m_entries[s].bytes;
+    ok =
+      fwrite(zeros,1,offsets[s]-pos,fp) == offsets[s]-pos &&
+      fwrite(bytes.data(),1,bytes.size(),fp) == bytes.size();
+    pos = offsets[s]+bytes.size();
+  }
+  ok = ok && fwrite(zeros,1,directory-pos,fp) == directory-pos;
+  for(size_t s = 0;ok && s<m_entries.size();s++)
+  {
+    const Entry & e = m_entries[s];
+    buffer.assign(RECORD_SIZE,0);
+    p = buffer.data();
+    put<uint64_t>(p,offsets[s]);
+    put<uint64_t>(p,e.rows);
+    put<uint64_t>(p,e.cols);
+    put<uint32_t>(p,e.type);
+    put<uint32_t>(p,e.name.size());
+    memcpy(p,e.name.c_str(),e.name.size());
+    ok = fwrite(buffer.data(),1,buffer.size(),fp) == buffer.size();
+  }
+  ok = fclose(fp) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: %s could not be written...\n",filename.c_str());
+  }
+  return ok;
+}
+
+IGL_INLINE bool igl::MappedMesh::open(const std::string & filename)
+{
+  using namespace igl::mapped_mesh;
+  close();
+  if(!m_file.open(filename))
+  {
+    return false;
+  }
+  const char * data = m_file.data();
+  const uint64_t size = m_file.size();
+  const auto & fail = [&](const char * what)->bool
+  {
+    fprintf(stderr,"IOError: %s is not a valid .iglb file (%s)\n",
+      filename.c_str(),what);
+    close();
+    return false;
+  };
+  if(size < HEADER_SIZE || memcmp(data,MAGIC,sizeof(MAGIC)) != 0)
+  {
+    return fail("bad header");
+  }
+  const char * p = data+sizeof(MAGIC);
+  const uint32_t version = get<uint32_t>(p);
+  const uint32_t mark = get<uint32_t>(p);
+  const uint64_t num_sections = get<uint64_t>(p);
+  const uint64_t directory = get<uint64_t>(p);
+  if(version > VERSION)
+  {
+    return fail("newer version");
+  }
+  if(mark != BYTE_ORDER_MARK)
+  {
+    return fail("other byte order");
+  }
+  if(directory > size || num_sections > (size-directory)/RECORD_SIZE)
+  {
+    return fail("truncated directory");
+  }
+  m_sections.resize(num_sections);
+  p = data+directory;
+  for(auto & s : m_sections)
+  {
+    const char * record = p;
+    const uint64_t offset = get<uint64_t>(p);
+    const uint64_t rows = get<uint64_t>(p);
+    const uint64_t cols = get<uint64_t>(p);
+    const uint32_t type = get<uint32_t>(p);
+    const uint32_t length = get<uint32_t>(p);
+    if(type >= NUM_SCALAR_TYPES || length >= MAX_NAME_LENGTH)
+    {
+      return fail("bad section");
+    }
+    const uint64_t max_entries =
+      offset > size ? 0 : (size-offset)/scalar_size((ScalarType)type);
+    if(offset % ALIGNMENT != 0)
+    {
+      // map() reinterprets the bytes as scalars in place
+      return fail("misaligned section");
+    }
+    if(offset > size ||
+      (rows > 0 && cols > max_entries/rows) ||
+      rows > (uint64_t)INT64_MAX || cols > (uint64_t)INT64_MAX)
+    {
+      return fail("truncated section");
+    }
+    s.name.assign(p,length);
+    s.type = (ScalarType)type;
+    s.rows = rows;
+    s.cols = cols;
+    s.data = data+offset;
+    p = record+RECORD_SIZE;
+  }
+  return true;
+}
+
+IGL_INLINE void igl::MappedMesh::close()
+{
+  m_sections.clear();
+  m_file.close();
+}
+
+IGL_INLINE const igl::MappedMesh::Section * igl::MappedMesh::find(
+  const std::string & name) const
+{
+  for(const auto & s : m_sections)
+  {
+    if(s.name == name)
+    {
+      return &s;
+    }
+  }
+  return NULL;
+}
+
+template <typename Scalar>
+IGL_INLINE Eigen::Map<
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> >
+  igl::MappedMesh::map(const std::string & name) const
+{
+  typedef Eigen::Map<
+    const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> > MapType;
+  const Section * s = find(name);
+  if(s == NULL || s->type != mapped_mesh::scalar_type<Scalar>::value)
+  {
+    return MapType(NULL,0,0);
+  }
+  return MapType(
+    reinterpret_cast<const Scalar *>(s->data),s->rows,s->cols);
+}
+
+template <typename DerivedV, int DIM>
+IGL_INLINE bool igl::MappedMesh::init_aabb(
+  const std::string & prefix,
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & Ele,
+  igl::AABB<DerivedV,DIM> & tree) const
+{
+  const Eigen::MatrixXd bb_mins = map<double>(prefix+"_mins");
+  const Eigen::MatrixXd bb_maxs = map<double>(prefix+"_maxs");
+  const auto mapped_elements = map<int>(prefix+"_elements");
+  if(mapped_elements.size() == 0 || mapped_elements.cols() != 1 ||
+    bb_mins.rows() != mapped_elements.rows() || bb_mins.cols() != DIM ||
+    bb_maxs.rows() != mapped_elements.rows() || bb_maxs.cols() != DIM)
+  {
+    return false;
+  }
+  const Eigen::VectorXi elements = mapped_elements;
+  // Nodes are stored heap-like (children of i at 2i+1 and 2i+2). Check that
+  // every node reachable from the root is either an inner node (-1) with
+  // both children present or a leaf referring to a row of Ele. Unreachable
+  // slots are left uninitialized by AABB::serialize and are not looked at.
+  std::vector<int> stack(1,0);
+  while(!stack.empty())
+  {
+    const int i = stack.back();
+    stack.pop_back();
+    const int e = elements(i);
+    if(e == -1)
+    {
+      if(2*(int64_t)i+2 >= elements.size())
+      {
+        return false;
+      }
+      stack.push_back(2*i+1);
+      stack.push_back(2*i+2);
+    }else if(e < -1 || e >= Ele.rows())
+    {
+      return false;
+    }
+  }
+  tree.init(V,Ele,bb_mins,bb_maxs,elements);
+  return true;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template Eigen::Map<const Eigen::Matrix<double, -1, -1, 0, -1, -1> > igl::MappedMesh::map<double>(std::string const&) const;
+template Eigen::Map<const Eigen::Matrix<float, -1, -1, 0, -1, -1> > igl::MappedMesh::map<float>(std::string const&) const;
+template Eigen::Map<const Eigen::Matrix<int, -1, -1, 0, -1, -1> > igl::MappedMesh::map<int>(std::string const&) const;
+template Eigen::Map<const Eigen::Matrix<int64_t, -1, -1, 0, -1, -1> > igl::MappedMesh::map<int64_t>(std::string const&) const;
+template Eigen::Map<const Eigen::Matrix<unsigned char, -1, -1, 0, -1, -1> > igl::MappedMesh::map<unsigned char>(std::string const&) const;
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<float, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<int64_t, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<int64_t, -1, -1, 0, -1, -1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<unsigned char, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<unsigned char, -1, -1, 0, -1, -1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<double, -1, 1, 0, -1, 1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<int, -1, 1, 0, -1, 1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<double, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&);
+template void igl::MappedMesh::Writer::add<Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&);
+template void igl::MappedMesh::Writer::add_aabb<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>(std::string const&, igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2> const&);
+template void igl::MappedMesh::Writer::add_aabb<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>(std::string const&, igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3> const&);
+template bool igl::MappedMesh::init_aabb<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 2>&) const;
+template bool igl::MappedMesh::init_aabb<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, igl::AABB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, 3>&) const;
+#endif
@@ -0,0 +1,164 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MAPPEDMESH_H
+#define IGL_MAPPEDMESH_H
+#include "AABB.h"
+#include "MappedFile.h"
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace igl
+{
+  // Binary mesh container (.iglb) that is opened by memory-mapping the file
+  // and hands out its matrices as Eigen::Map views without copying or
+  // parsing anything, so a cached mesh "loads" in the time it takes to map
+  // it and pages are only read from disk when touched.
+  //
+  // A file holds any number of named dense matrices ("sections") of double,
+  // float, int, int64_t or unsigned char entries. By convention a mesh is
+  // stored as "V", "F" and optionally "TC", "FTC", "N", "FN"; per-vertex or
+  // per-face attributes can be stored under any other name, and an igl::AABB
+  // tree as the arrays of AABB::serialize (see Writer::add_aabb and
+  // init_aabb).
+  //
+  // Layout (version 1, in native byte order): a 64-byte header (magic
+  // "IGLB\r\n\x1a\n", uint32 version, uint32 byte order mark 0x01020304,
+  // uint64 number of sections, uint64 offset of directory), the entries of
+  // each matrix in column-major order starting at a multiple of 64 bytes,
+  // and finally a directory of 128-byte records (uint64 offset, rows, cols,
+  // uint32 type, uint32 length of name, 96 bytes of null-terminated name).
+  // Files written on a machine of the other endianness are rejected.
+  //
+  // Example:
+  //   igl::MappedMesh::Writer w;
+  //   w.add("V",V);
+  //   w.add("F",F);
+  //   w.add("curvature",K);
+  //   w.write("cache.iglb");
+  //   ...
+  //   igl::MappedMesh mesh;
+  //   mesh.open("cache.iglb");
+  //   Eigen::Map<const Eigen::MatrixXd> V = mesh.map<double>("V");
+  //   Eigen::Map<const Eigen::MatrixXi> F = mesh.map<int>("F");
+  //
+  // Maps stay valid until the MappedMesh is closed or destroyed. Functions
+  // taking Eigen::PlainObjectBase arguments need a copy (see readIGLB).
+  class MappedMesh
+  {
+    public:
+      // Type of entries of a section
+      enum ScalarType
+      {
+        SCALAR_TYPE_DOUBLE = 0,
+        SCALAR_TYPE_FLOAT = 1,
+        SCALAR_TYPE_INT32 = 2,
+        SCALAR_TYPE_INT64 = 3,
+        SCALAR_TYPE_UINT8 = 4,
+        NUM_SCALAR_TYPES = 5
+      };
+      static const uint32_t VERSION = 1;
+      // Names must be shorter than this
+      static const size_t MAX_NAME_LENGTH = 96;
+      struct Section
+      {
+        std::string name;
+        ScalarType type;
+        int64_t rows,cols;
+        // Pointer to first entry in mapped file
+        const char * data;
+      };
+      // Collects matrices and writes them into a .iglb file
+      class Writer
+      {
+        public:
+          // Add a copy of a matrix (replacing a previous section of the same
+          // name)
+          //
+          // Inputs:
+          //   name  name of section (shorter than MAX_NAME_LENGTH)
+          //   A  rows by cols matrix of double, float, int, int64_t or
+          //     unsigned char
+          template <typename DerivedA>
+          IGL_INLINE void add(
+            const std::string & name,
+            const Eigen::PlainObjectBase<DerivedA> & A);
+          // Add the arrays of tree.serialize as sections prefix+"_mins",
+          // prefix+"_maxs" and prefix+"_elements"
+          template <typename DerivedV, int DIM>
+          IGL_INLINE void add_aabb(
+            const std::string & prefix,
+            const igl::AABB<DerivedV,DIM> & tree);
+          // Returns true on success, false (with message to stderr) on
+          // errors
+          IGL_INLINE bool write(const std::string & filename) const;
+        private:
+          struct Entry
+          {
+            std::string name;
+            ScalarType type;
+            int64_t rows,cols;
+            std::vector<char> bytes;
+          };
+          std::vector<Entry> m_entries;
+      };
+      MappedMesh(): m_file(), m_sections() {}
+      // Open and map a .iglb file, closing any previously open file
+      //
+      // Returns true on success, false (with message to stderr) if the file
+      // can't be opened or isn't a valid .iglb file
+      IGL_INLINE bool open(const std::string & filename);
+      IGL_INLINE void close();
+      bool is_open() const { return m_file.is_open(); }
+      // Returns whether the file is memory-mapped rather than read (see
+      // MappedFile)
+      bool is_mapped() const { return m_file.is_mapped(); }
+      const std::vector<Section> & sections() const { return m_sections; }
+      // Returns section called name, or NULL if there is none
+      IGL_INLINE const Section * find(const std::string & name) const;
+      // View of section called name without copying
+      //
+      // Templates:
+      //   Scalar  type of entries, must match the type stored in the file
+      // Returns map of section, or an empty map if there is no such section
+      // or it has another type
+      template <typename Scalar>
+      IGL_INLINE Eigen::Map<
+        const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> >
+        map(const std::string & name) const;
+      // Rebuild a tree stored with Writer::add_aabb
+      //
+      // Inputs:
+      //   prefix  prefix passed to add_aabb
+      //   V  #V by dim list of vertex positions the tree was built for
+      //   Ele  #Ele by dim+1 list of mesh indices into V
+      // Outputs:
+      //   tree  tree over V and Ele
+      // Returns false if there is no (valid) tree with this prefix
+      template <typename DerivedV, int DIM>
+      IGL_INLINE bool init_aabb(
+        const std::string & prefix,
+        const Eigen::PlainObjectBase<DerivedV> & V,
+        const Eigen::MatrixXi & Ele,
+        igl::AABB<DerivedV,DIM> & tree) const;
+    private:
+      // Not copyable (maps refer to m_file)
+      MappedMesh(const MappedMesh &);
+      MappedMesh & operator=(const MappedMesh &);
+      MappedFile m_file;
+      std::vector<Section> m_sections;
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "MappedMesh.cpp"
+#endif
+
+#endif
@@ -0,0 +1,715 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "PackedTriangles.h"
+#include <cassert>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+  (defined(__x86_64__) || defined(__i386__))
+#  define IGL_PACKED_TRIANGLES_X86
+#  include <immintrin.h>
+#endif
+
+#ifdef IGL_PACKED_TRIANGLES_X86
+// Kernels are compiled for each instruction set regardless of compiler flags
+// and only called if the CPU supports it
+#define IGL_PACKED_TRIANGLES_SSE4 __attribute__((target("sse4.1"))) inline
+#define IGL_PACKED_TRIANGLES_AVX2 __attribute__((target("avx2"))) inline
+namespace igl
+{
+  namespace packed_triangles
+  {
+    namespace sse
+    {
+      template <typename Scalar> struct Packet;
+      template <> struct Packet<float> { typedef __m128 Type; enum { N = 4 }; };
+      template <> struct Packet<double> { typedef __m128d Type; enum { N = 2 }; };
+      IGL_PACKED_TRIANGLES_SSE4 __m128 load(const float * p){ return _mm_loadu_ps(p); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d load(const double * p){ return _mm_loadu_pd(p); }
+      IGL_PACKED_TRIANGLES_SSE4 void store(float * p, __m128 a){ _mm_storeu_ps(p,a); }
+      IGL_PACKED_TRIANGLES_SSE4 void store(double * p, __m128d a){ _mm_storeu_pd(p,a); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 set1(float a){ return _mm_set1_ps(a); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d set1(double a){ return _mm_set1_pd(a); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 add(__m128 a, __m128 b){ return _mm_add_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d add(__m128d a, __m128d b){ return _mm_add_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 sub(__m128 a, __m128 b){ return _mm_sub_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d sub(__m128d a, __m128d b){ return _mm_sub_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 mul(__m128 a, __m128 b){ return _mm_mul_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d mul(__m128d a, __m128d b){ return _mm_mul_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 lt(__m128 a, __m128 b){ return _mm_cmplt_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d lt(__m128d a, __m128d b){ return _mm_cmplt_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 gt(__m128 a, __m128 b){ return _mm_cmpgt_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d gt(__m128d a, __m128d b){ return _mm_cmpgt_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 eq(__m128 a, __m128 b){ return _mm_cmpeq_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d eq(__m128d a, __m128d b){ return _mm_cmpeq_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 or_(__m128 a, __m128 b){ return _mm_or_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d or_(__m128d a, __m128d b){ return _mm_or_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 and_(__m128 a, __m128 b){ return _mm_and_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d and_(__m128d a, __m128d b){ return _mm_and_pd(a,b); }
+      // ~a & b
+      IGL_PACKED_TRIANGLES_SSE4 __m128 andnot(__m128 a, __m128 b){ return _mm_andnot_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d andnot(__m128d a, __m128d b){ return _mm_andnot_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128 xor_(__m128 a, __m128 b){ return _mm_xor_ps(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 __m128d xor_(__m128d a, __m128d b){ return _mm_xor_pd(a,b); }
+      IGL_PACKED_TRIANGLES_SSE4 int movemask(__m128 a){ return _mm_movemask_ps(a); }
+      IGL_PACKED_TRIANGLES_SSE4 int movemask(__m128d a){ return _mm_movemask_pd(a); }
+      // Watertight test of one register of lanes, computing the same
+      // quantities in the same order as igl::ray_triangle_intersect
+      //
+      // Inputs:
+      //   az,bz,cz  z of corners relative to the ray origin (after permuting)
+      //   ax,ay,bx,by,cx,cy  x,y of corners relative to the ray origin,
+      //     before shearing
+      //   sx,sy,sz  shear and scale of the ray
+      //   tmin,tmax  range of ray parameters
+      // Outputs:
+      //   T,D,V,W  scaled hit parameter, determinant and scaled barycentric
+      //     coordinates
+      //   zero  bitmask of lanes with a zero edge function
+      // Returns bitmask of lanes hit
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_SSE4 int lanes(
+        const typename Packet<Scalar>::Type az,
+        const typename Packet<Scalar>::Type bz,
+        const typename Packet<Scalar>::Type cz,
+        typename Packet<Scalar>::Type ax,
+        typename Packet<Scalar>::Type ay,
+        typename Packet<Scalar>::Type bx,
+        typename Packet<Scalar>::Type by,
+        typename Packet<Scalar>::Type cx,
+        typename Packet<Scalar>::Type cy,
+        const typename Packet<Scalar>::Type sx,
+        const typename Packet<Scalar>::Type sy,
+        const typename Packet<Scalar>::Type sz,
+        const typename Packet<Scalar>::Type tmin,
+        const typename Packet<Scalar>::Type tmax,
+        typename Packet<Scalar>::Type & T,
+        typename Packet<Scalar>::Type & D,
+        typename Packet<Scalar>::Type & V,
+        typename Packet<Scalar>::Type & W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const Vec vzero = set1(Scalar(0));
+        const Vec sign_bit = set1(Scalar(-0.0));
+        ax = sub(ax,mul(sx,az));
+        ay = sub(ay,mul(sy,az));
+        bx = sub(bx,mul(sx,bz));
+        by = sub(by,mul(sy,bz));
+        cx = sub(cx,mul(sx,cz));
+        cy = sub(cy,mul(sy,cz));
+        const Vec u = sub(mul(cx,by),mul(cy,bx));
+        V = sub(mul(ax,cy),mul(ay,cx));
+        W = sub(mul(bx,ay),mul(by,ax));
+        const Vec neg = or_(or_(lt(u,vzero),lt(V,vzero)),lt(W,vzero));
+        const Vec pos = or_(or_(gt(u,vzero),gt(V,vzero)),gt(W,vzero));
+        D = add(add(u,V),W);
+        T = add(add(mul(u,mul(sz,az)),mul(V,mul(sz,bz))),mul(W,mul(sz,cz)));
+        const Vec det_sign = and_(D,sign_bit);
+        const Vec abs_det = xor_(D,det_sign);
+        const Vec signed_t = xor_(T,det_sign);
+        const Vec in_range = and_(
+          gt(signed_t,mul(tmin,abs_det)),lt(signed_t,mul(tmax,abs_det)));
+        const Vec miss = or_(and_(neg,pos),eq(D,vzero));
+        zero = movemask(or_(or_(eq(u,vzero),eq(V,vzero)),eq(W,vzero)));
+        return movemask(andnot(miss,in_range));
+      }
+      // Test of a ray against all lanes of a block of triangles
+      //
+      // Inputs:
+      //   corners  9*LANES list of corner coordinates of a block
+      //   ray  ray
+      //   tmin,tmax  range of ray parameters
+      // Outputs:
+      //   T,D,V,W  LANES lists of scaled hit parameter, determinant and
+      //     scaled barycentric coordinates
+      //   zero  bitmask of lanes with a zero edge function
+      // Returns bitmask of lanes hit
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_SSE4 int intersect_block(
+        const Scalar * corners,
+        const WatertightRay<Scalar> & ray,
+        const Scalar tmin,
+        const Scalar tmax,
+        Scalar * T,
+        Scalar * D,
+        Scalar * V,
+        Scalar * W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const int N = Packet<Scalar>::N;
+        const int L = PackedTriangles<Scalar>::LANES;
+        const int kx = ray.kx*L, ky = ray.ky*L, kz = ray.kz*L;
+        const Vec ox = set1(ray.o[ray.kx]);
+        const Vec oy = set1(ray.o[ray.ky]);
+        const Vec oz = set1(ray.o[ray.kz]);
+        const Vec sx = set1(ray.sx);
+        const Vec sy = set1(ray.sy);
+        const Vec sz = set1(ray.sz);
+        const Vec vtmin = set1(tmin);
+        const Vec vtmax = set1(tmax);
+        int hit = 0;
+        zero = 0;
+        for(int c = 0;c<L;c += N)
+        {
+          const Scalar * a = corners+c;
+          const Scalar * b = a+3*L;
+          const Scalar * p = a+6*L;
+          Vec t,det,v,w;
+          int z;
+          hit |= lanes<Scalar>(
+            sub(load(a+kz),oz),sub(load(b+kz),oz),sub(load(p+kz),oz),
+            sub(load(a+kx),ox),sub(load(a+ky),oy),
+            sub(load(b+kx),ox),sub(load(b+ky),oy),
+            sub(load(p+kx),ox),sub(load(p+ky),oy),
+            sx,sy,sz,vtmin,vtmax,t,det,v,w,z) << c;
+          zero |= z << c;
+          store(T+c,t);
+          store(D+c,det);
+          store(V+c,v);
+          store(W+c,w);
+        }
+        return hit;
+      }
+      // Test of all lanes of a packet of rays against one triangle
+      //
+      // Inputs:
+      //   corners  9*LANES list of corner coordinates gathered per lane,
+      //     coordinate j (after permuting by the lane's ray) of corner c at
+      //     (3*c+j)*LANES+l
+      //   origins,shears  3*LANES lists of permuted origins and of shears of
+      //     the rays, coordinate j of lane l at j*LANES+l
+      //   tmin,tmax  LANES lists of ranges of ray parameters
+      // Outputs:
+      //   T,D,V,W,zero  as for intersect_block
+      // Returns bitmask of lanes hit
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_SSE4 int intersect_rays(
+        const Scalar * corners,
+        const Scalar * origins,
+        const Scalar * shears,
+        const Scalar * tmin,
+        const Scalar * tmax,
+        Scalar * T,
+        Scalar * D,
+        Scalar * V,
+        Scalar * W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const int N = Packet<Scalar>::N;
+        const int L = PackedRays<Scalar>::LANES;
+        int hit = 0;
+        zero = 0;
+        for(int c = 0;c<L;c += N)
+        {
+          const Scalar * a = corners+c;
+          const Scalar * b = a+3*L;
+          const Scalar * p = a+6*L;
+          const Vec ox = load(origins+c);
+          const Vec oy = load(origins+L+c);
+          const Vec oz = load(origins+2*L+c);
+          Vec t,det,v,w;
+          int z;
+          hit |= lanes<Scalar>(
+            sub(load(a+2*L),oz),sub(load(b+2*L),oz),sub(load(p+2*L),oz),
+            sub(load(a),ox),sub(load(a+L),oy),
+            sub(load(b),ox),sub(load(b+L),oy),
+            sub(load(p),ox),sub(load(p+L),oy),
+            load(shears+c),load(shears+L+c),load(shears+2*L+c),
+            load(tmin+c),load(tmax+c),t,det,v,w,z) << c;
+          zero |= z << c;
+          store(T+c,t);
+          store(D+c,det);
+          store(V+c,v);
+          store(W+c,w);
+        }
+        return hit;
+      }
+    }
+    namespace avx
+    {
+      template <typename Scalar> struct Packet;
+      template <> struct Packet<float> { typedef __m256 Type; enum { N = 8 }; };
+      template <> struct Packet<double> { typedef __m256d Type; enum { N = 4 }; };
+      IGL_PACKED_TRIANGLES_AVX2 __m256 load(const float * p){ return _mm256_loadu_ps(p); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d load(const double * p){ return _mm256_loadu_pd(p); }
+      IGL_PACKED_TRIANGLES_AVX2 void store(float * p, __m256 a){ _mm256_storeu_ps(p,a); }
+      IGL_PACKED_TRIANGLES_AVX2 void store(double * p, __m256d a){ _mm256_storeu_pd(p,a); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 set1(float a){ return _mm256_set1_ps(a); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d set1(double a){ return _mm256_set1_pd(a); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 add(__m256 a, __m256 b){ return _mm256_add_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d add(__m256d a, __m256d b){ return _mm256_add_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 sub(__m256 a, __m256 b){ return _mm256_sub_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d sub(__m256d a, __m256d b){ return _mm256_sub_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 mul(__m256 a, __m256 b){ return _mm256_mul_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d mul(__m256d a, __m256d b){ return _mm256_mul_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 lt(__m256 a, __m256 b){ return _mm256_cmp_ps(a,b,_CMP_LT_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d lt(__m256d a, __m256d b){ return _mm256_cmp_pd(a,b,_CMP_LT_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 gt(__m256 a, __m256 b){ return _mm256_cmp_ps(a,b,_CMP_GT_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d gt(__m256d a, __m256d b){ return _mm256_cmp_pd(a,b,_CMP_GT_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 eq(__m256 a, __m256 b){ return _mm256_cmp_ps(a,b,_CMP_EQ_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d eq(__m256d a, __m256d b){ return _mm256_cmp_pd(a,b,_CMP_EQ_OQ); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 or_(__m256 a, __m256 b){ return _mm256_or_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d or_(__m256d a, __m256d b){ return _mm256_or_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 and_(__m256 a, __m256 b){ return _mm256_and_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d and_(__m256d a, __m256d b){ return _mm256_and_pd(a,b); }
+      // ~a & b
+      IGL_PACKED_TRIANGLES_AVX2 __m256 andnot(__m256 a, __m256 b){ return _mm256_andnot_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d andnot(__m256d a, __m256d b){ return _mm256_andnot_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256 xor_(__m256 a, __m256 b){ return _mm256_xor_ps(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 __m256d xor_(__m256d a, __m256d b){ return _mm256_xor_pd(a,b); }
+      IGL_PACKED_TRIANGLES_AVX2 int movemask(__m256 a){ return _mm256_movemask_ps(a); }
+      IGL_PACKED_TRIANGLES_AVX2 int movemask(__m256d a){ return _mm256_movemask_pd(a); }
+      // Same as sse::lanes
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_AVX2 int lanes(
+        const typename Packet<Scalar>::Type az,
+        const typename Packet<Scalar>::Type bz,
+        const typename Packet<Scalar>::Type cz,
+        typename Packet<Scalar>::Type ax,
+        typename Packet<Scalar>::Type ay,
+        typename Packet<Scalar>::Type bx,
+        typename Packet<Scalar>::Type by,
+        typename Packet<Scalar>::Type cx,
+        typename Packet<Scalar>::Type cy,
+        const typename Packet<Scalar>::Type sx,
+        const typename Packet<Scalar>::Type sy,
+        const typename Packet<Scalar>::Type sz,
+        const typename Packet<Scalar>::Type tmin,
+        const typename Packet<Scalar>::Type tmax,
+        typename Packet<Scalar>::Type & T,
+        typename Packet<Scalar>::Type & D,
+        typename Packet<Scalar>::Type & V,
+        typename Packet<Scalar>::Type & W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const Vec vzero = set1(Scalar(0));
+        const Vec sign_bit = set1(Scalar(-0.0));
+        ax = sub(ax,mul(sx,az));
+        ay = sub(ay,mul(sy,az));
+        bx = sub(bx,mul(sx,bz));
+        by = sub(by,mul(sy,bz));
+        cx = sub(cx,mul(sx,cz));
+        cy = sub(cy,mul(sy,cz));
+        const Vec u = sub(mul(cx,by),mul(cy,bx));
+        V = sub(mul(ax,cy),mul(ay,cx));
+        W = sub(mul(bx,ay),mul(by,ax));
+        const Vec neg = or_(or_(lt(u,vzero),lt(V,vzero)),lt(W,vzero));
+        const Vec pos = or_(or_(gt(u,vzero),gt(V,vzero)),gt(W,vzero));
+        D = add(add(u,V),W);
+        T = add(add(mul(u,mul(sz,az)),mul(V,mul(sz,bz))),mul(W,mul(sz,cz)));
+        const Vec det_sign = and_(D,sign_bit);
+        const Vec abs_det = xor_(D,det_sign);
+        const Vec signed_t = xor_(T,det_sign);
+        const Vec in_range = and_(
+          gt(signed_t,mul(tmin,abs_det)),lt(signed_t,mul(tmax,abs_det)));
+        const Vec miss = or_(and_(neg,pos),eq(D,vzero));
+        zero = movemask(or_(or_(eq(u,vzero),eq(V,vzero)),eq(W,vzero)));
+        return movemask(andnot(miss,in_range));
+      }
+      // Same as sse::intersect_block
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_AVX2 int intersect_block(
+        const Scalar * corners,
+        const WatertightRay<Scalar> & ray,
+        const Scalar tmin,
+        const Scalar tmax,
+        Scalar * T,
+        Scalar * D,
+        Scalar * V,
+        Scalar * W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const int N = Packet<Scalar>::N;
+        const int L = PackedTriangles<Scalar>::LANES;
+        const int kx = ray.kx*L, ky = ray.ky*L, kz = ray.kz*L;
+        const Vec ox = set1(ray.o[ray.kx]);
+        const Vec oy = set1(ray.o[ray.ky]);
+        const Vec oz = set1(ray.o[ray.kz]);
+        const Vec sx = set1(ray.sx);
+        const Vec sy = set1(ray.sy);
+        const Vec sz = set1(ray.sz);
+        const Vec vtmin = set1(tmin);
+        const Vec vtmax = set1(tmax);
+        int hit = 0;
+        zero = 0;
+        for(int c = 0;c<L;c += N)
+        {
+          const Scalar * a = corners+c;
+          const Scalar * b = a+3*L;
+          const Scalar * p = a+6*L;
+          Vec t,det,v,w;
+          int z;
+          hit |= lanes<Scalar>(
+            sub(load(a+kz),oz),sub(load(b+kz),oz),sub(load(p+kz),oz),
+            sub(load(a+kx),ox),sub(load(a+ky),oy),
+            sub(load(b+kx),ox),sub(load(b+ky),oy),
+            sub(load(p+kx),ox),sub(load(p+ky),oy),
+            sx,sy,sz,vtmin,vtmax,t,det,v,w,z) << c;
+          zero |= z << c;
+          store(T+c,t);
+          store(D+c,det);
+          store(V+c,v);
+          store(W+c,w);
+        }
+        return hit;
+      }
+      // Same as sse::intersect_rays
+      template <typename Scalar>
+      IGL_PACKED_TRIANGLES_AVX2 int intersect_rays(
+        const Scalar * corners,
+        const Scalar * origins,
+        const Scalar * shears,
+        const Scalar * tmin,
+        const Scalar * tmax,
+        Scalar * T,
+        Scalar * D,
+        Scalar * V,
+        Scalar * W,
+        int & zero)
+      {
+        typedef typename Packet<Scalar>::Type Vec;
+        const int N = Packet<Scalar>::N;
+        const int L = PackedRays<Scalar>::LANES;
+        int hit = 0;
+        zero = 0;
+        for(int c = 0;c<L;c += N)
+        {
+          const Scalar * a = corners+c;
+          const Scalar * b = a+3*L;
+          const Scalar * p = a+6*L;
+          const Vec ox = load(origins+c);
+          const Vec oy = load(origins+L+c);
+          const Vec oz = load(origins+2*L+c);
+          Vec t,det,v,w;
+          int z;
+          hit |= lanes<Scalar>(
+            sub(load(a+2*L),oz),sub(load(b+2*L),oz),sub(load(p+2*L),oz),
+            sub(load(a),ox),sub(load(a+L),oy),
+            sub(load(b),ox),sub(load(b+L),oy),
+            sub(load(p),ox),sub(load(p+L),oy),
+            load(shears+c),load(shears+L+c),load(shears+2*L+c),
+            load(tmin+c),load(tmax+c),t,det,v,w,z) << c;
+          zero |= z << c;
+          store(T+c,t);
+          store(D+c,det);
+          store(V+c,v);
+          store(W+c,w);
+        }
+        return hit;
+      }
+    }
+  }
+}
+#undef IGL_PACKED_TRIANGLES_SSE4
+#undef IGL_PACKED_TRIANGLES_AVX2
+#endif
+
+IGL_INLINE igl::RayTriangleSIMDType igl::ray_triangle_simd_type()
+{
+#ifdef IGL_PACKED_TRIANGLES_X86
+  static const RayTriangleSIMDType type = []()
+  {
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return RAY_TRIANGLE_SIMD_TYPE_AVX2;
+    }else if(__builtin_cpu_supports("sse4.1"))
+    {
+      return RAY_TRIANGLE_SIMD_TYPE_SSE4;
+    }
+    return RAY_TRIANGLE_SIMD_TYPE_SCALAR;
+  }();
+  return type;
+#else
+  return RAY_TRIANGLE_SIMD_TYPE_SCALAR;
+#endif
+}
+
+template <typename Scalar>
+IGL_INLINE void igl::PackedTriangles<Scalar>::deinit()
+{
+  m_corners.clear();
+  m_ids.clear();
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::PackedTriangles<Scalar>::empty() const
+{
+  return m_ids.empty();
+}
+
+template <typename Scalar>
+IGL_INLINE int igl::PackedTriangles<Scalar>::size() const
+{
+  return m_ids.size();
+}
+
+template <typename Scalar>
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE void igl::PackedTriangles<Scalar>::init(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F)
+{
+  std::vector<int> ids(F.rows());
+  for(int f = 0;f<F.rows();f++)
+  {
+    ids[f] = f;
+  }
+  init(V,F,ids);
+}
+
+template <typename Scalar>
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE void igl::PackedTriangles<Scalar>::init(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const std::vector<int> & ids)
+{
+  assert((F.size() == 0 || F.cols() == 3) && "F should be triangles");
+  assert((V.size() == 0 || V.cols() == 3) && "V should be 3D");
+  m_ids = ids;
+  const int num_blocks = (ids.size()+LANES-1)/LANES;
+  // Unused lanes stay degenerate
+  m_corners.assign((size_t)num_blocks*9*LANES,Scalar(0));
+  for(size_t i = 0;i<ids.size();i++)
+  {
+    Scalar * block = m_corners.data()+(i/LANES)*9*LANES+i%LANES;
+    for(int c = 0;c<3;c++)
+    {
+      for(int k = 0;k<3;k++)
+      {
+        block[(3*c+k)*LANES] = static_cast<Scalar>(V(F(ids[i],c),k));
+      }
+    }
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE int igl::PackedTriangles<Scalar>::intersect_block(
+  const RayTriangleSIMDType simd_type,
+  const Scalar * corners,
+  const WatertightRay<Scalar> & ray,
+  const int valid,
+  const Scalar tmin,
+  const Scalar tmax,
+  Scalar * t,
+  Scalar * u,
+  Scalar * v)
+{
+  // Lanes to test one at a time
+  int scalar_lanes = valid;
+  int hit = 0;
+#ifdef IGL_PACKED_TRIANGLES_X86
+  if(simd_type != RAY_TRIANGLE_SIMD_TYPE_SCALAR)
+  {
+    Scalar T[LANES],D[LANES],U[LANES],W[LANES];
+    int zero;
+    hit = valid & (simd_type == RAY_TRIANGLE_SIMD_TYPE_AVX2 ?
+      packed_triangles::avx::intersect_block(corners,ray,tmin,tmax,T,D,U,W,zero):
+      packed_triangles::sse::intersect_block(corners,ray,tmin,tmax,T,D,U,W,zero));
+    // In single precision zero edge functions are recomputed in double
+    scalar_lanes = std::is_same<Scalar,float>::value ? valid & zero : 0;
+    hit &= ~scalar_lanes;
+    for(int l = 0;l<LANES;l++)
+    {
+      if(hit & (1<<l))
+      {
+        t[l] = T[l]/D[l];
+        u[l] = U[l]/D[l];
+        v[l] = W[l]/D[l];
+      }
+    }
+  }
+#endif
+  for(int l = 0;l<LANES && scalar_lanes;l++)
+  {
+    if(
+      (scalar_lanes & (1<<l)) &&
+      ray_triangle_intersect(ray,corners+l,LANES,tmin,tmax,t[l],u[l],v[l]))
+    {
+      hit |= 1<<l;
+    }
+  }
+  return hit;
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::PackedTriangles<Scalar>::intersect_ray(
+  const WatertightRay<Scalar> & ray,
+  const int begin,
+  const int end,
+  const Scalar tmin,
+  Scalar & tmax,
+  igl::Hit & hit) const
+{
+  assert(begin >= 0 && end <= size());
+  bool found = false;
+  for(int b = begin/LANES;b*LANES<end;b++)
+  {
+    // Lanes of block within [begin,end)
+    const int first = std::max(begin-b*LANES,0);
+    const int last = std::min(end-b*LANES,(int)LANES);
+    const int valid = ((1<<last)-1) & ~((1<<first)-1);
+    Scalar t[LANES],u[LANES],v[LANES];
+    const Scalar * corners = m_corners.data()+(size_t)b*9*LANES;
+    const int lanes_hit =
+      intersect_block(m_simd_type,corners,ray,valid,tmin,tmax,t,u,v);
+    for(int l = 0;l<LANES && lanes_hit;l++)
+    {
+      if((lanes_hit & (1<<l)) && t[l] < tmax)
+      {
+        tmax = t[l];
+        hit = {m_ids[b*LANES+l],-1,(float)u[l],(float)v[l],(float)t[l]};
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::PackedTriangles<Scalar>::intersect_ray(
+  const WatertightRay<Scalar> & ray,
+  const int begin,
+  const int end,
+  const Scalar tmin,
+  const Scalar tmax,
+  std::vector<igl::Hit> & hits) const
+{
+  assert(begin >= 0 && end <= size());
+  const size_t num_hits = hits.size();
+  for(int b = begin/LANES;b*LANES<end;b++)
+  {
+    const int first = std::max(begin-b*LANES,0);
+    const int last = std::min(end-b*LANES,(int)LANES);
+    const int valid = ((1<<last)-1) & ~((1<<first)-1);
+    Scalar t[LANES],u[LANES],v[LANES];
+    const Scalar * corners = m_corners.data()+(size_t)b*9*LANES;
+    const int lanes_hit =
+      intersect_block(m_simd_type,corners,ray,valid,tmin,tmax,t,u,v);
+    for(int l = 0;l<LANES && lanes_hit;l++)
+    {
+      if(lanes_hit & (1<<l))
+      {
+        hits.push_back({m_ids[b*LANES+l],-1,(float)u[l],(float)v[l],(float)t[l]});
+      }
+    }
+  }
+  return hits.size() > num_hits;
+}
+
+template <typename Scalar>
+IGL_INLINE igl::PackedRays<Scalar>::PackedRays():
+  m_simd_type(ray_triangle_simd_type())
+{
+  for(int l = 0;l<LANES;l++)
+  {
+    set(l,WatertightRay<Scalar>());
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE void igl::PackedRays<Scalar>::set(
+  const int l,
+  const WatertightRay<Scalar> & ray)
+{
+  assert(l >= 0 && l < LANES);
+  m_rays[l] = ray;
+  m_axes[0][l] = ray.kx;
+  m_axes[1][l] = ray.ky;
+  m_axes[2][l] = ray.kz;
+  for(int j = 0;j<3;j++)
+  {
+    m_origins[j][l] = ray.o[m_axes[j][l]];
+  }
+  m_shears[0][l] = ray.sx;
+  m_shears[1][l] = ray.sy;
+  m_shears[2][l] = ray.sz;
+}
+
+template <typename Scalar>
+IGL_INLINE int igl::PackedRays<Scalar>::intersect_triangle(
+  const Scalar * v0,
+  const Scalar * v1,
+  const Scalar * v2,
+  const Scalar * tmin,
+  const Scalar * tmax,
+  Scalar * t,
+  Scalar * u,
+  Scalar * v) const
+{
+  // Lanes to test one at a time
+  int scalar_lanes = (1<<LANES)-1;
+  int hit = 0;
+#ifdef IGL_PACKED_TRIANGLES_X86
+  if(m_simd_type != RAY_TRIANGLE_SIMD_TYPE_SCALAR)
+  {
+    // Corners permuted by the ray of each lane
+    const Scalar * P[3] = {v0,v1,v2};
+    Scalar corners[9*LANES];
+    for(int c = 0;c<3;c++)
+    {
+      for(int j = 0;j<3;j++)
+      {
+        for(int l = 0;l<LANES;l++)
+        {
+          corners[(3*c+j)*LANES+l] = P[c][m_axes[j][l]];
+        }
+      }
+    }
+    Scalar T[LANES],D[LANES],U[LANES],W[LANES];
+    int zero;
+    hit = m_simd_type == RAY_TRIANGLE_SIMD_TYPE_AVX2 ?
+      packed_triangles::avx::intersect_rays(corners,
+        m_origins[0],m_shears[0],tmin,tmax,T,D,U,W,zero):
+      packed_triangles::sse::intersect_rays(corners,
+        m_origins[0],m_shears[0],tmin,tmax,T,D,U,W,zero);
+    // In single precision zero edge functions are recomputed in double
+    scalar_lanes = std::is_same<Scalar,float>::value ? zero : 0;
+    hit &= ~scalar_lanes;
+    for(int l = 0;l<LANES;l++)
+    {
+      if(hit & (1<<l))
+      {
+        t[l] = T[l]/D[l];
+        u[l] = U[l]/D[l];
+        v[l] = W[l]/D[l];
+      }
+    }
+  }
+#endif
+  for(int l = 0;l<LANES && scalar_lanes;l++)
+  {
+    if(
+      (scalar_lanes & (1<<l)) &&
+      ray_triangle_intersect(
+        m_rays[l],v0,v1,v2,tmin[l],tmax[l],t[l],u[l],v[l]))
+    {
+      hit |= 1<<l;
+    }
+  }
+  return hit;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::PackedTriangles<double>;
+template class igl::PackedTriangles<float>;
+template class igl::PackedRays<double>;
+template class igl::PackedRays<float>;
+template void igl::PackedTriangles<double>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&);
+template void igl::PackedTriangles<double>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<int, std::allocator<int> > const&);
+template void igl::PackedTriangles<float>::init<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&);
+template void igl::PackedTriangles<float>::init<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<int, std::allocator<int> > const&);
+template void igl::PackedTriangles<float>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<int, std::allocator<int> > const&);
+#endif
@@ -0,0 +1,195 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PACKEDTRIANGLES_H
+#define IGL_PACKEDTRIANGLES_H
+
+#include "igl_inline.h"
+#include "Hit.h"
+#include "ray_triangle_intersect.h"
+#include <Eigen/Core>
+#include <vector>
+namespace igl
+{
+  enum RayTriangleSIMDType
+  {
+    // One triangle at a time
+    RAY_TRIANGLE_SIMD_TYPE_SCALAR = 0,
+    // 4 floats or 2 doubles per instruction
+    RAY_TRIANGLE_SIMD_TYPE_SSE4 = 1,
+    // 8 floats or 4 doubles per instruction
+    RAY_TRIANGLE_SIMD_TYPE_AVX2 = 2,
+    NUM_RAY_TRIANGLE_SIMD_TYPE = 3
+  };
+  // Widest instruction set for ray-triangle tests supported by this CPU.
+  // Detected at runtime on x86 with GCC or Clang, otherwise always scalar.
+  IGL_INLINE RayTriangleSIMDType ray_triangle_simd_type();
+  // Copies of the triangles of a mesh laid out for testing a ray against
+  // several triangles at once with igl::ray_triangle_intersect.
+  //
+  // Triangles are stored in blocks of LANES (one 256-bit register of
+  // coordinates) in structure-of-arrays layout, in a given order (e.g., the
+  // order of primitives in the leaves of a tree) so that a range of
+  // triangles is contiguous in memory. Results are identical whichever
+  // instruction set is used (unless the compiler is allowed to contract the
+  // scalar fallback into fused multiply-adds).
+  //
+  // Example:
+  //   igl::PackedTriangles<double> T;
+  //   T.init(V,F);
+  //   igl::WatertightRay<double> ray(origin,dir);
+  //   double tmax = std::numeric_limits<double>::infinity();
+  //   igl::Hit hit;
+  //   T.intersect_ray(ray,0,T.size(),0.,tmax,hit);
+  template <typename Scalar>
+  class PackedTriangles
+  {
+  public:
+    enum { LANES = 32/sizeof(Scalar) };
+    // #blocks*9*LANES list of corner coordinates, coordinate k of corner c
+    // of triangle l of block b at (b*9+3*c+k)*LANES+l
+    std::vector<Scalar> m_corners;
+    // #triangles list of indices of packed triangles into F
+    std::vector<int> m_ids;
+    // Instruction set used by intersect_ray
+    RayTriangleSIMDType m_simd_type;
+    PackedTriangles():
+      m_corners(),
+      m_ids(),
+      m_simd_type(ray_triangle_simd_type())
+    {}
+    IGL_INLINE void deinit();
+    IGL_INLINE bool empty() const;
+    // Returns number of packed triangles
+    IGL_INLINE int size() const;
+    // Copy triangles of a mesh
+    //
+    // Inputs:
+    //   V  #V by 3 list of vertex positions
+    //   F  #F by 3 list of triangle indices into V
+    //   ids  #ids list of indices into F of triangles to pack (in order)
+    //     {all}
+    template <typename DerivedV, typename DerivedF>
+    IGL_INLINE void init(
+      const Eigen::MatrixBase<DerivedV> & V,
+      const Eigen::MatrixBase<DerivedF> & F);
+    template <typename DerivedV, typename DerivedF>
+    IGL_INLINE void init(
+      const Eigen::MatrixBase<DerivedV> & V,
+      const Eigen::MatrixBase<DerivedF> & F,
+      const std::vector<int> & ids);
+    // Intersect a ray with the packed triangles [begin,end)
+    //
+    // Inputs:
+    //   ray  ray
+    //   begin,end  range of packed triangles
+    //   tmin  only consider hits with t greater than this
+    //   tmax  only consider hits with t less than this
+    // Outputs:
+    //   tmax  t of closest hit (unchanged if none)
+    //   hit  closest hit (id indexes F)
+    // Returns true iff there was a hit
+    IGL_INLINE bool intersect_ray(
+      const WatertightRay<Scalar> & ray,
+      const int begin,
+      const int end,
+      const Scalar tmin,
+      Scalar & tmax,
+      igl::Hit & hit) const;
+    // Outputs:
+    //   hits  all hits appended in order of packed triangles
+    IGL_INLINE bool intersect_ray(
+      const WatertightRay<Scalar> & ray,
+      const int begin,
+      const int end,
+      const Scalar tmin,
+      const Scalar tmax,
+      std::vector<igl::Hit> & hits) const;
+    // Intersect a ray with one block of triangles, e.g. gathered on the
+    // stack rather than packed beforehand
+    //
+    // Inputs:
+    //   simd_type  instruction set to use (see ray_triangle_simd_type)
+    //   corners  9*LANES list of corner coordinates, coordinate k of corner c
+    //     of lane l at (3*c+k)*LANES+l
+    //   ray  ray
+    //   valid  bitmask of lanes to test
+    //   tmin,tmax  range of ray parameters
+    // Outputs:
+    //   t,u,v  LANES lists of hit parameters
+    // Returns bitmask of lanes hit
+    IGL_INLINE static int intersect_block(
+      const RayTriangleSIMDType simd_type,
+      const Scalar * corners,
+      const WatertightRay<Scalar> & ray,
+      const int valid,
+      const Scalar tmin,
+      const Scalar tmax,
+      Scalar * t,
+      Scalar * u,
+      Scalar * v);
+  };
+  // Several rays laid out for testing them against one triangle at once
+  // with igl::ray_triangle_intersect, the transpose of PackedTriangles (e.g.,
+  // for a packet of rays traversing a tree together). Lanes are tested with
+  // the same instruction sets and give the same results as PackedTriangles.
+  //
+  // Example:
+  //   igl::PackedRays<double> R;
+  //   for(int l = 0;l<R.LANES;l++)
+  //   {
+  //     R.set(l,igl::WatertightRay<double>(O.row(l),D.row(l)));
+  //   }
+  //   const int lanes_hit = R.intersect_triangle(a,b,c,tmin,tmax,t,u,v);
+  template <typename Scalar>
+  class PackedRays
+  {
+  public:
+    enum { LANES = 8 };
+    // Rays of the lanes (lanes of unset rays have default rays)
+    WatertightRay<Scalar> m_rays[LANES];
+    // Permutations of axes: kx,ky,kz of ray l at m_axes[0..2][l]
+    int m_axes[3][LANES];
+    // Permuted origins: m_origins[j][l] = m_rays[l].o[m_axes[j][l]]
+    Scalar m_origins[3][LANES];
+    // Shears and scales sx,sy,sz of ray l at m_shears[0..2][l]
+    Scalar m_shears[3][LANES];
+    // Instruction set used by intersect_triangle
+    RayTriangleSIMDType m_simd_type;
+    IGL_INLINE PackedRays();
+    // Set the ray of a lane
+    //
+    // Inputs:
+    //   l  index of lane
+    //   ray  ray
+    IGL_INLINE void set(const int l, const WatertightRay<Scalar> & ray);
+    // Intersect the rays of all lanes with a triangle
+    //
+    // Inputs:
+    //   v0,v1,v2  3-long corners of triangle
+    //   tmin,tmax  LANES lists of ranges of ray parameters (hits with
+    //     tmin < t < tmax)
+    // Outputs:
+    //   t,u,v  LANES lists of hit parameters
+    // Returns bitmask of lanes hit
+    IGL_INLINE int intersect_triangle(
+      const Scalar * v0,
+      const Scalar * v1,
+      const Scalar * v2,
+      const Scalar * tmin,
+      const Scalar * tmax,
+      Scalar * t,
+      Scalar * u,
+      Scalar * v) const;
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "PackedTriangles.cpp"
+#endif
+
+#endif
@@ -0,0 +1,385 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PROFILER_H
+#define IGL_PROFILER_H
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Scoped-zone profiler. Zones are opened with
+//
+//     IGL_PROFILE_SCOPE("name");
+//
+// and closed at the end of the enclosing scope. Unless IGL_PROFILE is defined
+// (e.g. with the LIBIGL_WITH_PROFILER cmake option) IGL_PROFILE_SCOPE expands
+// to nothing, so instrumented code pays nothing when profiling is disabled.
+//
+// For each zone the profiler records its thread, nesting depth, start time,
+// duration, time not spent in nested zones ("self" time) and the number of
+// bytes allocated on the zone's thread while it was open. Bytes are only
+// counted if the application expands IGL_PROFILE_DEFINE_ALLOCATION_HOOKS()
+// once at global scope in one of its translation units (this replaces the
+// global operator new/delete).
+//
+// Example:
+//   #define IGL_PROFILE
+//   #include <igl/Profiler.h>
+//   IGL_PROFILE_DEFINE_ALLOCATION_HOOKS()
+//   ...
+//   {
+//     IGL_PROFILE_SCOPE("my_function");
+//     ...
+//   }
+//   igl::Profiler::instance().write_chrome_trace("trace.json");
+//   igl::Profiler::instance().print_summary(std::cout);
+//
+// trace.json can be loaded in chrome://tracing or https://ui.perfetto.dev
+namespace igl
+{
+  class Profiler
+  {
+    public:
+      struct Zone
+      {
+        // Name of the zone, must outlive the profiler (string literal)
+        const char * name;
+        // Small integer id of the thread the zone ran on
+        int thread;
+        // Number of enclosing zones on the same thread
+        int depth;
+        // Start time and duration in microseconds since profiler creation
+        double start;
+        double duration;
+        // Duration minus durations of directly nested zones
+        double self;
+        // Bytes allocated on this thread while the zone was open
+        size_t bytes;
+      };
+      // Returns the single process-wide profiler
+      inline static Profiler & instance();
+      // Turn recording on or off at runtime (on by default)
+      inline void set_enabled(const bool enabled);
+      inline bool enabled() const;
+      // Discard all recorded zones. Should not be called while zones are open.
+      inline void clear();
+      // Returns all recorded zones, ordered by thread then end time
+      inline std::vector<Zone> zones() const;
+      // Write recorded zones as Chrome trace event JSON
+      //
+      // Inputs:
+      //   filename  path to output .json file
+      // Returns true on success
+      inline bool write_chrome_trace(const std::string & filename) const;
+      // Print a flat summary (calls, total, self and mean time, bytes) of all
+      // zones with the same name, sorted by decreasing total time
+      //
+      // Inputs:
+      //   os  output stream
+      inline void print_summary(std::ostream & os) const;
+      // Microseconds since profiler creation
+      inline double now() const;
+      // Running count of bytes allocated by the calling thread (only counted
+      // with IGL_PROFILE_DEFINE_ALLOCATION_HOOKS)
+      inline static size_t & thread_allocated_bytes();
+      // Append a closed zone to the calling thread's log
+      inline void record(const Zone & zone);
+      // Small integer id of the calling thread
+      inline static int thread_id();
+    private:
+      inline Profiler();
+      Profiler(const Profiler &);
+      Profiler & operator=(const Profiler &);
+      struct ThreadLog
+      {
+        std::mutex mutex;
+        std::vector<Zone> zones;
+      };
+      inline ThreadLog & thread_log();
+      std::chrono::steady_clock::time_point m_epoch;
+      std::atomic<bool> m_enabled;
+      mutable std::mutex m_logs_mutex;
+      // Logs outlive their threads so that zones of finished threads are kept
+      std::vector<std::unique_ptr<ThreadLog> > m_logs;
+  };
+
+  // Opens a zone on construction and records it on destruction. Use through
+  // IGL_PROFILE_SCOPE.
+  class ProfileScope
+  {
+    public:
+      inline ProfileScope(const char * name);
+      inline ~ProfileScope();
+    private:
+      ProfileScope(const ProfileScope &);
+      ProfileScope & operator=(const ProfileScope &);
+      inline static ProfileScope *& current();
+      const char * m_name;
+      ProfileScope * m_parent;
+      int m_depth;
+      double m_start;
+      double m_children;
+      size_t m_bytes;
+      bool m_active;
+  };
+}
+
+#define IGL_PROFILE_CONCAT_(a,b) a##b
+#define IGL_PROFILE_CONCAT(a,b) IGL_PROFILE_CONCAT_(a,b)
+#ifdef IGL_PROFILE
+#  define IGL_PROFILE_SCOPE(name) \
+     igl::ProfileScope IGL_PROFILE_CONCAT(igl_profile_scope_,__LINE__)(name)
+#else
+#  define IGL_PROFILE_SCOPE(name)
+#endif
+
+#ifdef IGL_PROFILE
+#  include <cstdlib>
+#  include <new>
+// Replacement global allocation functions counting bytes per thread
+#  define IGL_PROFILE_DEFINE_ALLOCATION_HOOKS() \
+  void * operator new(std::size_t n) \
+  { \
+    igl::Profiler::thread_allocated_bytes() += n; \
+    if(void * p = std::malloc(n==0?1:n)) return p; \
+    throw std::bad_alloc(); \
+  } \
+  void * operator new[](std::size_t n) { return operator new(n); } \
+  void operator delete(void * p) noexcept { std::free(p); } \
+  void operator delete[](void * p) noexcept { std::free(p); } \
+  void operator delete(void * p, std::size_t) noexcept { std::free(p); } \
+  void operator delete[](void * p, std::size_t) noexcept { std::free(p); }
+#else
+#  define IGL_PROFILE_DEFINE_ALLOCATION_HOOKS()
+#endif
+
+// Implementation
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+inline igl::Profiler & igl::Profiler::instance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+inline igl::Profiler::Profiler():
+  m_epoch(std::chrono::steady_clock::now()),
+  m_enabled(true),
+  m_logs_mutex(),
+  m_logs()
+{
+}
+
+inline void igl::Profiler::set_enabled(const bool enabled)
+{
+  m_enabled = enabled;
+}
+
+inline bool igl::Profiler::enabled() const
+{
+  return m_enabled;
+}
+
+inline double igl::Profiler::now() const
+{
+  return std::chrono::duration<double,std::micro>(
+    std::chrono::steady_clock::now()-m_epoch).count();
+}
+
+inline size_t & igl::Profiler::thread_allocated_bytes()
+{
+  static thread_local size_t bytes = 0;
+  return bytes;
+}
+
+inline int igl::Profiler::thread_id()
+{
+  static std::atomic<int> next(0);
+  static thread_local int id = next++;
+  return id;
+}
+
+inline igl::Profiler::ThreadLog & igl::Profiler::thread_log()
+{
+  static thread_local ThreadLog * log = nullptr;
+  if(log == nullptr)
+  {
+    std::lock_guard<std::mutex> lock(m_logs_mutex);
+    m_logs.emplace_back(new ThreadLog());
+    log = m_logs.back().get();
+  }
+  return *log;
+}
+
+inline void igl::Profiler::record(const Zone & zone)
+{
+  ThreadLog & log = thread_log();
+  // Only ever contended while zones() or clear() runs
+  std::lock_guard<std::mutex> lock(log.mutex);
+  log.zones.push_back(zone);
+}
+
+inline void igl::Profiler::clear()
+{
+  std::lock_guard<std::mutex> lock(m_logs_mutex);
+  for(auto & log : m_logs)
+  {
+    std::lock_guard<std::mutex> log_lock(log->mutex);
+    log->zones.clear();
+  }
+}
+
+inline std::vector<igl::Profiler::Zone> igl::Profiler::zones() const
+{
+  std::vector<Zone> Z;
+  std::lock_guard<std::mutex> lock(m_logs_mutex);
+  for(const auto & log : m_logs)
+  {
+    std::lock_guard<std::mutex> log_lock(log->mutex);
+    Z.insert(Z.end(),log->zones.begin(),log->zones.end());
+  }
+  return Z;
+}
+
+inline bool igl::Profiler::write_chrome_trace(
+  const std::string & filename) const
+{
+  std::ofstream os(filename.c_str());
+  if(!os.good())
+  {
+    fprintf(stderr,"IOError: write_chrome_trace() could not open %s\n",
+      filename.c_str());
+    return false;
+  }
+  const std::vector<Zone> Z = zones();
+  os<<"{\"traceEvents\":[\n";
+  os<<std::fixed<<std::setprecision(3);
+  for(size_t z = 0;z<Z.size();z++)
+  {
+    std::string name(Z[z].name);
+    std::string escaped;
+    for(const char c : name)
+    {
+      if(c=='"' || c=='\\') escaped.push_back('\\');
+      escaped.push_back(c);
+    }
+    os<<"{\"name\":\""<<escaped<<"\",\"cat\":\"igl\",\"ph\":\"X\""<<
+      ",\"pid\":0,\"tid\":"<<Z[z].thread<<
+      ",\"ts\":"<<Z[z].start<<",\"dur\":"<<Z[z].duration<<
+      ",\"args\":{\"self_us\":"<<Z[z].self<<",\"bytes\":"<<Z[z].bytes<<"}}"<<
+      (z+1<Z.size()?",":"")<<"\n";
+  }
+  os<<"],\"displayTimeUnit\":\"ms\"}\n";
+  return os.good();
+}
+
+inline void igl::Profiler::print_summary(std::ostream & os) const
+{
+  struct Entry
+  {
+    std::string name;
+    size_t calls;
+    double total;
+    double self;
+    size_t bytes;
+  };
+  std::map<std::string,Entry> by_name;
+  for(const Zone & zone : zones())
+  {
+    Entry & e = by_name[zone.name];
+    e.name = zone.name;
+    e.calls++;
+    e.total += zone.duration;
+    e.self += zone.self;
+    e.bytes += zone.bytes;
+  }
+  std::vector<Entry> E;
+  for(const auto & kv : by_name)
+  {
+    E.push_back(kv.second);
+  }
+  std::sort(E.begin(),E.end(),
+    [](const Entry & a, const Entry & b){ return a.total > b.total; });
+  const std::ios::fmtflags flags = os.flags();
+  os<<std::left<<std::setw(40)<<"zone"<<std::right<<
+    std::setw(10)<<"calls"<<
+    std::setw(14)<<"total (ms)"<<
+    std::setw(14)<<"self (ms)"<<
+    std::setw(14)<<"mean (ms)"<<
+    std::setw(16)<<"bytes"<<"\n";
+  os<<std::fixed<<std::setprecision(3);
+  for(const Entry & e : E)
+  {
+    os<<std::left<<std::setw(40)<<e.name<<std::right<<
+      std::setw(10)<<e.calls<<
+      std::setw(14)<<e.total*1e-3<<
+      std::setw(14)<<e.self*1e-3<<
+      std::setw(14)<<e.total*1e-3/e.calls<<
+      std::setw(16)<<e.bytes<<"\n";
+  }
+  os.flags(flags);
+}
+
+inline igl::ProfileScope *& igl::ProfileScope::current()
+{
+  static thread_local ProfileScope * scope = nullptr;
+  return scope;
+}
+
+inline igl::ProfileScope::ProfileScope(const char * name):
+  m_name(name),
+  m_parent(nullptr),
+  m_depth(0),
+  m_start(0),
+  m_children(0),
+  m_bytes(0),
+  m_active(Profiler::instance().enabled())
+{
+  if(!m_active)
+  {
+    return;
+  }
+  m_parent = current();
+  m_depth = m_parent ? m_parent->m_depth+1 : 0;
+  current() = this;
+  m_bytes = Profiler::thread_allocated_bytes();
+  m_start = Profiler::instance().now();
+}
+
+inline igl::ProfileScope::~ProfileScope()
+{
+  if(!m_active)
+  {
+    return;
+  }
+  Profiler & profiler = Profiler::instance();
+  Profiler::Zone zone;
+  zone.name = m_name;
+  zone.thread = Profiler::thread_id();
+  zone.depth = m_depth;
+  zone.start = m_start;
+  zone.duration = profiler.now()-m_start;
+  zone.self = zone.duration-m_children;
+  zone.bytes = Profiler::thread_allocated_bytes()-m_bytes;
+  current() = m_parent;
+  if(m_parent)
+  {
+    m_parent->m_children += zone.duration;
+  }
+  profiler.record(zone);
+}
+
+#endif
@@ -0,0 +1,508 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "SignedDistanceField.h"
+#include "parallel_for.h"
+#include "parallel_sort.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+namespace igl
+{
+  namespace signed_distance_field
+  {
+    // Weights w (and derivatives dw) of the samples at offsets first, ...,
+    // first+n-1 from a cell at local coordinate t∈[0,1]
+    //
+    // Returns first
+    inline int weights(
+      const bool cubic,
+      const double t,
+      double * w,
+      double * dw)
+    {
+      if(cubic)
+      {
+        // Catmull-Rom
+        const double t2 = t*t;
+        const double t3 = t2*t;
+        w[0] = 0.5*(-t3+2.*t2-t);
+        w[1] = 0.5*(3.*t3-5.*t2+2.);
+        w[2] = 0.5*(-3.*t3+4.*t2+t);
+        w[3] = 0.5*(t3-t2);
+        dw[0] = 0.5*(-3.*t2+4.*t-1.);
+        dw[1] = 0.5*(9.*t2-10.*t);
+        dw[2] = 0.5*(-9.*t2+8.*t+1.);
+        dw[3] = 0.5*(3.*t2-2.*t);
+        return -1;
+      }
+      w[0] = 1.-t;
+      w[1] = t;
+      dw[0] = -1.;
+      dw[1] = 1.;
+      return 0;
+    }
+    // Interpolate samples f(a,b,c) about cell ijk at local coordinates t
+    //
+    // Outputs:
+    //   g  gradient with respect to t
+    // Returns interpolated value
+    template <typename Func>
+    inline double interpolate(
+      const Func & f,
+      const int * ijk,
+      const double * t,
+      const bool cubic,
+      double * g)
+    {
+      const int n = cubic ? 4 : 2;
+      double w[3][4],dw[3][4];
+      int first = 0;
+      for(int d = 0;d<3;d++)
+      {
+        first = weights(cubic,t[d],w[d],dw[d]);
+      }
+      double v = 0;
+      g[0] = g[1] = g[2] = 0;
+      for(int c = 0;c<n;c++)
+      {
+        for(int b = 0;b<n;b++)
+        {
+          for(int a = 0;a<n;a++)
+          {
+            const double fabc =
+              f(ijk[0]+first+a,ijk[1]+first+b,ijk[2]+first+c);
+            v += w[0][a]*w[1][b]*w[2][c]*fabc;
+            g[0] += dw[0][a]*w[1][b]*w[2][c]*fabc;
+            g[1] += w[0][a]*dw[1][b]*w[2][c]*fabc;
+            g[2] += w[0][a]*w[1][b]*dw[2][c]*fabc;
+          }
+        }
+      }
+      return v;
+    }
+  }
+}
+
+IGL_INLINE void igl::SignedDistanceField::deinit()
+{
+  m_res.setZero();
+  m_refinement = 0;
+  m_coarse.resize(0);
+  m_blocks.resize(0);
+  m_fine.resize(0);
+}
+
+IGL_INLINE bool igl::SignedDistanceField::empty() const
+{
+  return m_coarse.size() == 0;
+}
+
+IGL_INLINE void igl::SignedDistanceField::init(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const SignedDistanceType sign_type,
+  const int resolution,
+  const int refinement,
+  const double tolerance,
+  const double padding)
+{
+  using namespace Eigen;
+  assert(V.cols() == 3 && "V should be 3D");
+  assert(resolution > 0 && "resolution should be positive");
+  assert(refinement > 0 && "refinement should be positive");
+  deinit();
+  if(F.rows() == 0)
+  {
+    return;
+  }
+  m_refinement = refinement;
+  const RowVector3d bmin = V.colwise().minCoeff();
+  const RowVector3d bmax = V.colwise().maxCoeff();
+  const RowVector3d extent =
+    (bmax-bmin).array()+2.*padding*(bmax-bmin).norm();
+  m_h = extent.maxCoeff()/resolution;
+  if(!(m_h > 0))
+  {
+    m_h = 1;
+  }
+  for(int d = 0;d<3;d++)
+  {
+    m_res(d) = std::max(1,(int)std::ceil(extent(d)/m_h));
+  }
+  m_min = 0.5*(bmin+bmax) - 0.5*m_h*m_res.cast<double>();
+
+  // Sample coarse nodes and coarse cell centers in one go
+  const RowVector3i n = m_res.array()+1;
+  const int num_nodes = n.prod();
+  const int num_cells = m_res.prod();
+  MatrixXd P(num_nodes+num_cells,3);
+  parallel_for(num_nodes,[this,&n,&P](const int i)
+  {
+    const RowVector3d x(i%n(0),(i/n(0))%n(1),i/(n(0)*n(1)));
+    P.row(i) = m_min + m_h*x;
+  },1000);
+  parallel_for(num_cells,[this,num_nodes,&P](const int i)
+  {
+    const RowVector3d x(
+      i%m_res(0)+0.5,(i/m_res(0))%m_res(1)+0.5,i/(m_res(0)*m_res(1))+0.5);
+    P.row(num_nodes+i) = m_min + m_h*x;
+  },1000);
+  VectorXd S;
+  VectorXi I;
+  MatrixXd C,N;
+  igl::signed_distance(P,V,F,sign_type,S,I,C,N);
+  m_coarse = S.head(num_nodes);
+
+  const auto & coarse = [this,&n](const int x,const int y,const int z)->double
+  {
+    return m_coarse(x+n(0)*(y+n(1)*z));
+  };
+
+  // Refine cells that may contain the surface (distance is 1-Lipschitz)
+  m_blocks.resize(num_cells);
+  const double half_diagonal = 0.5*std::sqrt(3.)*m_h;
+  parallel_for(num_cells,[this,num_nodes,&S,half_diagonal](const int i)
+  {
+    m_blocks(i) = std::abs(S(num_nodes+i)) < half_diagonal ? 1 : -1;
+  },1000);
+  // ... and the others if interpolating their corners is off by more than
+  // tolerance*m_h at their center, face centers or edge midpoints. These
+  // test points are addressed by their integer coordinates H on the half
+  // lattice of the grid (coarse node ijk is at H=2*ijk), shared ones are
+  // sampled once.
+  const RowVector3i nh = m_res.array()*2+1;
+  const auto & half_key = [&nh](const int * H)->int64_t
+  {
+    return H[0] + (int64_t)nh(0)*(H[1] + (int64_t)nh(1)*H[2]);
+  };
+  // Corners (all even) and centers (all odd) are already sampled
+  const auto & is_test_point = [](const int a,const int b,const int c)->bool
+  {
+    return ((a|b|c)&1) && !((a&b&c)&1);
+  };
+  std::vector<int64_t> test_keys;
+  for(int i = 0;i<num_cells;i++)
+  {
+    if(m_blocks(i) >= 0)
+    {
+      continue;
+    }
+    const int cell[3] =
+      {i%m_res(0),(i/m_res(0))%m_res(1),i/(m_res(0)*m_res(1))};
+    for(int c = 0;c<3;c++)
+    {
+      for(int b = 0;b<3;b++)
+      {
+        for(int a = 0;a<3;a++)
+        {
+          if(is_test_point(a,b,c))
+          {
+            const int H[3] = {2*cell[0]+a,2*cell[1]+b,2*cell[2]+c};
+            test_keys.push_back(half_key(H));
+          }
+        }
+      }
+    }
+  }
+  parallel_sort(test_keys.begin(),test_keys.end(),std::less<int64_t>());
+  test_keys.erase(
+    std::unique(test_keys.begin(),test_keys.end()),test_keys.end());
+  MatrixXd PT(test_keys.size(),3);
+  parallel_for(test_keys.size(),[this,&test_keys,&nh,&PT](const int u)
+  {
+    const int64_t key = test_keys[u];
+    const RowVector3d H(
+      key%nh(0),(key/nh(0))%nh(1),key/((int64_t)nh(0)*nh(1)));
+    PT.row(u) = m_min + 0.5*m_h*H;
+  },1000);
+  VectorXd ST;
+  igl::signed_distance(PT,V,F,sign_type,ST,I,C,N);
+  parallel_for(num_cells,
+    [this,num_nodes,&S,&test_keys,&ST,&half_key,&is_test_point,&coarse,
+      tolerance](const int i)
+  {
+    if(m_blocks(i) >= 0)
+    {
+      return;
+    }
+    const int cell[3] =
+      {i%m_res(0),(i/m_res(0))%m_res(1),i/(m_res(0)*m_res(1))};
+    for(int c = 0;c<3;c++)
+    {
+      for(int b = 0;b<3;b++)
+      {
+        for(int a = 0;a<3;a++)
+        {
+          double exact;
+          if(is_test_point(a,b,c))
+          {
+            const int H[3] = {2*cell[0]+a,2*cell[1]+b,2*cell[2]+c};
+            exact = ST(std::lower_bound(
+              test_keys.begin(),test_keys.end(),half_key(H)) -
+              test_keys.begin());
+          }else if((a&b&c)&1)
+          {
+            exact = S(num_nodes+i);
+          }else
+          {
+            continue;
+          }
+          const double t[3] = {0.5*a,0.5*b,0.5*c};
+          double gt[3];
+          const double value =
+            signed_distance_field::interpolate(coarse,cell,t,false,gt);
+          if(std::abs(value-exact) > tolerance*m_h)
+          {
+            m_blocks(i) = 1;
+            return;
+          }
+        }
+      }
+    }
+  },100);
+  std::vector<int> block_cells;
+  for(int i = 0;i<num_cells;i++)
+  {
+    if(m_blocks(i) >= 0)
+    {
+      m_blocks(i) = block_cells.size();
+      block_cells.push_back(i);
+    }
+  }
+
+  // Fine nodes of refined cells, addressed by their integer coordinates G on
+  // the fine lattice over the whole grid (coarse node ijk is at G=ijk*r)
+  const int r = refinement;
+  const int nf = r+3;
+  const int block_size = nf*nf*nf;
+  const RowVector3i nl = m_res.array()*r+3;
+  const auto & lattice_key = [&nl](const int * G)->int64_t
+  {
+    return (G[0]+1) + (int64_t)nl(0)*((G[1]+1) + (int64_t)nl(1)*(G[2]+1));
+  };
+  // A fine node on the boundary of a refined cell that also touches an
+  // unrefined cell takes the value interpolated from the coarse nodes (as
+  // that cell does), so that trilinear interpolation is continuous across
+  // faces between refined and unrefined cells. Every other fine node
+  // (including the outer layer only used by tricubic interpolation) is an
+  // exact sample, computed once even if shared by several blocks.
+  const auto & is_constrained = [this,r](const int * G)->bool
+  {
+    int lo[3],hi[3];
+    for(int d = 0;d<3;d++)
+    {
+      const int c = G[d] >= 0 ? G[d]/r : -1;
+      lo[d] = std::max(0,G[d]%r == 0 ? c-1 : c);
+      hi[d] = std::min(m_res(d)-1,c);
+    }
+    for(int z = lo[2];z<=hi[2];z++)
+    {
+      for(int y = lo[1];y<=hi[1];y++)
+      {
+        for(int x = lo[0];x<=hi[0];x++)
+        {
+          if(m_blocks(x+m_res(0)*(y+m_res(1)*z)) < 0)
+          {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  };
+  const auto & coarse_value = [this,&coarse,r](const int * G)->double
+  {
+    int cell[3];
+    double t[3],gt[3];
+    for(int d = 0;d<3;d++)
+    {
+      cell[d] = std::max(0,std::min(m_res(d)-1,G[d]/r));
+      t[d] = double(G[d]-cell[d]*r)/r;
+    }
+    return signed_distance_field::interpolate(coarse,cell,t,false,gt);
+  };
+  // Lattice key of each fine node or -1 if it is constrained
+  std::vector<int64_t> keys(block_cells.size()*block_size);
+  parallel_for(block_cells.size(),
+    [this,&block_cells,r,nf,block_size,&keys,&lattice_key,&is_constrained](
+      const int b)
+  {
+    const int i = block_cells[b];
+    const int cell[3] =
+      {i%m_res(0),(i/m_res(0))%m_res(1),i/(m_res(0)*m_res(1))};
+    for(int k = 0;k<block_size;k++)
+    {
+      const int l[3] = {k%nf-1,(k/nf)%nf-1,k/(nf*nf)-1};
+      const int G[3] = {cell[0]*r+l[0],cell[1]*r+l[1],cell[2]*r+l[2]};
+      const bool in_cell =
+        l[0] >= 0 && l[0] <= r && l[1] >= 0 && l[1] <= r &&
+        l[2] >= 0 && l[2] <= r;
+      keys[(size_t)b*block_size+k] =
+        in_cell && is_constrained(G) ? -1 : lattice_key(G);
+    }
+  },10);
+  std::vector<int64_t> unique_keys;
+  unique_keys.reserve(keys.size());
+  for(const int64_t key : keys)
+  {
+    if(key >= 0)
+    {
+      unique_keys.push_back(key);
+    }
+  }
+  parallel_sort(unique_keys.begin(),unique_keys.end(),std::less<int64_t>());
+  unique_keys.erase(
+    std::unique(unique_keys.begin(),unique_keys.end()),unique_keys.end());
+  MatrixXd PF(unique_keys.size(),3);
+  parallel_for(unique_keys.size(),[this,&unique_keys,&nl,r,&PF](const int u)
+  {
+    const int64_t key = unique_keys[u];
+    const RowVector3d G(
+      key%nl(0)-1,(key/nl(0))%nl(1)-1,key/((int64_t)nl(0)*nl(1))-1);
+    PF.row(u) = m_min + m_h*G/r;
+  },1000);
+  VectorXd SF;
+  igl::signed_distance(PF,V,F,sign_type,SF,I,C,N);
+  m_fine.resize(keys.size());
+  parallel_for(block_cells.size(),
+    [this,&block_cells,r,nf,block_size,&keys,&unique_keys,&SF,&coarse_value](
+      const int b)
+  {
+    const int i = block_cells[b];
+    const int cell[3] =
+      {i%m_res(0),(i/m_res(0))%m_res(1),i/(m_res(0)*m_res(1))};
+    for(int k = 0;k<block_size;k++)
+    {
+      const size_t f = (size_t)b*block_size+k;
+      if(keys[f] < 0)
+      {
+        const int G[3] = {
+          cell[0]*r + k%nf-1,
+          cell[1]*r + (k/nf)%nf-1,
+          cell[2]*r + k/(nf*nf)-1};
+        m_fine(f) = coarse_value(G);
+      }else
+      {
+        m_fine(f) = SF(std::lower_bound(
+          unique_keys.begin(),unique_keys.end(),keys[f])-unique_keys.begin());
+      }
+    }
+  },10);
+}
+
+IGL_INLINE double igl::SignedDistanceField::signed_distance(
+  const Eigen::RowVector3d & q,
+  const SignedDistanceFieldInterpolation interpolation) const
+{
+  Eigen::RowVector3d g;
+  return signed_distance(q,g,interpolation);
+}
+
+IGL_INLINE double igl::SignedDistanceField::signed_distance(
+  const Eigen::RowVector3d & q,
+  Eigen::RowVector3d & g,
+  const SignedDistanceFieldInterpolation interpolation) const
+{
+  using namespace Eigen;
+  if(empty())
+  {
+    g.setZero();
+    return std::numeric_limits<double>::infinity();
+  }
+  const bool cubic =
+    interpolation == SIGNED_DISTANCE_FIELD_INTERPOLATION_TRICUBIC;
+  // Locate coarse cell of closest point on grid
+  RowVector3d c;
+  int cell[3];
+  double t[3];
+  for(int d = 0;d<3;d++)
+  {
+    c(d) = std::max(m_min(d),std::min(m_min(d)+m_res(d)*m_h,q(d)));
+    const double u = (c(d)-m_min(d))/m_h;
+    cell[d] = std::max(0,std::min(m_res(d)-1,(int)std::floor(u)));
+    t[d] = u-cell[d];
+  }
+  const int b = m_blocks(cell[0]+m_res(0)*(cell[1]+m_res(1)*cell[2]));
+  double s;
+  double gt[3];
+  double h;
+  if(b < 0)
+  {
+    const RowVector3i n = m_res.array()+1;
+    s = signed_distance_field::interpolate(
+      [this,&n](int x,int y,int z)->double
+      {
+        // Repeat boundary samples for cubic interpolation
+        x = std::max(0,std::min(n(0)-1,x));
+        y = std::max(0,std::min(n(1)-1,y));
+        z = std::max(0,std::min(n(2)-1,z));
+        return m_coarse(x+n(0)*(y+n(1)*z));
+      },cell,t,cubic,gt);
+    h = m_h;
+  }else
+  {
+    // Locate fine cell within block
+    const int nf = m_refinement+3;
+    const double * block = m_fine.data()+(size_t)b*nf*nf*nf;
+    int fine_cell[3];
+    double fine_t[3];
+    for(int d = 0;d<3;d++)
+    {
+      const double u = t[d]*m_refinement;
+      fine_cell[d] = std::min(m_refinement-1,(int)u);
+      fine_t[d] = u-fine_cell[d];
+    }
+    s = signed_distance_field::interpolate(
+      [block,nf](const int x,const int y,const int z)->double
+      {
+        return block[(x+1)+nf*((y+1)+nf*(z+1))];
+      },fine_cell,fine_t,cubic,gt);
+    h = m_h/m_refinement;
+  }
+  for(int d = 0;d<3;d++)
+  {
+    g(d) = gt[d]/h;
+  }
+  // Outside grid add distance to it
+  const RowVector3d e = q-c;
+  const double e_norm = e.norm();
+  if(e_norm > 0)
+  {
+    for(int d = 0;d<3;d++)
+    {
+      if(q(d) != c(d))
+      {
+        g(d) = 0;
+      }
+    }
+    g += e/e_norm;
+    s += e_norm;
+  }
+  return s;
+}
+
+IGL_INLINE void igl::SignedDistanceField::signed_distance(
+  const Eigen::MatrixXd & Q,
+  const SignedDistanceFieldInterpolation interpolation,
+  Eigen::VectorXd & S,
+  Eigen::MatrixXd & G) const
+{
+  assert((Q.rows() == 0 || Q.cols() == 3) && "Q should be 3D");
+  S.resize(Q.rows());
+  G.resize(Q.rows(),3);
+  parallel_for(Q.rows(),[this,&Q,interpolation,&S,&G](const int q)
+  {
+    Eigen::RowVector3d g;
+    S(q) = signed_distance(Eigen::RowVector3d(Q.row(q)),g,interpolation);
+    G.row(q) = g;
+  },1000);
+}
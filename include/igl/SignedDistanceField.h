@@ -0,0 +1,178 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_SIGNEDDISTANCEFIELD_H
+#define IGL_SIGNEDDISTANCEFIELD_H
+
+#include "igl_inline.h"
+#include "signed_distance.h"
+#include "serialize.h"
+#include <Eigen/Core>
+#include <vector>
+namespace igl
+{
+  enum SignedDistanceFieldInterpolation
+  {
+    // Continuous (also across refined/unrefined cells), exact at samples
+    SIGNED_DISTANCE_FIELD_INTERPOLATION_TRILINEAR = 0,
+    // Catmull-Rom splines through samples, smoother gradients but not
+    // continuous across the boundaries of refined cells (blocks)
+    SIGNED_DISTANCE_FIELD_INTERPOLATION_TRICUBIC = 1,
+    NUM_SIGNED_DISTANCE_FIELD_INTERPOLATION = 2
+  };
+  // Sampled signed distance to a static mesh for fast repeated queries.
+  //
+  // Distances are sampled on a coarse grid over the (padded) bounding box of
+  // the mesh. Coarse cells that may contain the surface, or that their
+  // corners do not interpolate within tolerance (see init), are refined into
+  // a block of finer samples. Fine samples on the boundary of a refined cell
+  // that also touch an unrefined cell take the coarse interpolated value, so
+  // both sides agree on shared faces. A query is a constant-time lookup of
+  // the cell (and block) containing it followed by interpolation,
+  // independent of the size of the mesh.
+  //
+  // Points outside the grid get the value at the closest point on the grid
+  // plus the distance to it.
+  //
+  // Example:
+  //   igl::SignedDistanceField sdf;
+  //   sdf.init(V,F);
+  //   Eigen::RowVector3d g;
+  //   const double s = sdf.signed_distance(q,g);
+  //   igl::serialize(sdf,"sdf","sdf.bin");
+  class SignedDistanceField
+  {
+  public:
+    // Corner of the grid with smallest coordinates
+    Eigen::RowVector3d m_min;
+    // Edge length of coarse cells
+    double m_h;
+    // Number of coarse cells along each axis
+    Eigen::RowVector3i m_res;
+    // Number of fine cells along each axis of a refined coarse cell
+    int m_refinement;
+    // (m_res+1).prod() list of values at coarse grid nodes, x fastest
+    Eigen::VectorXd m_coarse;
+    // m_res.prod() list of indices of refined blocks for each coarse cell (x
+    // fastest), -1 if the cell is not refined
+    Eigen::VectorXi m_blocks;
+    // #blocks*(m_refinement+3)³ list of values at fine grid nodes of each
+    // refined block, including one layer of nodes outside the cell, x fastest
+    Eigen::VectorXd m_fine;
+    SignedDistanceField():
+      m_min(0,0,0),
+      m_h(0),
+      m_res(0,0,0),
+      m_refinement(0),
+      m_coarse(),
+      m_blocks(),
+      m_fine()
+    {}
+    IGL_INLINE void deinit();
+    // Return whether there are no samples
+    IGL_INLINE bool empty() const;
+    // Sample signed distance to a mesh (in parallel)
+    //
+    // Inputs:
+    //   V  #V by 3 list of vertex positions
+    //   F  #F by 3 list of triangle indices into V
+    //   sign_type  method for computing the sign (see igl::signed_distance)
+    //   resolution  number of coarse cells along longest side of bounding box
+    //     {32}
+    //   refinement  number of fine cells along each side of a refined coarse
+    //     cell {8}
+    //   tolerance  coarse cells away from the surface are refined if
+    //     trilinear interpolation of their corners is off by more than
+    //     tolerance times their edge length at their center, face centers or
+    //     edge midpoints {0.1}. The error of unrefined cells is only bounded
+    //     at these points. In refined cells it is at most sqrt(3)/2 times the
+    //     fine edge length (the distance is 1-Lipschitz), plus, next to
+    //     unrefined cells, the error of the coarse values taken on shared
+    //     faces.
+    //   padding  grid extends beyond bounding box by padding times its
+    //     diagonal {0.1}
+    IGL_INLINE void init(
+      const Eigen::MatrixXd & V,
+      const Eigen::MatrixXi & F,
+      const SignedDistanceType sign_type = SIGNED_DISTANCE_TYPE_DEFAULT,
+      const int resolution = 32,
+      const int refinement = 8,
+      const double tolerance = 0.1,
+      const double padding = 0.1);
+    // Interpolated signed distance at a point
+    //
+    // Inputs:
+    //   q  query point
+    //   interpolation  interpolation scheme {trilinear}
+    // Returns interpolated signed distance
+    IGL_INLINE double signed_distance(
+      const Eigen::RowVector3d & q,
+      const SignedDistanceFieldInterpolation interpolation =
+        SIGNED_DISTANCE_FIELD_INTERPOLATION_TRILINEAR) const;
+    // Outputs:
+    //   g  gradient of the interpolated signed distance at q
+    IGL_INLINE double signed_distance(
+      const Eigen::RowVector3d & q,
+      Eigen::RowVector3d & g,
+      const SignedDistanceFieldInterpolation interpolation =
+        SIGNED_DISTANCE_FIELD_INTERPOLATION_TRILINEAR) const;
+    // Interpolated signed distances and gradients at many points (in
+    // parallel)
+    //
+    // Inputs:
+    //   Q  #Q by 3 list of query points
+    //   interpolation  interpolation scheme
+    // Outputs:
+    //   S  #Q list of signed distances
+    //   G  #Q by 3 list of gradients
+    IGL_INLINE void signed_distance(
+      const Eigen::MatrixXd & Q,
+      const SignedDistanceFieldInterpolation interpolation,
+      Eigen::VectorXd & S,
+      Eigen::MatrixXd & G) const;
+  };
+}
+
+namespace igl
+{
+  namespace serialization
+  {
+    inline void serialization(
+      bool s,
+      igl::SignedDistanceField & obj,
+      std::vector<char> & buffer)
+    {
+      SERIALIZE_MEMBER(m_min);
+      SERIALIZE_MEMBER(m_h);
+      SERIALIZE_MEMBER(m_res);
+      SERIALIZE_MEMBER(m_refinement);
+      SERIALIZE_MEMBER(m_coarse);
+      SERIALIZE_MEMBER(m_blocks);
+      SERIALIZE_MEMBER(m_fine);
+    }
+    template<>
+    inline void serialize(
+      const igl::SignedDistanceField & obj,
+      std::vector<char> & buffer)
+    {
+      serialization(true,const_cast<igl::SignedDistanceField&>(obj),buffer);
+    }
+    template<>
+    inline void deserialize(
+      igl::SignedDistanceField & obj,
+      const std::vector<char> & buffer)
+    {
+      serialization(false,obj,const_cast<std::vector<char>&>(buffer));
+    }
+  }
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "SignedDistanceField.cpp"
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_THREADPOOL_H
+#define IGL_THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace igl
+{
+  // Process-wide pool of persistent worker threads. Each worker owns a deque
+  // of jobs: it pops its own jobs from the back (LIFO, cache-warm) and, when
+  // idle, steals from the front of other workers' deques (FIFO). Workers are
+  // created lazily the first time they are needed and live until the process
+  // exits, so repeated calls to igl::parallel_for do not pay for thread
+  // creation.
+  //
+  // Typically one does not use this class directly but rather through
+  // igl::parallel_for.
+  //
+  // Example:
+  //   // Never use more than 4 threads (including the calling thread)
+  //   igl::ThreadPool::instance().set_num_threads(4);
+  class ThreadPool
+  {
+    public:
+      typedef std::function<void()> Job;
+      // Returns the single process-wide pool
+      inline static ThreadPool & instance();
+      // Set the maximum number of threads participating in a parallel loop,
+      // counting the calling thread. Workers are spawned lazily, so this may
+      // be called at any time; loops already running keep their threads.
+      //
+      // Inputs:
+      //   n  number of threads, 0 means std::thread::hardware_concurrency()
+      inline void set_num_threads(const size_t n);
+      // Returns maximum number of threads participating in a parallel loop
+      // (>=1, counting the calling thread)
+      inline size_t num_threads() const;
+      // Set the default number of loop iterations executed as one unit of work
+      // by igl::parallel_for.
+      //
+      // Inputs:
+      //   g  grain size, 0 means choose automatically based on loop size
+      inline void set_grain_size(const size_t g);
+      inline size_t grain_size() const;
+      // Push a job onto the deque of the calling worker (or distribute
+      // round-robin when called from a thread outside of the pool) and wake
+      // up an idle worker.
+      //
+      // Inputs:
+      //   job  function to be executed by some worker
+      inline void submit(Job job);
+      // Make sure at least n workers exist (never more than num_threads()-1)
+      //
+      // Inputs:
+      //   n  number of desired workers
+      // Returns number of workers the caller may use: min(n,num_threads()-1)
+      //   even if more workers exist from earlier calls
+      inline size_t reserve_workers(const size_t n);
+      // Returns index of the calling worker thread or -1 if the calling
+      // thread does not belong to the pool
+      inline static int worker_index();
+      inline ~ThreadPool();
+    private:
+      inline ThreadPool();
+      ThreadPool(const ThreadPool &);
+      ThreadPool & operator=(const ThreadPool &);
+      struct Worker
+      {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+      };
+      inline static int & this_worker_index();
+      inline void run(const size_t w);
+      // Pop from own deque or steal from others
+      inline bool try_pop(const size_t w, Job & job);
+      // Workers are never destroyed before the pool so pointers are stable
+      std::vector<std::unique_ptr<Worker> > m_workers;
+      std::atomic<size_t> m_num_workers;
+      std::mutex m_spawn_mutex;
+      std::mutex m_sleep_mutex;
+      std::condition_variable m_sleep;
+      std::atomic<size_t> m_pending;
+      std::atomic<size_t> m_next;
+      std::atomic<size_t> m_num_threads;
+      std::atomic<size_t> m_grain_size;
+      std::atomic<bool> m_stop;
+  };
+}
+
+// Implementation
+#include <algorithm>
+#include <cstdlib>
+
+inline igl::ThreadPool & igl::ThreadPool::instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+inline igl::ThreadPool::ThreadPool():
+  m_workers(),
+  m_num_workers(0),
+  m_pending(0),
+  m_next(0),
+  m_num_threads(0),
+  m_grain_size(0),
+  m_stop(false)
+{
+  set_num_threads(0);
+  // Worker slots are allocated up front so that m_workers is never
+  // reallocated while other threads read from it.
+  const size_t max_workers =
+    std::max(num_threads(),(size_t)std::thread::hardware_concurrency())*4;
+  m_workers.resize(max_workers);
+}
+
+inline igl::ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_stop = true;
+  }
+  m_sleep.notify_all();
+  const size_t nw = m_num_workers;
+  for(size_t w = 0;w<nw;w++)
+  {
+    if(m_workers[w]->thread.joinable())
+    {
+      m_workers[w]->thread.join();
+    }
+  }
+}
+
+inline void igl::ThreadPool::set_num_threads(const size_t n)
+{
+  size_t nt = n;
+  if(nt == 0)
+  {
+    // http://ideone.com/Z7zldb
+    const size_t sthc = std::thread::hardware_concurrency();
+    nt = sthc==0?8:sthc;
+  }
+  if(!m_workers.empty())
+  {
+    nt = std::min(nt,m_workers.size()+1);
+  }
+  m_num_threads = nt;
+}
+
+inline size_t igl::ThreadPool::num_threads() const
+{
+  return m_num_threads;
+}
+
+inline void igl::ThreadPool::set_grain_size(const size_t g)
+{
+  m_grain_size = g;
+}
+
+inline size_t igl::ThreadPool::grain_size() const
+{
+  return m_grain_size;
+}
+
+inline int & igl::ThreadPool::this_worker_index()
+{
+  static thread_local int index = -1;
+  return index;
+}
+
+inline int igl::ThreadPool::worker_index()
+{
+  return this_worker_index();
+}
+
+inline size_t igl::ThreadPool::reserve_workers(const size_t n)
+{
+  const size_t target = std::min(n,num_threads()-1);
+  // The pool may have grown for an earlier, larger request: hand out no
+  // more than asked for so that lowering num_threads() caps concurrency
+  if(m_num_workers >= target)
+  {
+    return target;
+  }
+  std::lock_guard<std::mutex> lock(m_spawn_mutex);
+  while(m_num_workers < target)
+  {
+    const size_t w = m_num_workers;
+    m_workers[w].reset(new Worker());
+    m_workers[w]->thread = std::thread(&ThreadPool::run,this,w);
+    // Publish only after the worker is fully constructed
+    m_num_workers++;
+  }
+  return std::min<size_t>(m_num_workers,target);
+}
+
+inline void igl::ThreadPool::submit(Job job)
+{
+  const size_t nw = m_num_workers;
+  if(nw == 0)
+  {
+    // Nobody to hand this to
+    job();
+    return;
+  }
+  const int self = this_worker_index();
+  const size_t w =
+    (self >= 0 && (size_t)self < nw) ? (size_t)self : (m_next++ % nw);
+  // Count before publishing so that m_pending never underflows
+  {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_pending++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_workers[w]->mutex);
+    m_workers[w]->jobs.push_back(std::move(job));
+  }
+  m_sleep.notify_one();
+}
+
+inline bool igl::ThreadPool::try_pop(const size_t w, Job & job)
+{
+  {
+    Worker & self = *m_workers[w];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if(!self.jobs.empty())
+    {
+      job = std::move(self.jobs.back());
+      self.jobs.pop_back();
+      m_pending--;
+      return true;
+    }
+  }
+  const size_t nw = m_num_workers;
+  for(size_t k = 1;k<nw;k++)
+  {
+    Worker & victim = *m_workers[(w+k)%nw];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if(!victim.jobs.empty())
+    {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      m_pending--;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void igl::ThreadPool::run(const size_t w)
+{
+  this_worker_index() = (int)w;
+  Job job;
+  while(true)
+  {
+    if(try_pop(w,job))
+    {
+      job();
+      job = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    m_sleep.wait(lock,[this]{ return m_stop || m_pending > 0; });
+    if(m_stop)
+    {
+      return;
+    }
+  }
+}
+
+#endif
@@ -9,36 +9,32 @@
 #define IGL_WINDINGNUMBERTREE_H
 #include <list>
 #include <map>
+#include <mutex>
 #include <Eigen/Dense>
 #include "WindingNumberMethod.h"
 
 namespace igl
 {
-  // This is only need to fill in references, it should never actually be touched
-  // and shouldn't cause race conditions. (This is a hack, but I think it's "safe")
-  static Eigen::MatrixXd dummyV;
   // Space partitioning tree for computing winding number hierarchically.
   //
+  // Queries (winding_number) only read the tree, or its per-node cache under
+  // a lock, so they may be issued from several threads at once.
+  //
   // Templates:
   //   Point  type for points in space, e.g. Eigen::Vector3d
   template <typename Point>
   class WindingNumberTree
   {
-    public:
-      // Method to use (see enum above)
-      //static double min_max_w;
-      static std::map< 
-        std::pair<const WindingNumberTree*,const WindingNumberTree*>, double>
-          cached;
     protected:
+      // Method to use (see enum above)
       WindingNumberMethod method;
       const WindingNumberTree * parent;
       std::list<WindingNumberTree * > children;
       //// List of boundary edges (recall edges are vertices in 2d)
       //const Eigen::MatrixXi boundary;
-      // Base mesh vertices
+      // Base mesh vertices (the root's SV, shared by all descendants)
       Eigen::MatrixXd & V;
-      // Base mesh vertices with duplicates removed
+      // Base mesh vertices with duplicates removed (only set for the root)
       Eigen::MatrixXd SV;
       // Facets in this bounding volume
       Eigen::MatrixXi F;
@@ -48,6 +44,10 @@ namespace igl
       double radius;
       // (Approximate) center (of mass)
       Point center;
+      // Winding numbers of the boundaries of other nodes `that` evaluated at
+      // this->center (see cached_winding_number)
+      mutable std::map<const WindingNumberTree*,double> cache;
+      mutable std::mutex cache_mutex;
     public:
       inline WindingNumberTree();
       // For root
@@ -139,25 +139,19 @@ namespace igl
 #include <iostream>
 #include <limits>
 
-//template <typename Point>
-//WindingNumberMethod WindingNumberTree<Point>::method = EXACT_WINDING_NUMBER_METHOD;
-//template <typename Point>
-//double WindingNumberTree<Point>::min_max_w = 0;
-template <typename Point>
-std::map< std::pair<const igl::WindingNumberTree<Point>*,const igl::WindingNumberTree<Point>*>, double>
-  igl::WindingNumberTree<Point>::cached;
-
 template <typename Point>
 inline igl::WindingNumberTree<Point>::WindingNumberTree():
   method(EXACT_WINDING_NUMBER_METHOD),
   parent(NULL),
-  V(igl::dummyV),
+  V(SV),
   SV(),
   F(),
   //boundary(igl::boundary_facets<Eigen::MatrixXi,Eigen::MatrixXi>(F))
   cap(),
   radius(std::numeric_limits<double>::infinity()),
-  center(0,0,0)
+  center(0,0,0),
+  cache(),
+  cache_mutex()
 {
 }
 
@@ -167,13 +161,15 @@ inline igl::WindingNumberTree<Point>::WindingNumberTree(
   const Eigen::MatrixXi & _F):
   method(EXACT_WINDING_NUMBER_METHOD),
   parent(NULL),
-  V(igl::dummyV),
+  V(SV),
   SV(),
   F(),
   //boundary(igl::boundary_facets<Eigen::MatrixXi,Eigen::MatrixXi>(F))
   cap(),
   radius(std::numeric_limits<double>::infinity()),
-  center(0,0,0)
+  center(0,0,0),
+  cache(),
+  cache_mutex()
 {
   set_mesh(_V,_F);
 }
@@ -188,9 +184,12 @@ inline void igl::WindingNumberTree<Point>::set_mesh(
   // Q: Can this ever increase the complexity of the boundary?
   // Q: Would we gain even more by remove almost exactly duplicate vertices?
   Eigen::MatrixXi SF,SVI,SVJ;
+  // Only the root owns vertices (V refers to SV)
+  assert(parent == NULL && "set_mesh should only be called on the root");
   igl::remove_duplicate_vertices(_V,_F,0.0,SV,SVI,SVJ,F);
   triangle_fan(igl::exterior_edges(F),cap);
-  V = SV;
+  // Any existing hierarchy refers to the previous mesh
+  delete_children();
 }
 
 template <typename Point>
@@ -202,7 +201,9 @@ inline igl::WindingNumberTree<Point>::WindingNumberTree(
   V(parent.V),
   SV(),
   F(_F),
-  cap(triangle_fan(igl::exterior_edges(_F)))
+  cap(triangle_fan(igl::exterior_edges(_F))),
+  cache(),
+  cache_mutex()
 {
 }
 
@@ -225,6 +226,9 @@ inline void igl::WindingNumberTree<Point>::delete_children()
     // erase from list, returns next element in iterator
     cit = children.erase(cit);
   }
+  // Cached values are keyed by (possibly) deleted children
+  lock_guard<mutex> lock(cache_mutex);
+  cache.clear();
 }
       
 template <typename Point>
@@ -332,7 +336,10 @@ inline double igl::WindingNumberTree<Point>::winding_number(const Point & p) con
         }
         case APPROX_CACHE_WINDING_NUMBER_METHOD:
         {
-          return parent->cached_winding_number(*this,p);
+          // The root has nobody to cache its values
+          return parent ?
+            parent->cached_winding_number(*this,p) :
+            winding_number_boundary(p);
         }
         default: assert(false);break;
       }
@@ -463,15 +470,19 @@ inline double igl::WindingNumberTree<Point>::cached_winding_number(
 
   if(is_far)
   {
-    // Not implemented yet
-    pair<const WindingNumberTree*,const WindingNumberTree*> this_that(this,&that);
-    // Need to compute it for first time?
-    if(cached.count(this_that)==0)
     {
-      cached[this_that] = 
-        that.winding_number_boundary(this->center);
+      lock_guard<mutex> lock(cache_mutex);
+      const auto it = cache.find(&that);
+      if(it != cache.end())
+      {
+        return it->second;
+      }
     }
-    return cached[this_that];
+    // Compute outside of the lock: another thread may compute the same
+    // (identical) value concurrently, but only the first one is stored
+    const double w = that.winding_number_boundary(this->center);
+    lock_guard<mutex> lock(cache_mutex);
+    return cache.insert(make_pair(&that,w)).first->second;
   }else if(children.size() == 0)
   {
     // not far and hierarchy ended too soon: can't use cache
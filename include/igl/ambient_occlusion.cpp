@@ -77,21 +77,47 @@ IGL_INLINE void igl::ambient_occlusion(
   const int num_samples,
   Eigen::PlainObjectBase<DerivedS> & S)
 {
-  const auto & shoot_ray = [&aabb,&V,&F](
-    const Eigen::Vector3f& _s,
-    const Eigen::Vector3f& dir)->bool
+  using namespace Eigen;
+  typedef typename DerivedV::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorXS;
+  typedef Matrix<Scalar,Dynamic,3> MatrixX3S;
+  const int n = P.rows();
+  // Resize output
+  S.resize(n,1);
+  const MatrixXf D = random_dir_stratified(num_samples).cast<float>();
+  const MatrixXi FI = F.template cast<int>();
+  // Shoot rays of chunks of points at once as batched any-hit queries
+  const int chunk = std::max(1,(1<<16)/std::max(num_samples,1));
+  for(int p0 = 0;p0<n;p0+=chunk)
   {
-    Eigen::Vector3f s = _s+1e-4*dir;
-    igl::Hit hit;
-    return aabb.intersect_ray(
-      V,
-      F,
-      s  .cast<typename DerivedV::Scalar>().eval(),
-      dir.cast<typename DerivedV::Scalar>().eval(),
-      hit);
-  };
-  return ambient_occlusion(shoot_ray,P,N,num_samples,S);
-
+    const int p1 = std::min(n,p0+chunk);
+    MatrixX3S O((p1-p0)*num_samples,3);
+    MatrixX3S R((p1-p0)*num_samples,3);
+    for(int p = p0;p<p1;p++)
+    {
+      const Vector3f origin = P.row(p).template cast<float>();
+      const Vector3f normal = N.row(p).template cast<float>();
+      for(int s = 0;s<num_samples;s++)
+      {
+        Vector3f d = D.row(s);
+        if(d.dot(normal) < 0)
+        {
+          // reverse ray
+          d *= -1;
+        }
+        const int r = (p-p0)*num_samples+s;
+        O.row(r) = (origin+1e-4*d).template cast<Scalar>();
+        R.row(r) = d.template cast<Scalar>();
+      }
+    }
+    VectorXi H;
+    aabb.intersect_rays_any(V,FI,O,R,VectorXS(),VectorXS(),H);
+    for(int p = p0;p<p1;p++)
+    {
+      S(p) = (double)H.segment((p-p0)*num_samples,num_samples).sum()/
+        (double)num_samples;
+    }
+  }
 }
 
 template <
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "arap.h"
+#include "Profiler.h"
 #include "colon.h"
 #include "cotmatrix.h"
 #include "massmatrix.h"
@@ -173,6 +174,7 @@ IGL_INLINE bool igl::arap_solve(
   ARAPData & data,
   Eigen::PlainObjectBase<DerivedU> & U)
 {
+  IGL_PROFILE_SCOPE("arap_solve");
   using namespace Eigen;
   using namespace std;
   assert(data.b.size() == bc.rows());
@@ -15,6 +15,7 @@
 #include "../../per_vertex_normals.h"
 #include "../../centroid.h"
 #include "../../WindingNumberAABB.h"
+#include "../../FastWindingNumber.h"
 
 #include <CGAL/Surface_mesh_default_triangulation_3.h>
 #include <CGAL/Complex_2_in_triangulation_3.h>
@@ -59,6 +60,7 @@ IGL_INLINE bool igl::copyleft::cgal::signed_distance_isosurface(
   Eigen::MatrixXi E;
   Eigen::VectorXi EMAP;
   WindingNumberAABB<Eigen::Vector3d> hier;
+  FastWindingNumber fwn;
   switch(sign_type)
   {
     default:
@@ -71,6 +73,9 @@ IGL_INLINE bool igl::copyleft::cgal::signed_distance_isosurface(
       hier.set_mesh(IV,IF);
       hier.grow();
       break;
+    case SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER:
+      fwn.init(IV,IF);
+      break;
     case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
       // "Signed Distance Computation Using the Angle Weighted Pseudonormal"
       // [Bærentzen & Aanæs 2005]
@@ -117,6 +122,18 @@ IGL_INLINE bool igl::copyleft::cgal::signed_distance_isosurface(
           return sd-level;
         };
       break;
+    case SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER:
+      fun =
+        [&tree,&IV,&IF,&fwn,&level](const Point_3 & q) -> FT
+        {
+          double s,sqrd;
+          int i;
+          RowVector3d c;
+          signed_distance_fast_winding_number(
+            tree,IV,IF,fwn,RowVector3d(q.x(),q.y(),q.z()),s,sqrd,i,c);
+          return s*sqrt(sqrd)-level;
+        };
+      break;
     case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
       fun = [&tree,&IV,&IF,&FN,&VN,&EN,&EMAP,&level](const Point_3 & q) -> FT
         {
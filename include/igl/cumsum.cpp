@@ -6,8 +6,11 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "cumsum.h"
+#include "parallel_for.h"
+#include "parallel_inclusive_scan.h"
 #include <numeric>
 #include <iostream>
+#include <algorithm>
 
 template <typename DerivedX, typename DerivedY>
 IGL_INLINE void igl::cumsum(
@@ -24,35 +27,53 @@ IGL_INLINE void igl::cumsum(
   int num_inner = (dim == 1 ? X.rows() : X.cols() );
   // This has been optimized so that dim = 1 or 2 is roughly the same cost.
   // (Optimizations assume ColMajor order)
+  typedef typename DerivedX::Scalar Scalar;
   if(dim == 1)
   {
-#pragma omp parallel for
-    for(int o = 0;o<num_outer;o++)
-    {
-      typename DerivedX::Scalar sum = 0;
-      for(int i = 0;i<num_inner;i++)
+    // Few long columns: scan each column in parallel; many columns:
+    // parallelize over columns.
+    const bool scan_columns = num_outer < 4 && num_inner >= 100000;
+    parallel_for(
+      num_outer,
+      [&X,&Y,&num_inner,&scan_columns](const int o)
       {
-        sum += X(i,o);
-        Y(i,o) = sum;
-      }
-    }
+        if(scan_columns)
+        {
+          igl::parallel_inclusive_scan(
+            num_inner,
+            Scalar(0),
+            [&X,&o](const int i)->Scalar{ return X(i,o); },
+            [](const Scalar a, const Scalar b){ return a+b; },
+            [&Y,&o](const int i, const Scalar y){ Y(i,o) = y; });
+        }else
+        {
+          Scalar sum = 0;
+          for(int i = 0;i<num_inner;i++)
+          {
+            sum += X(i,o);
+            Y(i,o) = sum;
+          }
+        }
+      },
+      scan_columns ? num_outer+1 : 10000/std::max(num_inner,1)+1);
   }else
   {
     for(int i = 0;i<num_inner;i++)
     {
       // Notice that it is *not* OK to put this above the inner loop
-      // Though here it doesn't seem to pay off...
-//#pragma omp parallel for
-      for(int o = 0;o<num_outer;o++)
-      {
-        if(i == 0)
+      parallel_for(
+        num_outer,
+        [&X,&Y,&i](const int o)
         {
-          Y(o,i) = X(o,i);
-        }else
-        {
-          Y(o,i) = Y(o,i-1) + X(o,i);
-        }
-      }
+          if(i == 0)
+          {
+            Y(o,i) = X(o,i);
+          }else
+          {
+            Y(o,i) = Y(o,i-1) + X(o,i);
+          }
+        },
+        100000);
     }
   }
 }
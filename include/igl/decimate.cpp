@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "decimate.h"
+#include "Profiler.h"
 #include "collapse_edge.h"
 #include "edge_flaps.h"
 #include "remove_unreferenced.h"
@@ -273,6 +274,7 @@ IGL_INLINE bool igl::decimate(
   Eigen::VectorXi & I
   )
 {
+  IGL_PROFILE_SCOPE("decimate");
 
   // Decimate 1
   using namespace Eigen;
@@ -0,0 +1,321 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "decode_mesh.h"
+#include "Profiler.h"
+#include "mesh_codec.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace igl
+{
+  namespace decode_mesh_helpers
+  {
+    // Inverse of parallelogram_residuals in encode_mesh
+    inline bool parallelogram_predict(
+      const std::vector<uint32_t> & R,
+      const int dim,
+      const int bits,
+      const Eigen::MatrixXi & P,
+      std::vector<uint32_t> & Q)
+    {
+      const int64_t m = (int64_t(1)<<bits) - 1;
+      const Eigen::Index nv = P.rows();
+      Q.resize(R.size());
+      for(Eigen::Index i = 0;i<nv;i++)
+      {
+        for(int d = 0;d<dim;d++)
+        {
+          int64_t p = 0;
+          if(P(i,0) >= 0)
+          {
+            p = int64_t(Q[P(i,0)*dim+d]) + int64_t(Q[P(i,1)*dim+d]) -
+              int64_t(Q[P(i,2)*dim+d]);
+            p = std::min(m,std::max<int64_t>(0,p));
+          }else if(i > 0)
+          {
+            p = Q[(i-1)*dim+d];
+          }
+          const int64_t q = p + mesh_codec::unzigzag(R[i*dim+d]);
+          if(q < 0 || q > m)
+          {
+            return false;
+          }
+          Q[i*dim+d] = static_cast<uint32_t>(q);
+        }
+      }
+      return true;
+    }
+    // Map quantized coordinates back to [lo,hi]
+    template <typename DerivedA>
+    inline void dequantize(
+      const std::vector<uint32_t> & Q,
+      const int bits,
+      const Eigen::RowVectorXd & lo,
+      const Eigen::RowVectorXd & hi,
+      Eigen::PlainObjectBase<DerivedA> & A)
+    {
+      typedef typename DerivedA::Scalar Scalar;
+      const int dim = A.cols();
+      const double m = static_cast<double>((uint64_t(1)<<bits) - 1);
+      for(int d = 0;d<dim;d++)
+      {
+        const double step = (hi(d)-lo(d))/m;
+        for(Eigen::Index i = 0;i<A.rows();i++)
+        {
+          A(i,d) = static_cast<Scalar>(lo(d) + Q[i*dim+d]*step);
+        }
+      }
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedN,
+  typename DerivedUV>
+IGL_INLINE bool igl::decode_mesh(
+  const unsigned char * data,
+  const size_t size,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedUV> & UV)
+{
+  using namespace igl::mesh_codec;
+  using namespace igl::decode_mesh_helpers;
+  IGL_PROFILE_SCOPE("decode_mesh");
+  const auto corrupt = []()
+  {
+    fprintf(stderr,"decode_mesh: data is not a valid encoded mesh\n");
+    return false;
+  };
+  // Header
+  if(size < 18 || memcmp(data,MAGIC,4) != 0 || data[4] != VERSION)
+  {
+    return corrupt();
+  }
+  const bool has_N = data[5] & 1;
+  const bool has_UV = (data[5] >> 1) & 1;
+  const int dim = data[6];
+  const int position_bits = data[7];
+  const int normal_bits = data[8];
+  const int uv_bits = data[9];
+  if((dim != 2 && dim != 3) ||
+    (DerivedV::ColsAtCompileTime != Eigen::Dynamic &&
+      DerivedV::ColsAtCompileTime != dim) ||
+    position_bits < 1 || position_bits > 30 ||
+    normal_bits < 2 || normal_bits > 30 || uv_bits < 1 || uv_bits > 30)
+  {
+    return corrupt();
+  }
+  size_t offset = 10;
+  uint32_t nv,nf;
+  get_u32(data,size,offset,nv);
+  get_u32(data,size,offset,nf);
+  if(nv > uint32_t(INT32_MAX/4) || nf > uint32_t(INT32_MAX/4))
+  {
+    return corrupt();
+  }
+  Eigen::RowVectorXd V_min(dim),V_max(dim),UV_min(2),UV_max(2);
+  bool ok = true;
+  for(int d = 0;d<dim;d++)
+  {
+    ok = ok && get_f64(data,size,offset,V_min(d));
+    ok = ok && get_f64(data,size,offset,V_max(d));
+  }
+  for(int d = 0;d<2 && has_UV;d++)
+  {
+    ok = ok && get_f64(data,size,offset,UV_min(d));
+    ok = ok && get_f64(data,size,offset,UV_max(d));
+  }
+  // Locate streams, then entropy decode them in parallel
+  const size_t num_streams = 3 + has_N + has_UV;
+  std::vector<size_t> stream_offset(num_streams),stream_end(num_streams);
+  for(size_t s = 0;s<num_streams && ok;s++)
+  {
+    uint32_t bytes = 0;
+    ok = get_u32(data,size,offset,bytes) && offset + bytes <= size;
+    stream_offset[s] = offset;
+    offset += bytes;
+    stream_end[s] = offset;
+  }
+  if(!ok)
+  {
+    return corrupt();
+  }
+  const size_t max_count[] = {nf, 3*size_t(nf), size_t(dim)*nv, 2*size_t(nv),
+    2*size_t(nv)};
+  std::vector<std::vector<uint32_t> > streams(num_streams);
+  std::vector<char> stream_ok(num_streams);
+  parallel_for(num_streams,[&](const size_t s)
+  {
+    // Normals and uvs are in this order but either may be missing
+    const size_t type = s < 3 ? s : (s == 3 && has_N ? 3 : 4);
+    size_t o = stream_offset[s];
+    stream_ok[s] =
+      decode_values(data,stream_end[s],o,max_count[type],streams[s]);
+  },2);
+  if(std::find(stream_ok.begin(),stream_ok.end(),0) != stream_ok.end() ||
+    streams[2].size() != size_t(dim)*nv ||
+    (has_N && streams[3].size() != 2*size_t(nv)) ||
+    (has_UV && streams.back().size() != 2*size_t(nv)))
+  {
+    return corrupt();
+  }
+
+  // Connectivity
+  const std::vector<uint32_t> & gates = streams[0];
+  const std::vector<uint32_t> & corners = streams[1];
+  F.resize(nf,3);
+  Eigen::MatrixXi P = Eigen::MatrixXi::Constant(nv,3,-1);
+  size_t gi = 0,ci = 0;
+  uint32_t next_new = 0;
+  // Returns -1 if s is not a valid vertex code
+  const auto vertex = [&](const uint32_t s)->int
+  {
+    if(s == 0)
+    {
+      return next_new < nv ? static_cast<int>(next_new++) : -1;
+    }
+    return s <= next_new ? static_cast<int>(next_new - s) : -1;
+  };
+  uint32_t head = 0,emitted = 0;
+  while(emitted < nf)
+  {
+    if(head == emitted)
+    {
+      // Root face
+      if(ci + 3 > corners.size())
+      {
+        return corrupt();
+      }
+      for(int k = 0;k<3;k++)
+      {
+        const int v = vertex(corners[ci++]);
+        if(v < 0)
+        {
+          return corrupt();
+        }
+        F(emitted,k) = v;
+      }
+      emitted++;
+      continue;
+    }
+    const uint32_t f = head++;
+    if(gi == gates.size())
+    {
+      return corrupt();
+    }
+    const uint32_t mask = gates[gi++];
+    for(int c = 0;c<3;c++)
+    {
+      if(!(mask & (1u<<c)))
+      {
+        continue;
+      }
+      if(ci == corners.size() || emitted == nf)
+      {
+        return corrupt();
+      }
+      const int a = F(f,c);
+      const int b = F(f,(c+1)%3);
+      const uint32_t s = corners[ci++];
+      const bool is_new = (s>>1) == 0;
+      const int x = vertex(s>>1);
+      if(x < 0)
+      {
+        return corrupt();
+      }
+      if(is_new)
+      {
+        P.row(x) << a, b, F(f,(c+2)%3);
+      }
+      if(s & 1)
+      {
+        F.row(emitted) << a, b, x;
+      }else
+      {
+        F.row(emitted) << b, a, x;
+      }
+      emitted++;
+    }
+  }
+
+  // Geometry
+  std::vector<uint32_t> Q;
+  if(!parallelogram_predict(streams[2],dim,position_bits,P,Q))
+  {
+    return corrupt();
+  }
+  V.resize(nv,dim);
+  dequantize(Q,position_bits,V_min,V_max,V);
+  N.resize(has_N ? nv : 0,3);
+  if(has_N)
+  {
+    const std::vector<uint32_t> & R = streams[3];
+    const int64_t m = (int64_t(1)<<normal_bits) - 1;
+    Q.resize(R.size());
+    for(uint32_t i = 0;i<nv;i++)
+    {
+      for(int k = 0;k<2;k++)
+      {
+        int64_t p = 0;
+        if(P(i,0) >= 0)
+        {
+          p = (int64_t(Q[2*P(i,0)+k]) + int64_t(Q[2*P(i,1)+k]))/2;
+        }else if(i > 0)
+        {
+          p = Q[2*(i-1)+k];
+        }
+        const int64_t q = p + unzigzag(R[2*i+k]);
+        if(q < 0 || q > m)
+        {
+          return corrupt();
+        }
+        Q[2*i+k] = static_cast<uint32_t>(q);
+      }
+      double n[3];
+      octahedral_decode(&Q[2*i],normal_bits,n);
+      for(int k = 0;k<3;k++)
+      {
+        N(i,k) = static_cast<typename DerivedN::Scalar>(n[k]);
+      }
+    }
+  }
+  UV.resize(has_UV ? nv : 0,2);
+  if(has_UV)
+  {
+    if(!parallelogram_predict(streams.back(),2,uv_bits,P,Q))
+    {
+      return corrupt();
+    }
+    dequantize(Q,uv_bits,UV_min,UV_max,UV);
+  }
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::decode_mesh(
+  const std::vector<unsigned char> & data,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F)
+{
+  Eigen::MatrixXd N,UV;
+  return decode_mesh(data.data(),data.size(),V,F,N,UV);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::decode_mesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(unsigned char const*, size_t, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template bool igl::decode_mesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::vector<unsigned char, std::allocator<unsigned char> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::decode_mesh<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::vector<unsigned char, std::allocator<unsigned char> > const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::decode_mesh<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::vector<unsigned char, std::allocator<unsigned char> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> >&);
+#endif
@@ -0,0 +1,57 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_DECODE_MESH_H
+#define IGL_DECODE_MESH_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <cstddef>
+#include <vector>
+
+namespace igl
+{
+  // Decompress a mesh encoded with encode_mesh. The entropy coded streams
+  // are decoded in parallel, then connectivity and (predicted) vertex
+  // attributes are rebuilt in a single pass each.
+  //
+  // Inputs:
+  //   data  pointer to encoded bytes
+  //   size  number of bytes at data
+  // Outputs:
+  //   V  #V by dim list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   N  #V by 3 list of unit vertex normals (empty if not encoded)
+  //   UV  #V by 2 list of texture coordinates (empty if not encoded)
+  // Returns true on success, false (with message to stderr) if data is not
+  // a valid encoded mesh
+  //
+  // See also: encode_mesh
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedN,
+    typename DerivedUV>
+  IGL_INLINE bool decode_mesh(
+    const unsigned char * data,
+    const size_t size,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedN> & N,
+    Eigen::PlainObjectBase<DerivedUV> & UV);
+  // Just V and F
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool decode_mesh(
+    const std::vector<unsigned char> & data,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "decode_mesh.cpp"
+#endif
+
+#endif
@@ -10,6 +10,7 @@
 #include "../doublearea.h"
 #include "../random_dir.h"
 #include "../bfs_orient.h"
+#include "../parallel_for.h"
 #include "EmbreeIntersector.h"
 #include <iostream>
 #include <random>
@@ -154,50 +155,67 @@ IGL_INLINE void igl::embree::reorient_facets_raycast(
   vector<pair<int  , int  >> C_vote_parity(num_cc, make_pair(0, 0));        // sum of parity count for each ray
 
   if (is_verbose) cout << "shooting rays... ";
-#pragma omp parallel for
-  for (int i = 0; i < (int)ray_face.size(); ++i)
-  {
-    int      f = ray_face[i];
-    Vector3f o = ray_ori [i];
-    Vector3f d = ray_dir [i];
-    int c = C(f);
+  // per thread copies of the votes, summed up afterwards
+  vector<vector<pair<float, float>>> T_vote_distance;
+  vector<vector<pair<int  , int  >>> T_vote_infinity;
+  vector<vector<pair<int  , int  >>> T_vote_parity;
+  parallel_for(
+    ray_face.size(),
+    [&](const size_t nt)
+    {
+      T_vote_distance.assign(nt, C_vote_distance);
+      T_vote_infinity.assign(nt, C_vote_infinity);
+      T_vote_parity  .assign(nt, C_vote_parity);
+    },
+    [&](const int i, const size_t t)
+    {
+      int      f = ray_face[i];
+      Vector3f o = ray_ori [i];
+      Vector3f d = ray_dir [i];
+      int c = C(f);
 
-    // shoot ray toward front & back
-    vector<Hit> hits_front;
-    vector<Hit> hits_back;
-    int num_rays_front;
-    int num_rays_back;
-    ei.intersectRay(o,  d, hits_front, num_rays_front);
-    ei.intersectRay(o, -d, hits_back , num_rays_back );
-    if (!hits_front.empty() && hits_front[0].id == f) hits_front.erase(hits_front.begin());
-    if (!hits_back .empty() && hits_back [0].id == f) hits_back .erase(hits_back .begin());
+      // shoot ray toward front & back
+      vector<Hit> hits_front;
+      vector<Hit> hits_back;
+      int num_rays_front;
+      int num_rays_back;
+      ei.intersectRay(o,  d, hits_front, num_rays_front);
+      ei.intersectRay(o, -d, hits_back , num_rays_back );
+      if (!hits_front.empty() && hits_front[0].id == f) hits_front.erase(hits_front.begin());
+      if (!hits_back .empty() && hits_back [0].id == f) hits_back .erase(hits_back .begin());
 
-    if (use_parity) {
-#pragma omp atomic
-      C_vote_parity[c].first  += hits_front.size() % 2;
-#pragma omp atomic
-      C_vote_parity[c].second += hits_back .size() % 2;
+      if (use_parity) {
+        T_vote_parity[t][c].first  += hits_front.size() % 2;
+        T_vote_parity[t][c].second += hits_back .size() % 2;
 
-    } else {
-      if (hits_front.empty())
-      {
-#pragma omp atomic
-        C_vote_infinity[c].first++;
       } else {
-#pragma omp atomic
-        C_vote_distance[c].first += hits_front[0].t;
-      }
+        if (hits_front.empty())
+        {
+          T_vote_infinity[t][c].first++;
+        } else {
+          T_vote_distance[t][c].first += hits_front[0].t;
+        }
 
-      if (hits_back.empty())
+        if (hits_back.empty())
+        {
+          T_vote_infinity[t][c].second++;
+        } else {
+          T_vote_distance[t][c].second += hits_back[0].t;
+        }
+      }
+    },
+    [&](const size_t t)
+    {
+      for (int c = 0; c < num_cc; ++c)
       {
-#pragma omp atomic
-        C_vote_infinity[c].second++;
-      } else {
-#pragma omp atomic
-        C_vote_distance[c].second += hits_back[0].t;
+        C_vote_distance[c].first  += T_vote_distance[t][c].first;
+        C_vote_distance[c].second += T_vote_distance[t][c].second;
+        C_vote_infinity[c].first  += T_vote_infinity[t][c].first;
+        C_vote_infinity[c].second += T_vote_infinity[t][c].second;
+        C_vote_parity  [c].first  += T_vote_parity  [t][c].first;
+        C_vote_parity  [c].second += T_vote_parity  [t][c].second;
       }
-    }
-  }
+    });
 
   I.resize(m);
   for(int f = 0; f < m; ++f)
@@ -0,0 +1,368 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "encode_mesh.h"
+#include "Profiler.h"
+#include "mesh_codec.h"
+#include "parallel_for.h"
+#include "triangle_triangle_adjacency.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace igl
+{
+  namespace encode_mesh_helpers
+  {
+    // Quantize column d of A (rows in order I) to bits bits over [lo,hi]
+    template <typename DerivedA>
+    inline void quantize(
+      const Eigen::PlainObjectBase<DerivedA> & A,
+      const Eigen::VectorXi & I,
+      const int bits,
+      const Eigen::RowVectorXd & lo,
+      const Eigen::RowVectorXd & hi,
+      std::vector<uint32_t> & Q,
+      double & error)
+    {
+      const int dim = A.cols();
+      const double m = static_cast<double>((uint64_t(1)<<bits) - 1);
+      Q.resize(static_cast<size_t>(I.size())*dim);
+      error = 0;
+      for(int d = 0;d<dim;d++)
+      {
+        const double range = hi(d) - lo(d);
+        const double scale = range > 0 ? m/range : 0;
+        const double step = range > 0 ? range/m : 0;
+        for(int i = 0;i<I.size();i++)
+        {
+          const double a = static_cast<double>(A(I(i),d));
+          const double q =
+            std::min(m,std::max(0.0,std::floor((a-lo(d))*scale + 0.5)));
+          Q[static_cast<size_t>(i)*dim+d] = static_cast<uint32_t>(q);
+          error = std::max(error,std::abs(lo(d) + q*step - a));
+        }
+      }
+    }
+    // Residuals of Q against the parallelogram prediction a+b-c (clamped
+    // to [0,2^bits-1]) or against the previous vertex if i has no triangle
+    inline void parallelogram_residuals(
+      const std::vector<uint32_t> & Q,
+      const int dim,
+      const int bits,
+      const Eigen::MatrixXi & P,
+      std::vector<uint32_t> & R)
+    {
+      const int64_t m = (int64_t(1)<<bits) - 1;
+      const Eigen::Index nv = P.rows();
+      R.resize(static_cast<size_t>(nv)*dim);
+      for(Eigen::Index i = 0;i<nv;i++)
+      {
+        for(int d = 0;d<dim;d++)
+        {
+          int64_t p = 0;
+          if(P(i,0) >= 0)
+          {
+            p = int64_t(Q[P(i,0)*dim+d]) + int64_t(Q[P(i,1)*dim+d]) -
+              int64_t(Q[P(i,2)*dim+d]);
+            p = std::min(m,std::max<int64_t>(0,p));
+          }else if(i > 0)
+          {
+            p = Q[(i-1)*dim+d];
+          }
+          R[i*dim+d] = mesh_codec::zigzag(int64_t(Q[i*dim+d]) - p);
+        }
+      }
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedN,
+  typename DerivedUV>
+IGL_INLINE bool igl::encode_mesh(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Eigen::PlainObjectBase<DerivedN> & N,
+  const Eigen::PlainObjectBase<DerivedUV> & UV,
+  const int position_bits,
+  const int normal_bits,
+  const int uv_bits,
+  std::vector<unsigned char> & data,
+  Eigen::VectorXi & I,
+  Eigen::VectorXi & J,
+  Eigen::Vector3d & error)
+{
+  using namespace igl::mesh_codec;
+  using namespace igl::encode_mesh_helpers;
+  IGL_PROFILE_SCOPE("encode_mesh");
+  const int nv = V.rows();
+  const int nf = F.rows();
+  const int dim = V.cols();
+  const bool has_N = N.rows() > 0;
+  const bool has_UV = UV.rows() > 0;
+  if((dim != 2 && dim != 3) || (nf > 0 && F.cols() != 3) ||
+    (has_N && (N.rows() != nv || N.cols() != 3)) ||
+    (has_UV && (UV.rows() != nv || UV.cols() != 2)))
+  {
+    fprintf(stderr,"encode_mesh: inputs have wrong sizes\n");
+    return false;
+  }
+  if(position_bits < 1 || position_bits > 30 ||
+    normal_bits < 2 || normal_bits > 30 || uv_bits < 1 || uv_bits > 30)
+  {
+    fprintf(stderr,"encode_mesh: number of bits out of range\n");
+    return false;
+  }
+  const Eigen::MatrixXi Fi = F.template cast<int>();
+  if(nf > 0 && (Fi.minCoeff() < 0 || Fi.maxCoeff() >= nv))
+  {
+    fprintf(stderr,"encode_mesh: F indexes out of V\n");
+    return false;
+  }
+
+  // Connectivity: breadth first traversal across shared edges
+  Eigen::MatrixXi TT;
+  if(nf > 0)
+  {
+    triangle_triangle_adjacency(Fi,TT);
+  }
+  std::vector<int> order;
+  order.reserve(nf);
+  // Emitted face f is the rotation Fi(f,(k+rot[f])%3), k=0,1,2
+  std::vector<int> rot(nf,0);
+  std::vector<char> visited(nf,0);
+  std::vector<int> vid(nv,-1);
+  I.resize(nv);
+  int next_new = 0;
+  // Triangle (a,b,c) each new vertex was reached from, -1 if none
+  Eigen::MatrixXi P = Eigen::MatrixXi::Constant(nv,3,-1);
+  std::vector<uint32_t> gates,corners;
+  gates.reserve(nf);
+  corners.reserve(nf+2);
+  // 0 for a new vertex, otherwise distance back from the next new index
+  const auto code = [&](const int v)->uint32_t
+  {
+    if(vid[v] < 0)
+    {
+      vid[v] = next_new;
+      I(next_new++) = v;
+      return 0;
+    }
+    return next_new - vid[v];
+  };
+  size_t head = 0;
+  for(int r = 0;r<nf && (int)order.size()<nf;r++)
+  {
+    if(visited[r])
+    {
+      continue;
+    }
+    visited[r] = 1;
+    order.push_back(r);
+    for(int k = 0;k<3;k++)
+    {
+      corners.push_back(code(Fi(r,k)));
+    }
+    while(head < order.size() && (int)order.size() < nf)
+    {
+      const int f = order[head++];
+      int g[3];
+      for(int k = 0;k<3;k++)
+      {
+        g[k] = Fi(f,(k+rot[f])%3);
+      }
+      uint32_t mask = 0;
+      int child[3];
+      bool flip[3];
+      for(int c = 0;c<3;c++)
+      {
+        const int n = TT(f,(c+rot[f])%3);
+        if(n < 0 || visited[n])
+        {
+          continue;
+        }
+        // Neighbor must contain edge (a,b), normally as (b,a)
+        const int a = g[c];
+        const int b = g[(c+1)%3];
+        int k = -1;
+        for(int kk = 0;kk<3 && k<0;kk++)
+        {
+          if(Fi(n,kk) == b && Fi(n,(kk+1)%3) == a)
+          {
+            k = kk;
+            flip[c] = false;
+          }
+        }
+        for(int kk = 0;kk<3 && k<0;kk++)
+        {
+          if(Fi(n,kk) == a && Fi(n,(kk+1)%3) == b)
+          {
+            k = kk;
+            flip[c] = true;
+          }
+        }
+        if(k < 0)
+        {
+          continue;
+        }
+        visited[n] = 1;
+        rot[n] = k;
+        child[c] = n;
+        mask |= 1u<<c;
+      }
+      gates.push_back(mask);
+      for(int c = 0;c<3;c++)
+      {
+        if(!(mask & (1u<<c)))
+        {
+          continue;
+        }
+        const int n = child[c];
+        order.push_back(n);
+        const int x = Fi(n,(rot[n]+2)%3);
+        const bool is_new = vid[x] < 0;
+        corners.push_back(2*code(x) + flip[c]);
+        if(is_new)
+        {
+          P.row(vid[x]) << vid[g[c]], vid[g[(c+1)%3]], vid[g[(c+2)%3]];
+        }
+      }
+    }
+  }
+  // Unreferenced vertices go last
+  for(int v = 0;v<nv;v++)
+  {
+    if(vid[v] < 0)
+    {
+      code(v);
+    }
+  }
+  J = Eigen::Map<const Eigen::VectorXi>(order.data(),order.size());
+
+  // Geometry
+  std::vector<std::vector<uint32_t> > streams(2);
+  streams[0].swap(gates);
+  streams[1].swap(corners);
+  error.setZero();
+  Eigen::RowVectorXd V_min(dim),V_max(dim),UV_min(2),UV_max(2);
+  if(nv > 0)
+  {
+    V_min = V.template cast<double>().colwise().minCoeff();
+    V_max = V.template cast<double>().colwise().maxCoeff();
+  }else
+  {
+    V_min.setZero();
+    V_max.setZero();
+  }
+  {
+    std::vector<uint32_t> Q,R;
+    quantize(V,I,position_bits,V_min,V_max,Q,error(0));
+    parallelogram_residuals(Q,dim,position_bits,P,R);
+    streams.push_back(R);
+  }
+  if(has_N)
+  {
+    // Predict from the midpoint of the edge the vertex was reached across
+    std::vector<uint32_t> Q(2*static_cast<size_t>(nv)),R(Q.size());
+    for(int i = 0;i<nv;i++)
+    {
+      double n[3],d[3];
+      for(int k = 0;k<3;k++)
+      {
+        n[k] = static_cast<double>(N(I(i),k));
+      }
+      octahedral_encode(n,normal_bits,&Q[2*i]);
+      octahedral_decode(&Q[2*i],normal_bits,d);
+      const double l = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+      for(int k = 0;k<3 && l>0;k++)
+      {
+        error(1) = std::max(error(1),std::abs(d[k] - n[k]/l));
+      }
+    }
+    for(int i = 0;i<nv;i++)
+    {
+      for(int k = 0;k<2;k++)
+      {
+        int64_t p = 0;
+        if(P(i,0) >= 0)
+        {
+          p = (int64_t(Q[2*P(i,0)+k]) + int64_t(Q[2*P(i,1)+k]))/2;
+        }else if(i > 0)
+        {
+          p = Q[2*(i-1)+k];
+        }
+        R[2*i+k] = zigzag(int64_t(Q[2*i+k]) - p);
+      }
+    }
+    streams.push_back(R);
+  }
+  if(has_UV)
+  {
+    UV_min = UV.template cast<double>().colwise().minCoeff();
+    UV_max = UV.template cast<double>().colwise().maxCoeff();
+    std::vector<uint32_t> Q,R;
+    quantize(UV,I,uv_bits,UV_min,UV_max,Q,error(2));
+    parallelogram_residuals(Q,2,uv_bits,P,R);
+    streams.push_back(R);
+  }
+
+  // Entropy code streams in parallel
+  std::vector<std::vector<unsigned char> > coded(streams.size());
+  parallel_for(streams.size(),[&](const size_t s)
+  {
+    encode_values(streams[s],coded[s]);
+  },2);
+  data.assign(MAGIC,MAGIC+4);
+  data.push_back(VERSION);
+  data.push_back(static_cast<unsigned char>(has_N | (has_UV<<1)));
+  data.push_back(static_cast<unsigned char>(dim));
+  data.push_back(static_cast<unsigned char>(position_bits));
+  data.push_back(static_cast<unsigned char>(normal_bits));
+  data.push_back(static_cast<unsigned char>(uv_bits));
+  put_u32(nv,data);
+  put_u32(nf,data);
+  for(int d = 0;d<dim;d++)
+  {
+    put_f64(V_min(d),data);
+    put_f64(V_max(d),data);
+  }
+  for(int d = 0;d<2 && has_UV;d++)
+  {
+    put_f64(UV_min(d),data);
+    put_f64(UV_max(d),data);
+  }
+  for(const auto & bytes : coded)
+  {
+    put_u32(static_cast<uint32_t>(bytes.size()),data);
+    data.insert(data.end(),bytes.begin(),bytes.end());
+  }
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::encode_mesh(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int position_bits,
+  std::vector<unsigned char> & data)
+{
+  const Eigen::MatrixXd N,UV;
+  Eigen::VectorXi I,J;
+  Eigen::Vector3d error;
+  return encode_mesh(V,F,N,UV,position_bits,12,12,data,I,J,error);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::encode_mesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, int, int, std::vector<unsigned char, std::allocator<unsigned char> >&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&, Eigen::Matrix<double, 3, 1, 0, 3, 1>&);
+template bool igl::encode_mesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, std::vector<unsigned char, std::allocator<unsigned char> >&);
+template bool igl::encode_mesh<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, std::vector<unsigned char, std::allocator<unsigned char> >&);
+template bool igl::encode_mesh<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int, std::vector<unsigned char, std::allocator<unsigned char> >&);
+#endif
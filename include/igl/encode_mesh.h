@@ -0,0 +1,81 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ENCODE_MESH_H
+#define IGL_ENCODE_MESH_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <vector>
+
+namespace igl
+{
+  // Compress a triangle mesh (and optionally per-vertex normals and texture
+  // coordinates) into a compact byte array to be decoded with decode_mesh.
+  //
+  // Positions and texture coordinates are quantized to a regular grid of
+  // 2^bits values per axis spanning their bounding box, normals to 2^bits
+  // values per coordinate of their octahedral mapping. Faces are visited
+  // breadth first across shared edges (see triangle_triangle_adjacency) so
+  // that each face reached from a neighbor only costs its third corner,
+  // vertices are renumbered in order of first appearance (so the third
+  // corner is mostly "new vertex" or a small distance back) and each new
+  // vertex is predicted from the triangle it was reached from
+  // (parallelogram rule). Gates, corners and zigzagged prediction residuals
+  // are then entropy coded (see mesh_codec).
+  //
+  // The decoded mesh is the same up to quantization, a permutation of
+  // vertices and faces and a cyclic rotation of the corners of each face
+  // (orientation is kept).
+  //
+  // Inputs:
+  //   V  #V by dim (2 or 3) list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   N  #V by 3 list of vertex normals (or empty)
+  //   UV  #V by 2 list of vertex texture coordinates (or empty)
+  //   position_bits  bits per position coordinate in [1,30] (e.g., 16)
+  //   normal_bits  bits per octahedral normal coordinate in [2,30] (e.g., 12)
+  //   uv_bits  bits per texture coordinate in [1,30] (e.g., 14)
+  // Outputs:
+  //   data  encoded bytes
+  //   I  #V list of indices so that decoded vertex i is V.row(I(i))
+  //   J  #F list of indices so that decoded face j is F.row(J(j))
+  //   error  3-vector of maximum absolute coordinate error of decoded
+  //     positions, (unit) normals and texture coordinates
+  // Returns true on success, false (with message to stderr) on errors
+  //
+  // See also: decode_mesh, writeIGLB
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedN,
+    typename DerivedUV>
+  IGL_INLINE bool encode_mesh(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Eigen::PlainObjectBase<DerivedN> & N,
+    const Eigen::PlainObjectBase<DerivedUV> & UV,
+    const int position_bits,
+    const int normal_bits,
+    const int uv_bits,
+    std::vector<unsigned char> & data,
+    Eigen::VectorXi & I,
+    Eigen::VectorXi & J,
+    Eigen::Vector3d & error);
+  // Just V and F
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool encode_mesh(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int position_bits,
+    std::vector<unsigned char> & data);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "encode_mesh.cpp"
+#endif
+
+#endif
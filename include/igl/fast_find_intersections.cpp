@@ -0,0 +1,222 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_find_intersections.h"
+#include "tri_tri_intersect.h"
+#include "num_threads.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace igl
+{
+  namespace find_intersections_detail
+  {
+    typedef igl::AABB<Eigen::MatrixXd,3> Tree;
+    // Pair of subtrees to test against each other, or a single subtree
+    // (second is NULL) to test against itself
+    typedef std::pair<const Tree *,const Tree *> Task;
+    // Push the subtasks of a task whose boxes overlap
+    //
+    // Returns false if the task is a pair of leaves (and cannot be split)
+    inline bool split(const Task & task, std::vector<Task> & out)
+    {
+      const Tree * a = task.first;
+      const Tree * b = task.second;
+      if(b == NULL)
+      {
+        if(a->m_left && a->m_right)
+        {
+          out.push_back(Task(a->m_left,NULL));
+          out.push_back(Task(a->m_right,NULL));
+          if(a->m_left->m_box.intersects(a->m_right->m_box))
+          {
+            out.push_back(Task(a->m_left,a->m_right));
+          }
+        }else if(a->m_left || a->m_right)
+        {
+          out.push_back(Task(a->m_left ? a->m_left : a->m_right,NULL));
+        }
+        return true;
+      }
+      if(a->is_leaf() && b->is_leaf())
+      {
+        return false;
+      }
+      // Descend into the larger node
+      const double a_size = a->m_box.diagonal().squaredNorm();
+      const double b_size = b->m_box.diagonal().squaredNorm();
+      const bool split_a = b->is_leaf() || (!a->is_leaf() && a_size >= b_size);
+      const Tree * node = split_a ? a : b;
+      const Tree * other = split_a ? b : a;
+      const Tree * children[2] = {node->m_left,node->m_right};
+      for(const Tree * child : children)
+      {
+        if(child && child->m_box.intersects(other->m_box))
+        {
+          out.push_back(split_a ? Task(child,b) : Task(a,child));
+        }
+      }
+      return true;
+    }
+    inline bool find_intersections(
+      const Tree & treeA,
+      const Eigen::MatrixXd & VA,
+      const Eigen::MatrixXi & FA,
+      const Tree & treeB,
+      const Eigen::MatrixXd & VB,
+      const Eigen::MatrixXi & FB,
+      const bool self,
+      const bool first_only,
+      Eigen::MatrixXi & IF,
+      Eigen::VectorXi & C)
+    {
+      // Expand root into enough independent subtree pairs to keep all
+      // threads busy
+      std::vector<Task> tasks;
+      if(self)
+      {
+        tasks.push_back(Task(&treeA,NULL));
+      }else if(treeA.m_box.intersects(treeB.m_box))
+      {
+        tasks.push_back(Task(&treeA,&treeB));
+      }
+      const size_t target_tasks = 64*igl::num_threads();
+      while(!tasks.empty() && tasks.size() < target_tasks)
+      {
+        std::vector<Task> next;
+        bool any_split = false;
+        for(const Task & task : tasks)
+        {
+          if(split(task,next))
+          {
+            any_split = true;
+          }else
+          {
+            next.push_back(task);
+          }
+        }
+        tasks.swap(next);
+        if(!any_split)
+        {
+          break;
+        }
+      }
+
+      // Depth-first traversal of each task, collecting (fa,fb,certain)
+      // triplets
+      std::atomic<bool> found(false);
+      std::vector<std::vector<int> > results(tasks.size());
+      igl::parallel_for(tasks.size(),
+        [&tasks,&VA,&FA,&VB,&FB,first_only,&found,&results](const int t)
+      {
+        std::vector<Task> stack(1,tasks[t]);
+        while(!stack.empty() && !(first_only && found))
+        {
+          const Task task = stack.back();
+          stack.pop_back();
+          if(split(task,stack))
+          {
+            continue;
+          }
+          const int fa = task.first->m_primitive;
+          const int fb = task.second->m_primitive;
+          const int r = igl::tri_tri_intersect(
+            VA.row(FA(fa,0)),VA.row(FA(fa,1)),VA.row(FA(fa,2)),
+            VB.row(FB(fb,0)),VB.row(FB(fb,1)),VB.row(FB(fb,2)));
+          if(r == 0)
+          {
+            continue;
+          }
+          results[t].push_back(fa);
+          results[t].push_back(fb);
+          results[t].push_back(r == 1);
+          if(r == 1)
+          {
+            found = true;
+          }
+        }
+      },1);
+
+      // Gather in task order
+      size_t num_pairs = 0;
+      for(const std::vector<int> & result : results)
+      {
+        num_pairs += result.size()/3;
+      }
+      IF.resize(num_pairs,2);
+      C.resize(num_pairs);
+      size_t k = 0;
+      for(const std::vector<int> & result : results)
+      {
+        for(size_t r = 0;r<result.size();r += 3,k++)
+        {
+          IF(k,0) = self ? std::min(result[r],result[r+1]) : result[r];
+          IF(k,1) = self ? std::max(result[r],result[r+1]) : result[r+1];
+          C(k) = result[r+2];
+        }
+      }
+      return found;
+    }
+  }
+}
+
+IGL_INLINE bool igl::fast_find_intersections(
+  const igl::AABB<Eigen::MatrixXd,3> & treeA,
+  const Eigen::MatrixXd & VA,
+  const Eigen::MatrixXi & FA,
+  const igl::AABB<Eigen::MatrixXd,3> & treeB,
+  const Eigen::MatrixXd & VB,
+  const Eigen::MatrixXi & FB,
+  const bool first_only,
+  Eigen::MatrixXi & IF,
+  Eigen::VectorXi & C)
+{
+  return find_intersections_detail::find_intersections(
+    treeA,VA,FA,treeB,VB,FB,false,first_only,IF,C);
+}
+
+IGL_INLINE bool igl::fast_find_intersections(
+  const Eigen::MatrixXd & VA,
+  const Eigen::MatrixXi & FA,
+  const Eigen::MatrixXd & VB,
+  const Eigen::MatrixXi & FB,
+  const bool first_only,
+  Eigen::MatrixXi & IF,
+  Eigen::VectorXi & C)
+{
+  igl::AABB<Eigen::MatrixXd,3> treeA,treeB;
+  treeA.init(VA,FA);
+  treeB.init(VB,FB);
+  return fast_find_intersections(treeA,VA,FA,treeB,VB,FB,first_only,IF,C);
+}
+
+IGL_INLINE bool igl::fast_find_self_intersections(
+  const igl::AABB<Eigen::MatrixXd,3> & tree,
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const bool first_only,
+  Eigen::MatrixXi & IF,
+  Eigen::VectorXi & C)
+{
+  return find_intersections_detail::find_intersections(
+    tree,V,F,tree,V,F,true,first_only,IF,C);
+}
+
+IGL_INLINE bool igl::fast_find_self_intersections(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const bool first_only,
+  Eigen::MatrixXi & IF,
+  Eigen::VectorXi & C)
+{
+  igl::AABB<Eigen::MatrixXd,3> tree;
+  tree.init(V,F);
+  return fast_find_self_intersections(tree,V,F,first_only,IF,C);
+}
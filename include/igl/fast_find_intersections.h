@@ -0,0 +1,94 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_FIND_INTERSECTIONS_H
+#define IGL_FAST_FIND_INTERSECTIONS_H
+#include "igl_inline.h"
+#include "AABB.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // FAST_FIND_INTERSECTIONS Find pairs of intersecting triangles between two
+  // meshes by traversing their AABB trees against each other (in parallel
+  // over pairs of subtrees) and testing overlapping leaves with
+  // igl::tri_tri_intersect.
+  //
+  // Unlike copyleft/cgal/intersect_other this does not need exact
+  // arithmetic: pairs whose intersection cannot be decided in floating point
+  // (touching or coplanar overlapping triangles) are reported as candidates,
+  // to be confirmed by an exact test if needed.
+  //
+  // Inputs:
+  //   treeA  AABB tree of (VA,FA)
+  //   VA  #VA by 3 list of vertex positions
+  //   FA  #FA by 3 list of triangle indices into VA
+  //   treeB  AABB tree of (VB,FB)
+  //   VB  #VB by 3 list of vertex positions
+  //   FB  #FB by 3 list of triangle indices into VB
+  //   first_only  whether to stop as soon as an intersection is confirmed
+  // Outputs:
+  //   IF  #IF by 2 list of intersecting or candidate face pairs, indexing FA
+  //     and FB
+  //   C  #IF list of whether each pair certainly intersects (1) or is only a
+  //     candidate (0)
+  // Returns true if any intersection was confirmed
+  IGL_INLINE bool fast_find_intersections(
+    const igl::AABB<Eigen::MatrixXd,3> & treeA,
+    const Eigen::MatrixXd & VA,
+    const Eigen::MatrixXi & FA,
+    const igl::AABB<Eigen::MatrixXd,3> & treeB,
+    const Eigen::MatrixXd & VB,
+    const Eigen::MatrixXi & FB,
+    const bool first_only,
+    Eigen::MatrixXi & IF,
+    Eigen::VectorXi & C);
+  // Build trees first
+  IGL_INLINE bool fast_find_intersections(
+    const Eigen::MatrixXd & VA,
+    const Eigen::MatrixXi & FA,
+    const Eigen::MatrixXd & VB,
+    const Eigen::MatrixXi & FB,
+    const bool first_only,
+    Eigen::MatrixXi & IF,
+    Eigen::VectorXi & C);
+  // FAST_FIND_SELF_INTERSECTIONS Find pairs of intersecting triangles of a
+  // mesh (see fast_find_intersections). Corners at exactly the same position
+  // are treated as shared, so faces meeting only at shared vertices or along
+  // shared edges are not reported.
+  //
+  // Inputs:
+  //   tree  AABB tree of (V,F)
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   first_only  whether to stop as soon as an intersection is confirmed
+  // Outputs:
+  //   IF  #IF by 2 list of intersecting or candidate face pairs, indexing F,
+  //     smaller index first
+  //   C  #IF list of whether each pair certainly intersects (1) or is only a
+  //     candidate (0)
+  // Returns true if any self-intersection was confirmed
+  IGL_INLINE bool fast_find_self_intersections(
+    const igl::AABB<Eigen::MatrixXd,3> & tree,
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const bool first_only,
+    Eigen::MatrixXi & IF,
+    Eigen::VectorXi & C);
+  // Build tree first
+  IGL_INLINE bool fast_find_self_intersections(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const bool first_only,
+    Eigen::MatrixXi & IF,
+    Eigen::VectorXi & C);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_find_intersections.cpp"
+#endif
+
+#endif
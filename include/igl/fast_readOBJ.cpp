@@ -0,0 +1,744 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_readOBJ.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "num_threads.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cfloat>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace igl
+{
+  namespace fast_obj
+  {
+    // Smallest chunk of the file parsed by one task
+    const size_t MIN_CHUNK_SIZE = 1<<16;
+    // Face corner formats
+    enum CornerFormat
+    {
+      CORNER_V = 0,
+      CORNER_V_TC = 1,
+      CORNER_V_N = 2,
+      CORNER_V_TC_N = 3
+    };
+    // Number of elements in (and errors of) a chunk
+    struct Counts
+    {
+      size_t v,vt,vn,f;
+      // Sum over faces of degree-2
+      size_t triangles;
+      // Faces with texture coordinates or normals
+      size_t f_tc,f_n;
+      // Most coordinates of a vertex or texture coordinate
+      int v_cols,vt_cols;
+      int min_degree,max_degree;
+      // Position of first error in chunk (NULL if none) and its description
+      const char * error;
+      const char * message;
+      Counts():
+        v(0),vt(0),vn(0),f(0),triangles(0),f_tc(0),f_n(0),
+        v_cols(0),vt_cols(0),
+        min_degree(0),max_degree(0),
+        error(NULL),message(NULL)
+      {}
+    };
+    inline bool is_space(const char c)
+    {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+    // Whether c ends a token (comments end a line)
+    inline bool is_end(const char c)
+    {
+      return is_space(c) || c == '#';
+    }
+    inline void skip_space(const char *& p, const char * e)
+    {
+      while(p<e && is_space(*p))
+      {
+        p++;
+      }
+    }
+    // Whether there is another token on the line
+    inline bool more(const char *& p, const char * e)
+    {
+      skip_space(p,e);
+      return p<e && *p != '#';
+    }
+    inline void skip_token(const char *& p, const char * e)
+    {
+      while(p<e && !is_end(*p))
+      {
+        p++;
+      }
+    }
+    // Number of tokens in [p,e)
+    inline int count_tokens(const char * p, const char * e)
+    {
+      int count = 0;
+      while(more(p,e))
+      {
+        skip_token(p,e);
+        count++;
+      }
+      return count;
+    }
+    // Type of line starting at p (after leading white space)
+    enum LineType
+    {
+      LINE_OTHER = 0,
+      LINE_V = 1,
+      LINE_VT = 2,
+      LINE_VN = 3,
+      LINE_F = 4
+    };
+    inline LineType line_type(const char *& p, const char * e)
+    {
+      skip_space(p,e);
+      if(p == e)
+      {
+        return LINE_OTHER;
+      }
+      if(p[0] == 'v')
+      {
+        if(p+1 == e || is_space(p[1]))
+        {
+          p += 1;
+          return LINE_V;
+        }
+        if(p+2 == e || is_space(p[2]))
+        {
+          const char c = p[1];
+          p += 2;
+          return c == 't' ? LINE_VT : (c == 'n' ? LINE_VN : LINE_OTHER);
+        }
+      }else if(p[0] == 'f' && (p+1 == e || is_space(p[1])))
+      {
+        p += 1;
+        return LINE_F;
+      }
+      return LINE_OTHER;
+    }
+    // Format of the face corner token starting at p
+    inline int corner_format(const char * p, const char * e)
+    {
+      int slashes = 0;
+      bool empty_tc = false;
+      for(;p<e && !is_end(*p);p++)
+      {
+        if(*p == '/')
+        {
+          slashes++;
+          empty_tc = empty_tc || (slashes == 2 && p[-1] == '/');
+        }
+      }
+      switch(slashes)
+      {
+        case 0: return CORNER_V;
+        case 1: return CORNER_V_TC;
+        case 2: return empty_tc ? CORNER_V_N : CORNER_V_TC_N;
+        default: return -1;
+      }
+    }
+    // Parse a number with strtod, which is slow and locale dependent, so only
+    // used for what parse_double can't (many digits, inf, nan, hex)
+    //
+    // Inputs:
+    //   decimal_point  decimal point of the current C locale
+    inline bool strtod_token(
+      const char * s,
+      const char * e,
+      const char decimal_point,
+      double & x)
+    {
+      char buffer[64];
+      std::string long_token;
+      char * token = buffer;
+      if(e-s >= (long)sizeof(buffer))
+      {
+        long_token.assign(s,e);
+        token = &long_token[0];
+      }else
+      {
+        std::copy(s,e,buffer);
+        buffer[e-s] = '\0';
+      }
+      std::replace(token,token+(e-s),'.',decimal_point);
+      char * end;
+      x = std::strtod(token,&end);
+      return end == token+(e-s);
+    }
+    // Round m*10^exp10 to double using long double (64-bit significand)
+    // arithmetic, exactly unless the long double result is too close to
+    // halfway between two doubles
+    //
+    // Returns true iff x is the correctly rounded result
+    inline bool long_double_pow10(
+      const uint64_t m,
+      const int exp10,
+      double & x)
+    {
+#if LDBL_MANT_DIG == 64
+      static const long double pow10[] = {
+        1e0L,1e1L,1e2L,1e3L,1e4L,1e5L,1e6L,1e7L,1e8L,1e9L,1e10L,1e11L,
+        1e12L,1e13L,1e14L,1e15L,1e16L,1e17L,1e18L,1e19L,1e20L,1e21L,1e22L,
+        1e23L,1e24L,1e25L,1e26L,1e27L};
+      if(std::abs(exp10) > 27 || m == 0)
+      {
+        return false;
+      }
+      // m and 10^|exp10| are exact, so this is a single rounding
+      const long double l = exp10 < 0 ?
+        (long double)m/pow10[-exp10] : (long double)m*pow10[exp10];
+      x = (double)l;
+      int e;
+      if(std::frexp(x,&e) == 0.5)
+      {
+        // Spacing of doubles changes at powers of 2
+        return false;
+      }
+      // Distance to x in units of the spacing of doubles
+      const long double r = std::fabs(l-(long double)x)/std::ldexp(1.0L,e-53);
+      return std::fabs(r-0.5L) > 4.0L/2048.0L;
+#else
+      return false;
+#endif
+    }
+    // Parse a floating point number token, advancing p past it. Numbers with
+    // at most 15 significant digits and a small exponent are exactly rounded
+    // with a single multiplication or division by an exact power of 10, up to
+    // 19 digits mostly with long double arithmetic, the rest with strtod.
+    inline bool parse_double(
+      const char *& p,
+      const char * e,
+      const char decimal_point,
+      double & x)
+    {
+      static const double pow10[] = {
+        1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+        1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+      const char * s = p;
+      bool neg = false;
+      if(p<e && (*p == '-' || *p == '+'))
+      {
+        neg = *p == '-';
+        p++;
+      }
+      uint64_t m = 0;
+      int digits = 0;
+      int exp10 = 0;
+      bool any = false;
+      // Whether nonzero digits didn't fit in m
+      bool truncated = false;
+      for(;p<e && *p >= '0' && *p <= '9';p++)
+      {
+        any = true;
+        if(digits < 19)
+        {
+          m = 10*m+(*p-'0');
+          digits += m>0;
+        }else
+        {
+          truncated = truncated || *p != '0';
+          exp10++;
+        }
+      }
+      if(p<e && *p == '.')
+      {
+        for(p++;p<e && *p >= '0' && *p <= '9';p++)
+        {
+          any = true;
+          if(digits < 19)
+          {
+            m = 10*m+(*p-'0');
+            digits += m>0;
+            exp10--;
+          }else
+          {
+            truncated = truncated || *p != '0';
+          }
+        }
+      }
+      if(any && p<e && (*p == 'e' || *p == 'E'))
+      {
+        const char * q = p+1;
+        bool neg_exp = false;
+        if(q<e && (*q == '-' || *q == '+'))
+        {
+          neg_exp = *q == '-';
+          q++;
+        }
+        if(q<e && *q >= '0' && *q <= '9')
+        {
+          int exp = 0;
+          for(;q<e && *q >= '0' && *q <= '9';q++)
+          {
+            exp = std::min(10*exp+(*q-'0'),100000);
+          }
+          exp10 += neg_exp ? -exp : exp;
+          p = q;
+        }
+      }
+      if(any && !truncated && (p == e || is_end(*p)))
+      {
+        if(digits <= 15 && std::abs(exp10) <= 22)
+        {
+          x = exp10 < 0 ? double(m)/pow10[-exp10] : double(m)*pow10[exp10];
+          x = neg ? -x : x;
+          return true;
+        }
+        // E.g., "%0.17g" written by writeOBJ
+        if(long_double_pow10(m,exp10,x))
+        {
+          x = neg ? -x : x;
+          return true;
+        }
+      }
+      skip_token(p,e);
+      return strtod_token(s,p,decimal_point,x);
+    }
+    // Parse an integer, advancing p past it
+    inline bool parse_int(const char *& p, const char * e, long & i)
+    {
+      bool neg = false;
+      if(p<e && (*p == '-' || *p == '+'))
+      {
+        neg = *p == '-';
+        p++;
+      }
+      if(!(p<e && *p >= '0' && *p <= '9'))
+      {
+        return false;
+      }
+      i = 0;
+      for(;p<e && *p >= '0' && *p <= '9';p++)
+      {
+        i = 10*i+(*p-'0');
+      }
+      i = neg ? -i : i;
+      return true;
+    }
+    // Parse a face corner token "v", "v/vt", "v//vn" or "v/vt/vn" (format
+    // already checked by corner_format), advancing p past it
+    inline bool parse_corner(
+      const char *& p,
+      const char * e,
+      long & v,
+      long & vt,
+      long & vn)
+    {
+      if(!parse_int(p,e,v))
+      {
+        return false;
+      }
+      if(p<e && *p == '/')
+      {
+        p++;
+        if(p<e && *p != '/' && !parse_int(p,e,vt))
+        {
+          return false;
+        }
+        if(p<e && *p == '/')
+        {
+          p++;
+          if(!parse_int(p,e,vn))
+          {
+            return false;
+          }
+        }
+      }
+      return p == e || is_end(*p);
+    }
+    // Count elements of the lines in [begin,end)
+    inline Counts count(const char * begin, const char * end)
+    {
+      Counts C;
+      const char * line = begin;
+      while(line < end)
+      {
+        const char * line_end =
+          static_cast<const char *>(memchr(line,'\n',end-line));
+        line_end = line_end ? line_end : end;
+        const char * p = line;
+        switch(line_type(p,line_end))
+        {
+          case LINE_V:
+          {
+            const int n = count_tokens(p,line_end);
+            if(n < 3)
+            {
+              C.error = line;
+              C.message = "vertex should have 3 or 4 coordinates";
+              return C;
+            }
+            // More than 4 are vertex colors (ignored)
+            C.v_cols = std::max(C.v_cols,n == 4 ? 4 : 3);
+            C.v++;
+            break;
+          }
+          case LINE_VT:
+          {
+            const int n = count_tokens(p,line_end);
+            if(n != 2 && n != 3)
+            {
+              C.error = line;
+              C.message = "texture coords should have 2 or 3 coordinates";
+              return C;
+            }
+            C.vt_cols = std::max(C.vt_cols,n);
+            C.vt++;
+            break;
+          }
+          case LINE_VN:
+            C.vn++;
+            break;
+          case LINE_F:
+          {
+            int degree = 0;
+            int format = -1;
+            while(more(p,line_end))
+            {
+              const int corner = corner_format(p,line_end);
+              if(corner < 0 || (degree > 0 && corner != format))
+              {
+                C.error = line;
+                C.message = "face has invalid format";
+                return C;
+              }
+              format = corner;
+              skip_token(p,line_end);
+              degree++;
+            }
+            if(degree == 0)
+            {
+              C.error = line;
+              C.message = "face has no corners";
+              return C;
+            }
+            C.min_degree = C.f ? std::min(C.min_degree,degree) : degree;
+            C.max_degree = std::max(C.max_degree,degree);
+            C.triangles += std::max(degree-2,0);
+            C.f_tc += (format & CORNER_V_TC) != 0;
+            C.f_n += (format & CORNER_V_N) != 0;
+            C.f++;
+            break;
+          }
+          default:
+            break;
+        }
+        line = line_end+1;
+      }
+      return C;
+    }
+    // Print error at position in file
+    inline void print_error(
+      const char * data,
+      const char * error,
+      const char * message)
+    {
+      const int line_no = 1+std::count(data,error,'\n');
+      fprintf(stderr,"Error: fast_readOBJ() %s on line %d\n",message,line_no);
+    }
+    // Resize M to be empty, keeping a fixed number of columns
+    template <typename DerivedM>
+    inline void clear(Eigen::PlainObjectBase<DerivedM> & M)
+    {
+      M.resize(
+        0,DerivedM::ColsAtCompileTime == Eigen::Dynamic ?
+          0 : (int)DerivedM::ColsAtCompileTime);
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedTC,
+  typename DerivedN,
+  typename DerivedF,
+  typename DerivedFTC,
+  typename DerivedFN>
+IGL_INLINE bool igl::fast_readOBJ(
+  const std::string obj_file_name,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedTC> & TC,
+  Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedFTC> & FTC,
+  Eigen::PlainObjectBase<DerivedFN> & FN)
+{
+  using namespace igl::fast_obj;
+  IGL_PROFILE_SCOPE("fast_readOBJ");
+  MappedFile file;
+  if(!file.open(obj_file_name))
+  {
+    return false;
+  }
+  const char * data = file.data();
+  const char * data_end = data+file.size();
+
+  // Split into chunks ending after a newline
+  const size_t chunk_size = std::max(
+    MIN_CHUNK_SIZE,file.size()/(8*std::max<size_t>(igl::num_threads(),1)));
+  std::vector<const char *> bounds(1,data);
+  while(bounds.back() < data_end)
+  {
+    const char * b = bounds.back()+std::min(
+      chunk_size,(size_t)(data_end-bounds.back()));
+    const char * nl =
+      b < data_end ? static_cast<const char *>(memchr(b,'\n',data_end-b)) :
+      NULL;
+    bounds.push_back(nl ? nl+1 : data_end);
+  }
+  const int num_chunks = bounds.size()-1;
+
+  // Count elements of each chunk
+  std::vector<Counts> counts(num_chunks);
+  parallel_for(num_chunks,[&counts,&bounds](const int c)
+  {
+    counts[c] = count(bounds[c],bounds[c+1]);
+  },2);
+  // Offsets of each chunk's elements in the outputs
+  std::vector<Counts> offsets(num_chunks+1);
+  Counts total;
+  for(int c = 0;c<num_chunks;c++)
+  {
+    const Counts & C = counts[c];
+    if(C.error)
+    {
+      print_error(data,C.error,C.message);
+      return false;
+    }
+    total.v += C.v;
+    total.vt += C.vt;
+    total.vn += C.vn;
+    total.triangles += C.triangles;
+    total.f_tc += C.f_tc;
+    total.f_n += C.f_n;
+    if(C.f)
+    {
+      total.min_degree =
+        total.f ? std::min(total.min_degree,C.min_degree) : C.min_degree;
+      total.max_degree = std::max(total.max_degree,C.max_degree);
+    }
+    total.f += C.f;
+    total.v_cols = std::max(total.v_cols,C.v_cols);
+    total.vt_cols = std::max(total.vt_cols,C.vt_cols);
+    offsets[c+1] = total;
+  }
+  if((total.f_tc != 0 && total.f_tc != total.f) ||
+     (total.f_n != 0 && total.f_n != total.f))
+  {
+    fprintf(stderr,
+      "Error: fast_readOBJ() faces disagree on having texture coordinates or "
+      "normals\n");
+    return false;
+  }
+  // Faces of mixed degree are fan-triangulated
+  const bool triangulate = total.min_degree != total.max_degree;
+  const int degree = triangulate ? 3 : total.max_degree;
+  const size_t num_faces = triangulate ? total.triangles : total.f;
+  const bool has_tc = total.f > 0 && total.f_tc == total.f;
+  const bool has_n = total.f > 0 && total.f_n == total.f;
+
+  // Allocate outputs
+  V.resize(total.v,std::max(total.v_cols,3));
+  if(total.vt)
+  {
+    TC.resize(total.vt,total.vt_cols);
+  }else
+  {
+    clear(TC);
+  }
+  if(total.vn)
+  {
+    N.resize(total.vn,3);
+  }else
+  {
+    clear(N);
+  }
+  F.resize(num_faces,degree);
+  if(has_tc)
+  {
+    FTC.resize(num_faces,degree);
+  }else
+  {
+    clear(FTC);
+  }
+  if(has_n)
+  {
+    FN.resize(num_faces,degree);
+  }else
+  {
+    clear(FN);
+  }
+
+  // Parse each chunk straight into the outputs
+  const char decimal_point = localeconv()->decimal_point[0];
+  std::vector<const char *> errors(num_chunks,(const char *)NULL);
+  std::vector<const char *> messages(num_chunks,(const char *)NULL);
+  const auto & parse_chunk = [&](const int c)
+  {
+    const Counts & O = offsets[c];
+    size_t v = O.v, vt = O.vt, vn = O.vn;
+    size_t f = triangulate ? O.triangles : O.f;
+    // Corners of current face
+    std::vector<long> corner_v,corner_vt,corner_vn;
+    const char * line = bounds[c];
+    const char * end = bounds[c+1];
+    const auto & fail = [&](const char * message)
+    {
+      errors[c] = line;
+      messages[c] = message;
+    };
+    while(line < end)
+    {
+      const char * line_end =
+        static_cast<const char *>(memchr(line,'\n',end-line));
+      line_end = line_end ? line_end : end;
+      const char * p = line;
+      switch(line_type(p,line_end))
+      {
+        case LINE_V:
+        {
+          double x[4] = {0,0,0,1};
+          int n = 0;
+          for(;n<4 && more(p,line_end);n++)
+          {
+            if(!parse_double(p,line_end,decimal_point,x[n]))
+            {
+              return fail("vertex has invalid coordinates");
+            }
+          }
+          if(more(p,line_end))
+          {
+            // Vertex color: only xyz are positions
+            x[3] = 1;
+          }
+          for(int k = 0;k<V.cols();k++)
+          {
+            V(v,k) = x[k];
+          }
+          v++;
+          break;
+        }
+        case LINE_VT:
+        {
+          double x[3] = {0,0,0};
+          for(int k = 0;k<3 && more(p,line_end);k++)
+          {
+            if(!parse_double(p,line_end,decimal_point,x[k]))
+            {
+              return fail("texture coords have invalid coordinates");
+            }
+          }
+          for(int k = 0;k<TC.cols();k++)
+          {
+            TC(vt,k) = x[k];
+          }
+          vt++;
+          break;
+        }
+        case LINE_VN:
+        {
+          double x[3];
+          for(int k = 0;k<3;k++)
+          {
+            if(!more(p,line_end) || !parse_double(p,line_end,decimal_point,x[k]))
+            {
+              return fail("normal should have 3 coordinates");
+            }
+          }
+          for(int k = 0;k<3;k++)
+          {
+            N(vn,k) = x[k];
+          }
+          vn++;
+          break;
+        }
+        case LINE_F:
+        {
+          corner_v.clear();
+          corner_vt.clear();
+          corner_vn.clear();
+          while(more(p,line_end))
+          {
+            long i = 0,it = 0,in = 0;
+            if(!parse_corner(p,line_end,i,it,in))
+            {
+              return fail("face has invalid element format");
+            }
+            // 1-based, or negative relative to elements read so far
+            corner_v.push_back(i<0 ? i+(long)v : i-1);
+            corner_vt.push_back(it<0 ? it+(long)vt : it-1);
+            corner_vn.push_back(in<0 ? in+(long)vn : in-1);
+          }
+          const int d = corner_v.size();
+          // Fan of triangles (or the face itself)
+          const int num_rows = triangulate ? std::max(d-2,0) : 1;
+          for(int r = 0;r<num_rows;r++,f++)
+          {
+            for(int k = 0;k<degree;k++)
+            {
+              // Corner of face in row
+              const int j = triangulate ? (k == 0 ? 0 : r+k) : k;
+              F(f,k) = corner_v[j];
+              if(has_tc)
+              {
+                FTC(f,k) = corner_vt[j];
+              }
+              if(has_n)
+              {
+                FN(f,k) = corner_vn[j];
+              }
+            }
+          }
+          break;
+        }
+        default:
+          break;
+      }
+      line = line_end+1;
+    }
+  };
+  parallel_for(num_chunks,parse_chunk,2);
+  for(int c = 0;c<num_chunks;c++)
+  {
+    if(errors[c])
+    {
+      print_error(data,errors[c],messages[c]);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_readOBJ(
+  const std::string obj_file_name,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F)
+{
+  Eigen::Matrix<typename DerivedV::Scalar,Eigen::Dynamic,Eigen::Dynamic> TC,N;
+  Eigen::Matrix<typename DerivedF::Scalar,Eigen::Dynamic,Eigen::Dynamic> FTC,FN;
+  return fast_readOBJ(obj_file_name,V,TC,N,F,FTC,FN);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_readOBJ<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readOBJ<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readOBJ<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+#endif
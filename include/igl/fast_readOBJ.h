@@ -0,0 +1,71 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_READOBJ_H
+#define IGL_FAST_READOBJ_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Read a mesh from an ascii obj file straight into Eigen matrices. Much
+  // faster than igl::readOBJ on large files: the file is memory-mapped, split
+  // into newline-aligned chunks which are parsed in parallel (first counted,
+  // then written into preallocated outputs) and numbers are parsed without
+  // sscanf, independently of the current locale.
+  //
+  // Relative (negative) indices are supported. If all faces have the same
+  // degree, F has that many columns (e.g., quads), otherwise every face is
+  // fan-triangulated and F, FTC and FN are #triangles by 3. Lines other
+  // than v, vt, vn and f are ignored.
+  //
+  // Inputs:
+  //   obj_file_name  path to .obj file
+  // Outputs:
+  //   V  #V by 3 (or 4 if any vertex has a w coordinate, 1 by default) list
+  //     of vertex positions
+  //   TC  #TC by 2 (or 3) list of texture coordinates
+  //   N  #N by 3 list of normals
+  //   F  #F by degree list of face indices into V
+  //   FTC  #F by degree list of face indices into TC (empty if faces have no
+  //     texture coordinates)
+  //   FN  #F by degree list of face indices into N (empty if faces have no
+  //     normals)
+  // Returns true on success, false (with message to stderr) on errors,
+  // including faces that disagree on whether they have texture coordinates
+  // or normals
+  //
+  // See also: readOBJ
+  template <
+    typename DerivedV,
+    typename DerivedTC,
+    typename DerivedN,
+    typename DerivedF,
+    typename DerivedFTC,
+    typename DerivedFN>
+  IGL_INLINE bool fast_readOBJ(
+    const std::string obj_file_name,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedTC> & TC,
+    Eigen::PlainObjectBase<DerivedN> & N,
+    Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedFTC> & FTC,
+    Eigen::PlainObjectBase<DerivedFN> & FN);
+  // Just V and F
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_readOBJ(
+    const std::string obj_file_name,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_readOBJ.cpp"
+#endif
+
+#endif
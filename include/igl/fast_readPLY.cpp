@@ -0,0 +1,844 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_readPLY.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace igl
+{
+  namespace fast_ply
+  {
+    enum Type
+    {
+      TYPE_INT8 = 0,
+      TYPE_UINT8 = 1,
+      TYPE_INT16 = 2,
+      TYPE_UINT16 = 3,
+      TYPE_INT32 = 4,
+      TYPE_UINT32 = 5,
+      TYPE_FLOAT32 = 6,
+      TYPE_FLOAT64 = 7
+    };
+    const size_t TYPE_SIZE[] = {1,1,2,2,4,4,4,8};
+    enum Format
+    {
+      FORMAT_ASCII = 0,
+      FORMAT_BINARY_LITTLE_ENDIAN = 1,
+      FORMAT_BINARY_BIG_ENDIAN = 2
+    };
+    // Where the values of a property go
+    enum Target
+    {
+      TARGET_NONE = 0,
+      TARGET_V = 1,
+      TARGET_N = 2,
+      TARGET_UV = 3,
+      TARGET_C = 4,
+      TARGET_VD = 5,
+      TARGET_FD = 6
+    };
+    // Rows decoded at once by one thread
+    const size_t CHUNK_SIZE = 4096;
+    struct Property
+    {
+      std::string name;
+      int type;
+      bool is_list;
+      int count_type;
+      Target target;
+      int col;
+    };
+    struct Element
+    {
+      std::string name;
+      size_t count;
+      std::vector<Property> props;
+    };
+    struct Header
+    {
+      Format format;
+      std::vector<Element> elements;
+      // Offset of first byte after header
+      size_t body;
+    };
+    inline bool little_endian()
+    {
+      const uint16_t one = 1;
+      char c;
+      memcpy(&c,&one,1);
+      return c == 1;
+    }
+    inline bool parse_type(const std::string & s, int & type)
+    {
+      const char * names[][2] = {
+        {"char","int8"},
+        {"uchar","uint8"},
+        {"short","int16"},
+        {"ushort","uint16"},
+        {"int","int32"},
+        {"uint","uint32"},
+        {"float","float32"},
+        {"double","float64"}};
+      for(int t = 0;t<8;t++)
+      {
+        if(s == names[t][0] || s == names[t][1])
+        {
+          type = t;
+          return true;
+        }
+      }
+      return false;
+    }
+    inline bool parse_header(
+      const char * data,
+      const size_t size,
+      Header & h,
+      std::string & error)
+    {
+      h.elements.clear();
+      bool has_format = false;
+      size_t pos = 0;
+      int line_no = 0;
+      while(pos < size)
+      {
+        const char * nl = (const char *)memchr(data+pos,'\n',size-pos);
+        if(nl == NULL)
+        {
+          break;
+        }
+        std::string line(data+pos,nl);
+        pos = nl+1-data;
+        if(!line.empty() && line[line.size()-1] == '\r')
+        {
+          line.resize(line.size()-1);
+        }
+        std::istringstream in(line);
+        std::string word;
+        in >> word;
+        if(line_no++ == 0)
+        {
+          if(word != "ply")
+          {
+            error = "not a ply file";
+            return false;
+          }
+        }else if(word == "format")
+        {
+          std::string format;
+          in >> format;
+          if(format == "ascii")
+          {
+            h.format = FORMAT_ASCII;
+          }else if(format == "binary_little_endian")
+          {
+            h.format = FORMAT_BINARY_LITTLE_ENDIAN;
+          }else if(format == "binary_big_endian")
+          {
+            h.format = FORMAT_BINARY_BIG_ENDIAN;
+          }else
+          {
+            error = "unknown format "+format;
+            return false;
+          }
+          has_format = true;
+        }else if(word == "element")
+        {
+          Element e;
+          // Signed so that "-1" is rejected rather than wrapped around
+          long long count;
+          in >> e.name >> count;
+          if(in.fail() || count < 0)
+          {
+            error = "bad element line: "+line;
+            return false;
+          }
+          e.count = count;
+          h.elements.push_back(e);
+        }else if(word == "property")
+        {
+          Property p;
+          p.target = TARGET_NONE;
+          p.col = 0;
+          std::string type;
+          in >> type;
+          p.is_list = type == "list";
+          p.count_type = TYPE_UINT8;
+          if(p.is_list)
+          {
+            std::string count_type;
+            in >> count_type >> type;
+            if(!parse_type(count_type,p.count_type))
+            {
+              error = "bad property line: "+line;
+              return false;
+            }
+          }
+          in >> p.name;
+          if(in.fail() || !parse_type(type,p.type) || h.elements.empty())
+          {
+            error = "bad property line: "+line;
+            return false;
+          }
+          h.elements.back().props.push_back(p);
+        }else if(word == "end_header")
+        {
+          if(!has_format)
+          {
+            error = "missing format";
+            return false;
+          }
+          h.body = pos;
+          // Reject counts that can't fit in the rest of the file before
+          // anything is allocated for them: a binary record takes at least
+          // its scalar properties and list counts, an ascii record at least
+          // one character per property.
+          size_t remaining = size-pos;
+          for(const Element & e : h.elements)
+          {
+            size_t min_record = 0;
+            for(const Property & p : e.props)
+            {
+              min_record += h.format == FORMAT_ASCII ? 1 :
+                TYPE_SIZE[p.is_list ? p.count_type : p.type];
+            }
+            if(min_record > 0 && e.count > remaining/min_record)
+            {
+              error = "element "+e.name+" does not fit in file";
+              return false;
+            }
+            remaining -= e.count*min_record;
+          }
+          return true;
+        }
+        // Ignore comment, obj_info, ...
+      }
+      error = "missing end_header";
+      return false;
+    }
+    template <typename T, bool Swap>
+    inline T load(const char * p)
+    {
+      T x;
+      if(Swap)
+      {
+        char b[sizeof(T)];
+        for(size_t k = 0;k<sizeof(T);k++)
+        {
+          b[k] = p[sizeof(T)-1-k];
+        }
+        memcpy(&x,b,sizeof(T));
+      }else
+      {
+        memcpy(&x,p,sizeof(T));
+      }
+      return x;
+    }
+    template <bool Swap>
+    inline double value(const char * p, const int type)
+    {
+      switch(type)
+      {
+        case TYPE_INT8: return load<int8_t,Swap>(p);
+        case TYPE_UINT8: return load<uint8_t,Swap>(p);
+        case TYPE_INT16: return load<int16_t,Swap>(p);
+        case TYPE_UINT16: return load<uint16_t,Swap>(p);
+        case TYPE_INT32: return load<int32_t,Swap>(p);
+        case TYPE_UINT32: return load<uint32_t,Swap>(p);
+        case TYPE_FLOAT32: return load<float,Swap>(p);
+        case TYPE_FLOAT64:
+        default: return load<double,Swap>(p);
+      }
+    }
+    // Out(i,col) = value at base+i*stride for i in [begin,end)
+    template <typename T, bool Swap, typename DerivedOut>
+    inline void decode_typed(
+      const char * base,
+      const size_t stride,
+      const size_t begin,
+      const size_t end,
+      Eigen::PlainObjectBase<DerivedOut> & Out,
+      const int col)
+    {
+      typedef typename DerivedOut::Scalar Scalar;
+      for(size_t i = begin;i<end;i++)
+      {
+        Out(i,col) = (Scalar)load<T,Swap>(base+i*stride);
+      }
+    }
+    template <bool Swap, typename DerivedOut>
+    inline void decode_column(
+      const char * base,
+      const size_t stride,
+      const int type,
+      const size_t begin,
+      const size_t end,
+      Eigen::PlainObjectBase<DerivedOut> & Out,
+      const int col)
+    {
+      switch(type)
+      {
+        case TYPE_INT8:
+          return decode_typed<int8_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_UINT8:
+          return decode_typed<uint8_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_INT16:
+          return decode_typed<int16_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_UINT16:
+          return decode_typed<uint16_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_INT32:
+          return decode_typed<int32_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_UINT32:
+          return decode_typed<uint32_t,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_FLOAT32:
+          return decode_typed<float,Swap>(base,stride,begin,end,Out,col);
+        case TYPE_FLOAT64:
+        default:
+          return decode_typed<double,Swap>(base,stride,begin,end,Out,col);
+      }
+    }
+    template <
+      typename DerivedV,
+      typename DerivedN,
+      typename DerivedUV,
+      typename DerivedC>
+    struct Outputs
+    {
+      Eigen::PlainObjectBase<DerivedV> & V;
+      Eigen::PlainObjectBase<DerivedN> & N;
+      Eigen::PlainObjectBase<DerivedUV> & UV;
+      Eigen::PlainObjectBase<DerivedC> & C;
+      Eigen::MatrixXd & VD;
+      Eigen::MatrixXd & FD;
+      template <bool Swap>
+      void decode(
+        const Property & p,
+        const char * base,
+        const size_t stride,
+        const size_t begin,
+        const size_t end)
+      {
+        switch(p.target)
+        {
+          case TARGET_V:
+            return decode_column<Swap>(base,stride,p.type,begin,end,V,p.col);
+          case TARGET_N:
+            return decode_column<Swap>(base,stride,p.type,begin,end,N,p.col);
+          case TARGET_UV:
+            return decode_column<Swap>(base,stride,p.type,begin,end,UV,p.col);
+          case TARGET_C:
+            return decode_column<Swap>(base,stride,p.type,begin,end,C,p.col);
+          case TARGET_VD:
+            return decode_column<Swap>(base,stride,p.type,begin,end,VD,p.col);
+          case TARGET_FD:
+            return decode_column<Swap>(base,stride,p.type,begin,end,FD,p.col);
+          case TARGET_NONE:
+          default:
+            return;
+        }
+      }
+      void set(const Property & p, const size_t i, const double x)
+      {
+        switch(p.target)
+        {
+          case TARGET_V: V(i,p.col) = (typename DerivedV::Scalar)x; return;
+          case TARGET_N: N(i,p.col) = (typename DerivedN::Scalar)x; return;
+          case TARGET_UV: UV(i,p.col) = (typename DerivedUV::Scalar)x; return;
+          case TARGET_C: C(i,p.col) = (typename DerivedC::Scalar)x; return;
+          case TARGET_VD: VD(i,p.col) = x; return;
+          case TARGET_FD: FD(i,p.col) = x; return;
+          case TARGET_NONE:
+          default:
+            return;
+        }
+      }
+    };
+    // Sequential sources of values for elements that can't be decoded in
+    // bulk
+    class AsciiSource
+    {
+      public:
+        AsciiSource(const char * p): m_p(p), m_failed(false) {}
+        double next(const int /*type*/)
+        {
+          char * e;
+          const double x = strtod(m_p,&e);
+          m_failed = m_failed || e == m_p;
+          m_p = e;
+          return x;
+        }
+        bool failed() const { return m_failed; }
+      private:
+        const char * m_p;
+        bool m_failed;
+    };
+    template <bool Swap>
+    class BinarySource
+    {
+      public:
+        BinarySource(const char * p, const char * end):
+          m_p(p), m_end(end), m_failed(false) {}
+        double next(const int type)
+        {
+          if(m_failed || (size_t)(m_end-m_p) < TYPE_SIZE[type])
+          {
+            m_failed = true;
+            return 0;
+          }
+          const double x = value<Swap>(m_p,type);
+          m_p += TYPE_SIZE[type];
+          return x;
+        }
+        bool failed() const { return m_failed; }
+        const char * position() const { return m_p; }
+      private:
+        const char * m_p;
+        const char * m_end;
+        bool m_failed;
+    };
+    // Faces read one at a time
+    struct Polygons
+    {
+      std::vector<int> degrees;
+      std::vector<int> corners;
+      // #faces by #FD row-major values of other face properties
+      std::vector<double> values;
+    };
+    template <typename DerivedF>
+    inline bool fixed_cols_allow(const int cols)
+    {
+      return
+        DerivedF::ColsAtCompileTime == Eigen::Dynamic ||
+        DerivedF::ColsAtCompileTime == cols;
+    }
+    // Read element record by record. Faces (list property fl) are gathered
+    // into polys.
+    template <typename Source, typename Out>
+    inline bool read_element(
+      Source & src,
+      const Element & e,
+      const int fl,
+      Out & out,
+      Polygons & polys)
+    {
+      for(size_t i = 0;i<e.count;i++)
+      {
+        for(int p = 0;p<(int)e.props.size();p++)
+        {
+          const Property & prop = e.props[p];
+          if(prop.is_list)
+          {
+            const double n = src.next(prop.count_type);
+            if(src.failed() || n < 0 || n > INT_MAX)
+            {
+              return false;
+            }
+            if(p == fl)
+            {
+              polys.degrees.push_back((int)n);
+            }
+            for(int k = 0;k<(int)n;k++)
+            {
+              const double x = src.next(prop.type);
+              if(p == fl)
+              {
+                polys.corners.push_back((int)x);
+              }
+            }
+          }else
+          {
+            const double x = src.next(prop.type);
+            if(prop.target == TARGET_FD)
+            {
+              polys.values.push_back(x);
+            }else
+            {
+              out.set(prop,i,x);
+            }
+          }
+        }
+        if(src.failed())
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    // Faces of element with list property fl (and no other lists) if they
+    // all have the same degree (and size in bytes)
+    //
+    // Outputs:
+    //   degree  degree of all faces
+    //   stride  size of each face record in bytes
+    // Returns whether faces are uniform
+    template <bool Swap, typename DerivedF>
+    inline bool uniform_faces(
+      const char * begin,
+      const char * end,
+      const Element & e,
+      const int fl,
+      int & degree,
+      size_t & stride)
+    {
+      size_t count_offset = 0;
+      for(int p = 0;p<fl;p++)
+      {
+        count_offset += TYPE_SIZE[e.props[p].type];
+      }
+      const Property & prop = e.props[fl];
+      if(e.count == 0 ||
+        (size_t)(end-begin) < count_offset+TYPE_SIZE[prop.count_type])
+      {
+        return false;
+      }
+      const double d = value<Swap>(begin+count_offset,prop.count_type);
+      if(d < 1 || d > 255 || !fixed_cols_allow<DerivedF>((int)d))
+      {
+        return false;
+      }
+      degree = (int)d;
+      stride = 0;
+      for(int p = 0;p<(int)e.props.size();p++)
+      {
+        stride += p == fl ?
+          TYPE_SIZE[prop.count_type]+degree*TYPE_SIZE[prop.type] :
+          TYPE_SIZE[e.props[p].type];
+      }
+      if((size_t)(end-begin)/stride < e.count)
+      {
+        return false;
+      }
+      std::atomic<bool> uniform(true);
+      const size_t num_chunks = (e.count+CHUNK_SIZE-1)/CHUNK_SIZE;
+      parallel_for(num_chunks,[&](const size_t c)
+      {
+        const size_t last = std::min(e.count,(c+1)*CHUNK_SIZE);
+        for(size_t i = c*CHUNK_SIZE;i<last && uniform;i++)
+        {
+          if(value<Swap>(begin+i*stride+count_offset,prop.count_type) != d)
+          {
+            uniform = false;
+          }
+        }
+      },2);
+      return uniform;
+    }
+    // Read all elements of a binary file
+    template <bool Swap, typename DerivedF, typename Out>
+    inline bool read_binary(
+      const char * data,
+      const size_t size,
+      const Header & h,
+      const int vi,
+      const int fi,
+      const int fl,
+      Eigen::PlainObjectBase<DerivedF> & F,
+      Out & out,
+      Polygons & polys,
+      bool & has_polys,
+      std::string & error)
+    {
+      const char * pos = data+h.body;
+      const char * end = data+size;
+      for(int ei = 0;ei<(int)h.elements.size();ei++)
+      {
+        const Element & e = h.elements[ei];
+        bool has_lists = false;
+        size_t stride = 0;
+        for(const auto & p : e.props)
+        {
+          has_lists = has_lists || p.is_list;
+          stride += TYPE_SIZE[p.type];
+        }
+        int degree = 0;
+        const bool uniform =
+          ei == fi && fl >= 0 &&
+          std::count_if(e.props.begin(),e.props.end(),
+            [](const Property & p){ return p.is_list; }) == 1 &&
+          uniform_faces<Swap,DerivedF>(pos,end,e,fl,degree,stride);
+        if(has_lists && !uniform)
+        {
+          // Record by record
+          BinarySource<Swap> src(pos,end);
+          if(!read_element(src,e,ei == fi ? fl : -1,out,polys))
+          {
+            error = "element "+e.name+" is too short";
+            return false;
+          }
+          has_polys = has_polys || ei == fi;
+          pos = src.position();
+          continue;
+        }
+        if(stride > 0 && (size_t)(end-pos)/stride < e.count)
+        {
+          error = "element "+e.name+" is too short";
+          return false;
+        }
+        if(ei == vi || ei == fi)
+        {
+          if(uniform)
+          {
+            F.resize(e.count,degree);
+          }
+          const size_t num_chunks = (e.count+CHUNK_SIZE-1)/CHUNK_SIZE;
+          parallel_for(num_chunks,[&](const size_t c)
+          {
+            const size_t begin = c*CHUNK_SIZE;
+            const size_t last = std::min(e.count,begin+CHUNK_SIZE);
+            size_t offset = 0;
+            for(int p = 0;p<(int)e.props.size();p++)
+            {
+              const Property & prop = e.props[p];
+              if(prop.is_list)
+              {
+                // Face list
+                offset += TYPE_SIZE[prop.count_type];
+                for(int k = 0;k<degree;k++)
+                {
+                  decode_column<Swap>(
+                    pos+offset,stride,prop.type,begin,last,F,k);
+                  offset += TYPE_SIZE[prop.type];
+                }
+              }else
+              {
+                out.template decode<Swap>(prop,pos+offset,stride,begin,last);
+                offset += TYPE_SIZE[prop.type];
+              }
+            }
+          },2);
+        }
+        pos += e.count*stride;
+      }
+      return true;
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedN,
+  typename DerivedUV,
+  typename DerivedC>
+IGL_INLINE bool igl::fast_readPLY(
+  const std::string & filename,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedUV> & UV,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::MatrixXd & VD,
+  std::vector<std::string> & Vheader,
+  Eigen::MatrixXd & FD,
+  std::vector<std::string> & Fheader)
+{
+  using namespace igl::fast_ply;
+  IGL_PROFILE_SCOPE("fast_readPLY");
+  const auto & fail = [&filename](const std::string & error)->bool
+  {
+    fprintf(stderr,"IOError: fast_readPLY() %s: %s\n",
+      filename.c_str(),error.c_str());
+    return false;
+  };
+  MappedFile file;
+  if(!file.open(filename))
+  {
+    return false;
+  }
+  Header h;
+  std::string error;
+  if(!parse_header(file.data(),file.size(),h,error))
+  {
+    return fail(error);
+  }
+  // Assign properties of vertex and face elements to outputs
+  int vi = -1, fi = -1, fl = -1;
+  int v_cols = 0, n_cols = 0, uv_cols = 0, c_cols = 0;
+  Vheader.clear();
+  Fheader.clear();
+  for(int ei = 0;ei<(int)h.elements.size();ei++)
+  {
+    Element & e = h.elements[ei];
+    if(e.name == "vertex" && vi < 0)
+    {
+      vi = ei;
+      const char * names[][4] = {
+        {"x","y","z",NULL},
+        {"nx","ny","nz",NULL},
+        {"s","t",NULL,NULL},
+        {"u","v",NULL,NULL},
+        {"texture_u","texture_v",NULL,NULL},
+        {"red","green","blue","alpha"}};
+      const Target targets[] =
+        {TARGET_V,TARGET_N,TARGET_UV,TARGET_UV,TARGET_UV,TARGET_C};
+      int * cols[] = {&v_cols,&n_cols,&uv_cols,&uv_cols,&uv_cols,&c_cols};
+      for(auto & p : e.props)
+      {
+        if(p.is_list)
+        {
+          continue;
+        }
+        for(int g = 0;g<6 && p.target == TARGET_NONE;g++)
+        {
+          for(int k = 0;k<4 && names[g][k];k++)
+          {
+            if(p.name == names[g][k])
+            {
+              p.target = targets[g];
+              p.col = k;
+              *cols[g] = std::max(*cols[g],k+1);
+            }
+          }
+        }
+        if(p.target == TARGET_NONE)
+        {
+          p.target = TARGET_VD;
+          p.col = Vheader.size();
+          Vheader.push_back(p.name);
+        }
+      }
+    }else if(e.name == "face" && fi < 0)
+    {
+      fi = ei;
+      for(int p = 0;p<(int)e.props.size();p++)
+      {
+        Property & prop = e.props[p];
+        if(prop.is_list)
+        {
+          if(fl < 0 &&
+            (prop.name == "vertex_indices" || prop.name == "vertex_index"))
+          {
+            fl = p;
+          }
+        }else
+        {
+          prop.target = TARGET_FD;
+          prop.col = Fheader.size();
+          Fheader.push_back(prop.name);
+        }
+      }
+    }
+  }
+  const size_t nv = vi >= 0 ? h.elements[vi].count : 0;
+  const size_t nf = fi >= 0 ? h.elements[fi].count : 0;
+  const auto & fixed = [](const int cols, const int fixed_cols)->int
+  {
+    return fixed_cols == Eigen::Dynamic ? cols : fixed_cols;
+  };
+  // Missing coordinates (e.g., z) are zero
+  V.setZero(nv,fixed(std::max(v_cols,2),DerivedV::ColsAtCompileTime));
+  N.resize(n_cols ? nv : 0,fixed(3,DerivedN::ColsAtCompileTime));
+  UV.resize(uv_cols ? nv : 0,fixed(2,DerivedUV::ColsAtCompileTime));
+  C.resize(
+    c_cols ? nv : 0,fixed(c_cols ? c_cols : 3,DerivedC::ColsAtCompileTime));
+  if(V.cols() < v_cols || (n_cols && N.cols() < 3) ||
+    (uv_cols && UV.cols() < 2) || (c_cols && C.cols() < c_cols))
+  {
+    return fail("outputs have too few columns");
+  }
+  VD.resize(nv,Vheader.size());
+  FD.setZero(nf,Fheader.size());
+  F.resize(0,fixed(3,DerivedF::ColsAtCompileTime));
+  Outputs<DerivedV,DerivedN,DerivedUV,DerivedC> out = {V,N,UV,C,VD,FD};
+  Polygons polys;
+  bool has_polys = false;
+  if(h.format == FORMAT_ASCII)
+  {
+    // Null-terminated copy for strtod
+    const std::string body(file.data()+h.body,file.data()+file.size());
+    AsciiSource src(body.c_str());
+    for(int ei = 0;ei<(int)h.elements.size();ei++)
+    {
+      if(!read_element(src,h.elements[ei],ei == fi ? fl : -1,out,polys))
+      {
+        return fail("bad values in element "+h.elements[ei].name);
+      }
+    }
+    has_polys = fi >= 0;
+  }else
+  {
+    const bool swap =
+      (h.format == FORMAT_BINARY_LITTLE_ENDIAN) != little_endian();
+    const bool ok = swap ?
+      read_binary<true>(
+        file.data(),file.size(),h,vi,fi,fl,F,out,polys,has_polys,error) :
+      read_binary<false>(
+        file.data(),file.size(),h,vi,fi,fl,F,out,polys,has_polys,error);
+    if(!ok)
+    {
+      return fail(error);
+    }
+  }
+  if(has_polys && fl >= 0)
+  {
+    // Keep degree if all faces agree, otherwise fan-triangulate
+    const int d = polys.degrees.empty() ? 3 : polys.degrees[0];
+    const bool same =
+      fixed_cols_allow<DerivedF>(d) &&
+      std::all_of(polys.degrees.begin(),polys.degrees.end(),
+        [d](const int di){ return di == d; });
+    if(!same && !fixed_cols_allow<DerivedF>(3))
+    {
+      return fail("faces don't fit into F");
+    }
+    size_t num_faces = 0;
+    for(const int di : polys.degrees)
+    {
+      num_faces += same ? 1 : std::max(di-2,0);
+    }
+    const int cols = same ? d : 3;
+    F.resize(num_faces,cols);
+    FD.resize(num_faces,FD.cols());
+    size_t c = 0, f = 0;
+    for(size_t p = 0;p<polys.degrees.size();p++)
+    {
+      const int di = polys.degrees[p];
+      for(int t = 0;t<(same ? 1 : di-2);t++)
+      {
+        for(int k = 0;k<cols;k++)
+        {
+          F(f,k) = polys.corners[c+(same || k == 0 ? k : t+k)];
+        }
+        for(int j = 0;j<FD.cols();j++)
+        {
+          FD(f,j) = polys.values[p*FD.cols()+j];
+        }
+        f++;
+      }
+      c += di;
+    }
+  }
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_readPLY(
+  const std::string & filename,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F)
+{
+  Eigen::MatrixXd N,UV,C,VD,FD;
+  std::vector<std::string> Vheader,Fheader;
+  return fast_readPLY(filename,V,F,N,UV,C,VD,Vheader,FD,Fheader);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_readPLY<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::Matrix<double, -1, -1, 0, -1, -1>&, std::vector<std::string, std::allocator<std::string> >&, Eigen::Matrix<double, -1, -1, 0, -1, -1>&, std::vector<std::string, std::allocator<std::string> >&);
+template bool igl::fast_readPLY<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readPLY<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readPLY<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> >&);
+#endif
@@ -0,0 +1,76 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_READPLY_H
+#define IGL_FAST_READPLY_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+#include <vector>
+
+namespace igl
+{
+  // Read a mesh from a ply file straight into Eigen matrices without going
+  // through ply.h. The file is memory-mapped; binary (little or big endian)
+  // elements whose records all have the same size (no lists, or faces of a
+  // single degree) are decoded property by property in parallel, with byte
+  // swapping if needed. Ascii files and faces of mixed degree are read
+  // record by record.
+  //
+  // Recognized vertex properties are x,y,z; nx,ny,nz; s,t (or u,v or
+  // texture_u,texture_v); red,green,blue[,alpha]. Any other scalar vertex
+  // property ends up in VD. Faces come from the vertex_indices (or
+  // vertex_index) list, other scalar face properties end up in FD. If faces
+  // have mixed degrees they are fan-triangulated (and rows of FD repeated
+  // accordingly). Other elements are skipped.
+  //
+  // Inputs:
+  //   filename  path to .ply file
+  // Outputs:
+  //   V  #V by 3 (or 2 if there is no z) list of vertex positions
+  //   F  #F by degree list of face indices into V
+  //   N  #V by 3 list of vertex normals (empty if not in file)
+  //   UV  #V by 2 list of texture coordinates (empty if not in file)
+  //   C  #V by 3 (or 4 with alpha) list of vertex colors as stored (e.g.,
+  //     0-255 for uchar) (empty if not in file)
+  //   VD  #V by #Vheader list of other vertex properties
+  //   Vheader  list of names of columns of VD
+  //   FD  #F by #Fheader list of other face properties
+  //   Fheader  list of names of columns of FD
+  // Returns true on success, false (with message to stderr) on errors
+  //
+  // See also: readPLY, fast_writePLY
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedN,
+    typename DerivedUV,
+    typename DerivedC>
+  IGL_INLINE bool fast_readPLY(
+    const std::string & filename,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedN> & N,
+    Eigen::PlainObjectBase<DerivedUV> & UV,
+    Eigen::PlainObjectBase<DerivedC> & C,
+    Eigen::MatrixXd & VD,
+    std::vector<std::string> & Vheader,
+    Eigen::MatrixXd & FD,
+    std::vector<std::string> & Fheader);
+  // Just V and F
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_readPLY(
+    const std::string & filename,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_readPLY.cpp"
+#endif
+
+#endif
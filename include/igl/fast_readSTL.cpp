@@ -0,0 +1,327 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_readSTL.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "parallel_for.h"
+#include "parallel_inclusive_scan.h"
+#include "readSTL.h"
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace igl
+{
+  namespace fast_stl
+  {
+    // Binary layout: 80 byte header, 4 byte number of facets, then per facet
+    // 12 floats (normal and corners) and a 2 byte attribute count
+    const size_t HEADER_SIZE = 84;
+    const size_t RECORD_SIZE = 50;
+    // Don't bother threads for fewer facets
+    const size_t MIN_PARALLEL = 1000;
+    // Whether file is a binary stl, using the same test as igl::readSTL: ascii
+    // files start with "solid" (but so do some binary files)
+    //
+    // Outputs:
+    //   num_tri  number of facets if binary
+    inline bool is_binary(
+      const char * data,
+      const size_t size,
+      uint32_t & num_tri)
+    {
+      if(size < HEADER_SIZE)
+      {
+        return false;
+      }
+      memcpy(&num_tri,data+80,sizeof(uint32_t));
+      const char * p = data;
+      const char * e = data+80;
+      while(p<e && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+      {
+        p++;
+      }
+      const bool solid =
+        e-p >= 5 && strncmp(p,"solid",5) == 0 &&
+        (e-p == 5 || p[5] == ' ' || p[5] == '\t' || p[5] == '\r' ||
+         p[5] == '\n' || p[5] == '\0');
+      return !solid || size == HEADER_SIZE+RECORD_SIZE*(size_t)num_tri;
+    }
+    // Read k-th float of facet record t
+    inline float read_float(const char * data, const size_t t, const int k)
+    {
+      float x;
+      memcpy(&x,data+HEADER_SIZE+RECORD_SIZE*t+sizeof(float)*k,sizeof(float));
+      return x;
+    }
+    inline uint64_t mix(uint64_t x)
+    {
+      // splitmix64 finalizer
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return x;
+    }
+    // Merge corners with equal keys in parallel
+    //
+    // Inputs:
+    //   num_tri  number of triangles
+    //   corner  function handle so that corner(c,p) sets p to the 3
+    //     coordinates of corner c%3 of triangle c/3
+    //   epsilon  see fast_readSTL
+    // Outputs:
+    //   V  #V by 3 list of unique vertex positions (in order of first
+    //     occurrence)
+    //   F  num_tri by 3 list of triangle indices into V
+    template <typename CornerFunc, typename DerivedV, typename DerivedF>
+    inline void weld(
+      const size_t num_tri,
+      const CornerFunc & corner,
+      const double epsilon,
+      Eigen::PlainObjectBase<DerivedV> & V,
+      Eigen::PlainObjectBase<DerivedF> & F)
+    {
+      const int n = 3*num_tri;
+      // Key of a corner: cell of epsilon grid or bits of coordinates
+      const auto & key = [&corner,epsilon](const int c, int64_t k[3])
+      {
+        double p[3];
+        corner(c,p);
+        for(int i = 0;i<3;i++)
+        {
+          if(epsilon > 0)
+          {
+            k[i] = (int64_t)std::round(p[i]/(10.0*epsilon));
+          }else
+          {
+            // -0 == 0
+            const double x = p[i]+0.0;
+            memcpy(&k[i],&x,sizeof(double));
+          }
+        }
+      };
+      const auto & hash = [](const int64_t k[3])->uint64_t
+      {
+        return mix(mix(mix(k[0])^(uint64_t)k[1])^(uint64_t)k[2]);
+      };
+      // Open addressing table of corners, at most half full
+      size_t size = 1;
+      while(size < 2*(size_t)n)
+      {
+        size *= 2;
+      }
+      const size_t mask = size-1;
+      std::vector<std::atomic<int> > table(size);
+      parallel_for(size,[&table](const size_t s)
+      {
+        table[s].store(-1,std::memory_order_relaxed);
+      },MIN_PARALLEL);
+      // Slot of key of corner c (inserting c if absent). Each slot ends up
+      // holding the smallest corner with its key.
+      const auto & find = [&](const int c, const bool insert)->size_t
+      {
+        int64_t k[3];
+        key(c,k);
+        size_t s = hash(k) & mask;
+        while(true)
+        {
+          int cur = table[s].load(std::memory_order_relaxed);
+          if(cur == -1)
+          {
+            assert(insert);
+            if(table[s].compare_exchange_strong(cur,c))
+            {
+              return s;
+            }
+            // Lost race: cur is now set, compare with it below
+          }
+          int64_t l[3];
+          key(cur,l);
+          if(k[0] == l[0] && k[1] == l[1] && k[2] == l[2])
+          {
+            while(insert && c < cur && !table[s].compare_exchange_weak(cur,c))
+            {
+            }
+            return s;
+          }
+          s = (s+1) & mask;
+        }
+      };
+      parallel_for(n,[&find](const int c){ find(c,true); },MIN_PARALLEL);
+      // Representative of each corner
+      std::vector<int> rep(n);
+      parallel_for(n,[&](const int c)
+      {
+        rep[c] = table[find(c,false)].load(std::memory_order_relaxed);
+      },MIN_PARALLEL);
+      std::vector<std::atomic<int> >().swap(table);
+      // Number vertices by first occurrence
+      std::vector<int> J(n);
+      parallel_inclusive_scan(
+        n,0,
+        [&rep](const int c)->int{ return rep[c] == c ? 1 : 0; },
+        [](const int a, const int b)->int{ return a+b; },
+        [&J](const int c, const int j){ J[c] = j-1; },
+        MIN_PARALLEL);
+      V.resize(n ? J[n-1]+1 : 0,3);
+      F.resize(num_tri,3);
+      parallel_for(num_tri,[&](const int t)
+      {
+        for(int k = 0;k<3;k++)
+        {
+          const int c = 3*t+k;
+          if(rep[c] == c)
+          {
+            double p[3];
+            corner(c,p);
+            for(int i = 0;i<3;i++)
+            {
+              V(J[c],i) = p[i];
+            }
+          }
+          F(t,k) = J[rep[c]];
+        }
+      },MIN_PARALLEL);
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF, typename DerivedN>
+IGL_INLINE bool igl::fast_readSTL(
+  const std::string & filename,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedN> & N)
+{
+  using namespace igl::fast_stl;
+  IGL_PROFILE_SCOPE("fast_readSTL");
+  MappedFile file;
+  if(!file.open(filename))
+  {
+    return false;
+  }
+  uint32_t num_tri;
+  if(!is_binary(file.data(),file.size(),num_tri))
+  {
+    file.close();
+    return readSTL(filename,V,F,N);
+  }
+  if(file.size() < HEADER_SIZE+RECORD_SIZE*(size_t)num_tri)
+  {
+    fprintf(stderr,"IOError: fast_readSTL() %s is too short\n",
+      filename.c_str());
+    return false;
+  }
+  const char * data = file.data();
+  V.resize(3*(size_t)num_tri,3);
+  F.resize(num_tri,3);
+  N.resize(num_tri,3);
+  parallel_for(num_tri,[&](const size_t t)
+  {
+    for(int i = 0;i<3;i++)
+    {
+      N(t,i) = read_float(data,t,i);
+    }
+    for(int k = 0;k<3;k++)
+    {
+      F(t,k) = 3*t+k;
+      for(int i = 0;i<3;i++)
+      {
+        V(3*t+k,i) = read_float(data,t,3+3*k+i);
+      }
+    }
+  },MIN_PARALLEL);
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF, typename DerivedN>
+IGL_INLINE bool igl::fast_readSTL(
+  const std::string & filename,
+  const double epsilon,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedN> & N)
+{
+  using namespace igl::fast_stl;
+  IGL_PROFILE_SCOPE("fast_readSTL");
+  MappedFile file;
+  if(!file.open(filename))
+  {
+    return false;
+  }
+  uint32_t num_tri;
+  if(!is_binary(file.data(),file.size(),num_tri))
+  {
+    file.close();
+    Eigen::MatrixXd SV;
+    Eigen::MatrixXi SF;
+    if(!readSTL(filename,SV,SF,N))
+    {
+      return false;
+    }
+    weld(
+      SF.rows(),
+      [&SV,&SF](const int c, double p[3])
+      {
+        for(int i = 0;i<3;i++)
+        {
+          p[i] = SV(SF(c/3,c%3),i);
+        }
+      },
+      epsilon,V,F);
+    return true;
+  }
+  if(file.size() < HEADER_SIZE+RECORD_SIZE*(size_t)num_tri)
+  {
+    fprintf(stderr,"IOError: fast_readSTL() %s is too short\n",
+      filename.c_str());
+    return false;
+  }
+  if(3*(size_t)num_tri > (size_t)INT_MAX)
+  {
+    fprintf(stderr,"IOError: fast_readSTL() %s has too many facets\n",
+      filename.c_str());
+    return false;
+  }
+  const char * data = file.data();
+  N.resize(num_tri,3);
+  parallel_for(num_tri,[&](const size_t t)
+  {
+    for(int i = 0;i<3;i++)
+    {
+      N(t,i) = read_float(data,t,i);
+    }
+  },MIN_PARALLEL);
+  // Corners are read straight from the mapped file
+  weld(
+    num_tri,
+    [data](const int c, double p[3])
+    {
+      for(int i = 0;i<3;i++)
+      {
+        p[i] = read_float(data,c/3,3+3*(c%3)+i);
+      }
+    },
+    epsilon,V,F);
+  return true;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_readSTL<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readSTL<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readSTL<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
+template bool igl::fast_readSTL<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(std::string const&, double, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,66 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_READSTL_H
+#define IGL_FAST_READSTL_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Read a mesh from a binary stl file straight into Eigen matrices. Same
+  // output as igl::readSTL, but the file is memory-mapped and the 50-byte
+  // facet records are decoded in parallel. Ascii files are read with
+  // igl::readSTL.
+  //
+  // Inputs:
+  //   filename  path to .stl file
+  // Outputs:
+  //   V  #F*3 by 3 list of corner positions
+  //   F  #F by 3 list of triangle indices into V (row f is 3f,3f+1,3f+2)
+  //   N  #F by 3 list of facet normals
+  // Returns true on success, false (with message to stderr) on errors
+  //
+  // See also: readSTL
+  template <typename DerivedV, typename DerivedF, typename DerivedN>
+  IGL_INLINE bool fast_readSTL(
+    const std::string & filename,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedN> & N);
+  // Read and weld duplicate corners in the same pass, replacing
+  //
+  //   readSTL(filename,SV,SF,N);
+  //   remove_duplicate_vertices(SV,SF,epsilon,V,SVI,SVJ,F);
+  //
+  // Corners are merged in parallel with a hash table rather than by
+  // sorting. Vertices are ordered by first occurrence in the file (so the
+  // result doesn't depend on the number of threads) and keep the position
+  // of that occurrence.
+  //
+  // Inputs:
+  //   epsilon  corners whose coordinates rounded to multiples of 10*epsilon
+  //     agree are merged (as in remove_duplicate_vertices), 0 merges only
+  //     corners with identical coordinates
+  // Outputs:
+  //   V  #V by 3 list of unique vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  template <typename DerivedV, typename DerivedF, typename DerivedN>
+  IGL_INLINE bool fast_readSTL(
+    const std::string & filename,
+    const double epsilon,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedN> & N);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_readSTL.cpp"
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_winding_number.h"
+#include "FastWindingNumber.h"
+
+IGL_INLINE void igl::fast_winding_number(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const Eigen::MatrixXd & Q,
+  Eigen::VectorXd & W,
+  const double beta)
+{
+  FastWindingNumber fwn;
+  fwn.init(V,F);
+  fwn.winding_number(Q,beta,W);
+}
+
+IGL_INLINE void igl::fast_winding_number(
+  const Eigen::MatrixXd & P,
+  const Eigen::MatrixXd & N,
+  const Eigen::VectorXd & A,
+  const Eigen::MatrixXd & Q,
+  Eigen::VectorXd & W,
+  const double beta)
+{
+  FastWindingNumber fwn;
+  fwn.init(P,N,A);
+  fwn.winding_number(Q,beta,W);
+}
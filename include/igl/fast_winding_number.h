@@ -0,0 +1,55 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WINDING_NUMBER_H
+#define IGL_FAST_WINDING_NUMBER_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // FAST_WINDING_NUMBER Approximate the generalized winding number of a
+  // triangle soup at many query points using a hierarchical dipole
+  // expansion. See igl::FastWindingNumber to reuse the precomputation across
+  // calls, and igl::winding_number for exact evaluation.
+  //
+  // Inputs:
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   Q  #Q by 3 list of query points
+  //   beta  accuracy parameter, larger is more accurate and slower {2}
+  // Outputs:
+  //   W  #Q list of winding numbers
+  IGL_INLINE void fast_winding_number(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const Eigen::MatrixXd & Q,
+    Eigen::VectorXd & W,
+    const double beta = 2.0);
+  // Approximate the winding number of an oriented point cloud.
+  //
+  // Inputs:
+  //   P  #P by 3 list of point positions
+  //   N  #P by 3 list of unit outward normals
+  //   A  #P list of areas associated with each point
+  //   Q  #Q by 3 list of query points
+  //   beta  accuracy parameter, larger is more accurate and slower {2}
+  // Outputs:
+  //   W  #Q list of winding numbers
+  IGL_INLINE void fast_winding_number(
+    const Eigen::MatrixXd & P,
+    const Eigen::MatrixXd & N,
+    const Eigen::VectorXd & A,
+    const Eigen::MatrixXd & Q,
+    Eigen::VectorXd & W,
+    const double beta = 2.0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_winding_number.cpp"
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_writeDMAT.h"
+#include "Profiler.h"
+#include "to_chars.h"
+#include "write_ascii_rows.h"
+#include <cstdio>
+
+template <typename DerivedW>
+IGL_INLINE bool igl::fast_writeDMAT(
+  const std::string & file_name,
+  const Eigen::MatrixBase<DerivedW> & W,
+  const int precision)
+{
+  IGL_PROFILE_SCOPE("fast_writeDMAT");
+  FILE * fp = fopen(file_name.c_str(),"wb");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"IOError: fast_writeDMAT() could not open %s...\n",
+      file_name.c_str());
+    return false;
+  }
+  // Evaluate expressions once
+  const typename DerivedW::PlainObject P = W;
+  const size_t rows = P.rows();
+  bool ok = fprintf(fp,"%d %d\n",(int)P.cols(),(int)P.rows()) > 0;
+  // Column-major, one entry per line
+  ok = ok && write_ascii_rows(fp,P.size(),TO_CHARS_MAX_LENGTH+1,
+    [&](const size_t k, char * p)
+    {
+      p = to_chars(p,P(k%rows,k/rows),precision);
+      *p++ = '\n';
+      return p;
+    });
+  ok = fclose(fp) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: fast_writeDMAT() could not write %s...\n",
+      file_name.c_str());
+  }
+  return ok;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_writeDMAT<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeDMAT<Eigen::Matrix<float, -1, -1, 0, -1, -1> >(std::string const&, Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeDMAT<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeDMAT<Eigen::Matrix<double, -1, 1, 0, -1, 1> >(std::string const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, int);
+template bool igl::fast_writeDMAT<Eigen::Matrix<int, -1, 1, 0, -1, 1> >(std::string const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, int);
+#endif
@@ -0,0 +1,40 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WRITEDMAT_H
+#define IGL_FAST_WRITEDMAT_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Write a matrix to an ascii dmat file, like writeDMAT(...,true). Numbers
+  // are formatted with to_chars into large buffers and chunks of lines are
+  // formatted in parallel before being written in order. (Binary dmat files
+  // are already written in one go by writeDMAT(...,false).)
+  //
+  // Inputs:
+  //   file_name  path to .dmat file
+  //   W  eigen matrix containing to-be-written coefficients
+  //   precision  number of significant digits, or 0 to write the shortest
+  //     representation that reads back exactly {0}
+  // Returns true on success, false on error
+  //
+  // See also: writeDMAT, readDMAT, to_chars
+  template <typename DerivedW>
+  IGL_INLINE bool fast_writeDMAT(
+    const std::string & file_name,
+    const Eigen::MatrixBase<DerivedW> & W,
+    const int precision = 0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_writeDMAT.cpp"
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_writeOBJ.h"
+#include "Profiler.h"
+#include "to_chars.h"
+#include "write_ascii_rows.h"
+#include <cstdio>
+
+namespace igl
+{
+  namespace fast_write_obj
+  {
+    // Write "prefix A(i,0) A(i,1) ...\n" at p
+    template <typename DerivedA>
+    inline char * put_row(
+      const char * prefix,
+      const Eigen::PlainObjectBase<DerivedA> & A,
+      const Eigen::Index i,
+      const int precision,
+      char * p)
+    {
+      for(const char * c = prefix;*c;c++)
+      {
+        *p++ = *c;
+      }
+      for(Eigen::Index j = 0;j<A.cols();j++)
+      {
+        *p++ = ' ';
+        p = to_chars(p,A(i,j),precision);
+      }
+      *p++ = '\n';
+      return p;
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedCN,
+  typename DerivedFN,
+  typename DerivedTC,
+  typename DerivedFTC>
+IGL_INLINE bool igl::fast_writeOBJ(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const Eigen::PlainObjectBase<DerivedCN>& CN,
+  const Eigen::PlainObjectBase<DerivedFN>& FN,
+  const Eigen::PlainObjectBase<DerivedTC>& TC,
+  const Eigen::PlainObjectBase<DerivedFTC>& FTC,
+  const int precision)
+{
+  using namespace igl::fast_write_obj;
+  IGL_PROFILE_SCOPE("fast_writeOBJ");
+  const bool write_N = CN.rows() > 0;
+  const bool write_texture_coords = TC.rows() > 0;
+  if((write_N && (FN.rows() != F.rows() || FN.cols() != F.cols())) ||
+    (write_texture_coords &&
+      (FTC.rows() != F.rows() || FTC.cols() != F.cols())))
+  {
+    fprintf(stderr,"IOError: fast_writeOBJ() FN/FTC should match F\n");
+    return false;
+  }
+  FILE * obj_file = fopen(filename.c_str(),"w");
+  if(NULL==obj_file)
+  {
+    fprintf(stderr,"IOError: %s could not be opened for writing...\n",
+      filename.c_str());
+    return false;
+  }
+  const auto max_length = [](const Eigen::Index cols)
+  {
+    return 2+cols*(1+TO_CHARS_MAX_LENGTH)+1;
+  };
+  bool ok = write_ascii_rows(obj_file,V.rows(),max_length(V.cols()),
+    [&](const size_t i, char * p){ return put_row("v",V,i,precision,p); });
+  if(write_N)
+  {
+    ok = ok && write_ascii_rows(obj_file,CN.rows(),max_length(CN.cols()),
+      [&](const size_t i, char * p){ return put_row("vn",CN,i,precision,p); });
+    ok = ok && fputc('\n',obj_file) != EOF;
+  }
+  if(write_texture_coords)
+  {
+    ok = ok && write_ascii_rows(obj_file,TC.rows(),max_length(TC.cols()),
+      [&](const size_t i, char * p){ return put_row("vt",TC,i,precision,p); });
+    ok = ok && fputc('\n',obj_file) != EOF;
+  }
+  // OBJ is 1-indexed
+  const size_t max_face_length = 1+F.cols()*(1+3*(TO_CHARS_MAX_LENGTH+1))+1;
+  ok = ok && write_ascii_rows(obj_file,F.rows(),max_face_length,
+    [&](const size_t i, char * p)
+    {
+      *p++ = 'f';
+      for(Eigen::Index j = 0;j<F.cols();j++)
+      {
+        *p++ = ' ';
+        p = to_chars(p,static_cast<long long>(F(i,j))+1);
+        if(write_texture_coords)
+        {
+          *p++ = '/';
+          p = to_chars(p,static_cast<long long>(FTC(i,j))+1);
+        }
+        if(write_N)
+        {
+          *p++ = '/';
+          if(!write_texture_coords)
+          {
+            *p++ = '/';
+          }
+          p = to_chars(p,static_cast<long long>(FN(i,j))+1);
+        }
+      }
+      *p++ = '\n';
+      return p;
+    });
+  ok = fclose(obj_file) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: %s could not be written...\n",filename.c_str());
+  }
+  return ok;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_writeOBJ(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const int precision)
+{
+  const Eigen::MatrixXd CN,TC;
+  const Eigen::MatrixXi FN,FTC;
+  return fast_writeOBJ(filename,V,F,CN,FN,TC,FTC,precision);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_writeOBJ<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOBJ<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOBJ<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOBJ<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int);
+#endif
@@ -0,0 +1,62 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WRITEOBJ_H
+#define IGL_FAST_WRITEOBJ_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Write a mesh to an ascii obj file, producing the same lines as writeOBJ.
+  // Numbers are formatted with to_chars (by default with the fewest digits
+  // that read back exactly, instead of 17) into large buffers, chunks of
+  // lines are formatted in parallel and then written in order.
+  //
+  // Inputs:
+  //   filename  path to .obj file
+  //   V  #V by 3 mesh vertex positions
+  //   F  #F by 3|4 mesh indices into V
+  //   CN #CN by 3 normal vectors
+  //   FN  #F by 3|4 corner normal indices into CN
+  //   TC  #TC by 2|3 texture coordinates
+  //   FTC #F by 3|4 corner texture coord indices into TC
+  //   precision  number of significant digits of coordinates, or 0 to write
+  //     the shortest representation that reads back exactly {0}
+  // Returns true on success, false on error
+  //
+  // See also: writeOBJ, fast_readOBJ, to_chars
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedCN,
+    typename DerivedFN,
+    typename DerivedTC,
+    typename DerivedFTC>
+  IGL_INLINE bool fast_writeOBJ(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV>& V,
+    const Eigen::PlainObjectBase<DerivedF>& F,
+    const Eigen::PlainObjectBase<DerivedCN>& CN,
+    const Eigen::PlainObjectBase<DerivedFN>& FN,
+    const Eigen::PlainObjectBase<DerivedTC>& TC,
+    const Eigen::PlainObjectBase<DerivedFTC>& FTC,
+    const int precision = 0);
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_writeOBJ(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV>& V,
+    const Eigen::PlainObjectBase<DerivedF>& F,
+    const int precision = 0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_writeOBJ.cpp"
+#endif
+
+#endif
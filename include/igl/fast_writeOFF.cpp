@@ -0,0 +1,104 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_writeOFF.h"
+#include "Profiler.h"
+#include "to_chars.h"
+#include "write_ascii_rows.h"
+#include <cstdio>
+
+template <typename DerivedV, typename DerivedF, typename DerivedC>
+IGL_INLINE bool igl::fast_writeOFF(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const Eigen::PlainObjectBase<DerivedC>& C,
+  const int precision)
+{
+  IGL_PROFILE_SCOPE("fast_writeOFF");
+  const bool write_C = C.rows() > 0;
+  if(write_C && (C.rows() != V.rows() || C.cols() != 3))
+  {
+    fprintf(stderr,"IOError: fast_writeOFF() Only color per vertex "
+      "supported. V and C should have same size.\n");
+    return false;
+  }
+  FILE * fp = fopen(filename.c_str(),"w");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"IOError: fast_writeOFF() could not open %s\n",
+      filename.c_str());
+    return false;
+  }
+  bool ok = fprintf(fp,"%s\n%d %d 0\n",
+    write_C ? "COFF" : "OFF",(int)V.rows(),(int)F.rows()) > 0;
+  // Check if RGB values are in the range [0..1] or [0..255]
+  const double rgb_scale = write_C && C.maxCoeff() <= 1.0 ? 255 : 1;
+  ok = ok && write_ascii_rows(fp,V.rows(),
+    V.cols()*(TO_CHARS_MAX_LENGTH+1)+4*(TO_CHARS_MAX_LENGTH+1),
+    [&](const size_t i, char * p)
+    {
+      for(Eigen::Index j = 0;j<V.cols();j++)
+      {
+        p = to_chars(p,V(i,j),precision);
+        *p++ = ' ';
+      }
+      if(write_C)
+      {
+        for(Eigen::Index j = 0;j<3;j++)
+        {
+          p = to_chars(p,
+            static_cast<long long>((unsigned)(rgb_scale*C(i,j))));
+          *p++ = ' ';
+        }
+        *p++ = '2';
+        *p++ = '5';
+        *p++ = '5';
+        *p++ = ' ';
+      }
+      // Replace trailing space
+      p[-1] = '\n';
+      return p;
+    });
+  ok = ok && write_ascii_rows(fp,F.rows(),(F.cols()+1)*(TO_CHARS_MAX_LENGTH+1),
+    [&](const size_t f, char * p)
+    {
+      p = to_chars(p,static_cast<long long>(F.cols()));
+      for(Eigen::Index j = 0;j<F.cols();j++)
+      {
+        *p++ = ' ';
+        p = to_chars(p,static_cast<long long>(F(f,j)));
+      }
+      *p++ = '\n';
+      return p;
+    });
+  ok = fclose(fp) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: fast_writeOFF() could not write %s\n",
+      filename.c_str());
+  }
+  return ok;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_writeOFF(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const int precision)
+{
+  return fast_writeOFF(filename,V,F,Eigen::MatrixXd(),precision);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_writeOFF<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOFF<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOFF<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeOFF<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int);
+#endif
@@ -0,0 +1,50 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WRITEOFF_H
+#define IGL_FAST_WRITEOFF_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Write a mesh to an ascii off file, like writeOFF. Numbers are formatted
+  // with to_chars into large buffers and chunks of lines are formatted in
+  // parallel before being written in order.
+  //
+  // Inputs:
+  //   filename  path to .off output file
+  //   V  #V by 3 mesh vertex positions
+  //   F  #F by degree mesh indices into V
+  //   precision  number of significant digits of coordinates, or 0 to write
+  //     the shortest representation that reads back exactly {0}
+  // Returns true on success, false on errors
+  //
+  // See also: writeOFF, to_chars
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_writeOFF(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV>& V,
+    const Eigen::PlainObjectBase<DerivedF>& F,
+    const int precision = 0);
+  // Inputs:
+  //   C  #V by 3 list of rgb colors per vertex (in [0,1] or [0,255])
+  template <typename DerivedV, typename DerivedF, typename DerivedC>
+  IGL_INLINE bool fast_writeOFF(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV>& V,
+    const Eigen::PlainObjectBase<DerivedF>& F,
+    const Eigen::PlainObjectBase<DerivedC>& C,
+    const int precision = 0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_writeOFF.cpp"
+#endif
+
+#endif
@@ -0,0 +1,347 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_writePLY.h"
+#include "Profiler.h"
+#include "parallel_for.h"
+#include "to_chars.h"
+#include "write_ascii_rows.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+namespace igl
+{
+  namespace fast_write_ply
+  {
+    // Records packed per fwrite
+    const size_t BLOCK_SIZE = 1<<16;
+    // Records packed at once by one thread
+    const size_t CHUNK_SIZE = 4096;
+    // Type written for entries of type Scalar
+    template <typename Scalar>
+    inline const char * type_name()
+    {
+      return sizeof(Scalar) == sizeof(float) ? "float" : "double";
+    }
+    template <typename Scalar>
+    inline size_t type_size()
+    {
+      return sizeof(Scalar) == sizeof(float) ? sizeof(float) : sizeof(double);
+    }
+    // Append entries of row i of A as float or double
+    template <typename DerivedA>
+    inline void put_row(
+      const Eigen::PlainObjectBase<DerivedA> & A,
+      const Eigen::Index i,
+      char * & p)
+    {
+      typedef typename DerivedA::Scalar Scalar;
+      for(Eigen::Index j = 0;j<A.cols();j++)
+      {
+        if(type_size<Scalar>() == sizeof(float))
+        {
+          const float x = (float)A(i,j);
+          memcpy(p,&x,sizeof(float));
+          p += sizeof(float);
+        }else
+        {
+          const double x = (double)A(i,j);
+          memcpy(p,&x,sizeof(double));
+          p += sizeof(double);
+        }
+      }
+    }
+    // Append "A(i,0) A(i,1) ... " formatted as ascii
+    template <typename DerivedA>
+    inline void put_ascii_row(
+      const Eigen::PlainObjectBase<DerivedA> & A,
+      const Eigen::Index i,
+      const int precision,
+      char * & p)
+    {
+      for(Eigen::Index j = 0;j<A.cols();j++)
+      {
+        p = to_chars(p,A(i,j),precision);
+        *p++ = ' ';
+      }
+    }
+    inline bool little_endian()
+    {
+      const uint16_t one = 1;
+      char c;
+      memcpy(&c,&one,1);
+      return c == 1;
+    }
+    // Write n records of record_size bytes packed by pack(i,p) in blocks
+    template <typename PackFunc>
+    inline bool write_records(
+      FILE * fp,
+      const size_t n,
+      const size_t record_size,
+      const PackFunc & pack)
+    {
+      std::vector<char> buffer(std::min(n,BLOCK_SIZE)*record_size);
+      for(size_t b = 0;b<n;b += BLOCK_SIZE)
+      {
+        const size_t m = std::min(BLOCK_SIZE,n-b);
+        const size_t num_chunks = (m+CHUNK_SIZE-1)/CHUNK_SIZE;
+        parallel_for(num_chunks,[&](const size_t c)
+        {
+          const size_t last = std::min(m,(c+1)*CHUNK_SIZE);
+          for(size_t r = c*CHUNK_SIZE;r<last;r++)
+          {
+            char * p = buffer.data()+r*record_size;
+            pack(b+r,p);
+          }
+        },2);
+        if(fwrite(buffer.data(),record_size,m,fp) != m)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedN,
+  typename DerivedUV,
+  typename DerivedC>
+IGL_INLINE bool igl::fast_writePLY(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Eigen::PlainObjectBase<DerivedN> & N,
+  const Eigen::PlainObjectBase<DerivedUV> & UV,
+  const Eigen::PlainObjectBase<DerivedC> & C,
+  const Eigen::MatrixXd & VD,
+  const std::vector<std::string> & Vheader,
+  const Eigen::MatrixXd & FD,
+  const std::vector<std::string> & Fheader,
+  const bool ascii,
+  const int precision)
+{
+  using namespace igl::fast_write_ply;
+  IGL_PROFILE_SCOPE("fast_writePLY");
+  typedef typename DerivedV::Scalar VScalar;
+  typedef typename DerivedN::Scalar NScalar;
+  typedef typename DerivedUV::Scalar UVScalar;
+  typedef typename DerivedC::Scalar CScalar;
+  const Eigen::Index nv = V.rows();
+  const bool has_N = N.rows() > 0;
+  const bool has_UV = UV.rows() > 0;
+  const bool has_C = C.rows() > 0;
+  const bool has_VD = VD.cols() > 0;
+  const bool has_FD = FD.cols() > 0;
+  const bool uchar_C = std::numeric_limits<CScalar>::is_integer;
+  if(V.cols() < 2 || V.cols() > 3 ||
+    (has_N && (N.rows() != nv || N.cols() != 3)) ||
+    (has_UV && (UV.rows() != nv || UV.cols() != 2)) ||
+    (has_C && (C.rows() != nv || C.cols() < 3 || C.cols() > 4)) ||
+    (has_VD && (VD.rows() != nv || (size_t)VD.cols() != Vheader.size())) ||
+    (has_FD &&
+      (FD.rows() != F.rows() || (size_t)FD.cols() != Fheader.size())) ||
+    F.cols() > 255)
+  {
+    fprintf(stderr,"IOError: fast_writePLY() inputs have wrong sizes\n");
+    return false;
+  }
+  // Header
+  std::ostringstream header;
+  header<<"ply\n";
+  header<<"format "<<(ascii ? "ascii" :
+    (little_endian() ? "binary_little_endian" : "binary_big_endian"))<<
+    " 1.0\n";
+  header<<"comment libigl\n";
+  header<<"element vertex "<<nv<<"\n";
+  const char * xyz[] = {"x","y","z"};
+  for(Eigen::Index j = 0;j<V.cols();j++)
+  {
+    header<<"property "<<type_name<VScalar>()<<" "<<xyz[j]<<"\n";
+  }
+  size_t vsize = V.cols()*type_size<VScalar>();
+  if(has_N)
+  {
+    header<<"property "<<type_name<NScalar>()<<" nx\n";
+    header<<"property "<<type_name<NScalar>()<<" ny\n";
+    header<<"property "<<type_name<NScalar>()<<" nz\n";
+    vsize += 3*type_size<NScalar>();
+  }
+  if(has_UV)
+  {
+    header<<"property "<<type_name<UVScalar>()<<" s\n";
+    header<<"property "<<type_name<UVScalar>()<<" t\n";
+    vsize += 2*type_size<UVScalar>();
+  }
+  if(has_C)
+  {
+    const char * rgba[] = {"red","green","blue","alpha"};
+    for(Eigen::Index j = 0;j<C.cols();j++)
+    {
+      header<<"property "<<(uchar_C ? "uchar" : "float")<<" "<<rgba[j]<<"\n";
+    }
+    vsize += C.cols()*(uchar_C ? 1 : sizeof(float));
+  }
+  for(const auto & name : Vheader)
+  {
+    header<<"property double "<<name<<"\n";
+  }
+  vsize += VD.cols()*sizeof(double);
+  header<<"element face "<<F.rows()<<"\n";
+  header<<"property list uchar int vertex_indices\n";
+  for(const auto & name : Fheader)
+  {
+    header<<"property double "<<name<<"\n";
+  }
+  const size_t fsize = 1+F.cols()*sizeof(int)+FD.cols()*sizeof(double);
+  header<<"end_header\n";
+
+  FILE * fp = fopen(filename.c_str(),"wb");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"IOError: %s could not be opened for writing...\n",
+      filename.c_str());
+    return false;
+  }
+  const std::string h = header.str();
+  bool ok = fwrite(h.data(),1,h.size(),fp) == h.size();
+  if(ascii)
+  {
+    const size_t num_v = V.cols()+3*has_N+2*has_UV+C.cols()*has_C+VD.cols();
+    ok = ok && write_ascii_rows(fp,nv,num_v*(TO_CHARS_MAX_LENGTH+1)+1,
+      [&](const size_t i, char * p)
+      {
+        put_ascii_row(V,i,precision,p);
+        if(has_N)
+        {
+          put_ascii_row(N,i,precision,p);
+        }
+        if(has_UV)
+        {
+          put_ascii_row(UV,i,precision,p);
+        }
+        if(has_C)
+        {
+          for(Eigen::Index j = 0;j<C.cols();j++)
+          {
+            p = uchar_C ?
+              to_chars(p,(int)(unsigned char)C(i,j)) :
+              to_chars(p,(float)C(i,j),precision);
+            *p++ = ' ';
+          }
+        }
+        if(has_VD)
+        {
+          put_ascii_row(VD,i,precision,p);
+        }
+        // Replace trailing space
+        p[-1] = '\n';
+        return p;
+      });
+    ok = ok && write_ascii_rows(fp,F.rows(),
+      (1+F.cols()+FD.cols())*(TO_CHARS_MAX_LENGTH+1),
+      [&](const size_t f, char * p)
+      {
+        p = to_chars(p,(int)F.cols());
+        for(Eigen::Index k = 0;k<F.cols();k++)
+        {
+          *p++ = ' ';
+          p = to_chars(p,(long long)F(f,k));
+        }
+        *p++ = ' ';
+        if(has_FD)
+        {
+          put_ascii_row(FD,f,precision,p);
+        }
+        p[-1] = '\n';
+        return p;
+      });
+  }else
+  {
+    ok = ok && write_records(fp,nv,vsize,[&](const size_t i, char * p)
+    {
+      put_row(V,i,p);
+      if(has_N)
+      {
+        put_row(N,i,p);
+      }
+      if(has_UV)
+      {
+        put_row(UV,i,p);
+      }
+      if(has_C)
+      {
+        for(Eigen::Index j = 0;j<C.cols();j++)
+        {
+          if(uchar_C)
+          {
+            *p++ = (char)(unsigned char)C(i,j);
+          }else
+          {
+            const float x = (float)C(i,j);
+            memcpy(p,&x,sizeof(float));
+            p += sizeof(float);
+          }
+        }
+      }
+      if(has_VD)
+      {
+        put_row(VD,i,p);
+      }
+    });
+    const unsigned char degree = (unsigned char)F.cols();
+    ok = ok && write_records(fp,F.rows(),fsize,[&](const size_t f, char * p)
+    {
+      *p++ = (char)degree;
+      for(Eigen::Index k = 0;k<F.cols();k++)
+      {
+        const int v = (int)F(f,k);
+        memcpy(p,&v,sizeof(int));
+        p += sizeof(int);
+      }
+      if(has_FD)
+      {
+        put_row(FD,f,p);
+      }
+    });
+  }
+  ok = fclose(fp) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: %s could not be written...\n",filename.c_str());
+  }
+  return ok;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_writePLY(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const bool ascii,
+  const int precision)
+{
+  const Eigen::MatrixXd N,UV,C,VD,FD;
+  const std::vector<std::string> Vheader,Fheader;
+  return fast_writePLY(
+    filename,V,F,N,UV,C,VD,Vheader,FD,Fheader,ascii,precision);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_writePLY<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::Matrix<double, -1, -1, 0, -1, -1> const&, std::vector<std::string, std::allocator<std::string> > const&, Eigen::Matrix<double, -1, -1, 0, -1, -1> const&, std::vector<std::string, std::allocator<std::string> > const&, bool, int);
+template bool igl::fast_writePLY<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, bool, int);
+template bool igl::fast_writePLY<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, bool, int);
+template bool igl::fast_writePLY<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, bool, int);
+#endif
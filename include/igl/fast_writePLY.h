@@ -0,0 +1,77 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WRITEPLY_H
+#define IGL_FAST_WRITEPLY_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+#include <vector>
+
+namespace igl
+{
+  // Write a mesh to a binary ply file (in the byte order of this machine)
+  // or an ascii ply file without going through ply.h. Records are packed
+  // (binary) or formatted with to_chars (ascii) in parallel into a buffer
+  // and written with a single fwrite per block of records.
+  //
+  // Positions, normals and texture coordinates (s,t) are written as float
+  // or double following the scalar type of V, N and UV, colors as uchar if
+  // C is of an integer type (float otherwise), faces as a uchar list of int
+  // (vertex_indices) and extra properties as double.
+  //
+  // Inputs:
+  //   filename  path to .ply file
+  //   V  #V by 3 (or 2) list of vertex positions
+  //   F  #F by degree list of face indices into V
+  //   N  #V by 3 list of vertex normals (or empty)
+  //   UV  #V by 2 list of texture coordinates (or empty)
+  //   C  #V by 3 (or 4) list of vertex colors (or empty)
+  //   VD  #V by #Vheader list of other vertex properties (or empty)
+  //   Vheader  list of names of columns of VD
+  //   FD  #F by #Fheader list of other face properties (or empty)
+  //   Fheader  list of names of columns of FD
+  //   ascii  write ascii file {false}
+  //   precision  number of significant digits of ascii numbers, or 0 to write
+  //     the shortest representation that reads back exactly {0}
+  // Returns true on success, false (with message to stderr) on errors
+  //
+  // See also: writePLY, fast_readPLY, to_chars
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedN,
+    typename DerivedUV,
+    typename DerivedC>
+  IGL_INLINE bool fast_writePLY(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Eigen::PlainObjectBase<DerivedN> & N,
+    const Eigen::PlainObjectBase<DerivedUV> & UV,
+    const Eigen::PlainObjectBase<DerivedC> & C,
+    const Eigen::MatrixXd & VD,
+    const std::vector<std::string> & Vheader,
+    const Eigen::MatrixXd & FD,
+    const std::vector<std::string> & Fheader,
+    const bool ascii = false,
+    const int precision = 0);
+  // Just V and F
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_writePLY(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const bool ascii = false,
+    const int precision = 0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_writePLY.cpp"
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "fast_writeSTL.h"
+#include "Profiler.h"
+#include "to_chars.h"
+#include "write_ascii_rows.h"
+#include <cstdio>
+#include <cstring>
+
+namespace igl
+{
+  namespace fast_write_stl
+  {
+    inline char * put_string(const char * s, char * p)
+    {
+      const size_t n = strlen(s);
+      memcpy(p,s,n);
+      return p + n;
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF, typename DerivedN>
+IGL_INLINE bool igl::fast_writeSTL(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Eigen::PlainObjectBase<DerivedN> & N,
+  const int precision)
+{
+  using namespace igl::fast_write_stl;
+  IGL_PROFILE_SCOPE("fast_writeSTL");
+  const bool write_N = N.rows() > 0;
+  if(V.cols() != 3 || F.cols() != 3 ||
+    (write_N && (N.rows() != F.rows() || N.cols() != 3)))
+  {
+    fprintf(stderr,"IOError: fast_writeSTL() inputs have wrong sizes\n");
+    return false;
+  }
+  FILE * stl_file = fopen(filename.c_str(),"w");
+  if(stl_file == NULL)
+  {
+    fprintf(stderr,"IOError: %s could not be opened for writing.\n",
+      filename.c_str());
+    return false;
+  }
+  bool ok = fprintf(stl_file,"solid %s\n",filename.c_str()) > 0;
+  // 4 lines of 3 numbers and some keywords
+  const size_t max_facet_length = 12*(TO_CHARS_MAX_LENGTH+1)+128;
+  ok = ok && write_ascii_rows(stl_file,F.rows(),max_facet_length,
+    [&](const size_t f, char * p)
+    {
+      p = put_string("facet normal",p);
+      for(int j = 0;j<3;j++)
+      {
+        *p++ = ' ';
+        if(write_N)
+        {
+          p = to_chars(p,N(f,j),precision);
+        }else
+        {
+          *p++ = '0';
+        }
+      }
+      p = put_string("\nouter loop\n",p);
+      for(int c = 0;c<3;c++)
+      {
+        p = put_string("vertex",p);
+        for(int j = 0;j<3;j++)
+        {
+          *p++ = ' ';
+          p = to_chars(p,V(F(f,c),j),precision);
+        }
+        *p++ = '\n';
+      }
+      return put_string("endloop\nendfacet\n",p);
+    });
+  ok = ok && fprintf(stl_file,"endsolid %s\n",filename.c_str()) > 0;
+  ok = fclose(stl_file) == 0 && ok;
+  if(!ok)
+  {
+    fprintf(stderr,"IOError: %s could not be written.\n",filename.c_str());
+  }
+  return ok;
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::fast_writeSTL(
+  const std::string & filename,
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int precision)
+{
+  return fast_writeSTL(filename,V,F,DerivedV(),precision);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::fast_writeSTL<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeSTL<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeSTL<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template bool igl::fast_writeSTL<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int);
+#endif
@@ -0,0 +1,50 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_FAST_WRITESTL_H
+#define IGL_FAST_WRITESTL_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Write a mesh to an ascii stl file, like writeSTL(...,true). Numbers are
+  // formatted with to_chars into large buffers and chunks of facets are
+  // formatted in parallel before being written in order. (Binary stl files
+  // are better written with writeSTL(...,false).)
+  //
+  // Inputs:
+  //   filename  path to .stl file
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   N  #F by 3 list of face normals (or empty to write 0 0 0)
+  //   precision  number of significant digits of coordinates, or 0 to write
+  //     the shortest representation that reads back exactly {0}
+  // Returns true on success, false on errors
+  //
+  // See also: writeSTL, fast_readSTL, to_chars
+  template <typename DerivedV, typename DerivedF, typename DerivedN>
+  IGL_INLINE bool fast_writeSTL(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Eigen::PlainObjectBase<DerivedN> & N,
+    const int precision = 0);
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool fast_writeSTL(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int precision = 0);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "fast_writeSTL.cpp"
+#endif
+
+#endif
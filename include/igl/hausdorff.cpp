@@ -7,6 +7,133 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "hausdorff.h"
 #include "point_mesh_squared_distance.h"
+#include "point_simplex_squared_distance.h"
+#include "AABB.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace igl
+{
+  namespace hausdorff_detail
+  {
+    // Part of one mesh whose distance to the other mesh is to be bounded
+    struct Region
+    {
+      // 0: part of A measured against B, 1: part of B measured against A
+      int side;
+      // Tree node, or NULL for a (sub-)triangle
+      const AABB<Eigen::MatrixXd,3> * node;
+      // Corners of (sub-)triangle as rows
+      Eigen::Matrix3d T;
+      // Primitives of the other mesh closest to the parent region (-1 if
+      // unknown), used as initial guesses
+      int candidates[3];
+    };
+    // Squared distance from p to mesh (V,F), starting from the best of the
+    // candidate primitives
+    //
+    // Outputs:
+    //   i  closest primitive
+    inline double squared_distance(
+      const AABB<Eigen::MatrixXd,3> & tree,
+      const Eigen::MatrixXd & V,
+      const Eigen::MatrixXi & F,
+      const Eigen::RowVector3d & p,
+      const int * candidates,
+      int & i)
+    {
+      double sqr_d = std::numeric_limits<double>::infinity();
+      Eigen::RowVector3d c;
+      i = -1;
+      for(int k = 0;k<3;k++)
+      {
+        if(candidates[k] < 0 || candidates[k] == i)
+        {
+          continue;
+        }
+        double sqr_d_k;
+        Eigen::RowVector3d c_k;
+        point_simplex_squared_distance<3>(p,V,F,candidates[k],sqr_d_k,c_k);
+        if(sqr_d_k < sqr_d)
+        {
+          sqr_d = sqr_d_k;
+          i = candidates[k];
+          c = c_k;
+        }
+      }
+      return tree.squared_distance(V,F,p,sqr_d,i,c);
+    }
+    // Bound the largest distance from points of a region to mesh (V,F)
+    //
+    // Inputs:
+    //   R  region
+    //   V_R  vertex positions of mesh of R
+    //   F_R  faces of mesh of R
+    //   tree  tree over (V,F)
+    // Outputs:
+    //   lower  distance of some point of R
+    //   upper  bound on distance of all points of R
+    //   closest  primitives closest to sample points of R (-1 if unused)
+    inline void bound(
+      const Region & R,
+      const Eigen::MatrixXd & V_R,
+      const Eigen::MatrixXi & F_R,
+      const AABB<Eigen::MatrixXd,3> & tree,
+      const Eigen::MatrixXd & V,
+      const Eigen::MatrixXi & F,
+      double & lower,
+      double & upper,
+      int * closest)
+    {
+      if(R.node)
+      {
+        // Distance is 1-Lipschitz: bound by distance of box center
+        const Eigen::RowVector3d center = R.node->m_box.center().transpose();
+        upper = sqrt(squared_distance(tree,V,F,center,R.candidates,closest[0]))
+          + 0.5*R.node->m_box.diagonal().norm();
+        // Any point on the mesh in the node gives a lower bound
+        const AABB<Eigen::MatrixXd,3> * leaf = R.node;
+        while(!leaf->is_leaf())
+        {
+          leaf = leaf->m_left ? leaf->m_left : leaf->m_right;
+        }
+        const Eigen::RowVector3d p = V_R.row(F_R(leaf->m_primitive,0));
+        lower = sqrt(squared_distance(tree,V,F,p,R.candidates,closest[1]));
+        closest[2] = -1;
+        return;
+      }
+      double d[3];
+      for(int k = 0;k<3;k++)
+      {
+        d[k] = sqrt(
+          squared_distance(tree,V,F,R.T.row(k),R.candidates,closest[k]));
+      }
+      lower = std::max(std::max(d[0],d[1]),d[2]);
+      // Distance to a single triangle is convex, so over R it is largest at
+      // a corner
+      upper = std::numeric_limits<double>::infinity();
+      for(int j = 0;j<3;j++)
+      {
+        double upper_j = d[j];
+        for(int k = 0;k<3 && upper_j < upper;k++)
+        {
+          if(k == j || closest[k] == closest[j])
+          {
+            continue;
+          }
+          double sqr_d;
+          Eigen::RowVector3d c;
+          point_simplex_squared_distance<3>(
+            R.T.row(k),V,F,closest[j],sqr_d,c);
+          upper_j = std::max(upper_j,sqrt(sqr_d));
+        }
+        upper = std::min(upper,upper_j);
+      }
+    }
+  }
+}
 
 template <
   typename DerivedVA, 
@@ -36,6 +163,140 @@ IGL_INLINE void igl::hausdorff(
   d = sqrt(std::max(dba,dab));
 }
 
+template <
+  typename DerivedVA, 
+  typename DerivedFA,
+  typename DerivedVB,
+  typename DerivedFB,
+  typename Scalar>
+IGL_INLINE bool igl::hausdorff(
+  const Eigen::PlainObjectBase<DerivedVA> & VA, 
+  const Eigen::PlainObjectBase<DerivedFA> & FA,
+  const Eigen::PlainObjectBase<DerivedVB> & VB, 
+  const Eigen::PlainObjectBase<DerivedFB> & FB,
+  const Scalar tolerance,
+  const Scalar threshold,
+  Scalar & lower,
+  Scalar & upper)
+{
+  using namespace Eigen;
+  using namespace std;
+  using namespace igl::hausdorff_detail;
+  assert(VA.cols() == 3 && "VA should contain 3d points");
+  assert(FA.cols() == 3 && "FA should contain triangles");
+  assert(VB.cols() == 3 && "VB should contain 3d points");
+  assert(FB.cols() == 3 && "FB should contain triangles");
+  assert(tolerance > 0 && "tolerance should be positive");
+  const MatrixXd V[2] = {VA.template cast<double>(),VB.template cast<double>()};
+  const MatrixXi F[2] = {FA.template cast<int>(),FB.template cast<int>()};
+  if(F[0].rows() == 0 || F[1].rows() == 0)
+  {
+    lower = upper = F[0].rows() == F[1].rows() ?
+      0 : numeric_limits<Scalar>::infinity();
+    return !(lower > threshold);
+  }
+  AABB<MatrixXd,3> tree[2];
+  for(int side = 0;side<2;side++)
+  {
+    tree[side].init(V[side],F[side]);
+  }
+
+  vector<Region> regions(2);
+  for(int side = 0;side<2;side++)
+  {
+    regions[side].side = side;
+    regions[side].node = &tree[side];
+    fill(regions[side].candidates,regions[side].candidates+3,-1);
+  }
+  // Largest distance of any sample found so far
+  double max_lower = 0;
+  // Largest upper bound of regions discarded so far
+  double max_upper = 0;
+  bool exceeded = false;
+  while(!regions.empty())
+  {
+    const int n = regions.size();
+    VectorXd lo(n),up(n);
+    MatrixXi closest(n,3);
+    parallel_for(n,[&regions,&tree,&V,&F,&lo,&up,&closest](const int r)
+    {
+      const int side = regions[r].side;
+      const int other = 1-side;
+      int closest_r[3];
+      bound(
+        regions[r],V[side],F[side],tree[other],V[other],F[other],
+        lo(r),up(r),closest_r);
+      closest.row(r) << closest_r[0],closest_r[1],closest_r[2];
+    },100);
+    max_lower = max(max_lower,lo.maxCoeff());
+    if(max_lower > threshold)
+    {
+      max_upper = max(max_upper,up.maxCoeff());
+      exceeded = true;
+      break;
+    }
+    // Refine regions that may be farther than what was found so far
+    vector<Region> next;
+    for(int r = 0;r<n;r++)
+    {
+      if(up(r) <= max_lower + tolerance)
+      {
+        max_upper = max(max_upper,up(r));
+        continue;
+      }
+      Region child = regions[r];
+      for(int k = 0;k<3;k++)
+      {
+        child.candidates[k] = closest(r,k);
+      }
+      const AABB<MatrixXd,3> * node = regions[r].node;
+      if(node && node->is_leaf())
+      {
+        const int f = node->m_primitive;
+        child.node = NULL;
+        for(int k = 0;k<3;k++)
+        {
+          child.T.row(k) = V[child.side].row(F[child.side](f,k));
+        }
+        next.push_back(child);
+      }else if(node)
+      {
+        for(const AABB<MatrixXd,3> * c : {node->m_left,node->m_right})
+        {
+          if(c)
+          {
+            child.node = c;
+            next.push_back(child);
+          }
+        }
+      }else
+      {
+        // Split into 4 at edge midpoints
+        const Matrix3d & T = regions[r].T;
+        Matrix3d M;
+        for(int k = 0;k<3;k++)
+        {
+          M.row(k) = 0.5*(T.row((k+1)%3)+T.row((k+2)%3));
+        }
+        for(int k = 0;k<3;k++)
+        {
+          child.T.row(k) = T.row(k);
+          child.T.row((k+1)%3) = M.row((k+2)%3);
+          child.T.row((k+2)%3) = M.row((k+1)%3);
+          next.push_back(child);
+        }
+        child.T = M;
+        next.push_back(child);
+      }
+    }
+    regions.swap(next);
+  }
+  lower = max_lower;
+  upper = max(max_lower,max_upper);
+  return !exceeded;
+}
+
 #ifdef IGL_STATIC_LIBRARY
 template void igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double&);
+template bool igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, double, double&, double&);
 #endif
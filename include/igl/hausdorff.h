@@ -26,7 +26,8 @@ namespace igl
   // Hausdorff distance between the non-convex, block letter V polygon (with 7
   // vertices) in 2D and its convex hull. The Hausdorff distance is defined by
   // the midpoint in the middle of the segment across the concavity and some
-  // non-vertex point _on the edge_ of the V.
+  // non-vertex point _on the edge_ of the V. See the overload below for
+  // bounds on the true distance.
   //
   // Inputs:
   //   VA  #VA by 3 list of vertex positions
@@ -50,6 +51,46 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedVB> & VB, 
     const Eigen::PlainObjectBase<DerivedFB> & FB,
     Scalar & d);
+  // Compute lower and upper bounds on the Hausdorff distance between mesh
+  // (VA,FA) and mesh (VB,FB) by branch and bound: starting from the roots of
+  // AABB trees of both meshes, nodes and then triangles (recursively split
+  // into 4) are refined in parallel rounds as long as they may contain a
+  // point farther from the other mesh than the largest distance found so
+  // far (plus tolerance).
+  //
+  // The upper bound of a triangle is the farthest distance of its corners to
+  // any single triangle of the other mesh (distance to a triangle is convex,
+  // so it is largest at a corner). Results do not depend on the number of
+  // threads.
+  //
+  // Inputs:
+  //   VA  #VA by 3 list of vertex positions
+  //   FA  #FA by 3 list of face indices into VA
+  //   VB  #VB by 3 list of vertex positions
+  //   FB  #FB by 3 list of face indices into VB
+  //   tolerance  stop once upper-lower <= tolerance (should be positive)
+  //   threshold  stop as soon as lower > threshold (e.g., to reject a scan
+  //     deviating too much from its model), infinity to never stop early
+  // Outputs:
+  //   lower  lower bound on hausdorff distance
+  //   upper  upper bound on hausdorff distance
+  // Returns false if stopped early because lower > threshold
+  //
+  template <
+    typename DerivedVA, 
+    typename DerivedFA,
+    typename DerivedVB,
+    typename DerivedFB,
+    typename Scalar>
+  IGL_INLINE bool hausdorff(
+    const Eigen::PlainObjectBase<DerivedVA> & VA, 
+    const Eigen::PlainObjectBase<DerivedFA> & FA,
+    const Eigen::PlainObjectBase<DerivedVB> & VB, 
+    const Eigen::PlainObjectBase<DerivedFB> & FB,
+    const Scalar tolerance,
+    const Scalar threshold,
+    Scalar & lower,
+    Scalar & upper);
 }
 
 #ifndef IGL_STATIC_LIBRARY
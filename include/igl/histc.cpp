@@ -6,8 +6,11 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "histc.h"
+#include "parallel_for.h"
+#include "parallel_reduce.h"
 #include <cassert>
 #include <iostream>
+#include <algorithm>
 
 template <typename DerivedX, typename DerivedE, typename DerivedN, typename DerivedB>
 IGL_INLINE void igl::histc(
@@ -20,17 +23,24 @@ IGL_INLINE void igl::histc(
   const int n = E.size();
   const int m = X.size();
   assert(m == B.size());
-  N.resize(n,1);
-  N.setConstant(0);
-#pragma omp parallel for
-  for(int j = 0;j<m;j++)
-  {
-    if(B(j) >= 0)
+  typedef Eigen::Matrix<typename DerivedN::Scalar,Eigen::Dynamic,1> VectorN;
+  // Per-block counts are only worth it if there are many more samples than
+  // bins, otherwise use a single block
+  const int min_parallel = std::max(100000,64*n);
+  const VectorN Nm = igl::parallel_reduce(
+    m,
+    VectorN::Zero(n).eval(),
+    [&B](const int j, VectorN & Nb)
     {
-#pragma omp atomic
-      N(B(j))++;
-    }
-  }
+      if(B(j) >= 0)
+      {
+        Nb((int)B(j))++;
+      }
+    },
+    [](const VectorN & a, const VectorN & b)->VectorN{ return a+b; },
+    min_parallel,
+    m<min_parallel ? m : 0);
+  N = Nm;
 }
 
 template <typename DerivedX, typename DerivedE, typename DerivedB>
@@ -46,15 +56,14 @@ IGL_INLINE void igl::histc(
       E.topLeftCorner(E.size()-1,1)).maxCoeff() >= 0 && 
     "E should be monotonically increasing");
   B.resize(m,1);
-#pragma omp parallel for
-  for(int j = 0;j<m;j++)
+  parallel_for(m,[&X,&E,&B](const int j)
   {
     const double x = X(j);
     // Boring one-offs
     if(x < E(0) || x > E(E.size()-1))
     {
       B(j) = -1;
-      continue;
+      return;
     }
     // Find x in E
     int l = 0;
@@ -81,7 +90,7 @@ IGL_INLINE void igl::histc(
       k = l;
     }
     B(j) = k;
-  }
+  },10000);
 }
 
 template <typename DerivedE>
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "in_element.h"
+#include "parallel_for.h"
 
 template <typename DerivedV, typename DerivedQ, int DIM>
 IGL_INLINE void igl::in_element(
@@ -19,8 +20,7 @@ IGL_INLINE void igl::in_element(
   using namespace Eigen;
   const int Qr = Q.rows();
   I.setConstant(Qr,1,-1);
-#pragma omp parallel for if (Qr>10000)
-  for(int e = 0;e<Qr;e++)
+  parallel_for(Qr,[&V,&Ele,&Q,&aabb,&I](const int e)
   {
     // find all
     const auto R = aabb.find(V,Ele,Q.row(e).eval(),true);
@@ -28,7 +28,7 @@ IGL_INLINE void igl::in_element(
     {
       I(e) = R[0];
     }
-  }
+  },10000);
 }
 
 template <typename DerivedV, typename DerivedQ, int DIM, typename Scalar>
@@ -42,18 +42,27 @@ IGL_INLINE void igl::in_element(
   using namespace std;
   using namespace Eigen;
   const int Qr = Q.rows();
+  // Per-thread lists of triplets, concatenated afterwards
+  std::vector<std::vector<Triplet<Scalar> > > IJVt;
+  parallel_for(
+    Qr,
+    [&IJVt](const size_t n){ IJVt.resize(n); },
+    [&V,&Ele,&Q,&aabb,&IJVt](const int e, const size_t t)
+    {
+      // find all
+      const auto R = aabb.find(V,Ele,Q.row(e).eval(),false);
+      for(const auto r : R)
+      {
+        IJVt[t].push_back(Triplet<Scalar>(e,r,1));
+      }
+    },
+    [](const size_t){},
+    10000);
   std::vector<Triplet<Scalar> > IJV;
   IJV.reserve(Qr);
-#pragma omp parallel for if (Qr>10000)
-  for(int e = 0;e<Qr;e++)
+  for(const auto & IJVi : IJVt)
   {
-    // find all
-    const auto R = aabb.find(V,Ele,Q.row(e).eval(),false);
-    for(const auto r : R)
-    {
-#pragma omp critical
-      IJV.push_back(Triplet<Scalar>(e,r,1));
-    }
+    IJV.insert(IJV.end(),IJVi.begin(),IJVi.end());
   }
   I.resize(Qr,Ele.rows());
   I.setFromTriplets(IJV.begin(),IJV.end());
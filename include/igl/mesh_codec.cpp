@@ -0,0 +1,420 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "mesh_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace igl
+{
+  namespace mesh_codec
+  {
+    // Probabilities are multiples of 1/2^SCALE_BITS
+    const int SCALE_BITS = 12;
+    const uint32_t SCALE = 1u<<SCALE_BITS;
+    // Lower bound of normalized rANS states
+    const uint32_t RANS_L = 1u<<23;
+    // 16 literal symbols + 2 per bit length in [5,32]
+    const int NUM_SYMBOLS = 16 + 2*28;
+    inline int bit_length(const uint32_t u)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return u == 0 ? 0 : 32 - __builtin_clz(u);
+#else
+      int b = 0;
+      for(uint32_t v = u;v;v >>= 1)
+      {
+        b++;
+      }
+      return b;
+#endif
+    }
+    // Split u into symbol and number of raw low bits
+    inline int symbol(const uint32_t u, int & num_extra)
+    {
+      if(u < 16)
+      {
+        num_extra = 0;
+        return u;
+      }
+      const int b = bit_length(u);
+      num_extra = b-2;
+      return 16 + 2*(b-5) + ((u >> (b-2)) & 1);
+    }
+    // Append bits of x (LSB first)
+    struct BitWriter
+    {
+      std::vector<unsigned char> bytes;
+      uint64_t acc = 0;
+      int num_bits = 0;
+      void put(const uint32_t x, const int n)
+      {
+        acc |= static_cast<uint64_t>(x) << num_bits;
+        num_bits += n;
+        while(num_bits >= 8)
+        {
+          bytes.push_back(static_cast<unsigned char>(acc & 0xFF));
+          acc >>= 8;
+          num_bits -= 8;
+        }
+      }
+      void flush()
+      {
+        if(num_bits > 0)
+        {
+          bytes.push_back(static_cast<unsigned char>(acc & 0xFF));
+        }
+        acc = 0;
+        num_bits = 0;
+      }
+    };
+    struct BitReader
+    {
+      const unsigned char * p;
+      const unsigned char * end;
+      uint64_t acc = 0;
+      int num_bits = 0;
+      bool ok = true;
+      BitReader(const unsigned char * _p, const unsigned char * _end):
+        p(_p),end(_end){}
+      uint32_t get(const int n)
+      {
+        while(num_bits < n)
+        {
+          if(p == end)
+          {
+            ok = false;
+            return 0;
+          }
+          acc |= static_cast<uint64_t>(*p++) << num_bits;
+          num_bits += 8;
+        }
+        const uint32_t x = static_cast<uint32_t>(acc & ((uint64_t(1)<<n)-1));
+        acc >>= n;
+        num_bits -= n;
+        return x;
+      }
+    };
+    // Scale counts to frequencies summing to SCALE, keeping every present
+    // symbol at frequency >= 1
+    inline void normalize_frequencies(
+      const std::vector<uint64_t> & counts,
+      const uint64_t total,
+      std::vector<uint32_t> & freq)
+    {
+      freq.assign(counts.size(),0);
+      int64_t sum = 0;
+      for(size_t s = 0;s<counts.size();s++)
+      {
+        if(counts[s] > 0)
+        {
+          freq[s] = std::max<uint32_t>(1,
+            static_cast<uint32_t>((counts[s]*SCALE)/total));
+          sum += freq[s];
+        }
+      }
+      std::vector<int> order;
+      for(size_t s = 0;s<counts.size();s++)
+      {
+        if(freq[s] > 0)
+        {
+          order.push_back(static_cast<int>(s));
+        }
+      }
+      std::sort(order.begin(),order.end(),
+        [&](const int a, const int b){ return freq[a] > freq[b]; });
+      int64_t diff = static_cast<int64_t>(SCALE) - sum;
+      if(diff > 0)
+      {
+        freq[order[0]] += static_cast<uint32_t>(diff);
+      }
+      for(size_t i = 0;diff < 0 && i<order.size();i++)
+      {
+        const int64_t take = std::min<int64_t>(freq[order[i]]-1,-diff);
+        freq[order[i]] -= static_cast<uint32_t>(take);
+        diff += take;
+      }
+    }
+    inline void put_u16(const uint32_t x, std::vector<unsigned char> & data)
+    {
+      data.push_back(static_cast<unsigned char>(x & 0xFF));
+      data.push_back(static_cast<unsigned char>((x >> 8) & 0xFF));
+    }
+  }
+}
+
+IGL_INLINE void igl::mesh_codec::encode_values(
+  const std::vector<uint32_t> & values,
+  std::vector<unsigned char> & data)
+{
+  const size_t n = values.size();
+  std::vector<unsigned char> symbols(n);
+  std::vector<uint64_t> counts(NUM_SYMBOLS,0);
+  BitWriter extra;
+  for(size_t i = 0;i<n;i++)
+  {
+    int num_extra;
+    const int s = symbol(values[i],num_extra);
+    symbols[i] = static_cast<unsigned char>(s);
+    counts[s]++;
+    if(num_extra > 0)
+    {
+      extra.put(values[i] & ((1u<<num_extra)-1),num_extra);
+    }
+  }
+  extra.flush();
+  put_u32(static_cast<uint32_t>(n),data);
+  if(n == 0)
+  {
+    return;
+  }
+  std::vector<uint32_t> freq;
+  normalize_frequencies(counts,n,freq);
+  std::vector<uint32_t> start(NUM_SYMBOLS+1,0);
+  int num_present = 0;
+  for(int s = 0;s<NUM_SYMBOLS;s++)
+  {
+    start[s+1] = start[s] + freq[s];
+    num_present += freq[s] > 0;
+  }
+  data.push_back(static_cast<unsigned char>(num_present));
+  for(int s = 0;s<NUM_SYMBOLS;s++)
+  {
+    if(freq[s] > 0)
+    {
+      data.push_back(static_cast<unsigned char>(s));
+      put_u16(freq[s],data);
+    }
+  }
+  // rANS encodes in reverse, writing bytes backwards (at most 2 per symbol)
+  std::vector<unsigned char> buffer(2*n+4);
+  unsigned char * const end = buffer.data()+buffer.size();
+  unsigned char * p = end;
+  uint32_t x = RANS_L;
+  for(size_t i = n;i-- > 0;)
+  {
+    const int s = symbols[i];
+    const uint32_t x_max = ((RANS_L >> SCALE_BITS) << 8) * freq[s];
+    while(x >= x_max)
+    {
+      *--p = static_cast<unsigned char>(x & 0xFF);
+      x >>= 8;
+    }
+    x = ((x / freq[s]) << SCALE_BITS) + (x % freq[s]) + start[s];
+  }
+  p -= 4;
+  for(int b = 0;b<4;b++)
+  {
+    p[b] = static_cast<unsigned char>((x >> (8*b)) & 0xFF);
+  }
+  put_u32(static_cast<uint32_t>(end-p),data);
+  data.insert(data.end(),p,end);
+  put_u32(static_cast<uint32_t>(extra.bytes.size()),data);
+  data.insert(data.end(),extra.bytes.begin(),extra.bytes.end());
+}
+
+IGL_INLINE bool igl::mesh_codec::decode_values(
+  const unsigned char * data,
+  const size_t size,
+  size_t & offset,
+  const size_t max_count,
+  std::vector<uint32_t> & values)
+{
+  uint32_t n;
+  if(!get_u32(data,size,offset,n) || n > max_count)
+  {
+    return false;
+  }
+  values.resize(n);
+  if(n == 0)
+  {
+    return true;
+  }
+  // Frequency table
+  if(offset >= size)
+  {
+    return false;
+  }
+  const int num_present = data[offset++];
+  if(offset + 3*num_present > size)
+  {
+    return false;
+  }
+  uint32_t freq[NUM_SYMBOLS] = {0};
+  for(int i = 0;i<num_present;i++)
+  {
+    const int s = data[offset];
+    const uint32_t f = data[offset+1] | (uint32_t(data[offset+2]) << 8);
+    offset += 3;
+    if(s >= NUM_SYMBOLS)
+    {
+      return false;
+    }
+    freq[s] = f;
+  }
+  uint32_t start[NUM_SYMBOLS];
+  unsigned char slot_symbol[SCALE];
+  uint32_t sum = 0;
+  for(int s = 0;s<NUM_SYMBOLS;s++)
+  {
+    start[s] = sum;
+    if(sum + freq[s] > SCALE)
+    {
+      return false;
+    }
+    std::fill(slot_symbol+sum,slot_symbol+sum+freq[s],
+      static_cast<unsigned char>(s));
+    sum += freq[s];
+  }
+  if(sum != SCALE)
+  {
+    return false;
+  }
+  uint32_t rans_size,extra_size;
+  if(!get_u32(data,size,offset,rans_size) || rans_size < 4 ||
+    offset + rans_size > size)
+  {
+    return false;
+  }
+  const unsigned char * p = data+offset;
+  const unsigned char * const p_end = p+rans_size;
+  offset += rans_size;
+  if(!get_u32(data,size,offset,extra_size) || offset + extra_size > size)
+  {
+    return false;
+  }
+  BitReader extra(data+offset,data+offset+extra_size);
+  offset += extra_size;
+  uint32_t x = p[0] | (uint32_t(p[1])<<8) | (uint32_t(p[2])<<16) |
+    (uint32_t(p[3])<<24);
+  p += 4;
+  const uint32_t mask = SCALE-1;
+  for(uint32_t i = 0;i<n;i++)
+  {
+    const int s = slot_symbol[x & mask];
+    x = freq[s] * (x >> SCALE_BITS) + (x & mask) - start[s];
+    while(x < RANS_L)
+    {
+      if(p == p_end)
+      {
+        return false;
+      }
+      x = (x << 8) | *p++;
+    }
+    if(s < 16)
+    {
+      values[i] = s;
+    }else
+    {
+      const int b = (s-16)/2 + 5;
+      values[i] = (1u << (b-1)) | (uint32_t((s-16) & 1) << (b-2)) |
+        extra.get(b-2);
+    }
+  }
+  return extra.ok;
+}
+
+IGL_INLINE void igl::mesh_codec::octahedral_encode(
+  const double * n,
+  const int bits,
+  uint32_t * q)
+{
+  const double l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+  double px = 0, py = 0;
+  if(l1 > 0)
+  {
+    px = n[0]/l1;
+    py = n[1]/l1;
+    if(n[2] < 0)
+    {
+      const double ox = px;
+      px = (1.0-std::abs(py)) * (ox >= 0 ? 1.0 : -1.0);
+      py = (1.0-std::abs(ox)) * (py >= 0 ? 1.0 : -1.0);
+    }
+  }
+  // Even range so that 0 is on the grid
+  const double m = static_cast<double>((uint64_t(1)<<bits) - 2);
+  q[0] = static_cast<uint32_t>(std::floor((px*0.5+0.5)*m + 0.5));
+  q[1] = static_cast<uint32_t>(std::floor((py*0.5+0.5)*m + 0.5));
+}
+
+IGL_INLINE void igl::mesh_codec::octahedral_decode(
+  const uint32_t * q,
+  const int bits,
+  double * n)
+{
+  const double m = static_cast<double>((uint64_t(1)<<bits) - 2);
+  double px = std::min(1.0,q[0]/m*2.0-1.0);
+  double py = std::min(1.0,q[1]/m*2.0-1.0);
+  const double pz = 1.0 - std::abs(px) - std::abs(py);
+  if(pz < 0)
+  {
+    const double ox = px;
+    px = (1.0-std::abs(py)) * (ox >= 0 ? 1.0 : -1.0);
+    py = (1.0-std::abs(ox)) * (py >= 0 ? 1.0 : -1.0);
+  }
+  const double l = std::sqrt(px*px + py*py + pz*pz);
+  n[0] = px/l;
+  n[1] = py/l;
+  n[2] = pz/l;
+}
+
+IGL_INLINE void igl::mesh_codec::put_u32(
+  const uint32_t x,
+  std::vector<unsigned char> & data)
+{
+  for(int b = 0;b<4;b++)
+  {
+    data.push_back(static_cast<unsigned char>((x >> (8*b)) & 0xFF));
+  }
+}
+
+IGL_INLINE void igl::mesh_codec::put_f64(
+  const double x,
+  std::vector<unsigned char> & data)
+{
+  uint64_t bits;
+  memcpy(&bits,&x,sizeof(double));
+  put_u32(static_cast<uint32_t>(bits & 0xFFFFFFFFu),data);
+  put_u32(static_cast<uint32_t>(bits >> 32),data);
+}
+
+IGL_INLINE bool igl::mesh_codec::get_u32(
+  const unsigned char * data,
+  const size_t size,
+  size_t & offset,
+  uint32_t & x)
+{
+  if(offset + 4 > size)
+  {
+    return false;
+  }
+  x = 0;
+  for(int b = 0;b<4;b++)
+  {
+    x |= uint32_t(data[offset+b]) << (8*b);
+  }
+  offset += 4;
+  return true;
+}
+
+IGL_INLINE bool igl::mesh_codec::get_f64(
+  const unsigned char * data,
+  const size_t size,
+  size_t & offset,
+  double & x)
+{
+  uint32_t lo,hi;
+  if(!get_u32(data,size,offset,lo) || !get_u32(data,size,offset,hi))
+  {
+    return false;
+  }
+  const uint64_t bits = (uint64_t(hi) << 32) | lo;
+  memcpy(&x,&bits,sizeof(double));
+  return true;
+}
@@ -0,0 +1,107 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MESH_CODEC_H
+#define IGL_MESH_CODEC_H
+#include "igl_inline.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace igl
+{
+  // Building blocks shared by encode_mesh and decode_mesh.
+  namespace mesh_codec
+  {
+    // First bytes of an encoded mesh
+    const char MAGIC[4] = {'I','G','L','Z'};
+    const unsigned char VERSION = 1;
+    // Entropy code a list of (typically small) unsigned values and append
+    // the result to data. Values below 16 are symbols of their own, larger
+    // values are split into a symbol (bit length and next highest bit) and
+    // raw low bits. Symbols are coded with a static rANS coder (12-bit
+    // probabilities) whose frequency table is stored with the stream.
+    //
+    // Inputs:
+    //   values  list of values to encode
+    //   data  bytes to append to
+    // Outputs:
+    //   data  bytes with encoded stream appended
+    IGL_INLINE void encode_values(
+      const std::vector<uint32_t> & values,
+      std::vector<unsigned char> & data);
+    // Inverse of encode_values
+    //
+    // Inputs:
+    //   data  pointer to encoded bytes
+    //   size  number of bytes at data
+    //   offset  position of the stream in data
+    //   max_count  maximum number of values expected in the stream
+    // Outputs:
+    //   offset  position after the stream
+    //   values  list of decoded values
+    // Returns false if the stream is corrupt or truncated
+    IGL_INLINE bool decode_values(
+      const unsigned char * data,
+      const size_t size,
+      size_t & offset,
+      const size_t max_count,
+      std::vector<uint32_t> & values);
+    // Map signed residuals to unsigned values: 0,-1,1,-2,2,... -> 0,1,2,3,4
+    inline uint32_t zigzag(const int64_t r)
+    {
+      // Shift as unsigned: left shifting a negative value is undefined
+      return static_cast<uint32_t>(
+        (static_cast<uint64_t>(r) << 1) ^ static_cast<uint64_t>(r >> 63));
+    }
+    inline int64_t unzigzag(const uint32_t z)
+    {
+      return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+    }
+    // Quantize a direction to two bits-bit integers using the octahedral
+    // mapping [Cigolle et al. 2014]. The axis directions are represented
+    // exactly.
+    //
+    // Inputs:
+    //   n  3 coordinates of a (not necessarily unit) vector
+    //   bits  number of bits per coordinate
+    // Outputs:
+    //   q  2 quantized coordinates
+    IGL_INLINE void octahedral_encode(
+      const double * n,
+      const int bits,
+      uint32_t * q);
+    // Inverse of octahedral_encode (returns a unit vector)
+    IGL_INLINE void octahedral_decode(
+      const uint32_t * q,
+      const int bits,
+      double * n);
+    // Little endian serialization
+    IGL_INLINE void put_u32(
+      const uint32_t x,
+      std::vector<unsigned char> & data);
+    IGL_INLINE void put_f64(
+      const double x,
+      std::vector<unsigned char> & data);
+    IGL_INLINE bool get_u32(
+      const unsigned char * data,
+      const size_t size,
+      size_t & offset,
+      uint32_t & x);
+    IGL_INLINE bool get_f64(
+      const unsigned char * data,
+      const size_t size,
+      size_t & offset,
+      double & x);
+  }
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "mesh_codec.cpp"
+#endif
+
+#endif
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "min_quad_with_fixed.h"
+#include "Profiler.h"
 
 #include "slice.h"
 #include "is_symmetric.h"
@@ -33,6 +34,7 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
   min_quad_with_fixed_data<T> & data
   )
 {
+  IGL_PROFILE_SCOPE("min_quad_with_fixed_precompute");
 //#define MIN_QUAD_WITH_FIXED_CPP_DEBUG
   using namespace Eigen;
   using namespace std;
@@ -394,6 +396,7 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
   Eigen::PlainObjectBase<DerivedZ> & Z,
   Eigen::PlainObjectBase<Derivedsol> & sol)
 {
+  IGL_PROFILE_SCOPE("min_quad_with_fixed_solve");
   using namespace std;
   using namespace Eigen;
   typedef Matrix<T,Dynamic,1> VectorXT;
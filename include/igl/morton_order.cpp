@@ -0,0 +1,88 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "morton_order.h"
+#include "parallel_for.h"
+#include "parallel_sort.h"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+template <typename DerivedP, typename DerivedK>
+IGL_INLINE void igl::morton_codes(
+  const Eigen::MatrixBase<DerivedP> & P,
+  Eigen::PlainObjectBase<DerivedK> & K)
+{
+  typedef typename DerivedP::Scalar Scalar;
+  assert(P.cols() <= 3 && "Morton codes only implemented up to 3D");
+  const int n = P.rows();
+  K.resize(n,1);
+  if(n == 0)
+  {
+    return;
+  }
+  const Eigen::Matrix<Scalar,1,Eigen::Dynamic> pmin = P.colwise().minCoeff();
+  const Eigen::Matrix<Scalar,1,Eigen::Dynamic> pext =
+    P.colwise().maxCoeff() - pmin;
+  // Spread 20 bits so that there are two zeros between each
+  const auto spread = [](uint64_t x)->uint64_t
+  {
+    x &= 0xfffff;
+    x = (x | (x << 32)) & 0x1f00000000ffffULL;
+    x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+    x = (x | (x <<  8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x <<  4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x <<  2)) & 0x1249249249249249ULL;
+    return x;
+  };
+  parallel_for(n,[&P,&pmin,&pext,&spread,&K](const int i)
+  {
+    uint64_t key = 0;
+    for(int k = 0;k<P.cols();k++)
+    {
+      const Scalar s = pext(k) > 0 ? (P(i,k)-pmin(k))/pext(k) : 0;
+      const uint64_t q =
+        (uint64_t)std::max(Scalar(0),std::min(Scalar(0xfffff),s*0xfffff));
+      key |= spread(q) << k;
+    }
+    K(i) = key;
+  },10000);
+}
+
+template <typename DerivedP, typename DerivedI>
+IGL_INLINE void igl::morton_order(
+  const Eigen::MatrixBase<DerivedP> & P,
+  Eigen::PlainObjectBase<DerivedI> & I)
+{
+  Eigen::Matrix<uint64_t,Eigen::Dynamic,1> K;
+  morton_codes(P,K);
+  const int n = P.rows();
+  std::vector<std::pair<uint64_t,int> > order(n);
+  for(int i = 0;i<n;i++)
+  {
+    order[i] = std::make_pair(K(i),i);
+  }
+  parallel_sort(order.begin(),order.end(),
+    [](const std::pair<uint64_t,int> & a,const std::pair<uint64_t,int> & b)
+    {
+      return a.first < b.first;
+    },
+    10000);
+  I.resize(n,1);
+  for(int i = 0;i<n;i++)
+  {
+    I(i) = order[i].second;
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::morton_codes<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<uint64_t, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<uint64_t, -1, 1, 0, -1, 1> >&);
+template void igl::morton_codes<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<uint64_t, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<uint64_t, -1, 1, 0, -1, 1> >&);
+template void igl::morton_order<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
@@ -0,0 +1,45 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MORTON_ORDER_H
+#define IGL_MORTON_ORDER_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <cstdint>
+namespace igl
+{
+  // MORTON_CODES Compute Z-order (Morton) codes of points: coordinates are
+  // quantized to 20 bits within the bounding box of P and their bits are
+  // interleaved, so points with nearby codes tend to be close in space.
+  //
+  // Inputs:
+  //   P  #P by dim (dim<=3) list of points
+  // Outputs:
+  //   K  #P list of codes (only the lowest 60 bits are used)
+  template <typename DerivedP, typename DerivedK>
+  IGL_INLINE void morton_codes(
+    const Eigen::MatrixBase<DerivedP> & P,
+    Eigen::PlainObjectBase<DerivedK> & K);
+  // MORTON_ORDER Order points along a Z-order (Morton) space filling curve,
+  // e.g. to process queries so that consecutive ones are spatially coherent.
+  //
+  // Inputs:
+  //   P  #P by dim (dim<=3) list of points
+  // Outputs:
+  //   I  #P list of indices into P so that P(I,:) follows the curve (ties
+  //     are kept in input order)
+  template <typename DerivedP, typename DerivedI>
+  IGL_INLINE void morton_order(
+    const Eigen::MatrixBase<DerivedP> & P,
+    Eigen::PlainObjectBase<DerivedI> & I);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "morton_order.cpp"
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_NUM_THREADS_H
+#define IGL_NUM_THREADS_H
+#include <cstddef>
+
+namespace igl
+{
+  // Maximum number of threads (including the calling thread) libigl's
+  // parallel loops may use with the configured backend, see
+  // igl::set_num_threads
+  //
+  // Returns number of threads (1 for the serial backend)
+  inline size_t num_threads();
+}
+
+// Implementation
+
+#include "parallel_backend.h"
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+#  include "ThreadPool.h"
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+#  include <tbb/global_control.h>
+#  include <tbb/task_arena.h>
+#  include <algorithm>
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+#  include <omp.h>
+#endif
+
+inline size_t igl::num_threads()
+{
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+  return ThreadPool::instance().num_threads();
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+  return std::min<size_t>(
+    tbb::this_task_arena::max_concurrency(),
+    tbb::global_control::active_value(
+      tbb::global_control::max_allowed_parallelism));
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+#endif
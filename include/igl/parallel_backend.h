@@ -0,0 +1,41 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PARALLEL_BACKEND_H
+#define IGL_PARALLEL_BACKEND_H
+// Selects the threading runtime behind igl::parallel_for (and everything built
+// on it). Define exactly one of the following (shared/cmake/CMakeLists.txt
+// does this according to LIBIGL_PARALLEL_BACKEND):
+//
+//   IGL_PARALLEL_BACKEND_THREADPOOL  igl::ThreadPool, std::thread based
+//     (default)
+//   IGL_PARALLEL_BACKEND_TBB  Intel Threading Building Blocks (>=2019, needs
+//     linking against tbb)
+//   IGL_PARALLEL_BACKEND_OPENMP  OpenMP (needs compiling with e.g. -fopenmp)
+//   IGL_PARALLEL_BACKEND_SERIAL  no threads at all
+//
+// The legacy IGL_PARALLEL_FOR_FORCE_SERIAL is equivalent to
+// IGL_PARALLEL_BACKEND_SERIAL.
+#if defined(IGL_PARALLEL_FOR_FORCE_SERIAL) && !defined(IGL_PARALLEL_BACKEND_SERIAL)
+#  define IGL_PARALLEL_BACKEND_SERIAL
+#endif
+#if defined(IGL_PARALLEL_BACKEND_SERIAL)
+#  undef IGL_PARALLEL_BACKEND_THREADPOOL
+#  undef IGL_PARALLEL_BACKEND_TBB
+#  undef IGL_PARALLEL_BACKEND_OPENMP
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+#  undef IGL_PARALLEL_BACKEND_THREADPOOL
+#  undef IGL_PARALLEL_BACKEND_OPENMP
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+#  undef IGL_PARALLEL_BACKEND_THREADPOOL
+#  ifndef _OPENMP
+#    error "IGL_PARALLEL_BACKEND_OPENMP requires compiling with OpenMP enabled"
+#  endif
+#elif !defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+#  define IGL_PARALLEL_BACKEND_THREADPOOL
+#endif
+#endif
@@ -8,6 +8,7 @@
 #ifndef IGL_PARALLEL_FOR_H
 #define IGL_PARALLEL_FOR_H
 #include "igl_inline.h"
+#include <cstddef>
 #include <functional>
 
 namespace igl
@@ -26,6 +27,14 @@ namespace igl
   // available on the current hardware to parallelize this for loop so long as
   // loop_size<min_parallel, otherwise it will just use a serial for loop.
   //
+  // Iterations are executed by the backend selected in parallel_backend.h. By
+  // default this is the persistent, process-wide igl::ThreadPool: the range
+  // is split into grain-sized chunks and idle threads steal work from busy
+  // ones, so loops with uneven per-iteration cost stay balanced. The calling
+  // thread takes part in the loop, so parallel_for may be safely called from
+  // within another parallel_for. The number of threads is capped by
+  // igl::set_num_threads.
+  //
   // Inputs:
   //   loop_size  number of iterations. I.e. for(int i = 0;i<loop_size;i++) ...
   //   func  function handle taking iteration index as only arguement to compute
@@ -60,7 +69,8 @@ namespace igl
   // Inputs:
   //   loop_size  number of iterations. I.e. for(int i = 0;i<loop_size;i++) ...
   //   prep_func function handle taking n >= number of threads as only
-  //     argument 
+  //     argument (n is fixed per call, thread ids t passed to func and
+  //     accum_func lie in [0,n) and no two threads share a t concurrently)
   //   func  function handle taking iteration index i and thread id t as only
   //     arguements to compute inner block of for loop I.e. 
   //     for(int i ...){ func(i,t); }
@@ -69,6 +79,9 @@ namespace igl
   //     all n (potential) threads, see n in description of prep_func.
   //   min_parallel  min size of loop_size such that parallel (non-serial)
   //     thread pooling should be attempted {0}
+  //   grain_size  number of consecutive iterations executed as one unit of
+  //     work, 0 means use igl::ThreadPool::grain_size() or, if that is also 0,
+  //     choose automatically {0}
   // Returns true iff thread pool was invoked
   template<
     typename Index, 
@@ -81,16 +94,189 @@ namespace igl
     const PrepFunctionType & prep_func,
     const FunctionType & func,
     const AccumFunctionType & accum_func,
-    const size_t min_parallel=0);
+    const size_t min_parallel=0,
+    const size_t grain_size=0);
 }
 
 // Implementation
 
+#include "parallel_backend.h"
+#include "num_threads.h"
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+#  include "ThreadPool.h"
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+#  include <tbb/blocked_range.h>
+#  include <tbb/parallel_for.h>
+#  include <tbb/task_arena.h>
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+#  include <omp.h>
+#endif
 #include <cmath>
 #include <cassert>
 #include <thread>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+namespace igl
+{
+  namespace parallel_for_detail
+  {
+    // Range of loop iterations owned by one participating thread. The owner
+    // takes grain-sized chunks off the front; idle threads steal the back
+    // half.
+    struct Range
+    {
+      std::mutex mutex;
+      size_t begin;
+      size_t end;
+      Range():begin(0),end(0){}
+    };
+    // Shared state of a single call to parallel_for. Held by shared_ptr so
+    // that jobs still sitting in a worker's deque after the loop has finished
+    // never dereference a dead stack frame.
+    template <typename Index, typename FunctionType>
+    struct Loop
+    {
+      const FunctionType & func;
+      const size_t loop_size;
+      const size_t grain;
+      std::vector<Range> ranges;
+      // Next free slot for a helper thread (slot 0 is the calling thread)
+      std::atomic<size_t> next_slot;
+      std::atomic<size_t> done;
+      std::mutex done_mutex;
+      std::condition_variable done_cv;
+      std::mutex exception_mutex;
+      std::exception_ptr exception;
+      Loop(
+        const FunctionType & _func,
+        const size_t _loop_size,
+        const size_t _grain,
+        const size_t nslots):
+        func(_func),
+        loop_size(_loop_size),
+        grain(_grain),
+        ranges(nslots),
+        next_slot(1),
+        done(0),
+        done_mutex(),
+        done_cv(),
+        exception_mutex(),
+        exception()
+      {
+        // Initial static partition, rebalanced by stealing
+        for(size_t s = 0;s<nslots;s++)
+        {
+          ranges[s].begin = (loop_size*s)/nslots;
+          ranges[s].end = (loop_size*(s+1))/nslots;
+        }
+      }
+      // Take the next chunk from own range, else steal half of the largest
+      // remaining range of another slot.
+      //
+      // Inputs:
+      //   s  slot of calling thread
+      // Outputs:
+      //   b  begin of chunk
+      //   e  end of chunk
+      // Returns false iff no work is left anywhere
+      bool next(const size_t s, size_t & b, size_t & e)
+      {
+        while(true)
+        {
+          {
+            Range & own = ranges[s];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if(own.begin < own.end)
+            {
+              b = own.begin;
+              e = std::min(own.begin+grain,own.end);
+              own.begin = e;
+              return true;
+            }
+          }
+          // Pick victim with most remaining work (racy read is only a hint)
+          size_t victim = ranges.size();
+          size_t most = 0;
+          for(size_t v = 0;v<ranges.size();v++)
+          {
+            if(v == s) continue;
+            std::lock_guard<std::mutex> lock(ranges[v].mutex);
+            const size_t left = ranges[v].end-ranges[v].begin;
+            if(left > most)
+            {
+              most = left;
+              victim = v;
+            }
+          }
+          if(victim == ranges.size())
+          {
+            return false;
+          }
+          size_t sb,se;
+          {
+            Range & vr = ranges[victim];
+            std::lock_guard<std::mutex> lock(vr.mutex);
+            const size_t left = vr.end-vr.begin;
+            if(left == 0)
+            {
+              continue;
+            }
+            // Leave the victim at least the chunk it is about to take
+            const size_t take = left <= grain ? left : left/2;
+            se = vr.end;
+            sb = vr.end-take;
+            vr.end = sb;
+          }
+          {
+            Range & own = ranges[s];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = sb;
+            own.end = se;
+          }
+        }
+      }
+      // Run chunks until no work is left
+      //
+      // Inputs:
+      //   s  slot of calling thread
+      void work(const size_t s)
+      {
+        size_t b,e;
+        while(next(s,b,e))
+        {
+          try
+          {
+            for(size_t k = b;k<e;k++)
+            {
+              Index i = (Index)k;
+              func(i,s);
+            }
+          }catch(...)
+          {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if(!exception)
+            {
+              exception = std::current_exception();
+            }
+          }
+          if((done += (e-b)) == loop_size)
+          {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            done_cv.notify_all();
+          }
+        }
+      }
+    };
+  }
+}
+#endif
 
 template<typename Index, typename FunctionType >
 inline bool igl::parallel_for(
@@ -116,67 +302,128 @@ inline bool igl::parallel_for(
   const PreFunctionType & prep_func,
   const FunctionType & func,
   const AccumFunctionType & accum_func,
-  const size_t min_parallel)
+  const size_t min_parallel,
+  const size_t grain_size)
 {
   assert(loop_size>=0);
   if(loop_size==0) return false;
-  // Estimate number of threads in the pool
-  // http://ideone.com/Z7zldb
-  const static size_t sthc = std::thread::hardware_concurrency();
-  const size_t nthreads = 
-#ifdef IGL_PARALLEL_FOR_FORCE_SERIAL
-    0;
-#else
-    loop_size<min_parallel?0:(sthc==0?8:sthc);
-#endif
-  if(nthreads==0)
+  const size_t n = (size_t)loop_size;
+  const size_t nthreads = n<min_parallel ? 1 : num_threads();
+  if(nthreads<=1)
   {
     // serial
     prep_func(1);
     for(Index i = 0;i<loop_size;i++) func(i,0);
     accum_func(0);
     return false;
-  }else
+  }
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+  ThreadPool & pool = ThreadPool::instance();
+  // Default grain: enough chunks per thread to balance uneven iterations
+  const size_t grain = std::max<size_t>(1,
+    grain_size>0 ? grain_size :
+    (pool.grain_size()>0 ? pool.grain_size() : n/(8*nthreads)));
+  // Never ask for more helpers than there are chunks to hand out
+  const size_t nchunks = (n+grain-1)/grain;
+  const size_t nhelpers = pool.reserve_workers(std::min(nthreads-1,nchunks-1));
+  if(nhelpers==0)
   {
-    // Size of a slice for the range functions
-    Index slice = 
-      std::max(
-        (Index)std::round((loop_size+1)/static_cast<double>(nthreads)),(Index)1);
- 
-    // [Helper] Inner loop
-    const auto & range = [&func](const Index k1, const Index k2, const size_t t)
-    {
-      for(Index k = k1; k < k2; k++) func(k,t);
-    };
-    prep_func(nthreads);
-    // Create pool and launch jobs
-    std::vector<std::thread> pool;
-    pool.reserve(nthreads);
-    // Inner range extents
-    Index i1 = 0;
-    Index i2 = std::min(0 + slice, loop_size);
+    prep_func(1);
+    for(Index i = 0;i<loop_size;i++) func(i,0);
+    accum_func(0);
+    return false;
+  }
+  typedef parallel_for_detail::Loop<Index,FunctionType> Loop;
+  const size_t nslots = nhelpers+1;
+  prep_func(nslots);
+  const std::shared_ptr<Loop> loop(new Loop(func,n,grain,nslots));
+  for(size_t h = 0;h<nhelpers;h++)
+  {
+    pool.submit([loop]()
     {
-      size_t t = 0;
-      for (; t+1 < nthreads && i1 < loop_size; ++t)
+      const size_t s = loop->next_slot++;
+      // More jobs than slots can never happen, but be defensive
+      if(s < loop->ranges.size())
       {
-        pool.emplace_back(range, i1, i2, t);
-        i1 = i2;
-        i2 = std::min(i2 + slice, loop_size);
+        loop->work(s);
       }
-      if (i1 < loop_size)
+    });
+  }
+  // Calling thread participates (slot 0) and only ever executes iterations
+  // of its own loop. This makes nested calls from inside a worker safe: a
+  // worker waiting on an inner loop cannot pick up an unrelated job.
+  loop->work(0);
+  // Wait for chunks still being executed by helpers
+  {
+    std::unique_lock<std::mutex> lock(loop->done_mutex);
+    loop->done_cv.wait(lock,[&loop,n]{ return loop->done == n; });
+  }
+  if(loop->exception)
+  {
+    std::rethrow_exception(loop->exception);
+  }
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+  const size_t grain = std::max<size_t>(1,grain_size);
+  const size_t nslots = tbb::this_task_arena::max_concurrency();
+  prep_func(nslots);
+  // Isolation keeps a thread waiting on this loop from picking up iterations
+  // of an enclosing loop, which would otherwise reuse its slot t.
+  tbb::this_task_arena::isolate([&func,n,grain]
+  {
+    tbb::parallel_for(
+      tbb::blocked_range<size_t>(0,n,grain),
+      [&func](const tbb::blocked_range<size_t> & r)
       {
-        pool.emplace_back(range, i1, loop_size, t);
+        const size_t t = tbb::this_task_arena::current_thread_index();
+        for(size_t k = r.begin();k<r.end();k++)
+        {
+          Index i = (Index)k;
+          func(i,t);
+        }
+      });
+  });
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+  const long long grain = (long long)std::max<size_t>(1,
+    grain_size>0 ? grain_size : n/(8*nthreads));
+  const long long nchunks = ((long long)n+grain-1)/grain;
+  const size_t nslots = nthreads;
+  prep_func(nslots);
+  std::exception_ptr exception;
+#  pragma omp parallel for schedule(dynamic) num_threads((int)nthreads)
+  for(long long c = 0;c<nchunks;c++)
+  {
+    const size_t t = omp_get_thread_num();
+    try
+    {
+      const long long end = std::min((long long)n,(c+1)*grain);
+      for(long long k = c*grain;k<end;k++)
+      {
+        Index i = (Index)k;
+        func(i,t);
       }
-    }
-    // Wait for jobs to finish
-    for (std::thread &t : pool) if (t.joinable()) t.join();
-    // Accumulate across threads
-    for(size_t t = 0;t<nthreads;t++)
+    }catch(...)
     {
-      accum_func(t);
+#  pragma omp critical (igl_parallel_for_exception)
+      if(!exception)
+      {
+        exception = std::current_exception();
+      }
     }
-    return true;
   }
+  if(exception)
+  {
+    std::rethrow_exception(exception);
+  }
+#else
+  // IGL_PARALLEL_BACKEND_SERIAL: num_threads() is always 1
+  const size_t nslots = 0;
+#endif
+  // Accumulate across threads
+  for(size_t t = 0;t<nslots;t++)
+  {
+    accum_func(t);
+  }
+  return true;
 }
  
 //#ifndef IGL_STATIC_LIBRARY
@@ -0,0 +1,134 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PARALLEL_INCLUSIVE_SCAN_H
+#define IGL_PARALLEL_INCLUSIVE_SCAN_H
+#include "igl_inline.h"
+#include <cstddef>
+
+namespace igl
+{
+  // PARALLEL_INCLUSIVE_SCAN Functional implementation of a deterministic
+  // parallel inclusive scan (prefix "sum"). The serial code looks like:
+  //
+  //     T acc = identity;
+  //     for(int i = 0;i<loop_size;i++)
+  //     {
+  //       acc = op(acc,get(i));
+  //       set(i,acc);
+  //     }
+  //
+  // The range is cut into blocks whose boundaries only depend on loop_size
+  // and grain_size. Block totals are computed in parallel, scanned serially
+  // and then each block is rescanned in parallel starting from its offset.
+  // Hence results are identical across runs and thread counts. `get` is
+  // called twice per index (except for the last block) and `set` may write in
+  // place of what `get` reads, but only after it has been read for this index.
+  //
+  // Inputs:
+  //   loop_size  number of elements
+  //   identity  identity element of op (e.g., 0 for sums)
+  //   get  function handle taking index i and returning i-th input element
+  //   op  associative function handle taking two values and returning their
+  //     combination
+  //   set  function handle taking index i and i-th output value
+  //   min_parallel  min size of loop_size such that parallel (non-serial)
+  //     thread pooling should be attempted {0}
+  //   grain_size  number of elements per block, 0 means choose based on
+  //     loop_size so that there are at most 256 blocks {0}
+  //
+  // Example:
+  //   // Y = cumsum(X)
+  //   igl::parallel_inclusive_scan(
+  //     X.size(),0.0,
+  //     [&X](const int i){ return X(i); },
+  //     [](const double a, const double b){ return a+b; },
+  //     [&Y](const int i, const double y){ Y(i) = y; },
+  //     10000);
+  template<
+    typename Index,
+    typename T,
+    typename GetFunctionType,
+    typename OpFunctionType,
+    typename SetFunctionType>
+  inline void parallel_inclusive_scan(
+    const Index loop_size,
+    const T & identity,
+    const GetFunctionType & get,
+    const OpFunctionType & op,
+    const SetFunctionType & set,
+    const size_t min_parallel=0,
+    const size_t grain_size=0);
+}
+
+// Implementation
+
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+template<
+  typename Index,
+  typename T,
+  typename GetFunctionType,
+  typename OpFunctionType,
+  typename SetFunctionType>
+inline void igl::parallel_inclusive_scan(
+  const Index loop_size,
+  const T & identity,
+  const GetFunctionType & get,
+  const OpFunctionType & op,
+  const SetFunctionType & set,
+  const size_t min_parallel,
+  const size_t grain_size)
+{
+  assert(loop_size>=0);
+  const size_t n = (size_t)loop_size;
+  if(n==0) return;
+  const size_t max_blocks = 256;
+  const size_t block = grain_size>0 ? grain_size :
+    std::max<size_t>(1,(n+max_blocks-1)/max_blocks);
+  const size_t nblocks = (n+block-1)/block;
+  const size_t min_parallel_blocks = (min_parallel+block-1)/block;
+  // offset[b+1] = total of block b, last block's total is never needed
+  std::vector<T> offset(nblocks,identity);
+  parallel_for(
+    nblocks-1,
+    [&get,&op,&offset,block](const size_t b)
+    {
+      T acc = offset[b+1];
+      for(size_t k = b*block;k<(b+1)*block;k++)
+      {
+        acc = op(acc,get((Index)k));
+      }
+      offset[b+1] = acc;
+    },
+    min_parallel_blocks);
+  // Serial scan of block totals: offset[b] = total of blocks 0..b-1
+  for(size_t b = 2;b<nblocks;b++)
+  {
+    offset[b] = op(offset[b-1],offset[b]);
+  }
+  // Rescan each block from its offset. The first block starts from identity
+  // so that for nblocks==1 this is exactly the serial scan.
+  parallel_for(
+    nblocks,
+    [&get,&op,&set,&offset,block,n](const size_t b)
+    {
+      T acc = offset[b];
+      const size_t end = std::min(n,(b+1)*block);
+      for(size_t k = b*block;k<end;k++)
+      {
+        acc = op(acc,get((Index)k));
+        set((Index)k,acc);
+      }
+    },
+    min_parallel_blocks);
+}
+
+#endif
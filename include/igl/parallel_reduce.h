@@ -0,0 +1,118 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PARALLEL_REDUCE_H
+#define IGL_PARALLEL_REDUCE_H
+#include "igl_inline.h"
+#include <cstddef>
+
+namespace igl
+{
+  // PARALLEL_REDUCE Functional implementation of a deterministic parallel
+  // reduction. The serial code looks like:
+  //
+  //     T acc = identity;
+  //     for(int i = 0;i<loop_size;i++)
+  //     {
+  //       func(i,acc);
+  //     }
+  //
+  // The range is cut into consecutive blocks whose boundaries only depend on
+  // loop_size and grain_size (never on the number of threads), each block is
+  // reduced serially starting from a copy of identity and the partial results
+  // are combined from left to right. Hence the result is bitwise identical
+  // from run to run and across machines, even for floating point sums.
+  //
+  // Inputs:
+  //   loop_size  number of iterations. I.e. for(int i = 0;i<loop_size;i++) ...
+  //   identity  initial value of each partial result (e.g., 0 for sums)
+  //   func  function handle taking iteration index i and a reference to the
+  //     running partial result, I.e. for(int i ...){ func(i,acc); }
+  //   combine  function handle taking two partial results a and b (a covers
+  //     iterations before b) and returning their combination
+  //   min_parallel  min size of loop_size such that parallel (non-serial)
+  //     thread pooling should be attempted {0}
+  //   grain_size  number of iterations per block, 0 means choose based on
+  //     loop_size so that there are at most 256 partial results {0}
+  // Returns reduced value
+  //
+  // Example:
+  //   const double sum = igl::parallel_reduce(
+  //     X.size(),0.0,
+  //     [&X](const int i, double & s){ s += X(i); },
+  //     [](const double a, const double b){ return a+b; },
+  //     10000);
+  template<
+    typename Index,
+    typename T,
+    typename FunctionType,
+    typename CombineFunctionType>
+  inline T parallel_reduce(
+    const Index loop_size,
+    const T & identity,
+    const FunctionType & func,
+    const CombineFunctionType & combine,
+    const size_t min_parallel=0,
+    const size_t grain_size=0);
+}
+
+// Implementation
+
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+template<
+  typename Index,
+  typename T,
+  typename FunctionType,
+  typename CombineFunctionType>
+inline T igl::parallel_reduce(
+  const Index loop_size,
+  const T & identity,
+  const FunctionType & func,
+  const CombineFunctionType & combine,
+  const size_t min_parallel,
+  const size_t grain_size)
+{
+  assert(loop_size>=0);
+  const size_t n = (size_t)loop_size;
+  if(n==0) return identity;
+  const size_t max_blocks = 256;
+  const size_t block = grain_size>0 ? grain_size :
+    std::max<size_t>(1,(n+max_blocks-1)/max_blocks);
+  const size_t nblocks = (n+block-1)/block;
+  if(nblocks==1)
+  {
+    T acc = identity;
+    for(Index i = 0;i<loop_size;i++) func(i,acc);
+    return acc;
+  }
+  std::vector<T> partial(nblocks,identity);
+  parallel_for(
+    nblocks,
+    [&func,&partial,block,n](const size_t b)
+    {
+      T & acc = partial[b];
+      const size_t end = std::min(n,(b+1)*block);
+      for(size_t k = b*block;k<end;k++)
+      {
+        func((Index)k,acc);
+      }
+    },
+    // Blocks are coarse so compare min_parallel against blocks
+    (min_parallel+block-1)/block);
+  T result = partial[0];
+  for(size_t b = 1;b<nblocks;b++)
+  {
+    result = combine(result,partial[b]);
+  }
+  return result;
+}
+
+#endif
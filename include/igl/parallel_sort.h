@@ -0,0 +1,260 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_PARALLEL_SORT_H
+#define IGL_PARALLEL_SORT_H
+#include "igl_inline.h"
+#include <cstddef>
+#include <vector>
+
+namespace igl
+{
+  // PARALLEL_SORT Stable parallel merge sort of a random access range. Blocks
+  // are sorted with std::stable_sort in parallel and then merged pairwise;
+  // each merge is itself split into independent pieces (by co-ranking the
+  // two inputs), so the last merges are parallel too. Since the sort is
+  // stable, the output does not depend on the number of threads.
+  //
+  // Inputs:
+  //   first  iterator to first element
+  //   last  iterator past last element
+  //   less  strict weak ordering `bool less(a,b)`
+  //   min_parallel  min size of range such that parallel (non-serial)
+  //     thread pooling should be attempted {0}
+  // Returns true iff thread pool was invoked
+  template <typename RandomIt, typename Compare>
+  inline bool parallel_sort(
+    RandomIt first,
+    RandomIt last,
+    const Compare & less,
+    const size_t min_parallel=0);
+  // Stable parallel sort of a list returning the sorted list and the index
+  // map, mirroring igl::sort(std::vector...)
+  //
+  // Templates:
+  //   T  should be a class that implements the '<' comparator operator
+  // Input:
+  //   unsorted  unsorted vector
+  //   ascending  sort ascending (true) or descending (false); equal elements
+  //     keep their original relative order in both cases
+  //   min_parallel  see above {0}
+  // Output:
+  //   sorted     sorted vector, allowed to be same as unsorted
+  //   index_map  an index map such that sorted[i] = unsorted[index_map[i]]
+  template <typename T>
+  inline void parallel_sort(
+    const std::vector<T> & unsorted,
+    const bool ascending,
+    std::vector<T> & sorted,
+    std::vector<size_t> & index_map,
+    const size_t min_parallel=0);
+}
+
+// Implementation
+
+#include "parallel_for.h"
+#include "num_threads.h"
+#include <algorithm>
+#include <iterator>
+
+namespace igl
+{
+  namespace parallel_sort_detail
+  {
+    // Stable co-rank: number of elements taken from A among the first k
+    // elements of merge(A,B), elements of A winning ties.
+    template <typename It, typename Compare>
+    inline size_t co_rank(
+      const size_t k,
+      It A, const size_t na,
+      It B, const size_t nb,
+      const Compare & less)
+    {
+      size_t lo = k>nb ? k-nb : 0;
+      size_t hi = std::min(k,na);
+      while(lo < hi)
+      {
+        const size_t i = (lo+hi)/2;
+        const size_t j = k-i;
+        // A[i] <= B[j-1] means A[i] must be output before B[j-1]
+        if(j>0 && i<na && !less(*(B+(j-1)),*(A+i)))
+        {
+          lo = i+1;
+        }else
+        {
+          hi = i;
+        }
+      }
+      return lo;
+    }
+    // Merge consecutive pairs of sorted runs (each `width` blocks wide) of src
+    // into dst, splitting each merge into pieces of roughly `piece` outputs.
+    //
+    // Inputs:
+    //   src  input range
+    //   n  number of elements
+    //   nblocks  number of blocks, block b starts at (n*b)/nblocks
+    //   width  number of blocks per sorted run
+    //   piece  target number of outputs per parallel task
+    //   less  comparator
+    // Outputs:
+    //   dst  output range
+    template <typename SrcIt, typename DstIt, typename Compare>
+    inline void merge_round(
+      SrcIt src,
+      DstIt dst,
+      const size_t n,
+      const size_t nblocks,
+      const size_t width,
+      const size_t piece,
+      const Compare & less)
+    {
+      // (output begin, output end, begin of A, end of A == begin of B, end of B)
+      std::vector<size_t> tasks;
+      for(size_t b = 0;b<nblocks;b += 2*width)
+      {
+        const size_t a0 = (n*b)/nblocks;
+        const size_t a1 = (n*std::min(b+width,nblocks))/nblocks;
+        const size_t b1 = (n*std::min(b+2*width,nblocks))/nblocks;
+        for(size_t k0 = a0;k0<b1;k0 += piece)
+        {
+          tasks.push_back(k0);
+          tasks.push_back(std::min(k0+piece,b1));
+          tasks.push_back(a0);
+          tasks.push_back(a1);
+          tasks.push_back(b1);
+        }
+      }
+      parallel_for(
+        tasks.size()/5,
+        [&src,&dst,&tasks,&less](const size_t t)
+        {
+          const size_t k0 = tasks[5*t+0];
+          const size_t k1 = tasks[5*t+1];
+          const size_t a0 = tasks[5*t+2];
+          const size_t a1 = tasks[5*t+3];
+          const size_t b1 = tasks[5*t+4];
+          SrcIt A = src+a0;
+          SrcIt B = src+a1;
+          const size_t na = a1-a0;
+          const size_t nb = b1-a1;
+          const size_t i0 = co_rank(k0-a0,A,na,B,nb,less);
+          const size_t i1 = co_rank(k1-a0,A,na,B,nb,less);
+          const size_t j0 = (k0-a0)-i0;
+          const size_t j1 = (k1-a0)-i1;
+          std::merge(A+i0,A+i1,B+j0,B+j1,dst+k0,less);
+        },
+        2);
+    }
+  }
+}
+
+template <typename RandomIt, typename Compare>
+inline bool igl::parallel_sort(
+  RandomIt first,
+  RandomIt last,
+  const Compare & less,
+  const size_t min_parallel)
+{
+  typedef typename std::iterator_traits<RandomIt>::value_type Value;
+  const size_t n = std::distance(first,last);
+  const size_t nthreads = igl::num_threads();
+  // Smallest block worth a task
+  const size_t min_block = 4096;
+  if(n < min_parallel || nthreads <= 1 || n < 2*min_block)
+  {
+    std::stable_sort(first,last,less);
+    return false;
+  }
+  // Power of two number of blocks, a few per thread
+  size_t nblocks = 1;
+  while(nblocks < 2*nthreads && n/(2*nblocks) >= min_block)
+  {
+    nblocks *= 2;
+  }
+  parallel_for(
+    nblocks,
+    [&first,&less,n,nblocks](const size_t b)
+    {
+      std::stable_sort(
+        first+(n*b)/nblocks,
+        first+(n*(b+1))/nblocks,
+        less);
+    },
+    2);
+  const size_t piece = std::max(min_block,n/(4*nthreads));
+  std::vector<Value> buffer(n);
+  // Ping-pong between the input range and the buffer
+  bool in_buffer = false;
+  for(size_t width = 1;width<nblocks;width *= 2)
+  {
+    if(in_buffer)
+    {
+      parallel_sort_detail::merge_round(
+        buffer.begin(),first,n,nblocks,width,piece,less);
+    }else
+    {
+      parallel_sort_detail::merge_round(
+        first,buffer.begin(),n,nblocks,width,piece,less);
+    }
+    in_buffer = !in_buffer;
+  }
+  if(in_buffer)
+  {
+    parallel_for(
+      n,
+      [&first,&buffer](const size_t i){ *(first+i) = std::move(buffer[i]); },
+      min_block);
+  }
+  return true;
+}
+
+template <typename T>
+inline void igl::parallel_sort(
+  const std::vector<T> & unsorted,
+  const bool ascending,
+  std::vector<T> & sorted,
+  std::vector<size_t> & index_map,
+  const size_t min_parallel)
+{
+  const size_t n = unsorted.size();
+  index_map.resize(n);
+  parallel_for(n,[&index_map](const size_t i){ index_map[i] = i; },min_parallel);
+  if(ascending)
+  {
+    parallel_sort(
+      index_map.begin(),
+      index_map.end(),
+      [&unsorted](const size_t i, const size_t j)
+      {
+        return unsorted[i] < unsorted[j];
+      },
+      min_parallel);
+  }else
+  {
+    parallel_sort(
+      index_map.begin(),
+      index_map.end(),
+      [&unsorted](const size_t i, const size_t j)
+      {
+        return unsorted[j] < unsorted[i];
+      },
+      min_parallel);
+  }
+  // make space for output without clobbering (sorted may alias unsorted)
+  std::vector<T> copy(n);
+  parallel_for(
+    n,
+    [&copy,&unsorted,&index_map](const size_t i)
+    {
+      copy[i] = unsorted[index_map[i]];
+    },
+    min_parallel);
+  sorted.swap(copy);
+}
+
+#endif
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "project_to_line_segment.h"
+#include "parallel_for.h"
 #include "project_to_line.h"
 #include <Eigen/Core>
 
@@ -25,8 +26,7 @@ IGL_INLINE void igl::project_to_line_segment(
   project_to_line(P,S,D,t,sqrD);
   const int np = P.rows();
   // loop over points and fix those that projected beyond endpoints
-#pragma omp parallel for if (np>10000)
-  for(int p = 0;p<np;p++)
+  parallel_for(np,[&P,&S,&D,&t,&sqrD](const int p)
   {
     const DerivedP Pp = P.row(p);
     if(t(p)<0)
@@ -38,7 +38,7 @@ IGL_INLINE void igl::project_to_line_segment(
       sqrD(p) = (Pp-D).squaredNorm();
       t(p) = 1;
     }
-  }
+  },10000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -7,9 +7,113 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "ray_mesh_intersect.h"
 
-extern "C"
+#include "PackedTriangles.h"
+#include "ray_triangle_intersect.h"
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace igl
 {
-#include "raytri.c"
+  namespace ray_mesh
+  {
+    // Intersect a ray with all triangles of a mesh for t in (0,tmax)
+    //
+    // Inputs:
+    //   closest  whether to only keep the closest hit
+    //   tmax  upper bound on t
+    // Outputs:
+    //   tmax  t of closest hit if closest
+    //   hits  hits appended (or replaced by closer hit if closest)
+    template <typename Scalar, typename DerivedV, typename DerivedF>
+    inline void intersect(
+      const WatertightRay<Scalar> & ray,
+      const Eigen::MatrixBase<DerivedV> & V,
+      const Eigen::MatrixBase<DerivedF> & F,
+      const bool closest,
+      Scalar & tmax,
+      std::vector<igl::Hit> & hits)
+    {
+      const int LANES = PackedTriangles<Scalar>::LANES;
+      if(F.rows() < LANES)
+      {
+        // Not worth a block
+        for(int f = 0;f<F.rows();f++)
+        {
+          Scalar P[3][3];
+          for(int c = 0;c<3;c++)
+          {
+            for(int k = 0;k<3;k++)
+            {
+              P[c][k] = static_cast<Scalar>(V(F(f,c),k));
+            }
+          }
+          Scalar t,u,v;
+          if(ray_triangle_intersect(ray,P[0],P[1],P[2],Scalar(0),tmax,t,u,v))
+          {
+            const igl::Hit hit = {f,-1,(float)u,(float)v,(float)t};
+            if(closest)
+            {
+              tmax = t;
+              hits.assign(1,hit);
+            }else
+            {
+              hits.push_back(hit);
+            }
+          }
+        }
+        return;
+      }
+      // Gather one block at a time on the stack: nothing is allocated or
+      // packed ahead of the ray (see the PackedTriangles overloads for many
+      // rays against the same mesh)
+      const RayTriangleSIMDType simd_type = ray_triangle_simd_type();
+      Scalar corners[9*LANES] = {};
+      for(int begin = 0;begin<F.rows();begin += LANES)
+      {
+        const int n = std::min<int>(LANES,F.rows()-begin);
+        for(int l = 0;l<n;l++)
+        {
+          for(int c = 0;c<3;c++)
+          {
+            for(int k = 0;k<3;k++)
+            {
+              corners[(3*c+k)*LANES+l] =
+                static_cast<Scalar>(V(F(begin+l,c),k));
+            }
+          }
+        }
+        Scalar t[LANES],u[LANES],v[LANES];
+        const int lanes_hit = PackedTriangles<Scalar>::intersect_block(
+          simd_type,corners,ray,(1<<n)-1,Scalar(0),tmax,t,u,v);
+        for(int l = 0;l<n && lanes_hit;l++)
+        {
+          if(!(lanes_hit & (1<<l)))
+          {
+            continue;
+          }
+          const igl::Hit hit = {begin+l,-1,(float)u[l],(float)v[l],(float)t[l]};
+          if(!closest)
+          {
+            hits.push_back(hit);
+          }else if(t[l] < tmax)
+          {
+            tmax = t[l];
+            hits.assign(1,hit);
+          }
+        }
+      }
+    }
+    // Sort hits based on distance
+    inline bool sort_hits(std::vector<igl::Hit> & hits)
+    {
+      std::sort(
+        hits.begin(),
+        hits.end(),
+        [](const Hit & a, const Hit & b)->bool{ return a.t < b.t;});
+      return hits.size() > 0;
+    }
+  }
 }
 
 template <
@@ -24,34 +128,16 @@ IGL_INLINE bool igl::ray_mesh_intersect(
   const Eigen::MatrixBase<DerivedF> & F,
   std::vector<igl::Hit> & hits)
 {
-  using namespace Eigen;
-  using namespace std;
-  // Should be but can't be const 
-  Vector3d s_d = s.template cast<double>();
-  Vector3d dir_d = dir.template cast<double>();
+  // Single precision meshes are intersected in single precision
+  typedef typename std::conditional<
+    std::is_same<typename DerivedV::Scalar,float>::value,
+    float,
+    double>::type Scalar;
+  const WatertightRay<Scalar> ray(s,dir);
+  Scalar tmax = std::numeric_limits<Scalar>::infinity();
   hits.clear();
-  // loop over all triangles
-  for(int f = 0;f<F.rows();f++)
-  {
-    // Should be but can't be const 
-    RowVector3d v0 = V.row(F(f,0)).template cast<double>();
-    RowVector3d v1 = V.row(F(f,1)).template cast<double>();
-    RowVector3d v2 = V.row(F(f,2)).template cast<double>();
-    // shoot ray, record hit
-    double t,u,v;
-    if(intersect_triangle1(
-      s_d.data(), dir_d.data(), v0.data(), v1.data(), v2.data(), &t, &u, &v) &&
-      t>0)
-    {
-      hits.push_back({(int)f,(int)-1,(float)u,(float)v,(float)t});
-    }
-  }
-  // Sort hits based on distance
-  std::sort(
-    hits.begin(),
-    hits.end(),
-    [](const Hit & a, const Hit & b)->bool{ return a.t < b.t;});
-  return hits.size() > 0;
+  ray_mesh::intersect(ray,V,F,false,tmax,hits);
+  return ray_mesh::sort_hits(hits);
 }
 
 template <
@@ -66,8 +152,14 @@ IGL_INLINE bool igl::ray_mesh_intersect(
   const Eigen::MatrixBase<DerivedF> & F,
   igl::Hit & hit)
 {
+  typedef typename std::conditional<
+    std::is_same<typename DerivedV::Scalar,float>::value,
+    float,
+    double>::type Scalar;
+  const WatertightRay<Scalar> ray(source,dir);
+  Scalar tmax = std::numeric_limits<Scalar>::infinity();
   std::vector<igl::Hit> hits;
-  ray_mesh_intersect(source,dir,V,F,hits);
+  ray_mesh::intersect(ray,V,F,true,tmax,hits);
   if(hits.size() > 0)
   {
     hit = hits.front();
@@ -78,7 +170,36 @@ IGL_INLINE bool igl::ray_mesh_intersect(
   }
 }
 
+template <typename Derivedsource, typename Deriveddir, typename Scalar>
+IGL_INLINE bool igl::ray_mesh_intersect(
+  const Eigen::MatrixBase<Derivedsource> & source,
+  const Eigen::MatrixBase<Deriveddir> & dir,
+  const igl::PackedTriangles<Scalar> & T,
+  std::vector<igl::Hit> & hits)
+{
+  const WatertightRay<Scalar> ray(source,dir);
+  hits.clear();
+  T.intersect_ray(
+    ray,0,T.size(),Scalar(0),std::numeric_limits<Scalar>::infinity(),hits);
+  return ray_mesh::sort_hits(hits);
+}
+
+template <typename Derivedsource, typename Deriveddir, typename Scalar>
+IGL_INLINE bool igl::ray_mesh_intersect(
+  const Eigen::MatrixBase<Derivedsource> & source,
+  const Eigen::MatrixBase<Deriveddir> & dir,
+  const igl::PackedTriangles<Scalar> & T,
+  igl::Hit & hit)
+{
+  const WatertightRay<Scalar> ray(source,dir);
+  Scalar tmax = std::numeric_limits<Scalar>::infinity();
+  return T.intersect_ray(ray,0,T.size(),Scalar(0),tmax,hit);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
 template bool igl::ray_mesh_intersect<Eigen::Matrix<float, 3, 1, 0, 3, 1>, Eigen::Matrix<float, 3, 1, 0, 3, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, 3, 1, 0, 3, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<float, 3, 1, 0, 3, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<igl::Hit, std::allocator<igl::Hit> >&);
+template bool igl::ray_mesh_intersect<Eigen::Matrix<float, 3, 1, 0, 3, 1>, Eigen::Matrix<float, 3, 1, 0, 3, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, 3, 1, 0, 3, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<float, 3, 1, 0, 3, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::Hit&);
+template bool igl::ray_mesh_intersect<Eigen::Matrix<double, 1, 3, 1, 1, 3>, Eigen::Matrix<double, 1, 3, 1, 1, 3>, double>(Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, igl::PackedTriangles<double> const&, igl::Hit&);
+template bool igl::ray_mesh_intersect<Eigen::Matrix<double, 1, 3, 1, 1, 3>, Eigen::Matrix<double, 1, 3, 1, 1, 3>, double>(Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, Eigen::MatrixBase<Eigen::Matrix<double, 1, 3, 1, 1, 3> > const&, igl::PackedTriangles<double> const&, std::vector<igl::Hit, std::allocator<igl::Hit> >&);
 #endif
@@ -9,11 +9,14 @@
 #define IGL_RAY_MESH_INTERSECT_H
 #include "igl_inline.h"
 #include "Hit.h"
+#include "PackedTriangles.h"
 #include <Eigen/Core>
 #include <vector>
 namespace igl
 {
-  // Shoot a ray against a mesh (V,F) and collect all hits.
+  // Shoot a ray against a mesh (V,F) and collect all hits. Uses the
+  // watertight igl::ray_triangle_intersect on blocks of triangles with SIMD
+  // instructions (in single precision if V is float).
   //
   // Inputs:
   //   source  3-vector origin of ray
@@ -49,6 +52,29 @@ namespace igl
     const Eigen::MatrixBase<DerivedV> & V,
     const Eigen::MatrixBase<DerivedF> & F,
     igl::Hit & hit);
+  // Shoot a ray against triangles packed once beforehand, for many rays
+  // against the same small mesh (the packed copy takes 9 scalars per
+  // triangle; once it no longer fits in cache, the overloads above that
+  // gather from V and F are faster):
+  //
+  //   igl::PackedTriangles<double> T;
+  //   T.init(V,F);
+  //   for(...) igl::ray_mesh_intersect(source,dir,T,hit);
+  //
+  // Inputs:
+  //   T  triangles of the mesh (hit ids index the F they were packed from)
+  template <typename Derivedsource, typename Deriveddir, typename Scalar>
+  IGL_INLINE bool ray_mesh_intersect(
+    const Eigen::MatrixBase<Derivedsource> & source,
+    const Eigen::MatrixBase<Deriveddir> & dir,
+    const igl::PackedTriangles<Scalar> & T,
+    std::vector<igl::Hit> & hits);
+  template <typename Derivedsource, typename Deriveddir, typename Scalar>
+  IGL_INLINE bool ray_mesh_intersect(
+    const Eigen::MatrixBase<Derivedsource> & source,
+    const Eigen::MatrixBase<Deriveddir> & dir,
+    const igl::PackedTriangles<Scalar> & T,
+    igl::Hit & hit);
 }
 #ifndef IGL_STATIC_LIBRARY
 #  include "ray_mesh_intersect.cpp"
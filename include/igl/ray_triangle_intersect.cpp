@@ -0,0 +1,111 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "ray_triangle_intersect.h"
+#include <type_traits>
+
+namespace igl
+{
+  namespace watertight
+  {
+    // Inputs:
+    //   P  pointers to corners, coordinate k of corner c at P[c][k*stride]
+    template <typename Scalar>
+    inline bool intersect(
+      const WatertightRay<Scalar> & ray,
+      const Scalar * const * P,
+      const int stride,
+      const Scalar tmin,
+      const Scalar tmax,
+      Scalar & t,
+      Scalar & u,
+      Scalar & v)
+    {
+      const int kx = ray.kx*stride, ky = ray.ky*stride, kz = ray.kz*stride;
+      // Corners relative to origin in sheared ray space
+      const Scalar az = P[0][kz]-ray.o[ray.kz];
+      const Scalar bz = P[1][kz]-ray.o[ray.kz];
+      const Scalar cz = P[2][kz]-ray.o[ray.kz];
+      const Scalar ax = (P[0][kx]-ray.o[ray.kx])-ray.sx*az;
+      const Scalar ay = (P[0][ky]-ray.o[ray.ky])-ray.sy*az;
+      const Scalar bx = (P[1][kx]-ray.o[ray.kx])-ray.sx*bz;
+      const Scalar by = (P[1][ky]-ray.o[ray.ky])-ray.sy*bz;
+      const Scalar cx = (P[2][kx]-ray.o[ray.kx])-ray.sx*cz;
+      const Scalar cy = (P[2][ky]-ray.o[ray.ky])-ray.sy*cz;
+      // Scaled barycentric coordinates (edge functions)
+      Scalar U = cx*by-cy*bx;
+      Scalar V = ax*cy-ay*cx;
+      Scalar W = bx*ay-by*ax;
+      if(std::is_same<Scalar,float>::value && (U == 0 || V == 0 || W == 0))
+      {
+        U = static_cast<Scalar>((double)cx*(double)by-(double)cy*(double)bx);
+        V = static_cast<Scalar>((double)ax*(double)cy-(double)ay*(double)cx);
+        W = static_cast<Scalar>((double)bx*(double)ay-(double)by*(double)ax);
+      }
+      if((U < 0 || V < 0 || W < 0) && (U > 0 || V > 0 || W > 0))
+      {
+        return false;
+      }
+      const Scalar det = U+V+W;
+      if(det == 0)
+      {
+        return false;
+      }
+      const Scalar T = U*(ray.sz*az)+V*(ray.sz*bz)+W*(ray.sz*cz);
+      // Test T/det against range without dividing
+      const Scalar abs_det = std::abs(det);
+      const Scalar signed_T = det < 0 ? -T : T;
+      if(!(signed_T > tmin*abs_det && signed_T < tmax*abs_det))
+      {
+        return false;
+      }
+      t = T/det;
+      u = V/det;
+      v = W/det;
+      return true;
+    }
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::ray_triangle_intersect(
+  const WatertightRay<Scalar> & ray,
+  const Scalar * v0,
+  const Scalar * v1,
+  const Scalar * v2,
+  const Scalar tmin,
+  const Scalar tmax,
+  Scalar & t,
+  Scalar & u,
+  Scalar & v)
+{
+  const Scalar * P[3] = {v0,v1,v2};
+  return watertight::intersect(ray,P,1,tmin,tmax,t,u,v);
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::ray_triangle_intersect(
+  const WatertightRay<Scalar> & ray,
+  const Scalar * corners,
+  const int stride,
+  const Scalar tmin,
+  const Scalar tmax,
+  Scalar & t,
+  Scalar & u,
+  Scalar & v)
+{
+  const Scalar * P[3] = {corners,corners+3*stride,corners+6*stride};
+  return watertight::intersect(ray,P,stride,tmin,tmax,t,u,v);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::ray_triangle_intersect<double>(igl::WatertightRay<double> const&, double const*, double const*, double const*, double, double, double&, double&, double&);
+template bool igl::ray_triangle_intersect<float>(igl::WatertightRay<float> const&, float const*, float const*, float const*, float, float, float&, float&, float&);
+template bool igl::ray_triangle_intersect<double>(igl::WatertightRay<double> const&, double const*, int, double, double, double&, double&, double&);
+template bool igl::ray_triangle_intersect<float>(igl::WatertightRay<float> const&, float const*, int, float, float, float&, float&, float&);
+#endif
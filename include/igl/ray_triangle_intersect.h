@@ -0,0 +1,105 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_RAY_TRIANGLE_INTERSECT_H
+#define IGL_RAY_TRIANGLE_INTERSECT_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+namespace igl
+{
+  // Ray prepared for igl::ray_triangle_intersect: coordinates are permuted
+  // so that the largest component of the direction is z and then sheared so
+  // that the direction becomes (0,0,1).
+  template <typename Scalar>
+  struct WatertightRay
+  {
+    // origin
+    Scalar o[3];
+    // Permutation of axes (kz is the largest component of the direction,
+    // kx and ky keep the winding of triangles)
+    int kx,ky,kz;
+    // Shear and scale
+    Scalar sx,sy,sz;
+    WatertightRay():o(),kx(0),ky(1),kz(2),sx(0),sy(0),sz(1){}
+    // Inputs:
+    //   origin  3-long ray origin
+    //   dir  3-long ray direction
+    template <typename Derivedorigin, typename Deriveddir>
+    WatertightRay(
+      const Eigen::MatrixBase<Derivedorigin> & origin,
+      const Eigen::MatrixBase<Deriveddir> & dir)
+    {
+      Scalar d[3];
+      for(int k = 0;k<3;k++)
+      {
+        o[k] = static_cast<Scalar>(origin(k));
+        d[k] = static_cast<Scalar>(dir(k));
+      }
+      kz = std::abs(d[1]) > std::abs(d[0]) ? 1 : 0;
+      kz = std::abs(d[2]) > std::abs(d[kz]) ? 2 : kz;
+      kx = (kz+1)%3;
+      ky = (kx+1)%3;
+      if(d[kz] < 0)
+      {
+        std::swap(kx,ky);
+      }
+      sx = d[kx]/d[kz];
+      sy = d[ky]/d[kz];
+      sz = Scalar(1)/d[kz];
+    }
+  };
+  // RAY_TRIANGLE_INTERSECT Intersect a ray with a triangle ("Watertight
+  // Ray/Triangle Intersection" [Woop et al. 2013]). Unlike
+  // intersect_triangle1 in raytri.c, a ray through an edge or vertex shared
+  // by several triangles of a mesh hits at least one of them, regardless of
+  // the orientation of the triangles. With Scalar=float, edge tests that
+  // come out exactly zero are recomputed in double.
+  //
+  // Inputs:
+  //   ray  ray
+  //   v0,v1,v2  3-long corners of triangle
+  //   tmin,tmax  only report hits with tmin < t < tmax
+  // Outputs:
+  //   t  ray parameter of hit
+  //   u,v  barycentric coordinates of hit with respect to v1 and v2
+  // Returns true iff the ray hits the triangle
+  template <typename Scalar>
+  IGL_INLINE bool ray_triangle_intersect(
+    const WatertightRay<Scalar> & ray,
+    const Scalar * v0,
+    const Scalar * v1,
+    const Scalar * v2,
+    const Scalar tmin,
+    const Scalar tmax,
+    Scalar & t,
+    Scalar & u,
+    Scalar & v);
+  // Same, but with corners stored with a stride (e.g., in
+  // igl::PackedTriangles)
+  //
+  // Inputs:
+  //   corners  corner c coordinate k at corners[(3*c+k)*stride]
+  //   stride  distance between coordinates
+  template <typename Scalar>
+  IGL_INLINE bool ray_triangle_intersect(
+    const WatertightRay<Scalar> & ray,
+    const Scalar * corners,
+    const int stride,
+    const Scalar tmin,
+    const Scalar tmax,
+    Scalar & t,
+    Scalar & u,
+    Scalar & v);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "ray_triangle_intersect.cpp"
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "readIGLB.h"
+#include "MappedMesh.h"
+#include <cstdio>
+
+namespace igl
+{
+  namespace read_iglb
+  {
+    // Copy section called name (of any type) into A, casting entries
+    template <typename DerivedA>
+    inline bool copy(
+      const std::string & filename,
+      const MappedMesh & mesh,
+      const std::string & name,
+      Eigen::PlainObjectBase<DerivedA> & A)
+    {
+      typedef typename DerivedA::Scalar Scalar;
+      const MappedMesh::Section * s = mesh.find(name);
+      if(s == NULL)
+      {
+        fprintf(stderr,"IOError: readIGLB() %s has no %s\n",
+          filename.c_str(),name.c_str());
+        return false;
+      }
+      if(
+        (DerivedA::RowsAtCompileTime != Eigen::Dynamic &&
+         DerivedA::RowsAtCompileTime != s->rows) ||
+        (DerivedA::ColsAtCompileTime != Eigen::Dynamic &&
+         DerivedA::ColsAtCompileTime != s->cols))
+      {
+        fprintf(stderr,"IOError: readIGLB() %s in %s has wrong size\n",
+          name.c_str(),filename.c_str());
+        return false;
+      }
+      switch(s->type)
+      {
+        case MappedMesh::SCALAR_TYPE_DOUBLE:
+          A = mesh.map<double>(name).template cast<Scalar>();
+          break;
+        case MappedMesh::SCALAR_TYPE_FLOAT:
+          A = mesh.map<float>(name).template cast<Scalar>();
+          break;
+        case MappedMesh::SCALAR_TYPE_INT32:
+          A = mesh.map<int>(name).template cast<Scalar>();
+          break;
+        case MappedMesh::SCALAR_TYPE_INT64:
+          A = mesh.map<int64_t>(name).template cast<Scalar>();
+          break;
+        case MappedMesh::SCALAR_TYPE_UINT8:
+        default:
+          A = mesh.map<unsigned char>(name).template cast<Scalar>();
+          break;
+      }
+      return true;
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::readIGLB(
+  const std::string & filename,
+  Eigen::PlainObjectBase<DerivedV> & V,
+  Eigen::PlainObjectBase<DerivedF> & F)
+{
+  MappedMesh mesh;
+  return
+    mesh.open(filename) &&
+    read_iglb::copy(filename,mesh,"V",V) &&
+    read_iglb::copy(filename,mesh,"F",F);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::readIGLB<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::readIGLB<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> >&);
+template bool igl::readIGLB<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::readIGLB<Eigen::Matrix<float, -1, 3, 1, -1, 3>, Eigen::Matrix<unsigned int, -1, 3, 1, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, 3, 1, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<unsigned int, -1, 3, 1, -1, 3> >&);
+template bool igl::readIGLB<Eigen::Matrix<double, -1, 3, 1, -1, 3>, Eigen::Matrix<int, -1, 3, 1, -1, 3> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 1, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 1, -1, 3> >&);
+template bool igl::readIGLB<Eigen::Matrix<double, -1, -1, 1, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::string const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 1, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,41 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_READIGLB_H
+#define IGL_READIGLB_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Read a mesh from a binary .iglb file (see MappedMesh) into Eigen
+  // matrices. The file is memory-mapped and the "V" and "F" sections are
+  // copied (and cast) straight into the outputs. Use igl::MappedMesh directly
+  // to avoid the copy or to read other sections.
+  //
+  // Inputs:
+  //   filename  path to .iglb file
+  // Outputs:
+  //   V  #V by dim list of vertex positions
+  //   F  #F by ss list of face indices into V
+  // Returns true on success, false (with message to stderr) on errors,
+  // including missing sections
+  //
+  // See also: writeIGLB, MappedMesh
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool readIGLB(
+    const std::string & filename,
+    Eigen::PlainObjectBase<DerivedV> & V,
+    Eigen::PlainObjectBase<DerivedF> & F);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "readIGLB.cpp"
+#endif
+
+#endif
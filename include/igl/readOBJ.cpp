@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "readOBJ.h"
+#include "Profiler.h"
 
 #include "list_to_matrix.h"
 #include "max_size.h"
@@ -46,6 +47,7 @@ IGL_INLINE bool igl::readOBJ(
   std::vector<std::vector<Index > > & FTC,
   std::vector<std::vector<Index > > & FN)
 {
+  IGL_PROFILE_SCOPE("readOBJ");
   // File open was succesfull so clear outputs
   V.clear();
   TC.clear();
@@ -71,6 +71,8 @@ namespace igl
   // Eigen Wrappers. These will return true only if the data is perfectly
   // "rectangular": All faces are the same degree, all have the same number of
   // textures/normals etc.
+  //
+  // See also: fast_readOBJ for large files
   template <
     typename DerivedV, 
     typename DerivedTC, 
@@ -36,6 +36,9 @@ namespace igl
   //   remove_duplicate_vertices(temp_V,0,V,SVI,SVJ);
   //   for_each(F.data(),F.data()+F.size(),[&SVJ](int & f){f=SVJ(f);});
   //   writeOBJ("Downloads/cat.obj",V,F);
+  //
+  // See also: fast_readSTL for large files (and for reading and welding in
+  //   one pass)
   template <typename DerivedV, typename DerivedF, typename DerivedN>
   IGL_INLINE bool readSTL(
     const std::string & filename,
@@ -8,6 +8,7 @@
 #include "read_triangle_mesh.h"
 
 #include "list_to_matrix.h"
+#include "readIGLB.h"
 #include "readMESH.h"
 #include "readOBJ.h"
 #include "readOFF.h"
@@ -84,6 +85,11 @@ IGL_INLINE bool igl::read_triangle_mesh(
   pathinfo(filename,dir,base,ext,name);
   // Convert extension to lower case
   transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  if(ext == "iglb")
+  {
+    // Memory-mapped rather than read through a FILE
+    return readIGLB(filename,V,F);
+  }
   FILE * fp = fopen(filename.c_str(),"r");
   return read_triangle_mesh(ext,fp,V,F);
 }
@@ -147,6 +153,11 @@ IGL_INLINE bool igl::read_triangle_mesh(
     {
       return false;
     }
+  }else if(ext == "iglb")
+  {
+    fclose(fp);
+    cerr<<"Error: .iglb files can only be read by filename"<<endl;
+    return false;
   }else
   {
     cerr<<"Error: unknown extension: "<<ext<<endl;
@@ -22,7 +22,7 @@
 namespace igl
 {
   // read mesh from an ascii file with automatic detection of file format.
-  // supported: obj, off, stl, wrl, ply, mesh)
+  // supported: obj, off, stl, wrl, ply, mesh, iglb)
   // 
   // Templates:
   //   Scalar  type for positions and vectors (will be read as double and cast
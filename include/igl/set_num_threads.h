@@ -0,0 +1,67 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_SET_NUM_THREADS_H
+#define IGL_SET_NUM_THREADS_H
+#include <cstddef>
+
+namespace igl
+{
+  // Cap the number of threads libigl uses for all of its parallel loops
+  // (igl::parallel_for, igl::parallel_reduce, ...), regardless of the
+  // configured backend (see parallel_backend.h). Loops already running are
+  // not affected. With the OpenMP backend this calls omp_set_num_threads and
+  // hence also affects other OpenMP code of the host process.
+  //
+  // Inputs:
+  //   n  maximum number of threads including the calling thread, 0 means use
+  //     all hardware threads
+  inline void set_num_threads(const size_t n);
+}
+
+// Implementation
+
+#include "parallel_backend.h"
+#include <thread>
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+#  include "ThreadPool.h"
+#elif defined(IGL_PARALLEL_BACKEND_TBB)
+#  include <tbb/global_control.h>
+#  include <memory>
+#elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+#  include <omp.h>
+#endif
+
+inline void igl::set_num_threads(const size_t n)
+{
+#if defined(IGL_PARALLEL_BACKEND_THREADPOOL)
+  ThreadPool::instance().set_num_threads(n);
+#else
+  size_t nt = n;
+  if(nt == 0)
+  {
+    const size_t sthc = std::thread::hardware_concurrency();
+    nt = sthc==0?8:sthc;
+  }
+#  if defined(IGL_PARALLEL_BACKEND_TBB)
+  // The limit lasts as long as this object lives
+  static std::unique_ptr<tbb::global_control> control;
+  control.reset();
+  if(n != 0)
+  {
+    control.reset(new tbb::global_control(
+      tbb::global_control::max_allowed_parallelism,nt));
+  }
+#  elif defined(IGL_PARALLEL_BACKEND_OPENMP)
+  omp_set_num_threads((int)nt);
+#  else
+  (void)nt;
+#  endif
+#endif
+}
+
+#endif
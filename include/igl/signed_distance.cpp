@@ -6,30 +6,172 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "signed_distance.h"
+#include "Profiler.h"
 #include "get_seconds.h"
 #include "per_edge_normals.h"
 #include "per_face_normals.h"
 #include "per_vertex_normals.h"
 #include "point_mesh_squared_distance.h"
+#include "point_simplex_squared_distance.h"
 #include "pseudonormal_test.h"
+#include "parallel_for.h"
+#include "morton_order.h"
+#include <functional>
+#include <limits>
 
 
+namespace igl
+{
+  namespace signed_distance_detail
+  {
+    // Number of consecutive queries (in Morton order) processed together,
+    // each seeding its search with the result of the previous one. Fixed so
+    // that results do not depend on the number of threads.
+    const int QUERY_BLOCK_SIZE = 64;
+    // Bounded signed distance of all queries in P
+    //
+    // Inputs:
+    //   exact_closest  whether sign needs the exact closest point
+    //   sign  function (q,i,c,n) returning the sign (or signed scale) at q
+    //     with closest primitive i and point c (i=-1 if unknown), setting n
+    //   low_sqr_d  squared lower bound
+    //   upper_bound  upper bound
+    template <int DIM>
+    inline void bounded_signed_distance(
+      const Eigen::MatrixXd & P,
+      const Eigen::MatrixXd & V,
+      const Eigen::MatrixXi & F,
+      const AABB<Eigen::MatrixXd,DIM> & tree,
+      const bool exact_closest,
+      const std::function<double(
+        const Eigen::Matrix<double,1,DIM> &,
+        const int,
+        const Eigen::Matrix<double,1,DIM> &,
+        Eigen::Matrix<double,1,DIM> &)> & sign,
+      const double low_sqr_d,
+      const double upper_bound,
+      Eigen::VectorXd & S,
+      Eigen::VectorXi & I,
+      Eigen::MatrixXd & C,
+      Eigen::MatrixXd & N)
+    {
+      typedef Eigen::Matrix<double,1,DIM> RowVectorDIMS;
+      const double up_sqr_d = upper_bound*upper_bound;
+      const double nan = std::numeric_limits<double>::quiet_NaN();
+      const int np = P.rows();
+      Eigen::VectorXi order;
+      morton_order(P,order);
+      const int num_blocks = (np+QUERY_BLOCK_SIZE-1)/QUERY_BLOCK_SIZE;
+      parallel_for(num_blocks,
+        [&P,&V,&F,&tree,exact_closest,&sign,low_sqr_d,upper_bound,up_sqr_d,
+         nan,np,&order,&S,&I,&C,&N](const int b)
+      {
+        const int end = std::min(np,(b+1)*QUERY_BLOCK_SIZE);
+        int prev = -1;
+        // Squared radius of a ball about the previous query known not to
+        // reach the surface
+        double prev_free_sqr_d = 0;
+        for(int k = b*QUERY_BLOCK_SIZE;k<end;k++)
+        {
+          const int p = order(k);
+          const RowVectorDIMS q = P.row(p);
+          double sqrd = up_sqr_d;
+          int i = -1;
+          RowVectorDIMS c,n;
+          // Previous query's closest primitive bounds the distance
+          if(prev >= 0 && I(prev) >= 0)
+          {
+            double prev_sqrd;
+            RowVectorDIMS prev_c;
+            point_simplex_squared_distance<DIM>(
+              q,V,F,I(prev),prev_sqrd,prev_c);
+            if(prev_sqrd < sqrd)
+            {
+              sqrd = prev_sqrd;
+              i = I(prev);
+              c = prev_c;
+            }
+          }
+          if(sqrd >= low_sqr_d)
+          {
+            sqrd = tree.squared_distance(V,F,q,low_sqr_d,sqrd,i,c);
+          }
+          if(i >= 0)
+          {
+            // Below the lower bound sqrd need not be the smallest
+            prev_free_sqr_d = sqrd < low_sqr_d ? 0 : sqrd;
+            S(p) = sign(q,i,c,n)*sqrt(sqrd);
+            I(p) = i;
+            C.row(p) = c;
+            if(exact_closest)
+            {
+              N.row(p) = n;
+            }
+          }else
+          {
+            double s;
+            if(prev >= 0 && (q-P.row(prev)).squaredNorm() < prev_free_sqr_d)
+            {
+              // q is on the same side as the previous query
+              s = S(prev);
+            }else if(exact_closest)
+            {
+              tree.squared_distance(V,F,q,i,c);
+              s = sign(q,i,c,n);
+            }else
+            {
+              s = sign(q,-1,c,n);
+            }
+            S(p) = s < 0 ? -upper_bound : upper_bound;
+            prev_free_sqr_d = up_sqr_d;
+            I(p) = -1;
+            C.row(p).setConstant(nan);
+            if(exact_closest)
+            {
+              N.row(p).setConstant(nan);
+            }
+          }
+          prev = p;
+        }
+      },1000/QUERY_BLOCK_SIZE);
+    }
+  }
+}
+
+IGL_INLINE void igl::signed_distance(
+  const Eigen::MatrixXd & P,
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const SignedDistanceType sign_type,
+  Eigen::VectorXd & S,
+  Eigen::VectorXi & I,
+  Eigen::MatrixXd & C,
+  Eigen::MatrixXd & N)
+{
+  return signed_distance(
+    P,V,F,sign_type,0.,std::numeric_limits<double>::infinity(),S,I,C,N);
+}
+
 IGL_INLINE void igl::signed_distance(
   const Eigen::MatrixXd & P,
   const Eigen::MatrixXd & V,
   const Eigen::MatrixXi & F,
   const SignedDistanceType sign_type,
+  const double lower_bound,
+  const double upper_bound,
   Eigen::VectorXd & S,
   Eigen::VectorXi & I,
   Eigen::MatrixXd & C,
   Eigen::MatrixXd & N)
 {
+  IGL_PROFILE_SCOPE("signed_distance");
   using namespace Eigen;
   using namespace std;
   const int dim = V.cols();
   assert((V.cols() == 3||V.cols() == 2) && "V should have 3d or 2d positions");
   assert((P.cols() == 3||P.cols() == 2) && "P should have 3d or 2d positions");
   assert(V.cols() == P.cols() && "V should have same dimension as P");
+  assert(lower_bound <= upper_bound && "lower_bound should be <= upper_bound");
   // Only unsigned distance is supported for non-triangles
   if(sign_type != SIGNED_DISTANCE_TYPE_UNSIGNED)
   {
@@ -54,6 +196,7 @@ IGL_INLINE void igl::signed_distance(
   Eigen::MatrixXi E;
   Eigen::VectorXi EMAP;
   WindingNumberAABB<Eigen::Vector3d> hier3;
+  FastWindingNumber fwn;
   switch(sign_type)
   {
     default:
@@ -61,6 +204,13 @@ IGL_INLINE void igl::signed_distance(
     case SIGNED_DISTANCE_TYPE_UNSIGNED:
       // do nothing
       break;
+    case SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER:
+      if(dim == 3)
+      {
+        fwn.init(V,F);
+        break;
+      }
+      // fall through
     case SIGNED_DISTANCE_TYPE_DEFAULT:
     case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
       switch(dim)
@@ -111,57 +261,101 @@ IGL_INLINE void igl::signed_distance(
   S.resize(P.rows(),1);
   I.resize(P.rows(),1);
   C.resize(P.rows(),dim);
-  for(int p = 0;p<P.rows();p++)
+  // The pseudonormal test needs the exact closest point
+  const bool exact_closest = sign_type == SIGNED_DISTANCE_TYPE_PSEUDONORMAL;
+  const double low_sqr_d = exact_closest ? 0. : lower_bound*lower_bound;
+  switch(dim)
   {
-    RowVector3d q3;
-    RowVector2d q2;
-    switch(P.cols())
+    default:
+    case 3:
     {
-      default:
-      case 3:
-        q3 = P.row(p);
-        break;
-      case 2:
-        q2 = P.row(p);
-        break;
+      std::function<double(
+        const RowVector3d &,const int,const RowVector3d &,RowVector3d &)> sign;
+      switch(sign_type)
+      {
+        default:
+        case SIGNED_DISTANCE_TYPE_UNSIGNED:
+          sign = [](
+            const RowVector3d &,const int,const RowVector3d &,RowVector3d &)
+          {
+            return 1.;
+          };
+          break;
+        case SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER:
+          sign = [&fwn](
+            const RowVector3d & q,const int,const RowVector3d &,RowVector3d &)
+          {
+            return fwn.winding_number(q) > 0.5 ? -1. : 1.;
+          };
+          break;
+        case SIGNED_DISTANCE_TYPE_DEFAULT:
+        case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
+          sign = [&hier3](
+            const RowVector3d & q,const int,const RowVector3d &,RowVector3d &)
+          {
+            return 1.-2.*hier3.winding_number(q.transpose());
+          };
+          break;
+        case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
+          sign = [&V,&F,&FN,&VN,&EN,&EMAP](
+            const RowVector3d & q,
+            const int i,
+            const RowVector3d & c,
+            RowVector3d & n)
+          {
+            double s;
+            pseudonormal_test(V,F,FN,VN,EN,EMAP,q,i,c,s,n);
+            return s;
+          };
+          break;
+      }
+      signed_distance_detail::bounded_signed_distance<3>(
+        P,V,F,tree3,exact_closest,sign,low_sqr_d,upper_bound,S,I,C,N);
+      break;
     }
-    double s,sqrd;
-    RowVectorXd c;
-    RowVector3d c3;
-    RowVector2d c2;
-    int i=-1;
-    switch(sign_type)
+    case 2:
     {
-      default:
-        assert(false && "Unknown SignedDistanceType");
-      case SIGNED_DISTANCE_TYPE_UNSIGNED:
-        s = 1.;
-        sqrd = dim==3?
-          tree3.squared_distance(V,F,q3,i,c3):
-          tree2.squared_distance(V,F,q2,i,c2);
-        break;
-      case SIGNED_DISTANCE_TYPE_DEFAULT:
-      case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
-        dim==3 ? 
-          signed_distance_winding_number(tree3,V,F,hier3,q3,s,sqrd,i,c3):
-          signed_distance_winding_number(tree2,V,F,q2,s,sqrd,i,c2);
-        break;
-      case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
+      std::function<double(
+        const RowVector2d &,const int,const RowVector2d &,RowVector2d &)> sign;
+      switch(sign_type)
       {
-        RowVector3d n3;
-        RowVector2d n2;
-        dim==3 ?
-          signed_distance_pseudonormal(tree3,V,F,FN,VN,EN,EMAP,q3,s,sqrd,i,c3,n3):
-          signed_distance_pseudonormal(tree2,V,F,FN,VN,q2,s,sqrd,i,c2,n2);
-        Eigen::RowVectorXd n;
-        (dim==3 ? n = n3 : n = n2);
-        N.row(p) = n;
-        break;
+        default:
+        case SIGNED_DISTANCE_TYPE_UNSIGNED:
+          sign = [](
+            const RowVector2d &,const int,const RowVector2d &,RowVector2d &)
+          {
+            return 1.;
+          };
+          break;
+        case SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER:
+        case SIGNED_DISTANCE_TYPE_DEFAULT:
+        case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
+          sign = [&V,&F](
+            const RowVector2d & q,const int,const RowVector2d &,RowVector2d &)
+          {
+            double w;
+            winding_number_2(
+              V.data(),V.rows(),F.data(),F.rows(),q.data(),1,&w);
+            return 1.-2.*w;
+          };
+          break;
+        case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
+          sign = [&V,&F,&FN,&VN](
+            const RowVector2d & q,
+            const int i,
+            const RowVector2d & c,
+            RowVector2d & n)
+          {
+            double s;
+            pseudonormal_test(V,F,FN,VN,q,i,c,s,n);
+            return s;
+          };
+          break;
       }
+      signed_distance_detail::bounded_signed_distance<2>(
+        P,V,F,tree2,exact_closest,sign,low_sqr_d,upper_bound,S,I,C,N);
+      break;
     }
-    I(p) = i;
-    S(p) = s*sqrt(sqrd);
-    C.row(p) = (dim==3 ? c=c3 : c=c2);
   }
 }
 
@@ -203,8 +397,9 @@ IGL_INLINE void igl::signed_distance_pseudonormal(
   I.resize(np,1);
   N.resize(np,3);
   C.resize(np,3);
-# pragma omp parallel for if(np>1000)
-  for(size_t p = 0;p<np;p++)
+  parallel_for(
+    np,
+    [&tree,&V,&F,&FN,&VN,&EN,&EMAP,&P,&S,&I,&N,&C](const size_t p)
   {
     double s,sqrd;
     RowVector3d n,c;
@@ -215,7 +410,7 @@ IGL_INLINE void igl::signed_distance_pseudonormal(
     I(p) = i;
     N.row(p) = n;
     C.row(p) = c;
-  }
+  },1000);
 //  igl::AABB<MatrixXd,3> tree_P;
 //  MatrixXi J = igl::LinSpaced<VectorXi >(P.rows(),0,P.rows()-1);
 //  tree_P.init(P,J);
@@ -308,6 +503,24 @@ IGL_INLINE void igl::signed_distance_winding_number(
   s = 1.-2.*w;
 }
 
+IGL_INLINE void igl::signed_distance_fast_winding_number(
+  const AABB<Eigen::MatrixXd,3> & tree,
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const igl::FastWindingNumber & fwn,
+  const Eigen::RowVector3d & q,
+  double & s,
+  double & sqrd,
+  int & i,
+  Eigen::RowVector3d & c,
+  const double beta)
+{
+  sqrd = tree.squared_distance(V,F,q,i,c);
+  // The approximation is not exactly 0 or 1 even for closed meshes, so only
+  // keep the sign
+  s = fwn.winding_number(q,beta) > 0.5 ? -1. : 1.;
+}
+
 IGL_INLINE void igl::signed_distance_winding_number(
   const AABB<Eigen::MatrixXd,2> & tree,
   const Eigen::MatrixXd & V,
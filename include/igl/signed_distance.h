@@ -11,6 +11,7 @@
 #include "igl_inline.h"
 #include "AABB.h"
 #include "WindingNumberAABB.h"
+#include "FastWindingNumber.h"
 #include <Eigen/Core>
 #include <vector>
 namespace igl
@@ -22,7 +23,10 @@ namespace igl
     SIGNED_DISTANCE_TYPE_WINDING_NUMBER = 1,
     SIGNED_DISTANCE_TYPE_DEFAULT        = 2,
     SIGNED_DISTANCE_TYPE_UNSIGNED       = 3,
-    NUM_SIGNED_DISTANCE_TYPE            = 4
+    // Use approximate winding number (see FastWindingNumber.h), falls back to
+    // SIGNED_DISTANCE_TYPE_WINDING_NUMBER in 2D
+    SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER = 4,
+    NUM_SIGNED_DISTANCE_TYPE            = 5
   };
   // Computes signed distance to a mesh
   //
@@ -50,6 +54,46 @@ namespace igl
     Eigen::VectorXi & I,
     Eigen::MatrixXd & C,
     Eigen::MatrixXd & N);
+  // Computes signed distance to a mesh, exactly only within a band around
+  // the surface.
+  //
+  // Queries are processed in blocks of nearby points (see
+  // igl::morton_order), each seeding its closest point search with the
+  // closest primitive of the previous one, so dense grids are much cheaper
+  // than independent queries.
+  //
+  // Inputs:
+  //   P  #P by 3 list of query point positions
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by ss list of triangle indices, ss should be 3 unless sign_type ==
+  //     SIGNED_DISTANCE_TYPE_UNSIGNED
+  //   sign_type  method for computing distance _sign_ S
+  //   lower_bound  points closer than this may get any primitive within
+  //     this distance rather than the closest one (ignored for
+  //     SIGNED_DISTANCE_TYPE_PSEUDONORMAL, which needs the closest one)
+  //   upper_bound  points farther than this get S = ±upper_bound
+  // Outputs:
+  //   S  #P list of smallest signed distances, clamped to
+  //     [-upper_bound,upper_bound]
+  //   I  #P list of facet indices corresponding to smallest distances (-1
+  //     for clamped points)
+  //   C  #P by 3 list of closest points (NaN for clamped points)
+  //   N  #P by 3 list of closest normals (only set if
+  //     sign_type=SIGNED_DISTANCE_TYPE_PSEUDONORMAL, NaN for clamped points)
+  //
+  // Known bugs: The sign of a clamped point may be copied from a nearby
+  // query, which assumes the mesh is closed.
+  IGL_INLINE void signed_distance(
+    const Eigen::MatrixXd & P,
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const SignedDistanceType sign_type,
+    const double lower_bound,
+    const double upper_bound,
+    Eigen::VectorXd & S,
+    Eigen::VectorXi & I,
+    Eigen::MatrixXd & C,
+    Eigen::MatrixXd & N);
   // Computes signed distance to mesh
   //
   // Inputs:
@@ -151,6 +195,27 @@ namespace igl
     double & sqrd,
     int & i,
     Eigen::Matrix<double,1,2> & c);
+  // Inputs:
+  //   tree  AABB acceleration tree (see AABB.h)
+  //   fwn  fast winding number hierarchy of the same mesh
+  //   q  Query point
+  //   beta  accuracy parameter of fast winding number {2}
+  // Outputs:
+  //   s  sign (-1 if winding number is above ½, otherwise 1)
+  //   sqrd  squared distance
+  //   i  closest primitive
+  //   c  closest point
+  IGL_INLINE void signed_distance_fast_winding_number(
+    const AABB<Eigen::MatrixXd,3> & tree,
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const igl::FastWindingNumber & fwn,
+    const Eigen::RowVector3d & q,
+    double & s,
+    double & sqrd,
+    int & i,
+    Eigen::RowVector3d & c,
+    const double beta = 2.0);
 }
 
 #ifndef IGL_STATIC_LIBRARY
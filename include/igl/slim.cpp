@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "slim.h"
+#include "Profiler.h"
 
 #include "boundary_loop.h"
 #include "cotmatrix.h"
@@ -878,6 +879,7 @@ IGL_INLINE void igl::slim_precompute(
 
 IGL_INLINE Eigen::MatrixXd igl::slim_solve(SLIMData &data, int iter_num)
 {
+  IGL_PROFILE_SCOPE("slim_solve");
   for (int i = 0; i < iter_num; i++)
   {
     Eigen::MatrixXd dest_res;
@@ -6,9 +6,40 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "snap_points.h"
+#include "KDTree.h"
 #include <cassert>
 #include <limits>
 
+namespace igl
+{
+  namespace snap_points_detail
+  {
+    // Snap with a kd-tree over V of compile-time dimension DIM. Ties are
+    // broken by smallest index into V.
+    template <
+      int DIM,
+      typename DerivedC,
+      typename DerivedV,
+      typename DerivedI,
+      typename DerivedminD>
+    inline void snap_points_kdtree(
+      const Eigen::PlainObjectBase<DerivedC > & C,
+      const Eigen::PlainObjectBase<DerivedV > & V,
+      Eigen::PlainObjectBase<DerivedI > & I,
+      Eigen::PlainObjectBase<DerivedminD > & minD)
+    {
+      typedef typename DerivedV::Scalar Scalar;
+      KDTree<Scalar,DIM> tree;
+      tree.init(V);
+      Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic> K;
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> D;
+      tree.knn(C,1,K,D);
+      I = K.col(0).template cast<typename DerivedI::Scalar>();
+      minD = D.col(0).template cast<typename DerivedminD::Scalar>();
+    }
+  }
+}
+
 template <
   typename DerivedC, 
   typename DerivedV, 
@@ -43,27 +74,26 @@ IGL_INLINE void igl::snap_points(
   Eigen::PlainObjectBase<DerivedminD > & minD)
 {
   using namespace std;
+  using namespace Eigen;
   const int n = V.rows();
   const int m = C.rows();
   assert(V.cols() == C.cols() && "Dimensions should match");
-  // O(m*n)
-  //
-  // I believe there should be a way to do this in O(m*log(n) + n) assuming
-  // reasonably distubed points.
-  I.resize(m,1);
   typedef typename DerivedV::Scalar Scalar;
+  I.resize(m,1);
   minD.setConstant(m,1,numeric_limits<Scalar>::max());
-  for(int v = 0;v<n;v++)
+  if(n == 0)
   {
-    for(int c = 0;c<m;c++)
-    {
-      const Scalar d = (C.row(c) - V.row(v)).squaredNorm();
-      if(d < minD(c))
-      {
-        minD(c,0) = d;
-        I(c,0) = v;
-      }
-    }
+    return;
+  }
+  // O(n log n + m log n) for reasonably distributed points
+  switch(V.cols())
+  {
+    case 2:
+      return snap_points_detail::snap_points_kdtree<2>(C,V,I,minD);
+    case 3:
+      return snap_points_detail::snap_points_kdtree<3>(C,V,I,minD);
+    default:
+      return snap_points_detail::snap_points_kdtree<Dynamic>(C,V,I,minD);
   }
 }
 
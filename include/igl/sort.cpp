@@ -12,6 +12,7 @@
 #include "IndexComparison.h"
 #include "colon.h"
 #include "parallel_for.h"
+#include "parallel_sort.h"
 
 #include <cassert>
 #include <algorithm>
@@ -47,7 +48,7 @@ IGL_INLINE void igl::sort(
   IX.resizeLike(X);
   // idea is to process each column (or row) as a std vector
   // loop over columns (or rows)
-  for(int i = 0; i<num_outer;i++)
+  const auto & inner = [&X,&Y,&IX,&dim,&ascending,&num_inner](const int i)
   {
     // Unsorted index map for this column (or row)
     std::vector<size_t> index_map(num_inner);
@@ -77,7 +78,10 @@ IGL_INLINE void igl::sort(
         IX(i,j) = index_map[j];
       }
     }
-  }
+  };
+  // Parallelize over columns (or rows) once there are ~16000 entries in
+  // total. Long columns (or rows) are also sorted in parallel themselves.
+  parallel_for(num_outer,inner,16000/std::max(num_inner,1)+1);
 }
 
 template <typename DerivedX, typename DerivedY, typename DerivedIX>
@@ -290,27 +294,9 @@ const bool ascending,
 std::vector<T> & sorted,
 std::vector<size_t> & index_map)
 {
-// Original unsorted index map
-index_map.resize(unsorted.size());
-for(size_t i=0;i<unsorted.size();i++)
-{
-  index_map[i] = i;
-}
-// Sort the index map, using unsorted for comparison
-std::sort(
-  index_map.begin(),
-  index_map.end(),
-  igl::IndexLessThan<const std::vector<T>& >(unsorted));
-
-// if not ascending then reverse
-if(!ascending)
-{
-  std::reverse(index_map.begin(),index_map.end());
-}
-  // make space for output without clobbering
-  sorted.resize(unsorted.size());
-  // reorder unsorted into sorted using index map
-  igl::reorder(unsorted,index_map,sorted);
+// Stable (like matlab) in both directions and independent of the size:
+// large lists are sorted in parallel, small ones with std::stable_sort
+igl::parallel_sort(unsorted,ascending,sorted,index_map,100000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
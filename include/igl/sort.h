@@ -69,6 +69,7 @@ namespace igl
   // Input:
   //   unsorted  unsorted vector
   //   ascending  sort ascending (true, matlab default) or descending (false)
+  //     equal elements keep their original relative order in both cases
   // Output:
   //   sorted     sorted vector, allowed to be same as unsorted
   //   index_map  an index map such that sorted[i] = unsorted[index_map[i]]
@@ -12,6 +12,8 @@
 #include "sort.h"
 #include "colon.h"
 #include "IndexComparison.h"
+#include "parallel_for.h"
+#include "parallel_sort.h"
 
 #include <vector>
 
@@ -78,11 +80,12 @@ IGL_INLINE void igl::sortrows(
       }
       return false;
     };
-      std::sort(
+      // Stable and parallel for large inputs
+      igl::parallel_sort(
         IX.data(),
         IX.data()+IX.size(),
-        index_less_than
-        );
+        index_less_than,
+        100000);
   } else {
     auto index_greater_than = [&X, num_cols](size_t i, size_t j) {
       for (size_t c=0; c<num_cols; c++) {
@@ -91,18 +94,22 @@ IGL_INLINE void igl::sortrows(
       }
       return false;
     };
-      std::sort(
+      igl::parallel_sort(
         IX.data(),
         IX.data()+IX.size(),
-        index_greater_than
-        );
+        index_greater_than,
+        100000);
   }
-  for (size_t j=0; j<num_cols; j++) {
-      for(int i = 0;i<num_rows;i++)
+  parallel_for(
+    num_rows,
+    [&X,&Y,&IX,num_cols](const size_t i)
+    {
+      for (size_t j=0; j<num_cols; j++)
       {
           Y(i,j) = X(IX(i), j);
       }
-  }
+    },
+    100000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -0,0 +1,593 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "stream_mesh.h"
+#include "pathinfo.h"
+#include "ply.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace igl
+{
+  namespace streaming
+  {
+    // Buffers vertices and triangles and hands them to the callbacks of
+    // stream_mesh a block at a time
+    class Blocks
+    {
+      public:
+        Blocks(
+          const int block_size,
+          const std::function<bool(const Eigen::MatrixXd &, const int)> &
+            vertices,
+          const std::function<bool(const Eigen::MatrixXi &, const int)> &
+            faces):
+          m_block_size(block_size),
+          m_vertices(vertices),
+          m_faces(faces),
+          m_V(block_size,3),
+          m_F(block_size,3),
+          m_nv(0),
+          m_nf(0),
+          m_first_v(0),
+          m_first_f(0),
+          m_stopped(false)
+        {}
+        // Number of vertices added so far
+        int64_t num_vertices() const
+        {
+          return m_first_v+m_nv;
+        }
+        bool vertex(const double x, const double y, const double z)
+        {
+          m_V(m_nv,0) = x;
+          m_V(m_nv,1) = y;
+          m_V(m_nv,2) = z;
+          m_nv++;
+          return m_nv < m_block_size || flush_vertices();
+        }
+        bool face(const int64_t a, const int64_t b, const int64_t c)
+        {
+          if(std::min(a,std::min(b,c)) < 0 ||
+             std::max(a,std::max(b,c)) > INT_MAX)
+          {
+            fprintf(stderr,"IOError: stream_mesh() bad vertex index\n");
+            m_stopped = true;
+            return false;
+          }
+          m_F(m_nf,0) = (int)a;
+          m_F(m_nf,1) = (int)b;
+          m_F(m_nf,2) = (int)c;
+          m_nf++;
+          return m_nf < m_block_size || flush_faces();
+        }
+        // Hand over what's left
+        bool finish()
+        {
+          return flush_vertices() && flush_faces();
+        }
+      private:
+        bool flush_vertices()
+        {
+          return flush(m_vertices,m_V,m_nv,m_first_v);
+        }
+        bool flush_faces()
+        {
+          // Faces never come before the vertices they use
+          return flush_vertices() && flush(m_faces,m_F,m_nf,m_first_f);
+        }
+        template <typename Mat>
+        bool flush(
+          const std::function<bool(const Mat &, const int)> & func,
+          Mat & B,
+          int & n,
+          int64_t & first)
+        {
+          if(m_stopped)
+          {
+            return false;
+          }
+          if(n == 0)
+          {
+            return true;
+          }
+          if(first+n > INT_MAX)
+          {
+            fprintf(stderr,"IOError: stream_mesh() too many elements\n");
+            m_stopped = true;
+            return false;
+          }
+          bool go_on;
+          if(n == m_block_size)
+          {
+            go_on = func(B,(int)first);
+          }else
+          {
+            B.conservativeResize(n,3);
+            go_on = func(B,(int)first);
+            B.resize(m_block_size,3);
+          }
+          first += n;
+          n = 0;
+          m_stopped = !go_on;
+          return go_on;
+        }
+        const int m_block_size;
+        const std::function<bool(const Eigen::MatrixXd &, const int)> &
+          m_vertices;
+        const std::function<bool(const Eigen::MatrixXi &, const int)> &
+          m_faces;
+        Eigen::MatrixXd m_V;
+        Eigen::MatrixXi m_F;
+        int m_nv,m_nf;
+        int64_t m_first_v,m_first_f;
+        bool m_stopped;
+    };
+    // Reads a file line by line through a fixed (unless lines are longer)
+    // buffer
+    class LineReader
+    {
+      public:
+        LineReader(FILE * fp):
+          m_fp(fp),
+          m_buffer(1<<16),
+          m_begin(0),
+          m_end(0),
+          m_eof(false)
+        {}
+        // Returns next line without line break (null-terminated and
+        // modifiable), NULL at end of file
+        char * next()
+        {
+          while(true)
+          {
+            char * b = m_buffer.data()+m_begin;
+            char * nl = (char *)memchr(b,'\n',m_end-m_begin);
+            if(nl != NULL || (m_eof && m_begin < m_end))
+            {
+              char * e = nl ? nl : m_buffer.data()+m_end;
+              m_begin = nl ? nl+1-m_buffer.data() : m_end;
+              if(e > b && e[-1] == '\r')
+              {
+                e--;
+              }
+              *e = '\0';
+              return b;
+            }
+            if(m_eof)
+            {
+              return NULL;
+            }
+            // Keep the partial line and read more
+            memmove(m_buffer.data(),b,m_end-m_begin);
+            m_end -= m_begin;
+            m_begin = 0;
+            if(m_end+1 >= m_buffer.size())
+            {
+              m_buffer.resize(2*m_buffer.size());
+            }
+            // Leave room to terminate the last line
+            const size_t count =
+              fread(m_buffer.data()+m_end,1,m_buffer.size()-1-m_end,m_fp);
+            m_end += count;
+            m_eof = count == 0;
+          }
+        }
+      private:
+        FILE * m_fp;
+        std::vector<char> m_buffer;
+        size_t m_begin,m_end;
+        bool m_eof;
+    };
+    inline char * skip_space(char * s)
+    {
+      while(*s == ' ' || *s == '\t')
+      {
+        s++;
+      }
+      return s;
+    }
+    // Parse n doubles from s into x, false if there are fewer
+    inline bool parse_doubles(char * s, const int n, double * x)
+    {
+      for(int i = 0;i<n;i++)
+      {
+        char * e;
+        x[i] = strtod(s,&e);
+        if(e == s)
+        {
+          return false;
+        }
+        s = e;
+      }
+      return true;
+    }
+    // Fan-triangulate polygon with corners P
+    inline bool fan(const std::vector<int64_t> & P, Blocks & blocks)
+    {
+      for(size_t i = 2;i<P.size();i++)
+      {
+        if(!blocks.face(P[0],P[i-1],P[i]))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    inline bool stream_obj(FILE * fp, Blocks & blocks)
+    {
+      LineReader lines(fp);
+      std::vector<int64_t> P;
+      long long line_no = 0;
+      char * l;
+      while((l = lines.next()) != NULL)
+      {
+        line_no++;
+        l = skip_space(l);
+        if(l[0] == 'v' && (l[1] == ' ' || l[1] == '\t'))
+        {
+          double x[3];
+          if(!parse_doubles(l+2,3,x))
+          {
+            fprintf(stderr,"IOError: stream_mesh() bad vertex on line %lld\n",
+              line_no);
+            return false;
+          }
+          if(!blocks.vertex(x[0],x[1],x[2]))
+          {
+            return false;
+          }
+        }else if(l[0] == 'f' && (l[1] == ' ' || l[1] == '\t'))
+        {
+          // Only the position index of each v/vt/vn corner
+          P.clear();
+          char * s = l+2;
+          while(true)
+          {
+            s = skip_space(s);
+            if(*s == '\0')
+            {
+              break;
+            }
+            char * e;
+            const long long i = strtoll(s,&e,10);
+            if(e == s || i == 0)
+            {
+              fprintf(stderr,"IOError: stream_mesh() bad face on line %lld\n",
+                line_no);
+              return false;
+            }
+            P.push_back(i < 0 ? blocks.num_vertices()+i : i-1);
+            s = e;
+            while(*s != '\0' && *s != ' ' && *s != '\t')
+            {
+              s++;
+            }
+          }
+          if(!fan(P,blocks))
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+    // Next line of an off file that isn't blank or a comment
+    inline char * next_off_line(LineReader & lines)
+    {
+      char * l;
+      while((l = lines.next()) != NULL)
+      {
+        char * c = strchr(l,'#');
+        if(c)
+        {
+          *c = '\0';
+        }
+        l = skip_space(l);
+        if(*l != '\0')
+        {
+          return l;
+        }
+      }
+      return NULL;
+    }
+    inline bool stream_off(FILE * fp, Blocks & blocks)
+    {
+      LineReader lines(fp);
+      // [ST][C][N][4][n]OFF, possibly followed by the counts
+      char * l = next_off_line(lines);
+      char * off = l ? strstr(l,"OFF") : NULL;
+      if(off == NULL)
+      {
+        fprintf(stderr,"IOError: stream_mesh() first line should be OFF\n");
+        return false;
+      }
+      char * s = skip_space(off+3);
+      if(*s == '\0')
+      {
+        s = next_off_line(lines);
+      }
+      char * e;
+      const long long nv = s ? strtoll(s,&e,10) : -1;
+      const long long nf = s && e != s ? strtoll(e,&s,10) : -1;
+      if(nv < 0 || nf < 0)
+      {
+        fprintf(stderr,"IOError: stream_mesh() bad number of elements\n");
+        return false;
+      }
+      for(long long i = 0;i<nv;i++)
+      {
+        double x[3];
+        l = next_off_line(lines);
+        if(l == NULL || !parse_doubles(l,3,x))
+        {
+          fprintf(stderr,"IOError: stream_mesh() bad vertex %lld\n",i);
+          return false;
+        }
+        if(!blocks.vertex(x[0],x[1],x[2]))
+        {
+          return false;
+        }
+      }
+      std::vector<int64_t> P;
+      for(long long f = 0;f<nf;f++)
+      {
+        l = next_off_line(lines);
+        const long long n = l ? strtoll(l,&e,10) : -1;
+        bool ok = l != NULL && e != l && n >= 0;
+        P.resize(ok ? n : 0);
+        for(long long c = 0;ok && c<n;c++)
+        {
+          s = e;
+          P[c] = strtoll(s,&e,10);
+          ok = e != s;
+        }
+        if(!ok)
+        {
+          fprintf(stderr,"IOError: stream_mesh() bad face %lld\n",f);
+          return false;
+        }
+        if(!fan(P,blocks))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    inline bool stream_stl(FILE * fp, Blocks & blocks)
+    {
+      // Same test as readSTL: ascii files start with "solid", unless the size
+      // matches the binary layout (some binary files start with "solid" too)
+      char header[84];
+      const bool has_header = fread(header,1,84,fp) == 84;
+      uint32_t num_tri = 0;
+      bool binary = false;
+      if(has_header)
+      {
+        memcpy(&num_tri,header+80,sizeof(uint32_t));
+        const char * p = header;
+        while(p<header+80 && isspace((unsigned char)*p))
+        {
+          p++;
+        }
+        binary = !(header+80-p >= 5 && strncmp(p,"solid",5) == 0 &&
+          (header+80-p == 5 || isspace((unsigned char)p[5])));
+        if(!binary)
+        {
+#ifdef _WIN32
+          _fseeki64(fp,0,SEEK_END);
+          const long long size = _ftelli64(fp);
+#else
+          fseeko(fp,0,SEEK_END);
+          const long long size = ftello(fp);
+#endif
+          binary = size == 84+50*(long long)num_tri;
+          fseek(fp,84,SEEK_SET);
+        }
+      }
+      if(binary)
+      {
+        const int chunk = 4096;
+        std::vector<char> buffer(50*chunk);
+        for(uint32_t t = 0;t<num_tri;t += chunk)
+        {
+          const uint32_t n = std::min<uint32_t>(chunk,num_tri-t);
+          if(fread(buffer.data(),50,n,fp) != n)
+          {
+            fprintf(stderr,"IOError: stream_mesh() stl file is too short\n");
+            return false;
+          }
+          for(uint32_t r = 0;r<n;r++)
+          {
+            // Skip normal
+            float x[9];
+            memcpy(x,buffer.data()+50*r+12,sizeof(x));
+            const int64_t v = blocks.num_vertices();
+            if(!blocks.vertex(x[0],x[1],x[2]) ||
+               !blocks.vertex(x[3],x[4],x[5]) ||
+               !blocks.vertex(x[6],x[7],x[8]) ||
+               !blocks.face(v,v+1,v+2))
+            {
+              return false;
+            }
+          }
+        }
+        return true;
+      }
+      rewind(fp);
+      LineReader lines(fp);
+      int corner = 0;
+      char * l;
+      while((l = lines.next()) != NULL)
+      {
+        l = skip_space(l);
+        if(strncmp(l,"vertex",6) != 0)
+        {
+          continue;
+        }
+        double x[3];
+        if(!parse_doubles(l+6,3,x))
+        {
+          fprintf(stderr,"IOError: stream_mesh() bad stl vertex\n");
+          return false;
+        }
+        if(!blocks.vertex(x[0],x[1],x[2]))
+        {
+          return false;
+        }
+        if(++corner == 3)
+        {
+          const int64_t v = blocks.num_vertices();
+          if(!blocks.face(v-3,v-2,v-1))
+          {
+            return false;
+          }
+          corner = 0;
+        }
+      }
+      return true;
+    }
+    // Closes fp
+    inline bool stream_ply(FILE * fp, Blocks & blocks)
+    {
+      struct Vertex
+      {
+        double x,y,z;
+      };
+      struct Face
+      {
+        int n;
+        int * verts;
+      };
+      PlyProperty vert_props[] = {
+        {"x", PLY_DOUBLE, PLY_DOUBLE, offsetof(Vertex,x), 0, 0, 0, 0},
+        {"y", PLY_DOUBLE, PLY_DOUBLE, offsetof(Vertex,y), 0, 0, 0, 0},
+        {"z", PLY_DOUBLE, PLY_DOUBLE, offsetof(Vertex,z), 0, 0, 0, 0},
+      };
+      int nelems;
+      char ** elem_names;
+      PlyFile * in_ply = ply_read(fp,&nelems,&elem_names);
+      if(in_ply == NULL)
+      {
+        fclose(fp);
+        fprintf(stderr,"IOError: stream_mesh() bad ply header\n");
+        return false;
+      }
+      bool ok = true;
+      std::vector<int64_t> P;
+      // Elements have to be read in the order they appear
+      for(int e = 0;ok && e<in_ply->nelems;e++)
+      {
+        PlyElement * elem = in_ply->elems[e];
+        if(equal_strings(elem->name,"vertex"))
+        {
+          ply_get_element_setup(in_ply,elem->name,3,vert_props);
+          for(int j = 0;ok && j<elem->num;j++)
+          {
+            Vertex v;
+            ply_get_element(in_ply,(void *)&v);
+            ok = blocks.vertex(v.x,v.y,v.z);
+          }
+        }else if(equal_strings(elem->name,"face"))
+        {
+          // Either name is common
+          PlyProperty face_prop =
+            {"vertex_indices", PLY_INT, PLY_INT, offsetof(Face,verts),
+              1, PLY_INT, PLY_INT, offsetof(Face,n)};
+          int index;
+          if(find_property(elem,face_prop.name,&index) == NULL)
+          {
+            face_prop.name = "vertex_index";
+          }
+          ply_get_element_setup(in_ply,elem->name,1,&face_prop);
+          for(int j = 0;ok && j<elem->num;j++)
+          {
+            Face f;
+            f.n = 0;
+            f.verts = NULL;
+            ply_get_element(in_ply,(void *)&f);
+            P.assign(f.verts,f.verts+f.n);
+            free(f.verts);
+            ok = fan(P,blocks);
+          }
+        }else
+        {
+          // Skip over other elements without storing anything
+          ply_get_element_setup(in_ply,elem->name,0,NULL);
+          std::vector<char> ignored(std::max(elem->size,1));
+          for(int j = 0;j<elem->num;j++)
+          {
+            ply_get_element(in_ply,(void *)ignored.data());
+          }
+        }
+      }
+      for(int e = 0;e<nelems;e++)
+      {
+        free(elem_names[e]);
+      }
+      free(elem_names);
+      ply_close(in_ply);
+      return ok;
+    }
+  }
+}
+
+IGL_INLINE bool igl::stream_mesh(
+  const std::string & filename,
+  const int block_size,
+  const std::function<bool(const Eigen::MatrixXd &, const int)> & vertices,
+  const std::function<bool(const Eigen::MatrixXi &, const int)> & faces)
+{
+  using namespace igl::streaming;
+  if(block_size <= 0)
+  {
+    fprintf(stderr,"IOError: stream_mesh() block_size should be positive\n");
+    return false;
+  }
+  std::string d,b,ext,f;
+  pathinfo(filename,d,b,ext,f);
+  std::transform(ext.begin(),ext.end(),ext.begin(),::tolower);
+  bool (*stream)(FILE *, Blocks &);
+  if(ext == "obj")
+  {
+    stream = stream_obj;
+  }else if(ext == "off")
+  {
+    stream = stream_off;
+  }else if(ext == "ply")
+  {
+    stream = stream_ply;
+  }else if(ext == "stl")
+  {
+    stream = stream_stl;
+  }else
+  {
+    fprintf(stderr,"IOError: stream_mesh() %s is not a supported format\n",
+      filename.c_str());
+    return false;
+  }
+  FILE * fp = fopen(filename.c_str(),"rb");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"IOError: %s could not be opened...\n",filename.c_str());
+    return false;
+  }
+  Blocks blocks(block_size,vertices,faces);
+  const bool ok = stream(fp,blocks) && blocks.finish();
+  // stream_ply closes the file itself
+  if(ext != "ply")
+  {
+    fclose(fp);
+  }
+  return ok;
+}
@@ -0,0 +1,68 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_STREAM_MESH_H
+#define IGL_STREAM_MESH_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <functional>
+#include <string>
+
+namespace igl
+{
+  // Read a mesh that may not fit in memory by handing it to callbacks in
+  // blocks of at most block_size vertices or triangles, as it is parsed.
+  // Only the current blocks are kept in memory. Supports obj, off, ply (ascii
+  // and binary) and stl (ascii and binary); the format is detected from the
+  // extension as in read_triangle_mesh.
+  //
+  // Vertices and faces are numbered in file order and face indices refer to
+  // the whole mesh (not to the current block). Any vertices read so far are
+  // handed over before each block of faces, so all vertices referenced by a
+  // block of faces have already been seen (as long as the file doesn't
+  // refer to vertices further down, which no supported format does in
+  // practice). Polygons are fan-triangulated; stl files are not welded, so
+  // every facet brings its own 3 vertices.
+  //
+  // Inputs:
+  //   filename  path to mesh file
+  //   block_size  maximum number of rows handed to a callback at once
+  //   vertices  function called with a block of vertex positions (at most
+  //     block_size by 3) and the index of its first vertex in the mesh.
+  //     Returning false stops reading.
+  //   faces  function called with a block of triangles (at most block_size
+  //     by 3) and the index of its first triangle in the mesh. Returning
+  //     false stops reading.
+  // Returns true on success, false (with message to stderr) on errors or if
+  // a callback stopped reading
+  //
+  // Example:
+  //   // Bounding box of a huge mesh
+  //   Eigen::RowVector3d min_c = Eigen::RowVector3d::Constant( 1e300);
+  //   Eigen::RowVector3d max_c = Eigen::RowVector3d::Constant(-1e300);
+  //   igl::stream_mesh("huge.ply",1<<16,
+  //     [&](const Eigen::MatrixXd & V, const int)
+  //     {
+  //       min_c = min_c.cwiseMin(V.colwise().minCoeff());
+  //       max_c = max_c.cwiseMax(V.colwise().maxCoeff());
+  //       return true;
+  //     },
+  //     [](const Eigen::MatrixXi &, const int){ return true; });
+  //
+  // See also: read_triangle_mesh
+  IGL_INLINE bool stream_mesh(
+    const std::string & filename,
+    const int block_size,
+    const std::function<bool(const Eigen::MatrixXd &, const int)> & vertices,
+    const std::function<bool(const Eigen::MatrixXi &, const int)> & faces);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "stream_mesh.cpp"
+#endif
+
+#endif
@@ -7,6 +7,9 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "sum.h"
 #include "redux.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <vector>
 
 template <typename T>
 IGL_INLINE void igl::sum(
@@ -27,6 +30,79 @@ IGL_INLINE void igl::sum(
     S = Eigen::SparseVector<T>(m);
   }
 
+  if(X.nonZeros() >= 100000 && X.isCompressed())
+  {
+    // Dense accumulation in parallel. Results do not depend on the number of
+    // threads (column sums are even identical to the serial loop below).
+    const auto * outer = X.outerIndexPtr();
+    const auto * inner = X.innerIndexPtr();
+    const T * value = X.valuePtr();
+    const int ns = S.size();
+    Eigen::Matrix<T,Eigen::Dynamic,1> D = 
+      Eigen::Matrix<T,Eigen::Dynamic,1>::Zero(ns);
+    std::vector<char> touched(ns,0);
+    if(dim == 1)
+    {
+      // Column sums of column-major matrix: independent outer vectors
+      parallel_for(X.outerSize(),[&](const int k)
+      {
+        for(auto p = outer[k];p<outer[k+1];p++)
+        {
+          D(k) += value[p];
+          touched[k] = 1;
+        }
+      },2);
+    }else
+    {
+      // Row sums: a single pass over the nonzeros. Columns are cut into a
+      // fixed number of contiguous chunks of about equal nonzero count, each
+      // accumulating into its own dense rows. The chunks are then added in
+      // order, so the result does not depend on the number of threads. The
+      // dense accumulators never take more entries than there are nonzeros.
+      const int nnz = X.nonZeros();
+      const int nchunks =
+        std::max(1,std::min(std::min(16,nnz/65536),nnz/std::max(ns,1)));
+      std::vector<int> first(nchunks+1,X.outerSize());
+      first[0] = 0;
+      for(int c = 1;c<nchunks;c++)
+      {
+        const long long target = (long long)nnz*c/nchunks;
+        first[c] = std::upper_bound(outer,outer+X.outerSize(),target)-outer-1;
+      }
+      Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> DC =
+        Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>::Zero(ns,nchunks);
+      std::vector<char> touched_c((size_t)ns*nchunks,0);
+      parallel_for(nchunks,[&](const int c)
+      {
+        for(int k = first[c];k<first[c+1];k++)
+        {
+          for(auto p = outer[k];p<outer[k+1];p++)
+          {
+            DC(inner[p],c) += value[p];
+            touched_c[(size_t)c*ns+inner[p]] = 1;
+          }
+        }
+      },2);
+      parallel_for(ns,[&](const int i)
+      {
+        for(int c = 0;c<nchunks;c++)
+        {
+          D(i) += DC(i,c);
+          touched[i] |= touched_c[(size_t)c*ns+i];
+        }
+      },1024);
+    }
+    S.reserve(std::count(touched.begin(),touched.end(),1));
+    for(int i = 0;i<ns;i++)
+    {
+      if(touched[i])
+      {
+        S.insertBack(i) = D(i);
+      }
+    }
+    return;
+  }
+
   // Iterate over outside
   for(int k=0; k<X.outerSize(); ++k)
   {
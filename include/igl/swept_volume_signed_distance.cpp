@@ -14,6 +14,8 @@
 #include "per_face_normals.h"
 #include "per_vertex_normals.h"
 #include "per_edge_normals.h"
+#include "point_simplex_squared_distance.h"
+#include "parallel_for.h"
 #include <Eigen/Geometry>
 #include <cmath>
 
@@ -49,44 +51,69 @@ IGL_INLINE void igl::swept_volume_signed_distance(
     V,F,PER_EDGE_NORMALS_WEIGHTING_TYPE_UNIFORM,FN,EN,E,EMAP);
   AABB<MatrixXd,3> tree;
   tree.init(V,F);
+  const double min_sqrd = 
+    finite_iso ? 
+    pow(sqrt(3.)*h+isolevel,2) : 
+    numeric_limits<double>::infinity();
+  // Grid points are processed in blocks of consecutive (thus nearby) points,
+  // each seeding its closest point search with the closest triangle of the
+  // previous one
+  const int block_size = 64;
+  const int num_blocks = (GV.rows()+block_size-1)/block_size;
   for(int ti = 0;ti<t.size();ti++)
   {
     const Affine3d At = transform(t(ti));
-    for(int g = 0;g<GV.rows();g++)
+    parallel_for(num_blocks,
+      [&V,&F,&FN,&VN,&EN,&EMAP,&GV,h,isolevel,finite_iso,&box,&tree,
+       min_sqrd,block_size,&At,&S](const int b)
     {
-      // Don't bother finding out how deep inside points are.
-      if(finite_iso && S(g)==S(g) && S(g)<isolevel-sqrt(3.0)*h)
+      int prev_i = -1;
+      const int end = std::min<int>(GV.rows(),(b+1)*block_size);
+      for(int g = b*block_size;g<end;g++)
       {
-        continue;
-      }
-      const RowVector3d gv = 
-        (GV.row(g) - At.translation().transpose())*At.linear();
-      // If outside of extended box, then consider it "far away enough"
-      if(finite_iso && !box.contains(gv.transpose()))
-      {
-        continue;
-      }
-      RowVector3d c,n;
-      int i;
-      double sqrd,s;
-      //signed_distance_pseudonormal(tree,V,F,FN,VN,EN,EMAP,gv,s,sqrd,i,c,n);
-      const double min_sqrd = 
-        finite_iso ? 
-        pow(sqrt(3.)*h+isolevel,2) : 
-        numeric_limits<double>::infinity();
-      sqrd = tree.squared_distance(V,F,gv,min_sqrd,i,c);
-      if(sqrd<min_sqrd)
-      {
-        pseudonormal_test(V,F,FN,VN,EN,EMAP,gv,i,c,s,n);
-        if(S(g) == S(g))
+        // Don't bother finding out how deep inside points are.
+        if(finite_iso && S(g)==S(g) && S(g)<isolevel-sqrt(3.0)*h)
         {
-          S(g) = min(S(g),s*sqrt(sqrd));
-        }else
+          continue;
+        }
+        const RowVector3d gv = 
+          (GV.row(g) - At.translation().transpose())*At.linear();
+        // If outside of extended box, then consider it "far away enough"
+        if(finite_iso && !box.contains(gv.transpose()))
+        {
+          continue;
+        }
+        RowVector3d c,n;
+        int i = -1;
+        double sqrd = min_sqrd,s;
+        if(prev_i >= 0)
+        {
+          double prev_sqrd;
+          RowVector3d prev_c;
+          point_simplex_squared_distance<3>(gv,V,F,prev_i,prev_sqrd,prev_c);
+          if(prev_sqrd < sqrd)
+          {
+            sqrd = prev_sqrd;
+            i = prev_i;
+            c = prev_c;
+          }
+        }
+        //signed_distance_pseudonormal(tree,V,F,FN,VN,EN,EMAP,gv,s,sqrd,i,c,n);
+        sqrd = tree.squared_distance(V,F,gv,sqrd,i,c);
+        if(sqrd<min_sqrd)
         {
-          S(g) = s*sqrt(sqrd);
+          prev_i = i;
+          pseudonormal_test(V,F,FN,VN,EN,EMAP,gv,i,c,s,n);
+          if(S(g) == S(g))
+          {
+            S(g) = min(S(g),s*sqrt(sqrd));
+          }else
+          {
+            S(g) = s*sqrt(sqrd);
+          }
         }
       }
-    }
+    },1000/block_size);
   }
 
   if(finite_iso)
@@ -0,0 +1,486 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "to_chars.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace igl
+{
+  namespace grisu
+  {
+    // "Do-it-yourself" floating point number f*2^e
+    struct DiyFp
+    {
+      uint64_t f;
+      int e;
+      DiyFp(const uint64_t _f, const int _e):f(_f),e(_e){}
+    };
+    // Upper 64 bits (rounded) of the 128-bit product
+    inline DiyFp times(const DiyFp & a, const DiyFp & b)
+    {
+      const uint64_t M32 = 0xFFFFFFFFu;
+      const uint64_t ah = a.f>>32, al = a.f&M32;
+      const uint64_t bh = b.f>>32, bl = b.f&M32;
+      const uint64_t hh = ah*bh, lh = al*bh, hl = ah*bl, ll = al*bl;
+      uint64_t mid = (ll>>32) + (hl&M32) + (lh&M32);
+      mid += uint64_t(1)<<31;
+      return DiyFp(hh + (hl>>32) + (lh>>32) + (mid>>32), a.e + b.e + 64);
+    }
+    inline DiyFp normalize(const DiyFp & a)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      const int s = __builtin_clzll(a.f);
+      return DiyFp(a.f<<s, a.e-s);
+#else
+      DiyFp r = a;
+      while(!(r.f & (uint64_t(1)<<63)))
+      {
+        r.f <<= 1;
+        r.e--;
+      }
+      return r;
+#endif
+    }
+    // Cached power of ten c = 10^-K such that the exponent of w*c (for w of
+    // binary exponent e) lands in [-60,-32].
+    inline DiyFp cached_power(const int e, int & K)
+    {
+      // 10^k for k = -348,-340,...,340 as normalized (significand,exponent)
+      static const struct { uint64_t f; int e; } POWERS[] =
+      {
+        {0xfa8fd5a0081c0288ULL, -1220},
+        {0xbaaee17fa23ebf76ULL, -1193},
+        {0x8b16fb203055ac76ULL, -1166},
+        {0xcf42894a5dce35eaULL, -1140},
+        {0x9a6bb0aa55653b2dULL, -1113},
+        {0xe61acf033d1a45dfULL, -1087},
+        {0xab70fe17c79ac6caULL, -1060},
+        {0xff77b1fcbebcdc4fULL, -1034},
+        {0xbe5691ef416bd60cULL, -1007},
+        {0x8dd01fad907ffc3cULL, -980},
+        {0xd3515c2831559a83ULL, -954},
+        {0x9d71ac8fada6c9b5ULL, -927},
+        {0xea9c227723ee8bcbULL, -901},
+        {0xaecc49914078536dULL, -874},
+        {0x823c12795db6ce57ULL, -847},
+        {0xc21094364dfb5637ULL, -821},
+        {0x9096ea6f3848984fULL, -794},
+        {0xd77485cb25823ac7ULL, -768},
+        {0xa086cfcd97bf97f4ULL, -741},
+        {0xef340a98172aace5ULL, -715},
+        {0xb23867fb2a35b28eULL, -688},
+        {0x84c8d4dfd2c63f3bULL, -661},
+        {0xc5dd44271ad3cdbaULL, -635},
+        {0x936b9fcebb25c996ULL, -608},
+        {0xdbac6c247d62a584ULL, -582},
+        {0xa3ab66580d5fdaf6ULL, -555},
+        {0xf3e2f893dec3f126ULL, -529},
+        {0xb5b5ada8aaff80b8ULL, -502},
+        {0x87625f056c7c4a8bULL, -475},
+        {0xc9bcff6034c13053ULL, -449},
+        {0x964e858c91ba2655ULL, -422},
+        {0xdff9772470297ebdULL, -396},
+        {0xa6dfbd9fb8e5b88fULL, -369},
+        {0xf8a95fcf88747d94ULL, -343},
+        {0xb94470938fa89bcfULL, -316},
+        {0x8a08f0f8bf0f156bULL, -289},
+        {0xcdb02555653131b6ULL, -263},
+        {0x993fe2c6d07b7facULL, -236},
+        {0xe45c10c42a2b3b06ULL, -210},
+        {0xaa242499697392d3ULL, -183},
+        {0xfd87b5f28300ca0eULL, -157},
+        {0xbce5086492111aebULL, -130},
+        {0x8cbccc096f5088ccULL, -103},
+        {0xd1b71758e219652cULL, -77},
+        {0x9c40000000000000ULL, -50},
+        {0xe8d4a51000000000ULL, -24},
+        {0xad78ebc5ac620000ULL, 3},
+        {0x813f3978f8940984ULL, 30},
+        {0xc097ce7bc90715b3ULL, 56},
+        {0x8f7e32ce7bea5c70ULL, 83},
+        {0xd5d238a4abe98068ULL, 109},
+        {0x9f4f2726179a2245ULL, 136},
+        {0xed63a231d4c4fb27ULL, 162},
+        {0xb0de65388cc8ada8ULL, 189},
+        {0x83c7088e1aab65dbULL, 216},
+        {0xc45d1df942711d9aULL, 242},
+        {0x924d692ca61be758ULL, 269},
+        {0xda01ee641a708deaULL, 295},
+        {0xa26da3999aef774aULL, 322},
+        {0xf209787bb47d6b85ULL, 348},
+        {0xb454e4a179dd1877ULL, 375},
+        {0x865b86925b9bc5c2ULL, 402},
+        {0xc83553c5c8965d3dULL, 428},
+        {0x952ab45cfa97a0b3ULL, 455},
+        {0xde469fbd99a05fe3ULL, 481},
+        {0xa59bc234db398c25ULL, 508},
+        {0xf6c69a72a3989f5cULL, 534},
+        {0xb7dcbf5354e9beceULL, 561},
+        {0x88fcf317f22241e2ULL, 588},
+        {0xcc20ce9bd35c78a5ULL, 614},
+        {0x98165af37b2153dfULL, 641},
+        {0xe2a0b5dc971f303aULL, 667},
+        {0xa8d9d1535ce3b396ULL, 694},
+        {0xfb9b7cd9a4a7443cULL, 720},
+        {0xbb764c4ca7a44410ULL, 747},
+        {0x8bab8eefb6409c1aULL, 774},
+        {0xd01fef10a657842cULL, 800},
+        {0x9b10a4e5e9913129ULL, 827},
+        {0xe7109bfba19c0c9dULL, 853},
+        {0xac2820d9623bf429ULL, 880},
+        {0x80444b5e7aa7cf85ULL, 907},
+        {0xbf21e44003acdd2dULL, 933},
+        {0x8e679c2f5e44ff8fULL, 960},
+        {0xd433179d9c8cb841ULL, 986},
+        {0x9e19db92b4e31ba9ULL, 1013},
+        {0xeb96bf6ebadf77d9ULL, 1039},
+        {0xaf87023b9bf0ee6bULL, 1066}
+      };
+      const double dk = (-61 - e) * 0.30102999566398114 + 347;
+      int k = static_cast<int>(dk);
+      if(dk - k > 0.0)
+      {
+        k++;
+      }
+      const int index = (k>>3)+1;
+      K = -(-348 + index*8);
+      return DiyFp(POWERS[index].f,POWERS[index].e);
+    }
+    inline int count_digits(const uint32_t n)
+    {
+      if(n < 10) return 1;
+      if(n < 100) return 2;
+      if(n < 1000) return 3;
+      if(n < 10000) return 4;
+      if(n < 100000) return 5;
+      if(n < 1000000) return 6;
+      if(n < 10000000) return 7;
+      if(n < 100000000) return 8;
+      if(n < 1000000000) return 9;
+      return 10;
+    }
+    static const uint64_t POW10[] =
+    {
+      1ULL,10ULL,100ULL,1000ULL,10000ULL,100000ULL,1000000ULL,10000000ULL,
+      100000000ULL,1000000000ULL,10000000000ULL,100000000000ULL,
+      1000000000000ULL,10000000000000ULL,100000000000000ULL,
+      1000000000000000ULL,10000000000000000ULL,100000000000000000ULL,
+      1000000000000000000ULL,10000000000000000000ULL
+    };
+    // Move last digit towards w while staying inside the rounding interval
+    inline void round_weed(
+      char * buffer,
+      const int len,
+      const uint64_t delta,
+      uint64_t rest,
+      const uint64_t ten_kappa,
+      const uint64_t wp_w)
+    {
+      while(rest < wp_w && delta - rest >= ten_kappa &&
+        (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+      {
+        buffer[len-1]--;
+        rest += ten_kappa;
+      }
+    }
+    // Generate digits of Mp until they are within delta of Mp
+    inline void digit_gen(
+      const DiyFp & W,
+      const DiyFp & Mp,
+      uint64_t delta,
+      char * buffer,
+      int & len,
+      int & K)
+    {
+      const DiyFp one(uint64_t(1) << -Mp.e, Mp.e);
+      const uint64_t wp_w = Mp.f - W.f;
+      uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+      uint64_t p2 = Mp.f & (one.f - 1);
+      int kappa = count_digits(p1);
+      len = 0;
+      while(kappa > 0)
+      {
+        // Constant divisors compile to multiplications
+        uint32_t d = 0;
+        switch(kappa)
+        {
+          case 10: d = p1/1000000000; p1 %= 1000000000; break;
+          case  9: d = p1/100000000;  p1 %= 100000000;  break;
+          case  8: d = p1/10000000;   p1 %= 10000000;   break;
+          case  7: d = p1/1000000;    p1 %= 1000000;    break;
+          case  6: d = p1/100000;     p1 %= 100000;     break;
+          case  5: d = p1/10000;      p1 %= 10000;      break;
+          case  4: d = p1/1000;       p1 %= 1000;       break;
+          case  3: d = p1/100;        p1 %= 100;        break;
+          case  2: d = p1/10;         p1 %= 10;         break;
+          case  1: d = p1;            p1 = 0;           break;
+        }
+        if(d || len)
+        {
+          buffer[len++] = static_cast<char>('0' + d);
+        }
+        kappa--;
+        const uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        if(rest <= delta)
+        {
+          K += kappa;
+          round_weed(buffer,len,delta,rest,POW10[kappa] << -one.e,wp_w);
+          return;
+        }
+      }
+      for(;;)
+      {
+        p2 *= 10;
+        delta *= 10;
+        const char d = static_cast<char>(p2 >> -one.e);
+        if(d || len)
+        {
+          buffer[len++] = static_cast<char>('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if(p2 < delta)
+        {
+          K += kappa;
+          const int index = -kappa;
+          round_weed(
+            buffer,len,delta,p2,one.f,wp_w*(index < 20 ? POW10[index] : 0));
+          return;
+        }
+      }
+    }
+    // Digits and decimal exponent K of the positive number f*2^e, so that
+    // value ~ buffer*10^K. lower_closer should be true if the predecessor
+    // of f*2^e is closer than its successor (f is a power of two).
+    inline void grisu2(
+      const uint64_t f,
+      const int e,
+      const bool lower_closer,
+      char * buffer,
+      int & len,
+      int & K)
+    {
+      const DiyFp w_p = normalize(DiyFp((f<<1)+1,e-1));
+      DiyFp w_m = lower_closer ? DiyFp((f<<2)-1,e-2) : DiyFp((f<<1)-1,e-1);
+      w_m.f <<= w_m.e - w_p.e;
+      w_m.e = w_p.e;
+      const DiyFp c_mk = cached_power(w_p.e,K);
+      const DiyFp W = times(normalize(DiyFp(f,e)),c_mk);
+      DiyFp Wp = times(w_p,c_mk);
+      DiyFp Wm = times(w_m,c_mk);
+      Wm.f++;
+      Wp.f--;
+      digit_gen(W,Wp,Wp.f-Wm.f,buffer,len,K);
+    }
+    inline char * write_exponent(int K, char * buffer)
+    {
+      *buffer++ = 'e';
+      *buffer++ = K < 0 ? '-' : '+';
+      K = K < 0 ? -K : K;
+      if(K >= 100)
+      {
+        *buffer++ = static_cast<char>('0' + K/100);
+        K %= 100;
+      }
+      *buffer++ = static_cast<char>('0' + K/10);
+      *buffer++ = static_cast<char>('0' + K%10);
+      return buffer;
+    }
+    // Lay out len digits with decimal exponent k in buffer (which has room)
+    inline char * prettify(char * buffer, const int len, const int k)
+    {
+      // 10^(kk-1) <= value < 10^kk
+      const int kk = len + k;
+      if(0 <= k && kk <= 17)
+      {
+        // 1234e3 -> 1234000
+        std::fill(buffer+len,buffer+kk,'0');
+        return buffer + kk;
+      }else if(0 < kk && kk <= 17)
+      {
+        // 1234e-2 -> 12.34
+        memmove(buffer+kk+1,buffer+kk,len-kk);
+        buffer[kk] = '.';
+        return buffer + len + 1;
+      }else if(-4 < kk && kk <= 0)
+      {
+        // 1234e-6 -> 0.001234
+        const int offset = 2 - kk;
+        memmove(buffer+offset,buffer,len);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        std::fill(buffer+2,buffer+offset,'0');
+        return buffer + len + offset;
+      }else if(len == 1)
+      {
+        // 1e30
+        return write_exponent(kk-1,buffer+1);
+      }
+      // 1234e30 -> 1.234e+33
+      memmove(buffer+2,buffer+1,len-1);
+      buffer[1] = '.';
+      return write_exponent(kk-1,buffer+len+1);
+    }
+    inline char * write_string(char * buffer, const char * s)
+    {
+      const size_t n = strlen(s);
+      memcpy(buffer,s,n);
+      return buffer + n;
+    }
+  }
+}
+
+IGL_INLINE char * igl::to_chars(char * buffer, const double x)
+{
+  using namespace igl::grisu;
+  uint64_t bits;
+  memcpy(&bits,&x,sizeof(double));
+  const int biased_e = static_cast<int>((bits >> 52) & 0x7FF);
+  const uint64_t significand = bits & ((uint64_t(1)<<52)-1);
+  if(biased_e == 0x7FF)
+  {
+    if(significand != 0)
+    {
+      return write_string(buffer,"nan");
+    }
+    return write_string(buffer,(bits>>63) ? "-inf" : "inf");
+  }
+  if(bits>>63)
+  {
+    *buffer++ = '-';
+  }
+  if(biased_e == 0 && significand == 0)
+  {
+    *buffer++ = '0';
+    return buffer;
+  }
+  int len,K;
+  if(biased_e == 0)
+  {
+    grisu2(significand,-1074,false,buffer,len,K);
+  }else
+  {
+    grisu2(
+      significand + (uint64_t(1)<<52),
+      biased_e - 1075,
+      significand == 0 && biased_e > 1,
+      buffer,len,K);
+  }
+  return prettify(buffer,len,K);
+}
+
+IGL_INLINE char * igl::to_chars(char * buffer, const float x)
+{
+  using namespace igl::grisu;
+  uint32_t bits;
+  memcpy(&bits,&x,sizeof(float));
+  const int biased_e = static_cast<int>((bits >> 23) & 0xFF);
+  const uint32_t significand = bits & ((uint32_t(1)<<23)-1);
+  if(biased_e == 0xFF)
+  {
+    if(significand != 0)
+    {
+      return write_string(buffer,"nan");
+    }
+    return write_string(buffer,(bits>>31) ? "-inf" : "inf");
+  }
+  if(bits>>31)
+  {
+    *buffer++ = '-';
+  }
+  if(biased_e == 0 && significand == 0)
+  {
+    *buffer++ = '0';
+    return buffer;
+  }
+  int len,K;
+  if(biased_e == 0)
+  {
+    grisu2(significand,-149,false,buffer,len,K);
+  }else
+  {
+    grisu2(
+      significand + (uint32_t(1)<<23),
+      biased_e - 150,
+      significand == 0 && biased_e > 1,
+      buffer,len,K);
+  }
+  return prettify(buffer,len,K);
+}
+
+IGL_INLINE char * igl::to_chars(
+  char * buffer,
+  const double x,
+  const int precision)
+{
+  if(precision <= 0)
+  {
+    return to_chars(buffer,x);
+  }
+  const int p = std::min(precision,17);
+  const int n = snprintf(buffer,TO_CHARS_MAX_LENGTH,"%.*g",p,x);
+  return buffer + n;
+}
+
+IGL_INLINE char * igl::to_chars(
+  char * buffer,
+  const float x,
+  const int precision)
+{
+  if(precision <= 0)
+  {
+    return to_chars(buffer,x);
+  }
+  return to_chars(buffer,static_cast<double>(x),precision);
+}
+
+template <typename Scalar>
+IGL_INLINE char * igl::to_chars(
+  char * buffer,
+  const Scalar x,
+  const int precision)
+{
+  return to_chars(buffer,static_cast<double>(x),precision);
+}
+
+IGL_INLINE char * igl::to_chars(char * buffer, const int x)
+{
+  return to_chars(buffer,static_cast<long long>(x));
+}
+
+IGL_INLINE char * igl::to_chars(char * buffer, const long long x)
+{
+  unsigned long long u = static_cast<unsigned long long>(x);
+  if(x < 0)
+  {
+    *buffer++ = '-';
+    u = 0ULL - u;
+  }
+  char digits[20];
+  int n = 0;
+  do
+  {
+    digits[n++] = static_cast<char>('0' + u%10);
+    u /= 10;
+  }while(u);
+  while(n)
+  {
+    *buffer++ = digits[--n];
+  }
+  return buffer;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template char * igl::to_chars<int>(char *, int const, int const);
+template char * igl::to_chars<long long>(char *, long long const, int const);
+template char * igl::to_chars<unsigned int>(char *, unsigned int const, int const);
+template char * igl::to_chars<unsigned char>(char *, unsigned char const, int const);
+#endif
@@ -0,0 +1,67 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_TO_CHARS_H
+#define IGL_TO_CHARS_H
+#include "igl_inline.h"
+
+namespace igl
+{
+  // Maximum number of characters written by any to_chars call
+  const int TO_CHARS_MAX_LENGTH = 32;
+  // Format a number as ascii into a buffer (no terminating null character is
+  // written). Floating point numbers are written with the fewest digits such
+  // that reading them back (strtod, strtof, scanf, ifstream, ...) recovers
+  // exactly the same value, using the Grisu2 algorithm [Loitsch 2010].
+  // Results are written in plain notation ("0.25", "-3", "0.001") unless
+  // exponential notation ("1.5e-07", "6e+23") is needed for very small or
+  // large magnitudes. Non-finite values are written as "nan", "inf" and
+  // "-inf".
+  //
+  // Inputs:
+  //   buffer  pointer to at least TO_CHARS_MAX_LENGTH characters
+  //   x  number to write
+  // Returns pointer one past the last character written
+  //
+  // Known issues: for a small fraction of inputs Grisu2 emits one digit more
+  // than the shortest round-trip representation (the value read back is
+  // still exact).
+  //
+  // See also: write_ascii_rows
+  IGL_INLINE char * to_chars(char * buffer, const double x);
+  // Float version: fewest digits to recover the same float (not double)
+  IGL_INLINE char * to_chars(char * buffer, const float x);
+  // Fixed precision version, equivalent to printf("%.*g",precision,x)
+  //
+  // Inputs:
+  //   precision  number of significant digits (clamped to [1,17]), if
+  //     non-positive then same as to_chars(buffer,x)
+  IGL_INLINE char * to_chars(
+    char * buffer,
+    const double x,
+    const int precision);
+  IGL_INLINE char * to_chars(
+    char * buffer,
+    const float x,
+    const int precision);
+  // Other (e.g., integer) scalar types are written as double, so that
+  // to_chars(buffer,A(i,j),precision) works for any Eigen matrix A
+  template <typename Scalar>
+  IGL_INLINE char * to_chars(
+    char * buffer,
+    const Scalar x,
+    const int precision);
+  // Integer versions
+  IGL_INLINE char * to_chars(char * buffer, const int x);
+  IGL_INLINE char * to_chars(char * buffer, const long long x);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "to_chars.cpp"
+#endif
+
+#endif
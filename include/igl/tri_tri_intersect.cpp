@@ -0,0 +1,392 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "tri_tri_intersect.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace igl
+{
+  namespace tri_tri
+  {
+    typedef Eigen::RowVector3d Point;
+    // Sign of (d-c)·((a-c)×(b-c)), or 0 if it is within rounding error
+    inline int orient3d(
+      const Point & a,
+      const Point & b,
+      const Point & c,
+      const Point & d)
+    {
+      const double eps = 0.5*std::numeric_limits<double>::epsilon();
+      const double adx = a(0)-c(0), ady = a(1)-c(1), adz = a(2)-c(2);
+      const double bdx = b(0)-c(0), bdy = b(1)-c(1), bdz = b(2)-c(2);
+      const double ddx = d(0)-c(0), ddy = d(1)-c(1), ddz = d(2)-c(2);
+      const double bdxddy = bdx*ddy, ddxbdy = ddx*bdy;
+      const double ddxady = ddx*ady, adxddy = adx*ddy;
+      const double adxbdy = adx*bdy, bdxady = bdx*ady;
+      const double det =
+        adz*(bdxddy-ddxbdy) + bdz*(ddxady-adxddy) + ddz*(adxbdy-bdxady);
+      const double permanent =
+        (std::abs(bdxddy)+std::abs(ddxbdy))*std::abs(adz) +
+        (std::abs(ddxady)+std::abs(adxddy))*std::abs(bdz) +
+        (std::abs(adxbdy)+std::abs(bdxady))*std::abs(ddz);
+      const double bound = (7.+56.*eps)*eps*permanent;
+      return det > bound ? 1 : (det < -bound ? -1 : 0);
+    }
+    // Sign of (a-c)×(b-c) in 2D, or 0 if it is within rounding error
+    inline int orient2d(const double * a, const double * b, const double * c)
+    {
+      const double eps = 0.5*std::numeric_limits<double>::epsilon();
+      const double left = (a[0]-c[0])*(b[1]-c[1]);
+      const double right = (a[1]-c[1])*(b[0]-c[0]);
+      const double det = left-right;
+      const double bound = (3.+16.*eps)*eps*(std::abs(left)+std::abs(right));
+      return det > bound ? 1 : (det < -bound ? -1 : 0);
+    }
+    // Whether segment pq intersects triangle abc (1), does not (0) or is
+    // uncertain (-1)
+    inline int segment_triangle(
+      const Point & p,
+      const Point & q,
+      const Point & a,
+      const Point & b,
+      const Point & c)
+    {
+      const int sp = orient3d(a,b,c,p);
+      const int sq = orient3d(a,b,c,q);
+      if(sp != 0 && sp == sq)
+      {
+        return 0;
+      }
+      // Line pq passes through triangle iff it turns the same way around
+      // each edge
+      const int s0 = orient3d(p,q,a,b);
+      const int s1 = orient3d(p,q,b,c);
+      const int s2 = orient3d(p,q,c,a);
+      if((s0 > 0 || s1 > 0 || s2 > 0) && (s0 < 0 || s1 < 0 || s2 < 0))
+      {
+        return 0;
+      }
+      if(sp == 0 || sq == 0 || s0 == 0 || s1 == 0 || s2 == 0)
+      {
+        return -1;
+      }
+      return 1;
+    }
+    // Final test of [Guigue & Devillers 2003] once p1 and p2 are alone on
+    // their side of the other triangle's plane
+    inline int check_min_max(
+      const Point & p1,
+      const Point & q1,
+      const Point & r1,
+      const Point & p2,
+      const Point & q2,
+      const Point & r2)
+    {
+      const int s1 = orient3d(p2,p1,q1,q2);
+      const int s2 = orient3d(p2,r1,p1,r2);
+      if(s1 > 0 || s2 > 0)
+      {
+        return 0;
+      }
+      if(s1 == 0 || s2 == 0)
+      {
+        return -1;
+      }
+      return 1;
+    }
+    // Permute second triangle so that p2 is alone on its side
+    inline int tri_tri_3d(
+      const Point & p1,
+      const Point & q1,
+      const Point & r1,
+      const Point & p2,
+      const Point & q2,
+      const Point & r2,
+      const int dp2,
+      const int dq2,
+      const int dr2)
+    {
+      if(dp2 > 0)
+      {
+        if(dq2 > 0)
+        {
+          return check_min_max(p1,r1,q1,r2,p2,q2);
+        }else if(dr2 > 0)
+        {
+          return check_min_max(p1,r1,q1,q2,r2,p2);
+        }
+        return check_min_max(p1,q1,r1,p2,q2,r2);
+      }
+      if(dq2 < 0)
+      {
+        return check_min_max(p1,q1,r1,r2,p2,q2);
+      }else if(dr2 < 0)
+      {
+        return check_min_max(p1,q1,r1,q2,r2,p2);
+      }
+      return check_min_max(p1,r1,q1,p2,q2,r2);
+    }
+    // Triangles without shared corners
+    inline int general(const Point * A, const Point * B)
+    {
+      const Point & p1 = A[0], & q1 = A[1], & r1 = A[2];
+      const Point & p2 = B[0], & q2 = B[1], & r2 = B[2];
+      const int dp1 = orient3d(p2,q2,r2,p1);
+      const int dq1 = orient3d(p2,q2,r2,q1);
+      const int dr1 = orient3d(p2,q2,r2,r1);
+      if(dp1 != 0 && dp1 == dq1 && dp1 == dr1)
+      {
+        return 0;
+      }
+      const int dp2 = orient3d(p1,q1,r1,p2);
+      const int dq2 = orient3d(p1,q1,r1,q2);
+      const int dr2 = orient3d(p1,q1,r1,r2);
+      if(dp2 != 0 && dp2 == dq2 && dp2 == dr2)
+      {
+        return 0;
+      }
+      // Corners on (or too close to) the other plane
+      if(dp1 == 0 || dq1 == 0 || dr1 == 0 || dp2 == 0 || dq2 == 0 || dr2 == 0)
+      {
+        return -1;
+      }
+      // Permute first triangle so that p1 is alone on its side
+      if(dp1 > 0)
+      {
+        if(dq1 > 0)
+        {
+          return tri_tri_3d(r1,p1,q1,p2,r2,q2,dp2,dr2,dq2);
+        }else if(dr1 > 0)
+        {
+          return tri_tri_3d(q1,r1,p1,p2,r2,q2,dp2,dr2,dq2);
+        }
+        return tri_tri_3d(p1,q1,r1,p2,q2,r2,dp2,dq2,dr2);
+      }
+      if(dq1 < 0)
+      {
+        return tri_tri_3d(r1,p1,q1,p2,q2,r2,dp2,dq2,dr2);
+      }else if(dr1 < 0)
+      {
+        return tri_tri_3d(q1,r1,p1,p2,q2,r2,dp2,dq2,dr2);
+      }
+      return tri_tri_3d(p1,q1,r1,p2,r2,q2,dp2,dr2,dq2);
+    }
+    // Whether the projections of the triangles along the dominant axis of
+    // the first one's normal are separated by the line through an edge of
+    // either (ignoring shared corners), or by their wedges at a single shared
+    // corner. Points of the first triangle project one to one, so then the
+    // triangles only meet at shared corners.
+    //
+    // Inputs:
+    //   shared  shared(i) = j if A[i] is B[j], -1 otherwise
+    inline bool separated_2d(
+      const Point * A,
+      const Point * B,
+      const int * shared)
+    {
+      const Point n = (A[1]-A[0]).cross(A[2]-A[0]);
+      int k;
+      n.cwiseAbs().maxCoeff(&k);
+      if(n(k) == 0)
+      {
+        return false;
+      }
+      double P[2][3][2];
+      for(int c = 0;c<3;c++)
+      {
+        for(int d = 0;d<2;d++)
+        {
+          P[0][c][d] = A[c]((k+1+d)%3);
+          P[1][c][d] = B[c]((k+1+d)%3);
+        }
+      }
+      // is_shared[t][c][o] whether corner c of triangle t is corner o of the
+      // other triangle
+      bool is_shared[2][3][3] = {};
+      for(int c = 0;c<3;c++)
+      {
+        if(shared[c] >= 0)
+        {
+          is_shared[0][c][shared[c]] = true;
+          is_shared[1][shared[c]][c] = true;
+        }
+      }
+      for(int t = 0;t<2;t++)
+      {
+        for(int e = 0;e<3;e++)
+        {
+          const int u = e, v = (e+1)%3, w = (e+2)%3;
+          const int sw = orient2d(P[t][u],P[t][v],P[t][w]);
+          if(sw == 0)
+          {
+            continue;
+          }
+          bool separated = true;
+          for(int o = 0;o<3 && separated;o++)
+          {
+            if(is_shared[t][u][o] || is_shared[t][v][o])
+            {
+              continue;
+            }
+            separated = orient2d(P[t][u],P[t][v],P[1-t][o]) == -sw;
+          }
+          if(separated)
+          {
+            return true;
+          }
+        }
+      }
+      // Triangles sharing a single corner only meet elsewhere if their
+      // wedges at it overlap, i.e., one contains an edge of the other leaving
+      // the corner (lines through edges may all fail to separate them, e.g.,
+      // when edges of both are collinear)
+      int i = 0;
+      while(i < 3 && shared[i] < 0)
+      {
+        i++;
+      }
+      if(i == 3 || shared[(i+1)%3] >= 0 || shared[(i+2)%3] >= 0)
+      {
+        return false;
+      }
+      const int j = shared[i];
+      const double * s = P[0][i];
+      // Ends of edges leaving the shared corner, counter-clockwise
+      const double * W[2][2] = {
+        {P[0][(i+1)%3],P[0][(i+2)%3]},
+        {P[1][(j+1)%3],P[1][(j+2)%3]}};
+      for(int t = 0;t<2;t++)
+      {
+        const int o = orient2d(W[t][0],W[t][1],s);
+        if(o == 0)
+        {
+          return false;
+        }
+        if(o < 0)
+        {
+          std::swap(W[t][0],W[t][1]);
+        }
+      }
+      for(int t = 0;t<2;t++)
+      {
+        for(int e = 0;e<2;e++)
+        {
+          const double * w = W[1-t][e];
+          if(orient2d(W[t][0],w,s) >= 0 && orient2d(w,W[t][1],s) >= 0)
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  }
+}
+
+IGL_INLINE int igl::tri_tri_intersect(
+  const Eigen::RowVector3d & p1,
+  const Eigen::RowVector3d & q1,
+  const Eigen::RowVector3d & r1,
+  const Eigen::RowVector3d & p2,
+  const Eigen::RowVector3d & q2,
+  const Eigen::RowVector3d & r2)
+{
+  using namespace igl::tri_tri;
+  const Point A[3] = {p1,q1,r1};
+  const Point B[3] = {p2,q2,r2};
+  // Triangles with repeated corners are left undecided
+  for(int c = 0;c<3;c++)
+  {
+    if(A[c] == A[(c+1)%3] || B[c] == B[(c+1)%3])
+    {
+      return -1;
+    }
+  }
+  int shared[3] = {-1,-1,-1};
+  int num_shared = 0;
+  for(int i = 0;i<3;i++)
+  {
+    for(int j = 0;j<3;j++)
+    {
+      if(A[i] == B[j])
+      {
+        shared[i] = j;
+        num_shared++;
+      }
+    }
+  }
+  int result = -1;
+  switch(num_shared)
+  {
+    case 0:
+      result = general(A,B);
+      break;
+    case 1:
+    {
+      // Beyond the shared corner, triangles can only meet where the edge
+      // opposite it in one crosses the other (unless coplanar)
+      int i = 0;
+      while(shared[i] < 0)
+      {
+        i++;
+      }
+      const int j = shared[i];
+      const int ra = segment_triangle(A[(i+1)%3],A[(i+2)%3],B[0],B[1],B[2]);
+      const int rb = segment_triangle(B[(j+1)%3],B[(j+2)%3],A[0],A[1],A[2]);
+      if(ra == 1 || rb == 1)
+      {
+        result = 1;
+      }else if(ra == 0 && rb == 0)
+      {
+        result = 0;
+      }
+      break;
+    }
+    case 2:
+    {
+      // Triangles sharing an edge only overlap if coplanar
+      int i = 0;
+      while(shared[i] >= 0)
+      {
+        i++;
+      }
+      int j = 0;
+      while(j == shared[(i+1)%3] || j == shared[(i+2)%3])
+      {
+        j++;
+      }
+      if(orient3d(A[(i+1)%3],A[(i+2)%3],A[i],B[j]) != 0)
+      {
+        result = 0;
+      }
+      break;
+    }
+    default:
+      // Same triangle
+      return 1;
+  }
+  // Nearly coplanar: try to separate in 2D, projecting along either normal
+  if(result == -1)
+  {
+    int shared_b[3] = {-1,-1,-1};
+    for(int i = 0;i<3;i++)
+    {
+      if(shared[i] >= 0)
+      {
+        shared_b[shared[i]] = i;
+      }
+    }
+    if(separated_2d(A,B,shared) || separated_2d(B,A,shared_b))
+    {
+      result = 0;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,47 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_TRI_TRI_INTERSECT_H
+#define IGL_TRI_TRI_INTERSECT_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // TRI_TRI_INTERSECT Determine whether two triangles in 3D intersect using
+  // orientation predicates ("Fast and Robust Triangle-Triangle Overlap Test
+  // using Orientation Predicates" [Guigue & Devillers 2003]).
+  //
+  // Predicates are evaluated in floating point with a forward error bound
+  // (as in "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+  // Geometric Predicates" [Shewchuk 1997]). When a sign cannot be certified
+  // the answer is "uncertain" rather than possibly wrong, so exactly touching
+  // or coplanar overlapping triangles are left to an exact test (e.g.,
+  // copyleft/cgal/intersect_other).
+  //
+  // Corners at exactly the same position are treated as shared, as between
+  // neighboring faces of a mesh: triangles meeting only at shared corners (or
+  // along a shared edge) do not intersect.
+  //
+  // Inputs:
+  //   p1,q1,r1  corners of first triangle
+  //   p2,q2,r2  corners of second triangle
+  // Returns 1 if the triangles certainly intersect, 0 if they certainly do
+  //   not, -1 if this could not be decided in floating point
+  IGL_INLINE int tri_tri_intersect(
+    const Eigen::RowVector3d & p1,
+    const Eigen::RowVector3d & q1,
+    const Eigen::RowVector3d & r1,
+    const Eigen::RowVector3d & p2,
+    const Eigen::RowVector3d & q2,
+    const Eigen::RowVector3d & r2);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "tri_tri_intersect.cpp"
+#endif
+
+#endif
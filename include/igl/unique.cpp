@@ -12,6 +12,8 @@
 #include "sortrows.h"
 #include "list_to_matrix.h"
 #include "matrix_to_list.h"
+#include "parallel_for.h"
+#include "parallel_inclusive_scan.h"
 
 #include <algorithm>
 #include <iostream>
@@ -41,24 +43,27 @@ IGL_INLINE void igl::unique(
     igl::IndexEquals<const std::vector<T>& >(sortA)),IA.end());
 
   IC.resize(A.size());
-  {
-    int j = 0;
-    for(int i = 0;i<(int)sortA.size();i++)
+  // IC[IM[i]] is the number of times the value changes in sortA[0..i]
+  igl::parallel_inclusive_scan(
+    sortA.size(),
+    (size_t)0,
+    [&sortA](const size_t i)->size_t
     {
-      if(sortA[IA[j]] != sortA[i])
-      {
-        j++;
-      }
-      IC[IM[i]] = j;
-    }
-  }
+      return (i > 0 && sortA[i-1] != sortA[i]) ? 1 : 0;
+    },
+    [](const size_t a, const size_t b){ return a+b; },
+    [&IC,&IM](const size_t i, const size_t j){ IC[IM[i]] = j; },
+    100000);
   C.resize(IA.size());
   // Reindex IA according to IM
-  for(int i = 0;i<(int)IA.size();i++)
-  {
-    IA[i] = IM[IA[i]];
-    C[i] = A[IA[i]];
-  }
+  parallel_for(
+    IA.size(),
+    [&IA,&IM,&C,&A](const size_t i)
+    {
+      IA[i] = IM[IA[i]];
+      C[i] = A[IA[i]];
+    },
+    100000);
 
 }
 
@@ -235,26 +240,29 @@ IGL_INLINE void igl::unique_rows(
     ),vIA.end());
 
   IC.resize(A.rows(),1);
-  {
-    int j = 0;
-    for(int i = 0;i<num_rows;i++)
+  // IC(IM(i)) is the number of times the row changes in sortA.row(0..i)
+  igl::parallel_inclusive_scan(
+    num_rows,
+    0,
+    [&index_equal](const int i)->int
     {
-      if(sortA.row(vIA[j]) != sortA.row(i))
-      {
-        j++;
-      }
-      IC(IM(i,0),0) = j;
-    }
-  }
+      return (i > 0 && !index_equal(i-1,i)) ? 1 : 0;
+    },
+    [](const int a, const int b){ return a+b; },
+    [&IC,&IM](const int i, const int j){ IC(IM(i,0),0) = j; },
+    100000);
   const int unique_rows = vIA.size();
   C.resize(unique_rows,A.cols());
   IA.resize(unique_rows,1);
   // Reindex IA according to IM
-  for(int i = 0;i<unique_rows;i++)
-  {
-    IA(i,0) = IM(vIA[i],0);
-    C.row(i) = A.row(IA(i,0));
-  }
+  parallel_for(
+    unique_rows,
+    [&IA,&IM,&vIA,&C,&A](const int i)
+    {
+      IA(i,0) = IM(vIA[i],0);
+      C.row(i) = A.row(IA(i,0));
+    },
+    100000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
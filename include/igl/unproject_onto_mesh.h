@@ -8,6 +8,7 @@
 #ifndef IGL_UNPROJECT_ONTO_MESH
 #define IGL_UNPROJECT_ONTO_MESH
 #include "igl_inline.h"
+#include "AABB.h"
 #include "Hit.h"
 #include <Eigen/Core>
 #include <functional>
@@ -39,6 +40,24 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedF> & F,
     int & fid,
     Eigen::PlainObjectBase<Derivedbc> & bc);
+  // Same as above but using a prebuilt AABB tree of (V,F), so that picking
+  // costs a logarithmic traversal rather than a test against every face.
+  //
+  // Inputs:
+  //    F  #F by 3 list of mesh triangle indices into V (the element type
+  //      igl::AABB works with)
+  //    tree  AABB tree built (or refit) with tree.init(V,F)
+  template < typename DerivedV, typename Derivedbc>
+  IGL_INLINE bool unproject_onto_mesh(
+    const Eigen::Vector2f& pos,
+    const Eigen::Matrix4f& model,
+    const Eigen::Matrix4f& proj,
+    const Eigen::Vector4f& viewport,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::MatrixXi & F,
+    const igl::AABB<DerivedV,3> & tree,
+    int & fid,
+    Eigen::PlainObjectBase<Derivedbc> & bc);
   //
   // Inputs:
   //    pos        screen space coordinates
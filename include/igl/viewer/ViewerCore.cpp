@@ -138,6 +138,7 @@ IGL_INLINE void igl::viewer::ViewerCore::draw(
   if (data.dirty)
   {
     opengl.set_data(data,data.invert_normals);
+    data.tree_dirty |= data.dirty;
     data.dirty = ViewerData::DIRTY_NONE;
   }
   opengl.bind_mesh();
@@ -16,7 +16,7 @@
 #include <igl/per_vertex_normals.h>
 
 IGL_INLINE igl::viewer::ViewerData::ViewerData()
-: dirty(DIRTY_ALL)
+: dirty(DIRTY_ALL), tree_dirty(DIRTY_ALL)
 {
   reset();
 };
@@ -346,6 +346,8 @@ IGL_INLINE void igl::viewer::ViewerData::clear()
   points                  = Eigen::MatrixXd (0,6);
   labels_positions        = Eigen::MatrixXd (0,3);
   labels_strings.clear();
+
+  tree_dirty |= DIRTY_FACE;
 }
 
 IGL_INLINE void igl::viewer::ViewerData::reset()
@@ -373,6 +375,22 @@ IGL_INLINE void igl::viewer::ViewerData::reset()
   line_width = 0.5f;
 }
 
+IGL_INLINE const igl::AABB<Eigen::MatrixXd,3> &
+igl::viewer::ViewerData::update_tree()
+{
+  tree_dirty |= dirty;
+  if (tree_dirty & DIRTY_FACE)
+  {
+    tree.init(V,F);
+  }
+  else if (tree_dirty & DIRTY_POSITION)
+  {
+    tree.refit(V,F);
+  }
+  tree_dirty = DIRTY_NONE;
+  return tree;
+}
+
 IGL_INLINE void igl::viewer::ViewerData::compute_normals()
 {
   igl::per_face_normals(V, F, F_normals);
@@ -14,6 +14,7 @@
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
+#include <igl/AABB.h>
 #include <igl/igl_inline.h>
 
 namespace igl
@@ -140,6 +141,11 @@ public:
   // Generates a default grid texture
   IGL_INLINE void grid_texture();
 
+  // Returns the AABB tree of (V,F) for picking (e.g., with
+  // igl::unproject_onto_mesh), rebuilding it if the faces changed or refitting
+  // it if only the vertex positions changed since the last call
+  IGL_INLINE const igl::AABB<Eigen::MatrixXd,3> & update_tree();
+
   // Model matrix
   Eigen::Matrix4f model;
   Eigen::Vector3f model_translation;
@@ -198,6 +204,12 @@ public:
   // Marks dirty buffers that need to be uploaded to OpenGL
   uint32_t dirty;
 
+  // Cached AABB tree of (V,F), see update_tree()
+  igl::AABB<Eigen::MatrixXd,3> tree;
+  // Marks changes not yet applied to tree (dirty is cleared when buffers are
+  // uploaded to OpenGL, so it is accumulated here)
+  uint32_t tree_dirty;
+
   // Enable per-face or per-vertex properties
   bool face_based;
 
@@ -7,6 +7,7 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "winding_number.h"
 #include "WindingNumberAABB.h"
+#include "parallel_for.h"
 
 #include <igl/PI.h>
 #include <cmath>
@@ -38,12 +39,11 @@ IGL_INLINE void igl::winding_number(
       hier.grow();
       // loop over origins
       const int no = O.rows();
-#   pragma omp parallel for if (no>IGL_WINDING_NUMBER_OMP_MIN_VALUE)
-      for(int o = 0;o<no;o++)
+      parallel_for(no,[&hier,&O,&W](const int o)
       {
         Vector3d p = O.row(o);
         W(o) = hier.winding_number(p);
-      }
+      },IGL_WINDING_NUMBER_OMP_MIN_VALUE);
       break;
     }
     default: assert(false && "Bad simplex size"); break;
@@ -60,35 +60,13 @@ IGL_INLINE void igl::winding_number_3(
   const int no,
   Scalar * S)
 {
-  // Initialize output
-  // loop over origins
-#pragma omp parallel for if (no>IGL_WINDING_NUMBER_OMP_MIN_VALUE)
-  for(int o = 0;o<no;o++)
-  {
-    S[o] = 0;
-  }
-  // Only use parallel for if there are many facets and more than one origin.
-  // Assumes that if there is exactly one origin then this is being called
-  // within an outer for loop which may be parallel
-#pragma omp parallel for if (m>IGL_WINDING_NUMBER_OMP_MIN_VALUE && no>1)
-  // loop over faces
-  for(int f = 0;f<m;f++)
+  // Each origin sums the contributions of all faces in order, so the output
+  // does not depend on the number of threads and no atomics are needed.
+  const auto & origin = [&V,n,&F,m,&O,no,&S](const int o)
   {
-    // Gather corners 
-    Scalar C[3][3];
-    // loop around triangle
-    for(int t=0;t<3;t++)
-    {
-      // loop over dimensions
-      for(int d = 0;d<3;d++)
-      {
-        // Indices are offset by 1
-        int Ff = F[m*t + f];
-        C[t][d] = V[d*n + Ff];
-      }
-    }
-    // loop over origins
-    for(int o = 0;o<no;o++)
+    Scalar So = 0;
+    // loop over faces
+    for(int f = 0;f<m;f++)
     {
       // Gather vectors to corners
       Scalar v[3][3];
@@ -97,10 +75,11 @@ IGL_INLINE void igl::winding_number_3(
       for(int t=0;t<3;t++)
       {
         vl[t] = 0;
+        const int Ff = F[m*t + f];
         // loop over dimensions
         for(int d = 0;d<3;d++)
         {
-          v[t][d] = C[t][d] - O[d*no + o];
+          v[t][d] = V[d*n + Ff] - O[d*no + o];
           // compute edge length contribution
           vl[t] += v[t][d]*v[t][d];
         }
@@ -111,7 +90,6 @@ IGL_INLINE void igl::winding_number_3(
           vl[t] = sqrt(vl[t]);
         }
       }
-      //printf("\n");
       // Compute determinant
       Scalar detf = 
         v[0][0]*v[1][1]*v[2][2]+
@@ -133,14 +111,23 @@ IGL_INLINE void igl::winding_number_3(
       dp[2] += v[0][2]*v[1][2];
       // Compute winding number
       // Only divide by TWO_PI instead of 4*pi because there was a 2 out front
-      Scalar val = atan2(detf,
+      So += atan2(detf,
         vl[0]*vl[1]*vl[2] + 
         dp[0]*vl[0] +
         dp[1]*vl[1] +
         dp[2]*vl[2]) / (2.*igl::PI);
-#pragma omp atomic
-      S[o] += val;
     }
+    S[o] = So;
+  };
+  // Only use parallel for if there are many facets and more than one origin.
+  // Assumes that if there is exactly one origin then this is being called
+  // within an outer for loop which may be parallel
+  if(m>IGL_WINDING_NUMBER_OMP_MIN_VALUE)
+  {
+    parallel_for(no,origin,2);
+  }else
+  {
+    for(int o = 0;o<no;o++) origin(o);
   }
 }
 
@@ -154,31 +141,17 @@ IGL_INLINE void igl::winding_number_2(
   const int no,
   double * S)
 {
-  // Initialize output
-  // loop over origins
-#pragma omp parallel for if (no>IGL_WINDING_NUMBER_OMP_MIN_VALUE)
-  for(int o = 0;o<no;o++)
+  // Each origin sums the contributions of all faces in order, so the output
+  // does not depend on the number of threads and no atomics are needed.
+  const auto & origin = [&V,n,&F,m,&O,no,&S](const int o)
   {
-    S[o] = 0;
-  }
-#pragma omp parallel for if (m>IGL_WINDING_NUMBER_OMP_MIN_VALUE && no>1)
-  // loop over faces
-  for(int f = 0;f<m;f++)
-  {
-    // Index of source and destination
-    int s = F[m*0 + f];
-    int d = F[m*1 + f];
-    // Positions of source and destination
-    double vs[2];
-    double vd[2];
-    vs[0] = V[0*n + s];
-    vs[1] = V[1*n + s];
-    vd[0] = V[0*n + d];
-    vd[1] = V[1*n + d];
-    
-    // loop over origins
-    for(int o = 0;o<no;o++)
+    double So = 0;
+    // loop over faces
+    for(int f = 0;f<m;f++)
     {
+      // Index of source and destination
+      int s = F[m*0 + f];
+      int d = F[m*1 + f];
       // Gather vectors to source and destination
       double o2vs[2];
       double o2vd[2];
@@ -187,8 +160,8 @@ IGL_INLINE void igl::winding_number_2(
       double o2vdl = 0;
       for(int i = 0;i<2;i++)
       {
-        o2vs[i] = O[i*no + o] - vs[i];
-        o2vd[i] = O[i*no + o] - vd[i];
+        o2vs[i] = O[i*no + o] - V[i*n + s];
+        o2vd[i] = O[i*no + o] - V[i*n + d];
         o2vsl += o2vs[i]*o2vs[i];
         o2vdl += o2vd[i]*o2vd[i];
       }
@@ -207,12 +180,18 @@ IGL_INLINE void igl::winding_number_2(
           o2vd[i] /= o2vdl;
         }
       }
-      double val =
+      So +=
         -atan2(o2vd[0]*o2vs[1]-o2vd[1]*o2vs[0],o2vd[0]*o2vs[0]+o2vd[1]*o2vs[1])/
         (2.*igl::PI);
-#pragma omp atomic
-      S[o] += val;
     }
+    S[o] = So;
+  };
+  if(m>IGL_WINDING_NUMBER_OMP_MIN_VALUE)
+  {
+    parallel_for(no,origin,2);
+  }else
+  {
+    for(int o = 0;o<no;o++) origin(o);
   }
 }
 
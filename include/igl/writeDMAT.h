@@ -24,6 +24,7 @@ namespace igl
   //   ascii  write ascii file {true}
   // Returns true on success, false on error
   //
+  // See also: fast_writeDMAT
   template <typename DerivedW>
   IGL_INLINE bool writeDMAT(
     const std::string file_name, 
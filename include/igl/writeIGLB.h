@@ -0,0 +1,37 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_WRITEIGLB_H
+#define IGL_WRITEIGLB_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <string>
+
+namespace igl
+{
+  // Write a mesh to a binary .iglb file (see MappedMesh) as sections "V"
+  // and "F". Use igl::MappedMesh::Writer to store more sections.
+  //
+  // Inputs:
+  //   filename  path to .iglb file
+  //   V  #V by dim list of vertex positions
+  //   F  #F by ss list of face indices into V
+  // Returns true on success, false (with message to stderr) on errors
+  //
+  // See also: readIGLB, MappedMesh, encode_mesh
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE bool writeIGLB(
+    const std::string & filename,
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "writeIGLB.cpp"
+#endif
+
+#endif
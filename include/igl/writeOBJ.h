@@ -29,6 +29,8 @@ namespace igl
   //
   // Known issues: Horrifyingly, this does not have the same order of
   // parameters as readOBJ.
+  //
+  // See also: fast_writeOBJ
   template <
     typename DerivedV, 
     typename DerivedF,
@@ -29,6 +29,8 @@ namespace igl
   //   C  double matrix of rgb values per vertex #V by 3
   // Outputs:
   // Returns true on success, false on errors
+  //
+  // See also: fast_writeOFF
   template <typename DerivedV, typename DerivedF, typename DerivedC>
   IGL_INLINE bool writeOFF(
     const std::string str,
@@ -22,6 +22,8 @@ namespace igl
   //   N  #V by 3 list of vertex normals
   //   UV  #V by 2 list of vertex texture coordinates
   // Returns true iff success
+  //
+  // See also: fast_writePLY
   template <
     typename DerivedV,
     typename DerivedF,
@@ -30,6 +30,7 @@ namespace igl
   //   asci  write ascii file {true}
   // Returns true on success, false on errors
   //
+  // See also: fast_writeSTL
   template <typename DerivedV, typename DerivedF, typename DerivedN>
   IGL_INLINE bool writeSTL(
     const std::string & filename,
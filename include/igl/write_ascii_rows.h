@@ -0,0 +1,95 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2017 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_WRITE_ASCII_ROWS_H
+#define IGL_WRITE_ASCII_ROWS_H
+#include <cstddef>
+#include <cstdio>
+
+namespace igl
+{
+  // Write n variable-length ascii rows (lines, records, ...) to a file.
+  // Rows are formatted in parallel, in chunks of consecutive rows, into a
+  // large buffer and chunks are then written sequentially (in order) with one
+  // fwrite each, so the file contents are the same as a serial loop:
+  //
+  //     for(size_t i = 0;i<n;i++)
+  //     {
+  //       char row[max_row_length];
+  //       fwrite(row,1,format(i,row)-row,fp);
+  //     }
+  //
+  // Inputs:
+  //   fp  file opened for writing
+  //   n  number of rows
+  //   max_row_length  upper bound on the number of characters of any row
+  //   format  function handle so that format(i,p) writes row i starting at
+  //     p and returns one past its last character. Called concurrently for
+  //     different i.
+  // Returns true iff all rows were written
+  //
+  // See also: to_chars, parallel_for
+  template <typename FormatFunc>
+  inline bool write_ascii_rows(
+    FILE * fp,
+    const size_t n,
+    const size_t max_row_length,
+    const FormatFunc & format);
+}
+
+// Implementation
+
+#include "parallel_for.h"
+#include <algorithm>
+#include <vector>
+
+template <typename FormatFunc>
+inline bool igl::write_ascii_rows(
+  FILE * fp,
+  const size_t n,
+  const size_t max_row_length,
+  const FormatFunc & format)
+{
+  // Rows formatted at once by one thread
+  const size_t CHUNK_ROWS = 1024;
+  // Keep the buffer around 16MB (and at least one chunk)
+  const size_t num_chunks = std::max<size_t>(1,
+    std::min<size_t>(
+      (n+CHUNK_ROWS-1)/CHUNK_ROWS,
+      (size_t(1)<<24)/(CHUNK_ROWS*max_row_length)));
+  const size_t chunk_bytes = CHUNK_ROWS*max_row_length;
+  std::vector<char> buffer(num_chunks*chunk_bytes);
+  std::vector<size_t> chunk_size(num_chunks);
+  const size_t block_rows = num_chunks*CHUNK_ROWS;
+  for(size_t b = 0;b<n;b += block_rows)
+  {
+    const size_t m = std::min(block_rows,n-b);
+    const size_t block_chunks = (m+CHUNK_ROWS-1)/CHUNK_ROWS;
+    parallel_for(block_chunks,[&](const size_t c)
+    {
+      char * const begin = buffer.data()+c*chunk_bytes;
+      char * p = begin;
+      const size_t last = b+std::min(m,(c+1)*CHUNK_ROWS);
+      for(size_t i = b+c*CHUNK_ROWS;i<last;i++)
+      {
+        p = format(i,p);
+      }
+      chunk_size[c] = p-begin;
+    },2);
+    for(size_t c = 0;c<block_chunks;c++)
+    {
+      if(fwrite(buffer.data()+c*chunk_bytes,1,chunk_size[c],fp) !=
+        chunk_size[c])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+#endif
@@ -7,6 +7,7 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "write_triangle_mesh.h"
 #include "pathinfo.h"
+#include "writeIGLB.h"
 #include "writeMESH.h"
 #include "writeOBJ.h"
 #include "writeOFF.h"
@@ -52,6 +53,10 @@ IGL_INLINE bool igl::write_triangle_mesh(
   {
     assert(ascii && ".wrl only supports ascii");
     return writeWRL(str,V,F);
+  }else if(e == "iglb")
+  {
+    // Always binary
+    return writeIGLB(str,V,F);
   }else
   {
     assert("Unsupported file format");
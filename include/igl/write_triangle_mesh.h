@@ -15,7 +15,7 @@
 namespace igl
 {
   // write mesh to a file with automatic detection of file format.  supported:
-  // obj, off, stl, wrl, ply, mesh). 
+  // obj, off, stl, wrl, ply, mesh, iglb). 
   // 
   // Templates:
   //   Scalar  type for positions and vectors (will be read as double and cast
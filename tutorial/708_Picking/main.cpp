@@ -25,7 +25,8 @@ int main(int argc, char *argv[])
     double x = viewer.current_mouse_x;
     double y = viewer.core.viewport(3) - viewer.current_mouse_y;
     if(igl::unproject_onto_mesh(Eigen::Vector2f(x,y), viewer.core.view * viewer.data.model,
-      viewer.core.proj, viewer.core.viewport, V, F, fid, bc))
+      viewer.core.proj, viewer.core.viewport, viewer.data.V, viewer.data.F,
+      viewer.data.update_tree(), fid, bc))
     {
       // paint hit red
       C.row(fid)<<1,0,0;